@@ -30,7 +30,7 @@
 #include <blitz/array.h>
 #include <boost/format.hpp>
 
-#include <bob/sp/FFT1D.h>
+#include <complex>
 
 #include "Energy.h"
 
@@ -221,9 +221,17 @@ class Spectrogram: public Energy
     void hammingWindow(blitz::Array<double,1> &data) const;
 
     /**
-     * @brief Computes the power-spectrum of the FFT of the input frame
+     * @brief Extracts all the frames of the input signal, and applies the
+     * pre-emphasis and the Hamming window to each of them. The frames are
+     * stored as the rows of m_cache_frames.
      */
-    void powerSpectrumFFT(blitz::Array<double,1>& x);
+    void extractFrames(const blitz::Array<double,1>& input, const int n_frames);
+    /**
+     * @brief Computes the power-spectrum of the FFT of each row of the input
+     * frames, using a single batch of real-to-complex transforms. The first
+     * half of each row is overwritten by its power spectrum.
+     */
+    void powerSpectrumFFT(blitz::Array<double,2>& frames);
     /**
      * @brief Applies the triangular filter bank
      */
@@ -280,10 +288,9 @@ class Spectrogram: public Energy
     blitz::Array<double,1> m_hamming_kernel;
     blitz::Array<int,1> m_p_index;
     std::vector<blitz::Array<double,1> > m_filter_bank;
-    bob::sp::FFT1D m_fft;
 
-    mutable blitz::Array<std::complex<double>,1> m_cache_frame_c1;
-    mutable blitz::Array<std::complex<double>,1> m_cache_frame_c2;
+    mutable blitz::Array<double,2> m_cache_frames;
+    mutable blitz::Array<std::complex<double>,2> m_cache_spectra;
     mutable blitz::Array<double,1> m_cache_filters;
 };
 
@@ -0,0 +1,121 @@
+/**
+ * @file bob/core/parallel.h
+ * @date Fri Oct 16 19:12:38 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Splits a range of work items into contiguous chunks, which are
+ * processed on their own threads.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_CORE_PARALLEL_H
+#define BOB_CORE_PARALLEL_H
+
+#include <algorithm>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/thread.hpp>
+
+namespace bob { namespace core {
+/**
+ * @ingroup CORE
+ * @{
+ */
+
+/**
+ * @brief Returns the number of chunks parallelChunks() splits n work items
+ * into, when using (at most) n_threads threads.
+ */
+inline int getNChunks(const int n, const size_t n_threads)
+{
+  return std::max(1, std::min(n, static_cast<int>(std::max<size_t>(n_threads, 1))));
+}
+
+/**
+ * @brief Returns the first work item (start) and the number of work items
+ * (count) of the k'th chunk, when splitting n work items into n_chunks
+ * contiguous chunks of nearly equal sizes.
+ */
+inline void getChunk(const int n, const int n_chunks, const int k,
+    int& start, int& count)
+{
+  const int chunk = n / n_chunks;
+  const int remainder = n % n_chunks;
+  start = k * chunk + std::min(k, remainder);
+  count = chunk + (k < remainder ? 1 : 0);
+}
+
+namespace detail {
+
+  template <typename F>
+  void runChunk(const F& f, const int k, const int start, const int count,
+      boost::exception_ptr& error)
+  {
+    try {
+      f(k, start, count);
+    }
+    catch (...) {
+      error = boost::current_exception();
+    }
+  }
+
+}
+
+/**
+ * @brief Splits the n work items [0,n) into getNChunks(n, n_threads)
+ * contiguous chunks of nearly equal sizes, and calls f(k, start, count)
+ * for each chunk k on its own thread. The chunks only depend on n and
+ * n_threads: results combined in chunk order are hence reproducible for a
+ * given number of threads. If there is a single chunk, f is called on the
+ * calling thread. An exception raised by f is rethrown once all the chunks
+ * are over.
+ * @warning The reference counts of blitz arrays are not thread-safe (unless
+ * blitz is built with BZ_THREADSAFE): f should not create nor release
+ * references (e.g. slices) to arrays shared with other chunks. Such slices
+ * should be created beforehand (see getChunk()), and shared arrays only
+ * accessed through their elements.
+ */
+template <typename F>
+void parallelChunks(const int n, const size_t n_threads, const F& f)
+{
+  if (n <= 0) return;
+  const int n_chunks = getNChunks(n, n_threads);
+  if (n_chunks == 1) {
+    f(0, 0, n);
+    return;
+  }
+
+  std::vector<boost::exception_ptr> errors(n_chunks);
+  boost::thread_group threads;
+  for (int k=0; k<n_chunks; ++k) {
+    int start, count;
+    getChunk(n, n_chunks, k, start, count);
+    threads.create_thread(boost::bind(&detail::runChunk<F>, boost::cref(f),
+      k, start, count, boost::ref(errors[k])));
+  }
+  threads.join_all();
+
+  for (int k=0; k<n_chunks; ++k)
+    if (errors[k]) boost::rethrow_exception(errors[k]);
+}
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_CORE_PARALLEL_H */
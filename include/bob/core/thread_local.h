@@ -0,0 +1,77 @@
+/**
+ * @file bob/core/thread_local.h
+ * @date Fri Oct 16 18:04:12 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Per-thread scratch space, which allows const methods to use
+ * temporary buffers while remaining safe to call concurrently on a shared
+ * instance.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_CORE_THREAD_LOCAL_H
+#define BOB_CORE_THREAD_LOCAL_H
+
+#include <blitz/array.h>
+#include <boost/thread/tss.hpp>
+
+namespace bob { namespace core {
+/**
+ * @ingroup CORE
+ * @{
+ */
+
+/**
+ * @brief Returns the instance of T owned by the calling thread. It is
+ * default-constructed on first use, and destroyed when the thread exits.
+ * There is a single instance per type and thread: T should hence be a
+ * type private to the translation unit (e.g. declared in an anonymous
+ * namespace), and a function should not call another function using the
+ * same instance while it still needs its content.
+ */
+template <typename T> T& threadLocal()
+{
+  static boost::thread_specific_ptr<T> instance;
+  if (!instance.get()) instance.reset(new T());
+  return *instance;
+}
+
+/**
+ * @brief Resizes a scratch array, unless it already has the requested
+ * extent (in which case its content is left untouched).
+ */
+template <typename T>
+void ensureExtent(blitz::Array<T,1>& a, const int n0)
+{
+  if (a.extent(0) != n0) a.resize(n0);
+}
+
+/**
+ * @brief Resizes a scratch array, unless it already has the requested
+ * extents (in which case its content is left untouched).
+ */
+template <typename T>
+void ensureExtent(blitz::Array<T,2>& a, const int n0, const int n1)
+{
+  if (a.extent(0) != n0 || a.extent(1) != n1) a.resize(n0, n1);
+}
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_CORE_THREAD_LOCAL_H */
@@ -96,6 +96,16 @@ namespace io {
        */
       virtual void read(bob::core::array::interface& buffer, size_t index) =0;
 
+      /**
+       * Loads the data of the array at the given index like read(), but lets
+       * the buffer refer to the data held by the codec (e.g. a memory-mapped
+       * file) instead of copying it, if the codec supports it. The buffer
+       * then keeps that data alive, and should be treated as read-only.
+       *
+       * The default implementation just calls read().
+       */
+      virtual void refer(bob::core::array::interface& buffer, size_t index);
+
       /**
        * Loads all the data available at the file into a single in-memory
        * array.
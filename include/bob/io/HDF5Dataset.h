@@ -259,6 +259,50 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
           return readArray<T,N>(0);
         }
 
+      /**
+       * Reads count consecutive entries of a list, starting at position
+       * start, into an array with one more dimension than the entries: the
+       * first dimension indexes the entries. This is done with a single
+       * (hyperslab) read, which is much faster than reading the entries one
+       * by one. For lists of scalars, N is 1.
+       *
+       * @param start The position of the first entry to read
+       * @param value The output array, which extent along the first
+       * dimension sets the number of entries to read. This variable has to be
+       * a zero-based C-style contiguous storage array. If that is not the
+       * case, we will raise an exception.
+       */
+      template <typename T, int N>
+        void readArrayRange(size_t start, blitz::Array<T,N>& value) {
+          bob::core::array::assertCZeroBaseContiguous(value);
+          bob::io::HDF5Type dest_type(value);
+          if (N > 1) dest_type.shape() <<= 1; ///< contract shape
+          else dest_type.shape()[0] = 1; ///< scalar entries
+          read_range_buffer(start, value.extent(0), dest_type,
+              reinterpret_cast<void*>(value.data()));
+        }
+
+      /**
+       * Reads count consecutive entries of a list into an array allocated
+       * dynamically. The same conditions as for readArrayRange(start, value)
+       * apply.
+       */
+      template <typename T, int N>
+        blitz::Array<T,N> readArrayRange(size_t start, size_t count) {
+          const bob::io::HDF5Shape& S = m_descr[0].type.shape();
+          if ((N == 1 && S.n() == 1 && S[0] == 1) || (int)S.n() == N-1) {
+            blitz::TinyVector<int,N> shape;
+            shape(0) = count;
+            for (int k=1; k<N; ++k) shape(k) = S[k-1];
+            blitz::Array<T,N> retval(shape);
+            readArrayRange(start, retval);
+            return retval;
+          }
+          boost::format m("trying to read or write `%s' at `%s' that only accepts `%s'");
+          m % "unknown dynamic shape" % url() % m_descr[0].type.str();
+          throw std::runtime_error(m.str());
+        }
+
       /**
        * DATA WRITING FUNCTIONALITY
        */
@@ -377,6 +421,28 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
           }
       }
 
+      /**
+       * Appends value.extent(0) entries to a list, with a single (hyperslab)
+       * write: the first dimension of value indexes the entries. This is
+       * much faster than appending the entries one by one. For lists of
+       * scalars, N is 1. The same conditions as for addArray() apply.
+       */
+      template <typename T, int N>
+        void addArrayRange(const blitz::Array<T,N>& value) {
+          bob::io::HDF5Type dest_type(value);
+          if (N > 1) dest_type.shape() <<= 1; ///< contract shape
+          else dest_type.shape()[0] = 1; ///< scalar entries
+          if(!bob::core::array::isCZeroBaseContiguous(value)) {
+            blitz::Array<T,N> tmp = bob::core::array::ccopy(value);
+            extend_range_buffer(value.extent(0), dest_type,
+                reinterpret_cast<const void*>(tmp.data()));
+          }
+          else {
+            extend_range_buffer(value.extent(0), dest_type,
+                reinterpret_cast<const void*>(value.data()));
+          }
+      }
+
     private: //apis
 
       /**
@@ -392,10 +458,19 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
     public: //direct access for other bindings -- don't use these!
 
       /**
-       * Reads a previously selected area into the given (user) buffer.
+       * Reads the entry at the given index into the given (user) buffer. The
+       * file selection is private to the call, so concurrent reads are safe
+       * with a thread-safe HDF5 library.
        */
       void read_buffer (size_t index, const bob::io::HDF5Type& dest, void* buffer);
 
+      /**
+       * Reads count consecutive entries, starting at position start, into the
+       * given (user) buffer, using a single hyperslab selection.
+       */
+      void read_range_buffer (size_t start, size_t count,
+          const bob::io::HDF5Type& dest, void* buffer);
+
       /**
        * Writes the contents of a given buffer into the file. The area that the
        * data will occupy should have been selected beforehand.
@@ -408,6 +483,13 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        */
       void extend_buffer (const bob::io::HDF5Type& dest, const void* buffer);
 
+      /**
+       * Extend the dataset with count extra entries, which are laid out one
+       * after the other in the given buffer.
+       */
+      void extend_range_buffer (size_t count, const bob::io::HDF5Type& dest,
+          const void* buffer);
+
     public: //attribute support
 
       /**
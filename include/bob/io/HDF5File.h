@@ -56,15 +56,41 @@ namespace bob { namespace io {
 
       /**
        * Constructor, starts a new HDF5File object giving it a file name and an
-       * action: excl/trunc/in/inout
+       * action: excl/trunc/in/inout. Optionally, sets the size in bytes of
+       * the raw data chunk cache of each chunked dataset: the default (0)
+       * keeps the HDF5 default (1 MiB), enlarged for datasets which chunks
+       * do not fit in it.
        */
-      HDF5File (const std::string& filename, mode_t mode);
+      HDF5File (const std::string& filename, mode_t mode,
+          size_t cache_size=0);
 
       /**
        * Destructor virtualization
        */
       virtual ~HDF5File();
 
+      /**
+       * Returns the size in bytes of the raw data chunk cache of each chunked
+       * dataset, as set at construction.
+       */
+      size_t cacheSize() const { return m_file->cache_size(); }
+
+      /**
+       * Returns the approximate size in bytes of the chunks of the list
+       * datasets created from now on. See setChunkSize().
+       */
+      size_t chunkSize() const { return m_file->chunk_size(); }
+
+      /**
+       * Sets the approximate size in bytes of the chunks of the list datasets
+       * (and compressed arrays) created from now on. Each chunk then holds as
+       * many list entries as fit in this size (but at least one), which
+       * makes sequential reads and appends faster and files smaller. The
+       * default (0) stores each entry on its own chunk. Existing datasets
+       * keep their chunks.
+       */
+      void setChunkSize(size_t size) { m_file->set_chunk_size(size); }
+
       /**
        * Changes the current prefix path. When this object is started, it
        * points to the root of the file. If you set this to a different
@@ -221,6 +247,29 @@ namespace bob { namespace io {
         return (*m_cwd)[path]->readArray<T,N>(pos);
       }
 
+      /**
+       * Reads value.extent(0) consecutive entries of a list, starting at
+       * position start, into an array which first dimension indexes the
+       * entries. This is done with a single read. Raises an exception if the
+       * type is incompatible or the entries do not exist. Relative paths are
+       * accepted.
+       */
+      template <typename T, int N> void readArrayRange(const std::string& path,
+          size_t start, blitz::Array<T,N>& value) {
+        (*m_cwd)[path]->readArrayRange(start, value);
+      }
+
+      /**
+       * Reads count consecutive entries of a list, starting at position
+       * start. Destination array is allocated internally and returned by
+       * value. The same conditions as for readArrayRange(path, start, value)
+       * apply.
+       */
+      template <typename T, int N> blitz::Array<T,N> readArrayRange
+        (const std::string& path, size_t start, size_t count) {
+        return (*m_cwd)[path]->readArrayRange<T,N>(start, count);
+      }
+
       /**
        * Reads data from the file into a array. Raises an exception if the type
        * is incompatible. Relative paths are accepted. Calling this method is
@@ -326,6 +375,29 @@ namespace bob { namespace io {
         (*m_cwd)[path]->addArray(value);
       }
 
+      /**
+       * Appends value.extent(0) entries to a dataset, with a single write:
+       * the first dimension of value indexes the entries (for lists of
+       * scalars, N is 1). If the dataset does not yet exist, one is created
+       * with the type characteristics of an entry. Relative paths are
+       * accepted. The compression level is set as for appendArray().
+       */
+      template <typename T, int N> void appendArrayRange(const std::string& path,
+          const blitz::Array<T,N>& value, size_t compression=0) {
+        if (!m_file->writeable()) {
+          boost::format m("cannot append arrays to dataset '%s' at path '%s' of file '%s' because it is not writeable");
+          m % path % m_cwd->path() % m_file->filename();
+          throw std::runtime_error(m.str());
+        }
+        if (!contains(path)) {
+          bob::io::HDF5Type entry(value);
+          if (N > 1) entry.shape() <<= 1; ///< contract shape
+          else entry.shape()[0] = 1; ///< scalar entries
+          m_cwd->create_dataset(path, entry, true, compression);
+        }
+        (*m_cwd)[path]->addArrayRange(value);
+      }
+
       /**
        * Sets the scalar at position 0 to the given value. This method is
        * equivalent to checking if the scalar at position 0 exists and then
@@ -381,6 +453,27 @@ namespace bob { namespace io {
       void read_buffer (const std::string& path, size_t pos,
           const HDF5Type& type, void* buffer) const;
 
+      /**
+       * Reads count consecutive entries of a list into a buffer, which
+       * contains sufficient space to hold count times the type described in
+       * "dest". Raises an exception if the type is incompatible with the
+       * expected data in the file. Relative paths are accepted.
+       */
+      void read_range_buffer (const std::string& path, size_t start,
+          size_t count, const HDF5Type& type, void* buffer) const;
+
+      /**
+       * Returns the dataset at the given path. Relative paths are accepted.
+       * The groups on the way are opened (and listed) on first access, which
+       * changes the group hierarchy of this file: this is not thread-safe.
+       * Reading through the returned dataset, though, leaves the hierarchy
+       * untouched. Callers which serialize the accesses to this file with
+       * their own lock (e.g. the Python GIL) may therefore resolve the
+       * dataset with the lock held, and release it only around the read.
+       */
+      boost::shared_ptr<detail::hdf5::Dataset> dataset
+        (const std::string& path) const;
+
       /**
        * writes the contents of a given buffer into the file. the area that the
        * data will occupy should have been selected beforehand.
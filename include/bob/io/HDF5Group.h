@@ -48,8 +48,9 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       Group(boost::shared_ptr<Group> parent, const std::string& name);
 
       /**
-       * Binds to an existing group in a parent, reads all the group contents
-       * recursively. Note that the last parameter is there only to
+       * Binds to an existing group in a parent. Its contents are listed on
+       * first access, and each of its sub-groups and datasets is opened on
+       * first access as well. Note that the last parameter is there only to
        * differentiate from the above constructor. It is ignored.
        */
       Group(boost::shared_ptr<Group> parent,  const std::string& name,
@@ -61,9 +62,10 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       Group(boost::shared_ptr<File> parent);
 
       /**
-       * Recursively open sub-groups and datasets. This cannot be done at the
-       * constructor because of a enable_shared_from_this<> restriction that
-       * results in a bad weak pointer exception being raised.
+       * Recursively open sub-groups and datasets, which are otherwise opened
+       * on first access. This cannot be done at the constructor because of a
+       * enable_shared_from_this<> restriction that results in a bad weak
+       * pointer exception being raised.
        */
       void open_recursively();
 
@@ -136,12 +138,10 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       virtual const boost::shared_ptr<Group> cd(const std::string& path) const;
 
       /**
-       * Get a mapping of all child groups
+       * Get a mapping of all child groups (opens them if required)
        */
       virtual const std::map<std::string, boost::shared_ptr<Group> >& groups()
-        const {
-        return m_groups;
-      }
+        const;
 
       /**
        * Create a new subgroup with a given name.
@@ -180,12 +180,10 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       virtual bool has_group(const std::string& path) const;
 
       /**
-       * Get all datasets attached to this group
+       * Get all datasets attached to this group (opens them if required)
        */
       virtual const std::map<std::string, boost::shared_ptr<Dataset> >&
-        datasets() const {
-          return m_datasets;
-        }
+        datasets() const;
 
       /**
        * Creates a new HDF5 dataset from scratch and inserts it in this group.
@@ -248,8 +246,10 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        * container with T = std::string and accepting push_back()
        */
       template <typename T> void dataset_paths (T& container) const {
-        for (std::map<std::string, boost::shared_ptr<io::detail::hdf5::Dataset> >::const_iterator it=m_datasets.begin(); it != m_datasets.end(); ++it) container.push_back(it->second->path());
-        for (std::map<std::string, boost::shared_ptr<io::detail::hdf5::Group> >::const_iterator it=m_groups.begin(); it != m_groups.end(); ++it) it->second->dataset_paths(container);
+        Group* self = const_cast<Group*>(this);
+        self->load();
+        for (std::map<std::string, boost::shared_ptr<io::detail::hdf5::Dataset> >::const_iterator it=m_datasets.begin(); it != m_datasets.end(); ++it) container.push_back(path() + "/" + it->first);
+        for (std::map<std::string, boost::shared_ptr<io::detail::hdf5::Group> >::const_iterator it=m_groups.begin(); it != m_groups.end(); ++it) self->child_group(it->first)->dataset_paths(container);
       }
 
       /**
@@ -257,19 +257,21 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        * container with T = std::string and accepting push_back()
        */
       template <typename T> void subgroup_paths (T& container, bool recursive = true) const {
+        Group* self = const_cast<Group*>(this);
+        self->load();
         for (std::map<std::string, boost::shared_ptr<io::detail::hdf5::Group> >::const_iterator it=m_groups.begin(); it != m_groups.end(); ++it){
           container.push_back(it->first);
           if (recursive)
-            it->second->subgroup_paths(container);
+            self->child_group(it->first)->subgroup_paths(container);
         }
       }
 
       /**
        * Callback function for group iteration. Two cases are blessed here:
        *
-       * 1. Object is another group. In this case just instantiate the group and
-       *    recursively iterate from there
-       * 2. Object is a dataset. Instantiate it.
+       * 1. Object is another group. In this case just record its name: the
+       *    group is opened (and iterated) on first access
+       * 2. Object is a dataset. Record its name, it is opened on first access
        *
        * Only hard-links are considered. At the time being, no soft links.
        */
@@ -379,6 +381,22 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       void write_attribute (const std::string& name,
           const bob::io::HDF5Type& dest, const void* buffer);
 
+    private: //lazy loading
+
+      /**
+       * Lists the sub-groups and datasets of this group, if not done yet.
+       * Their names are recorded with empty pointers, filled in by
+       * child_group() and child_dataset() on first access.
+       */
+      void load();
+
+      /**
+       * Returns the named sub-group or dataset of this group, opening it if
+       * required. The child must exist.
+       */
+      boost::shared_ptr<Group> child_group(const std::string& name);
+      boost::shared_ptr<Dataset> child_dataset(const std::string& name);
+
     private: //not implemented
 
       /**
@@ -399,6 +417,7 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       boost::weak_ptr<Group> m_parent;
       std::map<std::string, boost::shared_ptr<Group> > m_groups;
       std::map<std::string, boost::shared_ptr<Dataset> > m_datasets;
+      bool m_loaded; ///< if the sub-groups and datasets have been listed
       //std::map<std::string, boost::shared_ptr<Attribute> > m_attributes;
 
   };
@@ -57,10 +57,12 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
 
       /**
        * Creates a new HDF5 file. Optionally set the userblock size (multiple
-       * of 2 number of bytes).
+       * of 2 number of bytes) and the size, in bytes, of the raw data chunk
+       * cache of each chunked dataset (0 keeps the HDF5 default, unless a
+       * single chunk does not fit in it).
        */
       File(const boost::filesystem::path& path, unsigned int flags,
-          size_t userblock_size=0);
+          size_t userblock_size=0, size_t cache_size=0);
 
       /**
        * Copies a file by creating a copy of each of its groups
@@ -128,6 +130,32 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        */
       bool writeable() const;
 
+      /**
+       * Returns the size, in bytes, of the raw data chunk cache of each
+       * chunked dataset, as set at construction (0 means HDF5's default).
+       */
+      size_t cache_size() const {
+        return m_cache_size;
+      }
+
+      /**
+       * Returns the approximate size, in bytes, of the chunks of the list
+       * datasets created from now on (0 means one list entry per chunk).
+       */
+      size_t chunk_size() const {
+        return m_chunk_size;
+      }
+
+      /**
+       * Sets the approximate size, in bytes, of the chunks of the list
+       * datasets created from now on. Chunks hold as many list entries as
+       * fit in this size, but at least one. 0 stores each entry on its own
+       * chunk (the default).
+       */
+      void set_chunk_size(size_t size) {
+        m_chunk_size = size;
+      }
+
     private: //representation
 
       const boost::filesystem::path m_path; ///< path to the file
@@ -135,6 +163,8 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       boost::shared_ptr<hid_t> m_fcpl; ///< file creation property lists
       boost::shared_ptr<hid_t> m_id; ///< the HDF5 id attributed to this file.
       boost::shared_ptr<RootGroup> m_root;
+      size_t m_cache_size; ///< raw data chunk cache size of datasets
+      size_t m_chunk_size; ///< chunk size of new list datasets
   };
 
 }}}}
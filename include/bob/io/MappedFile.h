@@ -0,0 +1,106 @@
+/**
+ * @file bob/io/MappedFile.h
+ * @date Fri Oct 16 21:07:45 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief A shared, read-only memory mapping of a whole file, which lets
+ * binary codecs read samples without any stream, and refer to the mapped
+ * data instead of copying it.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IO_MAPPEDFILE_H
+#define BOB_IO_MAPPEDFILE_H
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <bob/core/array.h>
+
+namespace bob { namespace io { namespace detail {
+
+  /**
+   * A private (copy-on-write) memory mapping of a whole file. Mappings are
+   * shared: opening a file that is already mapped, and was not modified
+   * since, returns the existing mapping, so all the threads (and File
+   * objects) reading a file use the same pages. Reading from a mapping does
+   * not change its state, and is therefore thread-safe.
+   *
+   * The data is mapped copy-on-write: modifying it never changes the file,
+   * but is seen by all the users of the mapping.
+   */
+  class MappedFile: public boost::enable_shared_from_this<MappedFile> {
+
+    public: //api
+
+      /**
+       * Returns the (shared) mapping of a given file. Raises if the file
+       * cannot be mapped.
+       */
+      static boost::shared_ptr<MappedFile> open(const std::string& path);
+
+      /**
+       * Unmaps the file
+       */
+      virtual ~MappedFile();
+
+      /**
+       * The name of the mapped file
+       */
+      const std::string& filename() const { return m_filename; }
+
+      /**
+       * The size of the mapped file, in bytes
+       */
+      size_t size() const { return m_size; }
+
+      /**
+       * The mapped data (0 if the file is empty)
+       */
+      char* data() const { return m_data; }
+
+      /**
+       * Tells if an array of the given type, at the given offset, may be
+       * referred to directly: it has to lie inside the file, and its first
+       * element has to be aligned on the size of its elements.
+       */
+      bool can_refer(size_t offset, const bob::core::array::typeinfo& info)
+        const;
+
+      /**
+       * Returns an array interface referring to the mapped data at the
+       * given offset, with the given type. The interface (and any buffer set
+       * to refer to it) keeps the mapping alive. Check can_refer() first.
+       */
+      boost::shared_ptr<bob::core::array::interface> refer(size_t offset,
+          const bob::core::array::typeinfo& info);
+
+    private: //representation
+
+      MappedFile(const std::string& path);
+
+      std::string m_filename; ///< the mapped file
+      boost::iostreams::mapped_file m_file; ///< the mapping
+      size_t m_size; ///< the size of the file, in bytes
+      char* m_data; ///< the mapped data
+      std::string m_key; ///< identifies this mapping in the cache
+
+  };
+
+}}}
+
+#endif /* BOB_IO_MAPPEDFILE_H */
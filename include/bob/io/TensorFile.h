@@ -28,6 +28,7 @@
 
 #include <bob/core/blitz_array.h>
 #include <bob/io/TensorFileHeader.h>
+#include <bob/io/MappedFile.h>
 
 namespace bob { namespace io {
 
@@ -105,6 +106,15 @@ namespace bob { namespace io {
        */
       void read (size_t index, bob::core::array::interface& data);
 
+      /**
+       * Reads the array at the given position like read(index, data), but
+       * lets the bob::core::array::interface refer to the memory-mapped file
+       * if possible (i.e. if the file is opened read-only, and the data is
+       * aligned and stored the same way in row- and column-major order).
+       * Otherwise, the data is copied.
+       */
+      void refer (size_t index, bob::core::array::interface& data);
+
       /**
        * Peeks the file and returns the currently set typeinfo
        */
@@ -175,6 +185,12 @@ namespace bob { namespace io {
        */
       void initHeader(const bob::core::array::typeinfo& info);
 
+      /**
+       * Tells if the array at the given index can be read from the mapping
+       * of the file
+       */
+      bool mapped(size_t index) const;
+
     public:
 
       /********************************************************************
@@ -223,6 +239,7 @@ namespace bob { namespace io {
       detail::TensorFileHeader m_header;
       openmode m_openmode;
       boost::shared_ptr<void> m_buffer;
+      boost::shared_ptr<detail::MappedFile> m_mapping; ///< read-only files
   };
 
   inline _TensorFileFlag operator&(_TensorFileFlag a, _TensorFileFlag b) {
@@ -145,6 +145,34 @@ namespace bob { namespace io {
       inline const bob::core::array::typeinfo& frame_type() const 
       { return m_typeinfo_frame; }
 
+      /**
+       * Sets the number of threads FFmpeg may use to decode the frames, for
+       * the iterators created from now on (frame and/or slice threading,
+       * depending on what the codec supports). The default (1) decodes on
+       * the calling thread; 0 uses as many threads as there are cores.
+       */
+      inline void setDecoderThreads(size_t n_threads)
+      { m_decoder_threads = n_threads; }
+
+      /**
+       * Returns the number of threads FFmpeg may use to decode the frames
+       */
+      inline size_t decoderThreads() const { return m_decoder_threads; }
+
+      /**
+       * Sets the number of frames the iterators created from now on (and
+       * hence load()) decode ahead of the reader, on a background thread.
+       * The default (0) decodes each frame when it is read. When set, the
+       * error reporting behavior of the first call to read() applies to the
+       * whole readout.
+       */
+      inline void setPrefetch(size_t frames) { m_prefetch = frames; }
+
+      /**
+       * Returns the number of frames decoded ahead of the reader
+       */
+      inline size_t prefetch() const { return m_prefetch; }
+
       /**
        * Loads all of the video stream in a blitz array organized in this way:
        * (frames, color-bands, height, width). The 'data' parameter will be
@@ -234,10 +262,11 @@ namespace bob { namespace io {
           //const_iterator operator++ (int); //too inefficient!
 
           /**
-           * Fast-forward the video readout by N frames, return self. This
-           * implementation is slow because of ffmpeg limitations. It has no
-           * precise frame lookup function. What we have to do is to read
-           * frame-by-frame and stop when you want to.
+           * Fast-forward the video readout by N frames, return self. Long
+           * jumps seek the last keyframe before the requested frame (based on
+           * its timestamp) and only decode the frames in between. Short
+           * jumps, or streams that cannot be seeked this way, are read
+           * frame-by-frame.
            */
           const_iterator& operator+= (size_t frames);
 
@@ -336,6 +365,19 @@ namespace bob { namespace io {
            */
           void init();
 
+          /**
+           * Positions the iterator on the given frame using a keyframe seek.
+           * Returns false if the stream was not seeked, in which case the
+           * frames should be skipped from the current position (which may
+           * have been rewound to the first frame).
+           */
+          bool seek(size_t frame);
+
+          /**
+           * Decodes frames ahead of the iterator, on a background thread
+           */
+          class prefetcher;
+
         private: //representation
           const VideoReader* m_parent; ///< who generated me
           boost::shared_ptr<AVFormatContext> m_format_context; ///< format context
@@ -347,6 +389,7 @@ namespace bob { namespace io {
           blitz::Array<uint8_t,3> m_rgb_array; ///< temporary
           boost::shared_ptr<SwsContext> m_swscaler; ///< software scaler
           size_t m_current_frame; ///< the current frame to be read
+          boost::shared_ptr<prefetcher> m_prefetcher; ///< decode-ahead
 
         public: //friendship
 
@@ -368,6 +411,8 @@ namespace bob { namespace io {
 
       std::string m_filepath; ///< the name of the file we are manipulating
       bool m_check; ///< shall I check for compatibility when opening?
+      size_t m_decoder_threads; ///< threads used by the decoder
+      size_t m_prefetch; ///< frames decoded ahead of the reader
       size_t m_height; ///< the height of the video frames (number of rows)
       size_t m_width; ///< the width of the video frames (number of columns)
       size_t m_nframes; ///< the number of frames in this video file
@@ -113,7 +113,9 @@ namespace bob { namespace io { namespace detail { namespace ffmpeg {
    ************************************************************************/
 
   /**
-   * Creates a new codec context and verify all is good.
+   * Creates a new codec context and verify all is good. If n_threads is
+   * larger than 1, the codec is allowed to use that many threads (frame
+   * and/or slice threading, depending on what it supports).
    *
    * @note The returned object knows how to correctly delete itself, freeing
    * all acquired resources. Nonetheless, when this object is used in
@@ -121,7 +123,8 @@ namespace bob { namespace io { namespace detail { namespace ffmpeg {
    * respected.
    */
   boost::shared_ptr<AVCodecContext> make_codec_context(
-      const std::string& filename, AVStream* stream, AVCodec* codec);
+      const std::string& filename, AVStream* stream, AVCodec* codec,
+      size_t n_threads=1);
 
   /**
    * Allocates the software scaler that handles size and pixel format
@@ -214,6 +217,24 @@ namespace bob { namespace io { namespace detail { namespace ffmpeg {
       boost::shared_ptr<AVCodecContext> codec_context,
       boost::shared_ptr<AVFrame> context_frame, bool throw_on_error);
 
+  /**
+   * Positions the stream so that the next frame to be read is 'frame'. It
+   * seeks the last keyframe at or before the timestamp of that frame
+   * (assuming a constant frame rate) and skips the frames in between, which
+   * is much faster than skipping all the frames from the current position
+   * for long jumps.
+   *
+   * @return false, leaving the stream untouched, if the stream has no usable
+   * frame rate or cannot be seeked. If the stream was seeked but the frame
+   * reached cannot be determined (e.g. missing timestamps), an exception is
+   * raised and the decoding state is undefined: the stream should then be
+   * re-opened.
+   */
+  bool seek_video_frame (const std::string& filename, size_t frame,
+      int stream_index, boost::shared_ptr<AVFormatContext> format_context,
+      boost::shared_ptr<AVCodecContext> codec_context,
+      boost::shared_ptr<AVFrame> context_frame);
+
   /************************************************************************
    * Video writing specific utilities
    ************************************************************************/
@@ -58,11 +58,17 @@ namespace bob { namespace io {
        * and codec are known to work and have been tested, otherwise an
        * exception is raised. If you set 'check' to 'false', though, we will
        * ignore this check.
+       * @param encoder_threads The number of threads FFmpeg may use to encode
+       * the frames (0 uses as many threads as there are cores)
+       * @param queue_size If larger than 0, append() copies the frames into a
+       * queue of that many frames, which are encoded on a background thread.
+       * append() only blocks when the queue is full. Errors raised while
+       * encoding are reported by the next call to append() or close().
        */
       VideoWriter(const std::string& filename, size_t height, size_t width,
           double framerate=25., double bitrate=1500000., size_t gop=12,
           const std::string& codec="", const std::string& format="",
-          bool check=true);
+          bool check=true, size_t encoder_threads=1, size_t queue_size=0);
 
       /**
        * Destructor virtualization
@@ -71,7 +77,8 @@ namespace bob { namespace io {
 
       /**
        * Closes the current video stream and forces writing the trailer. After
-       * this point the video becomes invalid.
+       * this point the video becomes invalid. Queued frames are encoded
+       * before the stream is closed.
        */
       void close();
 
@@ -113,7 +120,13 @@ namespace bob { namespace io {
       }
 
       /**
-       * Returns the current number of frames written
+       * Returns the size of the queue of frames to be encoded (0 if frames
+       * are encoded by append())
+       */
+      inline size_t queueSize() const { return m_queue_size; }
+
+      /**
+       * Returns the current number of frames written (or queued)
        */
       inline size_t numberOfFrames() const { return m_current_frame; }
 
@@ -190,6 +203,23 @@ namespace bob { namespace io {
 
       VideoWriter& operator= (const VideoWriter& other);
 
+    private: //methods
+
+      /**
+       * Encodes (or queues) a single frame
+       */
+      void write(const blitz::Array<uint8_t,3>& data);
+
+      /**
+       * Encodes a single frame
+       */
+      void encode(const blitz::Array<uint8_t,3>& data);
+
+      /**
+       * Encodes the queued frames on a background thread
+       */
+      class encoder;
+
     private: //representation
       
       std::string m_filename; ///< file being written
@@ -212,6 +242,8 @@ namespace bob { namespace io {
       bob::core::array::typeinfo m_typeinfo_video;
       bob::core::array::typeinfo m_typeinfo_frame;
       size_t m_current_frame;
+      size_t m_queue_size;
+      boost::shared_ptr<encoder> m_encoder; ///< asynchronous encoding
 
   };
 
@@ -23,7 +23,7 @@
 
 #include <bob/core/cast.h>
 #include <bob/core/array_copy.h>
-#include <bob/sp/DCT2D.h>
+#include <bob/sp/batch.h>
 #include <bob/ip/block.h>
 #include <bob/ip/zigzag.h>
 #include <list>
@@ -80,7 +80,6 @@ class DCTFeatures
       const size_t overlap_h, const size_t overlap_w,
       const size_t n_dct_coefs, const bool norm_block=false,
       const bool norm_dct=false, const bool square_pattern=false):
-        m_dct2d(block_h, block_w),
         m_block_h(block_h), m_block_w(block_w), m_overlap_h(overlap_h),
         m_overlap_w(overlap_w), m_n_dct_coefs(n_dct_coefs),
         m_norm_block(norm_block), m_norm_dct(norm_dct),
@@ -95,7 +94,6 @@ class DCTFeatures
       * @brief Copy constructor
       */
     DCTFeatures(const DCTFeatures& other):
-      m_dct2d(other.m_dct2d),
       m_block_h(other.m_block_h), m_block_w(other.m_block_w),
       m_overlap_h(other.m_overlap_h), m_overlap_w(other.m_overlap_w),
       m_n_dct_coefs(other.m_n_dct_coefs),
@@ -143,11 +141,9 @@ class DCTFeatures
       * @brief Setters
       */
     void setBlockH(const size_t block_h)
-    { m_block_h = block_h; m_dct2d.setHeight(block_h);
-      resetCacheBlock(); }
+    { m_block_h = block_h; }
     void setBlockW(const size_t block_w)
-    { m_block_w = block_w; m_dct2d.setWidth(block_w);
-      resetCacheBlock(); }
+    { m_block_w = block_w; }
     void setOverlapH(const size_t overlap_h)
     { m_overlap_h = overlap_h; }
     void setOverlapW(const size_t overlap_w)
@@ -213,7 +209,6 @@ class DCTFeatures
     /**
       * Attributes
       */
-    bob::sp::DCT2D m_dct2d;
     size_t m_block_h;
     size_t m_block_w;
     size_t m_overlap_h;
@@ -226,18 +221,20 @@ class DCTFeatures
     double m_norm_epsilon;
 
     void setCheckSqrtNDctCoefs();
-    void normalizeBlock(const blitz::Array<double,2>& src) const;
-    void extractRowDCTCoefs(blitz::Array<double,1>& coefs) const;
+    void normalizeBlock(const blitz::Array<double,2>& src,
+      blitz::Array<double,2>& dst) const;
+    void extractRowDCTCoefs(const blitz::Array<double,2>& dct_block,
+      blitz::Array<double,1>& coefs) const;
+    void dctBlocks(const std::list<blitz::Array<double,2> >& blocks) const;
 
     /**
       * Working arrays/variables in cache
       */
     void resetCache() const;
-    void resetCacheBlock() const;
     void resetCacheDct() const;
 
-    mutable blitz::Array<double,2> m_cache_block1;
-    mutable blitz::Array<double,2> m_cache_block2;
+    mutable blitz::Array<double,3> m_cache_blocks;
+    mutable blitz::Array<double,3> m_cache_dct_blocks;
     mutable blitz::Array<double,1> m_cache_dct_full;
     mutable blitz::Array<double,1> m_cache_dct1;
     mutable blitz::Array<double,1> m_cache_dct2;
@@ -205,11 +205,54 @@ namespace bob { namespace ip {
       uint16_t right_shift_circular(uint16_t pattern, int shift);
 
       /**
-       * Extract the LBP code of a 2D blitz::Array at the given location, and return it.
-       * Checks are disabled in this function.
+       * The sampling of the neighbors for a given source image layout
+       */
+      struct Sampling {
+        // offsets (in elements) of the four interpolation points
+        // (y_low/x_low, y_low/x_high, y_high/x_low, y_high/x_high) of each
+        // neighbor, relative to the central pixel
+        int offsets[16][4];
+        // relative positions (y,x) of the neighbors
+        double positions[16][2];
+        // relative integral positions (y_high, x_high) of the neighbors
+        int high[16][2];
+      };
+
+      /**
+       * Computes the sampling of the neighbors for the given strides of the
+       * source image
+       */
+      void getSampling(const int stride_y, const int stride_x, Sampling& sampling) const;
+
+      /**
+       * Samples the P neighbors of the pixel (y,x) pointed by center into
+       * pixels. Checks are disabled in this function.
        */
       template <typename T>
-        uint16_t lbp_code(const blitz::Array<T,2>& src, int y, int x) const;
+        void sample(const T* center, const int y, const int x, const Sampling& sampling, double* pixels) const;
+
+      /**
+       * Computes the raw LBP code (i.e., before applying the look up table)
+       * from the sampled neighbors and the central pixel value.
+       */
+      template <bob::ip::ELBPType E>
+        uint16_t lbp_code(const double* pixels, const double center) const;
+
+      /**
+       * Extract the LBP codes of all pixels of the dst image, using the
+       * generic sampling of the neighbors
+       */
+      template <bob::ip::ELBPType E, typename T>
+        void lbp_image(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst) const;
+
+      /**
+       * Extract the LBP codes of all pixels of the dst image, for
+       * rectangular, regular LBP codes with P neighbors compared to the
+       * central pixel. No interpolation is required and the comparison is
+       * done in the pixel type.
+       */
+      template <int P, typename T>
+        void lbp_image_rectangular(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst) const;
 
       /**
        * Attributes
@@ -229,6 +272,10 @@ namespace bob { namespace ip {
 
       // the positions of the points that have to be processed
       blitz::Array<double, 2> m_positions;
+
+      // the integral positions (y_low, x_low, y_high, x_high) of the
+      // interpolation points of each neighbor
+      blitz::Array<int, 2> m_int_positions;
   };
 
   ///////////////////////////////////////////////////
@@ -244,6 +291,27 @@ namespace bob { namespace ip {
     }
 
 
+  namespace detail {
+    /**
+     * Compares a neighbor to the reference value. Floating point values
+     * which are close are considered to be equal; the integral pixel types
+     * are compared exactly.
+     */
+    template <typename T>
+      inline bool lbpGreaterEqual(const T& value, const T& reference){
+        return value > reference || bob::core::isClose(static_cast<double>(value), static_cast<double>(reference));
+      }
+
+    inline bool lbpGreaterEqual(const uint8_t& value, const uint8_t& reference){
+      return value >= reference;
+    }
+
+    inline bool lbpGreaterEqual(const uint16_t& value, const uint16_t& reference){
+      return value >= reference;
+    }
+  }
+
+
   template <typename T>
     inline void LBP::operator()(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst) const
     {
@@ -251,12 +319,20 @@ namespace bob { namespace ip {
       bob::core::array::assertZeroBase(dst);
       bob::core::array::assertSameShape(dst, getLBPShape(src) );
 
-      // offset in the source image
-      const int r_y = (int)ceil(m_R_y), r_x = (int)ceil(m_R_x);
-      // iterate over target pixels
-      for (int y = 0; y < dst.extent(0); ++y)
-        for (int x = 0; x < dst.extent(1); ++x)
-          dst(y, x) = lbp_code(src, y + r_y, x + r_x);
+      // fast path: rectangular LBP codes compared to the central pixel do
+      // not need to interpolate nor to convert the pixels
+      if (!m_circular && m_eLBP_type == ELBP_REGULAR && !m_to_average && !m_add_average_bit){
+        switch (m_P){
+          case 4: lbp_image_rectangular<4>(src, dst); return;
+          case 8: lbp_image_rectangular<8>(src, dst); return;
+        }
+      }
+
+      switch (m_eLBP_type){
+        case ELBP_REGULAR: lbp_image<ELBP_REGULAR>(src, dst); break;
+        case ELBP_TRANSITIONAL: lbp_image<ELBP_TRANSITIONAL>(src, dst); break;
+        case ELBP_DIRECTION_CODED: lbp_image<ELBP_DIRECTION_CODED>(src, dst); break;
+      }
     }
 
 
@@ -276,30 +352,53 @@ namespace bob { namespace ip {
       m % x % r_x % (src.extent(1)-r_x-1);
       throw std::runtime_error(m.str());
     }
+
+    Sampling sampling;
+    getSampling(src.stride(0), src.stride(1), sampling);
+    double pixels[16];
+    const T* center = src.data() + y * src.stride(0) + x * src.stride(1);
+    sample(center, y, x, sampling, pixels);
+
     // return LBP code
-    return lbp_code(src, y, x);
+    uint16_t code = 0;
+    switch (m_eLBP_type){
+      case ELBP_REGULAR: code = lbp_code<ELBP_REGULAR>(pixels, static_cast<double>(*center)); break;
+      case ELBP_TRANSITIONAL: code = lbp_code<ELBP_TRANSITIONAL>(pixels, static_cast<double>(*center)); break;
+      case ELBP_DIRECTION_CODED: code = lbp_code<ELBP_DIRECTION_CODED>(pixels, static_cast<double>(*center)); break;
+    }
+    return m_lut(code);
   }
 
 
   template <typename T>
-  inline uint16_t LBP::lbp_code(const blitz::Array<T,2>& src, int y, int x) const{
-    std::vector<double> pixels(m_P);
-    if (m_circular)
-      for (int p = 0; p < m_P; ++p)
-        pixels[p] = bob::sp::detail::bilinearInterpolationNoCheck(src, y + m_positions(p,0), x + m_positions(p,1));
-    else
+  inline void LBP::sample(const T* center, const int y, const int x, const Sampling& sampling, double* pixels) const{
+    if (m_circular){
       for (int p = 0; p < m_P; ++p){
-        pixels[p] = static_cast<double>(src(y + static_cast<int>(m_positions(p,0)), x + static_cast<int>(m_positions(p,1))));
+        // bilinear interpolation with precomputed interpolation points; the
+        // weights are computed as in bob::sp::detail::bilinearInterpolationNoCheck
+        const int* offsets = sampling.offsets[p];
+        const double w_y = (y + sampling.high[p][0]) - (y + sampling.positions[p][0]);
+        const double w_x = (x + sampling.high[p][1]) - (x + sampling.positions[p][1]);
+        const double low = w_x * center[offsets[0]] + (1. - w_x) * center[offsets[1]];
+        const double high = w_x * center[offsets[2]] + (1. - w_x) * center[offsets[3]];
+        pixels[p] = w_y * low + (1. - w_y) * high;
       }
+    }else{
+      for (int p = 0; p < m_P; ++p)
+        pixels[p] = static_cast<double>(center[sampling.offsets[p][0]]);
+    }
+  }
 
-    double center = static_cast<double>(src(y, x));
+
+  template <bob::ip::ELBPType E>
+  inline uint16_t LBP::lbp_code(const double* pixels, const double center) const{
     double cmp_point = center;
     if (m_to_average)
-      cmp_point = std::accumulate(pixels.begin(), pixels.end(), center) / (m_P + 1); // /(P+1) since (averaged over P+1 points)
+      cmp_point = std::accumulate(pixels, pixels + m_P, center) / (m_P + 1); // /(P+1) since (averaged over P+1 points)
 
     // the formulas are implemented from Cosmin's thesis
     uint16_t lbp_code = 0;
-    switch (m_eLBP_type){
+    switch (E){
       case ELBP_REGULAR:{
         for (int p = 0; p < m_P; ++p){
           lbp_code <<= 1;
@@ -315,8 +414,9 @@ namespace bob { namespace ip {
 
       case ELBP_TRANSITIONAL:{
         for (int p = 0; p < m_P; ++p){
+          const double next = pixels[p+1 < m_P ? p+1 : 0];
           lbp_code <<= 1;
-          if (pixels[p] > pixels[(p+1)%m_P] || bob::core::isClose(pixels[p], pixels[(p+1)%m_P])) ++lbp_code;
+          if (pixels[p] > next || bob::core::isClose(pixels[p], next)) ++lbp_code;
         }
         break;
       }
@@ -333,8 +433,51 @@ namespace bob { namespace ip {
       }
     }
 
-    // convert the lbp code according to the requested setup (uniform, rotation invariant, ...)
-    return m_lut(lbp_code);
+    return lbp_code;
+  }
+
+
+  template <bob::ip::ELBPType E, typename T>
+  inline void LBP::lbp_image(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst) const{
+    // offset in the source image
+    const int r_y = (int)ceil(m_R_y), r_x = (int)ceil(m_R_x);
+    const int s_y = src.stride(0), s_x = src.stride(1);
+    Sampling sampling;
+    getSampling(s_y, s_x, sampling);
+    double pixels[16];
+    // iterate over target pixels
+    for (int y = 0; y < dst.extent(0); ++y){
+      const T* center = src.data() + (y + r_y) * s_y + r_x * s_x;
+      for (int x = 0; x < dst.extent(1); ++x, center += s_x){
+        sample(center, y + r_y, x + r_x, sampling, pixels);
+        // convert the lbp code according to the requested setup (uniform, rotation invariant, ...)
+        dst(y, x) = m_lut(lbp_code<E>(pixels, static_cast<double>(*center)));
+      }
+    }
+  }
+
+
+  template <int P, typename T>
+  inline void LBP::lbp_image_rectangular(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst) const{
+    // offset in the source image
+    const int r_y = (int)ceil(m_R_y), r_x = (int)ceil(m_R_x);
+    const int s_y = src.stride(0), s_x = src.stride(1);
+    Sampling sampling;
+    getSampling(s_y, s_x, sampling);
+    int offset[P];
+    for (int p = 0; p < P; ++p) offset[p] = sampling.offsets[p][0];
+    // iterate over target pixels
+    for (int y = 0; y < dst.extent(0); ++y){
+      const T* center = src.data() + (y + r_y) * s_y + r_x * s_x;
+      for (int x = 0; x < dst.extent(1); ++x, center += s_x){
+        const T c = *center;
+        // branch-free code generation; the loop is unrolled since P is constant
+        uint16_t code = 0;
+        for (int p = 0; p < P; ++p)
+          code = (code << 1) | static_cast<uint16_t>(detail::lbpGreaterEqual(center[offset[p]], c));
+        dst(y, x) = m_lut(code);
+      }
+    }
   }
 
 } }
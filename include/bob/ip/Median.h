@@ -23,9 +23,9 @@
 #ifndef BOB_IP_MEDIAN_H
 #define BOB_IP_MEDIAN_H
 
-#include <stdexcept>
-#include <boost/shared_ptr.hpp>
-#include <list>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
 #include "bob/core/assert.h"
 #include "bob/core/cast.h"
 
@@ -39,45 +39,189 @@ namespace bob {
   namespace ip {
 
     namespace detail {
+      /**
+       * @brief Compare-exchange element of the sorting networks below
+       */
       template <typename T>
-      struct Pixel {
-        int y;
-        int x;
-        T value;
-        Pixel(): y(0), x(0), value(0) {}
-        Pixel(int b, int a, T v): y(b), x(a), value(v) {}
-      };
+      inline void medianSort(T& a, T& b)
+      {
+        const T x = a, y = b;
+        a = std::min(x, y);
+        b = std::max(x, y);
+      }
+
+      inline void medianSort(int& a, int& b)
+      {
+        // this form is compiled to conditional moves for integers
+        const int x = a, y = b;
+        const bool swap = y < x;
+        a = swap ? y : x;
+        b = swap ? x : y;
+      }
 
+      /**
+       * @brief Returns the median of the 9 values of p (modified in place),
+       * using the selection network of Paeth ("Graphics Gems", 1990)
+       */
       template <typename T>
-      void listInsertPixel(const boost::shared_ptr<Pixel<T> > p,
-                           std::list<boost::shared_ptr<Pixel<T> > >& l)
+      inline T median9(T* p)
       {
-        typename std::list<boost::shared_ptr<Pixel<T> > >::iterator it=l.begin();
-        for( ; it!=l.end(); ++it)
-          if( p->value > (*it)->value) break;
-        l.insert(it, p);
+        medianSort(p[1], p[2]); medianSort(p[4], p[5]); medianSort(p[7], p[8]);
+        medianSort(p[0], p[1]); medianSort(p[3], p[4]); medianSort(p[6], p[7]);
+        medianSort(p[1], p[2]); medianSort(p[4], p[5]); medianSort(p[7], p[8]);
+        medianSort(p[0], p[3]); medianSort(p[5], p[8]); medianSort(p[4], p[7]);
+        medianSort(p[3], p[6]); medianSort(p[1], p[4]); medianSort(p[2], p[5]);
+        medianSort(p[4], p[7]); medianSort(p[4], p[2]); medianSort(p[6], p[4]);
+        medianSort(p[4], p[2]);
+        return p[4];
       }
 
+      /**
+       * @brief Returns the median of the 25 values of p (modified in place),
+       * using the selection network of N. Devillard ("Fast median search:
+       * an ANSI C implementation", 1998)
+       */
       template <typename T>
-      T listGetValueAtPosition(const int pos,
-        const std::list<boost::shared_ptr<Pixel<T> > >& l)
+      inline T median25(T* p)
       {
-        typename std::list<boost::shared_ptr<Pixel<T> > >::const_iterator it=l.begin();
-        int c=0;
-        for( ; it!=l.end(); ++it, ++c)
-          if( c==pos) return (*it)->value;
-        throw std::runtime_error("reached the end of method w/o returning");
+        medianSort(p[0], p[1]);   medianSort(p[3], p[4]);   medianSort(p[2], p[4]);
+        medianSort(p[2], p[3]);   medianSort(p[6], p[7]);   medianSort(p[5], p[7]);
+        medianSort(p[5], p[6]);   medianSort(p[9], p[10]);  medianSort(p[8], p[10]);
+        medianSort(p[8], p[9]);   medianSort(p[12], p[13]); medianSort(p[11], p[13]);
+        medianSort(p[11], p[12]); medianSort(p[15], p[16]); medianSort(p[14], p[16]);
+        medianSort(p[14], p[15]); medianSort(p[18], p[19]); medianSort(p[17], p[19]);
+        medianSort(p[17], p[18]); medianSort(p[21], p[22]); medianSort(p[20], p[22]);
+        medianSort(p[20], p[21]); medianSort(p[23], p[24]); medianSort(p[2], p[5]);
+        medianSort(p[3], p[6]);   medianSort(p[0], p[6]);   medianSort(p[0], p[3]);
+        medianSort(p[4], p[7]);   medianSort(p[1], p[7]);   medianSort(p[1], p[4]);
+        medianSort(p[11], p[14]); medianSort(p[8], p[14]);  medianSort(p[8], p[11]);
+        medianSort(p[12], p[15]); medianSort(p[9], p[15]);  medianSort(p[9], p[12]);
+        medianSort(p[13], p[16]); medianSort(p[10], p[16]); medianSort(p[10], p[13]);
+        medianSort(p[20], p[23]); medianSort(p[17], p[23]); medianSort(p[17], p[20]);
+        medianSort(p[21], p[24]); medianSort(p[18], p[24]); medianSort(p[18], p[21]);
+        medianSort(p[19], p[22]); medianSort(p[8], p[17]);  medianSort(p[9], p[18]);
+        medianSort(p[0], p[18]);  medianSort(p[0], p[9]);   medianSort(p[10], p[19]);
+        medianSort(p[1], p[19]);  medianSort(p[1], p[10]);  medianSort(p[11], p[20]);
+        medianSort(p[2], p[20]);  medianSort(p[2], p[11]);  medianSort(p[12], p[21]);
+        medianSort(p[3], p[21]);  medianSort(p[3], p[12]);  medianSort(p[13], p[22]);
+        medianSort(p[4], p[22]);  medianSort(p[4], p[13]);  medianSort(p[14], p[23]);
+        medianSort(p[5], p[23]);  medianSort(p[5], p[14]);  medianSort(p[15], p[24]);
+        medianSort(p[6], p[24]);  medianSort(p[6], p[15]);  medianSort(p[7], p[16]);
+        medianSort(p[7], p[19]);  medianSort(p[13], p[21]); medianSort(p[15], p[23]);
+        medianSort(p[7], p[13]);  medianSort(p[7], p[15]);  medianSort(p[1], p[9]);
+        medianSort(p[3], p[11]);  medianSort(p[5], p[17]);  medianSort(p[11], p[17]);
+        medianSort(p[9], p[17]);  medianSort(p[4], p[10]);  medianSort(p[6], p[12]);
+        medianSort(p[7], p[14]);  medianSort(p[4], p[6]);   medianSort(p[4], p[7]);
+        medianSort(p[12], p[14]); medianSort(p[10], p[14]); medianSort(p[6], p[7]);
+        medianSort(p[10], p[12]); medianSort(p[6], p[10]);  medianSort(p[6], p[17]);
+        medianSort(p[12], p[17]); medianSort(p[7], p[17]);  medianSort(p[7], p[10]);
+        medianSort(p[12], p[18]); medianSort(p[7], p[12]);  medianSort(p[10], p[18]);
+        medianSort(p[12], p[20]); medianSort(p[10], p[20]); medianSort(p[10], p[12]);
+        return p[12];
       }
 
+      /**
+       * @brief Type in which the selection networks are evaluated: small
+       * integral types are promoted to int, for which compilers generate
+       * branch-free min/max instructions
+       */
+      template <typename T> struct MedianNetworkType { typedef T type; };
+      template <> struct MedianNetworkType<uint8_t> { typedef int type; };
+      template <> struct MedianNetworkType<uint16_t> { typedef int type; };
+      template <> struct MedianNetworkType<int8_t> { typedef int type; };
+      template <> struct MedianNetworkType<int16_t> { typedef int type; };
+
+      template <typename T>
+      inline T medianWindow(T (&p)[9]) { return median9(p); }
+
       template <typename T>
-      void printList(const std::list<boost::shared_ptr<Pixel<T> > >& l)
+      inline T medianWindow(T (&p)[25]) { return median25(p); }
+
+      /**
+       * @brief Median filter for 3x3 and 5x5 kernels, based on the
+       * selection networks above
+       */
+      template <typename T, int N>
+      void medianNetwork(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst)
       {
-        typename std::list<boost::shared_ptr<Pixel<T> > >::const_iterator it=l.begin();
-        for( ; it!=l.end(); ++it)
-        {
-          std::cout << "(" << (*it)->y << "," << (*it)->x << "," << (*it)->value << ") - ";
-        }
-        std::cout << std::endl;
+        typename MedianNetworkType<T>::type window[N*N];
+        const int s_y = src.stride(0), s_x = src.stride(1);
+        for (int j=0; j<dst.extent(0); ++j)
+          for (int i=0; i<dst.extent(1); ++i)
+          {
+            const T* corner = src.data() + j*s_y + i*s_x;
+            for (int y=0; y<N; ++y)
+              for (int x=0; x<N; ++x)
+                window[y*N+x] = corner[y*s_y + x*s_x];
+            dst(j,i) = static_cast<T>(medianWindow(window));
+          }
+      }
+
+      /**
+       * @brief Generic median filter, which selects the median of each
+       * window with std::nth_element
+       */
+      template <typename T>
+      void medianSelect(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst,
+        const int radius_y, const int radius_x)
+      {
+        const int h = 2*radius_y+1, w = 2*radius_x+1;
+        const int median_pos = h*w/2;
+        std::vector<T> window(h*w);
+        const int s_y = src.stride(0), s_x = src.stride(1);
+        for (int j=0; j<dst.extent(0); ++j)
+          for (int i=0; i<dst.extent(1); ++i)
+          {
+            const T* corner = src.data() + j*s_y + i*s_x;
+            for (int y=0; y<h; ++y)
+              for (int x=0; x<w; ++x)
+                window[y*w+x] = corner[y*s_y + x*s_x];
+            std::nth_element(window.begin(), window.begin() + median_pos, window.end());
+            dst(j,i) = window[median_pos];
+          }
+      }
+
+      /**
+       * @brief Constant-time median filter for 8-bit images, which maintains
+       * one histogram per column of the image (S. Perreault and P. Hébert,
+       * "Median Filtering in Constant Time", IEEE Trans. on Image
+       * Processing, 2007)
+       */
+      void medianHistogram(const blitz::Array<uint8_t,2>& src,
+        blitz::Array<uint8_t,2>& dst, const int radius_y, const int radius_x);
+
+      /**
+       * @brief Median filter for 16-bit images, which slides a two-level
+       * (coarse and fine) histogram of the kernel along each row (T. Huang,
+       * G. Yang and G. Tang, "A fast two-dimensional median filtering
+       * algorithm", IEEE Trans. on Acoustics, Speech and Signal Processing,
+       * 1979). Per-column 16-bit histograms would be too large.
+       */
+      void medianHistogram(const blitz::Array<uint16_t,2>& src,
+        blitz::Array<uint16_t,2>& dst, const int radius_y, const int radius_x);
+
+      /**
+       * @brief Median filter for kernels larger than 5x5, which uses the
+       * histogram-based filters for integral types with small dynamic
+       * range, and the generic selection otherwise
+       */
+      template <typename T>
+      inline void medianLarge(const blitz::Array<T,2>& src,
+        blitz::Array<T,2>& dst, const int radius_y, const int radius_x)
+      {
+        medianSelect(src, dst, radius_y, radius_x);
+      }
+
+      inline void medianLarge(const blitz::Array<uint8_t,2>& src,
+        blitz::Array<uint8_t,2>& dst, const int radius_y, const int radius_x)
+      {
+        medianHistogram(src, dst, radius_y, radius_x);
+      }
+
+      inline void medianLarge(const blitz::Array<uint16_t,2>& src,
+        blitz::Array<uint16_t,2>& dst, const int radius_y, const int radius_x)
+      {
+        medianHistogram(src, dst, radius_y, radius_x);
       }
     }
 
@@ -94,8 +238,7 @@ namespace bob {
          * @param radius_x The radius of the kernel along the x-axis (width=2*radius_x+1)
          */
         Median(const size_t radius_y=1, const size_t radius_x=1):
-          m_radius_y(radius_y), m_radius_x(radius_x),
-          m_median_pos((2*radius_y+1)*(2*radius_x+1)/2)
+          m_radius_y(radius_y), m_radius_x(radius_x)
         {
         }
 
@@ -110,11 +253,12 @@ namespace bob {
         {
           m_radius_y = (int)radius_y;
           m_radius_x = (int)radius_x;
-          m_median_pos = (2*(int)radius_y+1)*(2*(int)radius_x+1)/2;
         }
 
         /**
-         * @brief Processes a 2D blitz Array/Image
+         * @brief Processes a 2D blitz Array/Image. 3x3 and 5x5 kernels are
+         * processed with sorting networks, larger kernels with histograms
+         * for uint8 and uint16 images.
          * @param src The 2D input blitz array
          * @param dst The 2D input blitz array
          */
@@ -131,92 +275,13 @@ namespace bob {
 
 
       private:
-        /**
-          * @brief Initializes the ordered lists of values
-          */
-        void initLists(const blitz::Array<T,2>& src);
-        /**
-          * @brief Efficiently updates the ordered lists
-          */
-        void listRemoveAddColumn(const int j, const int i,
-                const blitz::Array<T,2>& src,
-                std::list<boost::shared_ptr<struct detail::Pixel<T> > >& l);
-        void listRemoveAddRow(const int j, const int i,
-                const blitz::Array<T,2>& src,
-                std::list<boost::shared_ptr<struct detail::Pixel<T> > >& l);
-
         /**
          * @brief Attributes
          */
         int m_radius_y;
         int m_radius_x;
-        int m_median_pos;
-
-        std::list<boost::shared_ptr<struct detail::Pixel<T> > > m_list_current;
-        std::list<boost::shared_ptr<struct detail::Pixel<T> > > m_list_first_col;
     };
 
-    template <typename T>
-    void bob::ip::Median<T>::initLists(const blitz::Array<T,2>& src)
-    {
-      // Clears content
-      m_list_first_col.clear();
-      m_list_current.clear();
-      typedef struct bob::ip::detail::Pixel<T> Pix;
-      for(int j=0; j<2*m_radius_y+1; ++j)
-        for(int i=0; i<2*m_radius_x+1; ++i)
-        {
-          boost::shared_ptr<Pix> pix(new Pix(j,i,src(j,i)));
-          bob::ip::detail::listInsertPixel(pix, m_list_first_col);
-        }
-      m_list_current = m_list_first_col;
-    }
-
-
-    template <typename T>
-    void bob::ip::Median<T>::listRemoveAddColumn(const int j, const int i,
-                  const blitz::Array<T,2>& src,
-                  std::list<boost::shared_ptr<struct detail::Pixel<T> > >& l)
-    {
-      // Erases elements from column i
-      typename std::list<boost::shared_ptr<struct detail::Pixel<T> > >::iterator it=l.begin();
-      for( ; it!=l.end(); )
-      {
-        if( (*it)->x == i) it = l.erase(it);
-        else ++it;
-      }
-      // Adds elements from new column i+2*m_radius_x+1
-      blitz::Array<T,1> col_new = src(blitz::Range(j,j+2*m_radius_y), i+2*m_radius_x+1);
-      for(int k=0; k<col_new.extent(0); ++k)
-      {
-        boost::shared_ptr<struct detail::Pixel<T> > pix(
-          new struct detail::Pixel<T>(j+k,i+2*m_radius_x+1,src(j+k,i+2*m_radius_x+1)));
-        bob::ip::detail::listInsertPixel(pix, l);
-      }
-    }
-
-    template <typename T>
-    void bob::ip::Median<T>::listRemoveAddRow(const int j, const int i,
-                  const blitz::Array<T,2>& src,
-                  std::list<boost::shared_ptr<struct detail::Pixel<T> > >& l)
-    {
-      // Erases elements from row j
-      typename std::list<boost::shared_ptr<struct detail::Pixel<T> > >::iterator it=l.begin();
-      for( ; it!=l.end(); )
-      {
-        if( (*it)->y == j) it = l.erase(it);
-        else ++it;
-      }
-      // Adds elements from new row j+2*m_radius_y+2
-      blitz::Array<T,1> col_new = src(j+2*m_radius_y+1,blitz::Range(i,i+2*m_radius_x));
-      for(int k=0; k<col_new.extent(0); ++k)
-      {
-        boost::shared_ptr<struct detail::Pixel<T> > pix(
-          new struct detail::Pixel<T>(j+2*m_radius_y+1,i+k,src(j+2*m_radius_y+1,i+k)));
-        bob::ip::detail::listInsertPixel(pix, l);
-      }
-    }
-
     template <typename T>
     void bob::ip::Median<T>::operator()(const blitz::Array<T,2>& src,
       blitz::Array<T,2>& dst)
@@ -229,27 +294,13 @@ namespace bob {
       dst_size(1) = src.extent(1) - 2 * m_radius_x;
       bob::core::array::assertSameShape(dst, dst_size);
 
-      // Initializes the lists
-      initLists(src);
-
       // Filters
-      for(int j=0; j<dst.extent(0); ++j)
-      {
-        for(int i=0; i<dst.extent(1); ++i)
-        {
-          dst(j,i) = bob::ip::detail::listGetValueAtPosition( m_median_pos, m_list_current);
-          // Updates current ordered list
-          if( i<dst.extent(1) - 1) {
-            listRemoveAddColumn(j, i, src, m_list_current);
-          }
-        }
-        // Updates current ordered list
-        if(j<dst.extent(0)-1)
-        {
-          listRemoveAddRow(j, 0, src, m_list_first_col);
-          m_list_current = m_list_first_col;
-        }
-      }
+      if (m_radius_y == 1 && m_radius_x == 1)
+        bob::ip::detail::medianNetwork<T,3>(src, dst);
+      else if (m_radius_y == 2 && m_radius_x == 2)
+        bob::ip::detail::medianNetwork<T,5>(src, dst);
+      else
+        bob::ip::detail::medianLarge(src, dst, m_radius_y, m_radius_x);
     }
 
     template <typename T>
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <boost/shared_ptr.hpp>
+#include <blitz/array.h>
 #include "bob/io/HDF5File.h"
 
 namespace bob { namespace machine {
@@ -57,6 +58,24 @@ namespace bob { namespace machine {
        */
       virtual double f_prime_from_f (double a) const =0;
 
+      /**
+       * Computes the activated values of a whole layer, in place: z holds
+       * one sample per row, and each element z(i,j) is replaced by
+       * f(z(i,j) + bias(j)). This costs a single virtual call per layer. The
+       * default implementation calls f() for each element.
+       */
+      virtual void f_layer (blitz::Array<double,2>& z,
+          const blitz::Array<double,1>& bias) const;
+
+      /**
+       * Multiplies each element error(i,j) by the derivative of the
+       * activation, given the activated value a(i,j) - that is, the output
+       * of f_layer() above. The default implementation calls
+       * f_prime_from_f() for each element.
+       */
+      virtual void f_prime_from_f_layer (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& error) const;
+
       /**
        * Saves itself to an HDF5File
        */
@@ -109,6 +128,10 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_layer (blitz::Array<double,2>& z,
+          const blitz::Array<double,1>& bias) const;
+      virtual void f_prime_from_f_layer (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& error) const;
       virtual void save(bob::io::HDF5File&) const;
       virtual void load(bob::io::HDF5File&);
       virtual std::string unique_identifier() const;
@@ -128,6 +151,10 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_layer (blitz::Array<double,2>& z,
+          const blitz::Array<double,1>& bias) const;
+      virtual void f_prime_from_f_layer (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& error) const;
       double C() const;
       virtual void save(bob::io::HDF5File& f) const;
       virtual void load(bob::io::HDF5File&);
@@ -150,6 +177,10 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_layer (blitz::Array<double,2>& z,
+          const blitz::Array<double,1>& bias) const;
+      virtual void f_prime_from_f_layer (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& error) const;
       virtual void save(bob::io::HDF5File& f) const;
       virtual void load(bob::io::HDF5File&);
       virtual std::string unique_identifier() const;
@@ -169,6 +200,10 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_layer (blitz::Array<double,2>& z,
+          const blitz::Array<double,1>& bias) const;
+      virtual void f_prime_from_f_layer (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& error) const;
       double C() const;
       double M() const;
       virtual void save(bob::io::HDF5File& f) const;
@@ -193,6 +228,10 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_layer (blitz::Array<double,2>& z,
+          const blitz::Array<double,1>& bias) const;
+      virtual void f_prime_from_f_layer (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& error) const;
       virtual void save(bob::io::HDF5File& f) const;
       virtual void load(bob::io::HDF5File&);
       virtual std::string unique_identifier() const;
@@ -97,9 +97,6 @@ namespace bob { namespace machine {
 
     private:
 
-      //! initializes internal data storages for the given class
-      void initialize(bool clazz, int input_length, int projected_length);
-
       //! project data?
       bool m_project_data;
 
@@ -116,9 +113,6 @@ namespace bob { namespace machine {
       blitz::Array<double, 2> m_Phi_I, m_Phi_E;
       //! averaged eigenvalues to calculate DFFS
       double m_rho_I, m_rho_E;
-      //! temporary storage
-      mutable blitz::Array<double, 1> m_diff_I, m_diff_E;
-      mutable blitz::Array<double, 1> m_proj_I, m_proj_E;
 
   };
 
@@ -31,6 +31,7 @@
 #include <bob/io/HDF5File.h>
 #include <iostream>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <vector>
 
 namespace bob { namespace machine {
@@ -42,6 +43,9 @@ namespace bob { namespace machine {
 /**
  * @brief This class implements a multivariate diagonal Gaussian distribution.
  * @details See Section 2.3.9 of Bishop, "Pattern recognition and machine learning", 2006
+ * The const methods (log-likelihood computation, statistics accumulation)
+ * only use thread-local scratch space: a single instance can be shared by
+ * several scoring threads, as long as it is not modified concurrently.
  */
 class GMMMachine: public Machine<blitz::Array<double,1>, double>
 {
@@ -237,6 +241,46 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      */
     double logLikelihood_(const blitz::Array<double, 1> &x) const;
 
+    /**
+     * Output the log likelihoods of a set of samples, one per row of input.
+     * All the samples and Gaussian components are processed at once, with
+     * one matrix product per block of samples.
+     * @param[in]  input                             The samples (n_samples x n_inputs)
+     * @param[out] log_weighted_gaussian_likelihoods For each sample n and Gaussian i: log(weight_i*p(x_n|Gaussian_i)) (n_samples x n_gaussians)
+     * @param[out] log_likelihoods                   For each sample n: log(p(x_n|GMMMachine))
+     * Dimensions of the parameters are checked
+     */
+    void logLikelihood(const blitz::Array<double,2> &input,
+      blitz::Array<double,2> &log_weighted_gaussian_likelihoods,
+      blitz::Array<double,1> &log_likelihoods) const;
+
+    /**
+     * Output the log likelihoods of a set of samples, one per row of input.
+     * @see logLikelihood()
+     * @warning Dimensions of the parameters are not checked
+     */
+    void logLikelihood_(const blitz::Array<double,2> &input,
+      blitz::Array<double,2> &log_weighted_gaussian_likelihoods,
+      blitz::Array<double,1> &log_likelihoods) const;
+
+    /**
+     * Output the log likelihoods of a set of samples, one per row of input,
+     * i.e. log(p(x_n|GMMMachine)).
+     * @param[in]  input           The samples (n_samples x n_inputs)
+     * @param[out] log_likelihoods The log likelihood of each sample
+     * Dimensions of the parameters are checked
+     */
+    void logLikelihood(const blitz::Array<double,2> &input,
+      blitz::Array<double,1> &log_likelihoods) const;
+
+    /**
+     * Output the log likelihoods of a set of samples, one per row of input,
+     * i.e. log(p(x_n|GMMMachine)).
+     * @warning Dimensions of the parameters are not checked
+     */
+    void logLikelihood_(const blitz::Array<double,2> &input,
+      blitz::Array<double,1> &log_likelihoods) const;
+
     /**
      * Output the log likelihood of the sample, x
      * (overrides Machine::forward)
@@ -253,6 +297,9 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
 
     /**
      * Accumulates the GMM statistics over a set of samples.
+     * The responsibilities of all the samples are computed at once (see
+     * the batch logLikelihood()), and the first and second order statistics
+     * are accumulated with one matrix product per block of samples.
      * @see bool accStatistics(const blitz::Array<double,1> &x, GMMStats stats)
      * Dimensions of the parameters are checked
      */
@@ -269,6 +316,7 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      * Accumulate the GMM statistics for this sample.
      *
      * @param[in]  x     The current sample
+     * @param[in]  log_weighted_gaussian_likelihoods For each Gaussian i: log(weight_i*p(x|Gaussian_i))
      * @param[out] stats The accumulated statistics
      * Dimensions of the parameters are checked
      */
@@ -371,18 +419,51 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      * @warning Dimensions of the parameters are not checked
      */
     void accStatisticsInternal(const blitz::Array<double,1> &x,
+      const blitz::Array<double,1> &log_weighted_gaussian_likelihoods,
       GMMStats &stats, const double log_likelihood) const;
 
+    /**
+     * Computes the contiguous parameters used by the batch computations.
+     * With x' = x - center, log(weight_i*p(x|Gaussian_i)) is the dot
+     * product of [x', x'^2] with the i'th row of params, plus constants(i).
+     * The samples are centered on the average of the means to limit the
+     * cancellation errors of this expansion.
+     *
+     * @param[out] center    The average of the means (n_inputs)
+     * @param[out] params    [(mean_i - center)/variance_i, -1/(2*variance_i)] (n_gaussians x 2*n_inputs)
+     * @param[out] constants The constant terms (n_gaussians)
+     */
+    void getBatchParameters(blitz::Array<double,1> &center,
+      blitz::Array<double,2> &params, blitz::Array<double,1> &constants) const;
+
+    /**
+     * Computes the log likelihoods of a block of samples, given the
+     * parameters computed by getBatchParameters(). The block is addressed
+     * by its first row rather than sliced, so that no reference to the
+     * (possibly shared) input array is created.
+     *
+     * @param[in]  input    The samples (n_total x n_inputs)
+     * @param[in]  start    The first row of the block in input
+     * @param[out] features Workspace for [x', x'^2] (n_samples x 2*n_inputs)
+     * @param[out] log_weighted_gaussian_likelihoods (n_samples x n_gaussians)
+     * @param[out] log_likelihoods (n_samples)
+     * @warning Dimensions of the parameters are not checked
+     */
+    void logLikelihoodBlock(const blitz::Array<double,2> &input,
+      const int start, const blitz::Array<double,1> &center, const blitz::Array<double,2> &params,
+      const blitz::Array<double,1> &constants, blitz::Array<double,2> &features,
+      blitz::Array<double,2> &log_weighted_gaussian_likelihoods,
+      blitz::Array<double,1> &log_likelihoods) const;
+
 
-    /// Some cache arrays to avoid re-allocation when computing log-likelihoods
+    /// The log of the weights, updated whenever the weights are set
     mutable blitz::Array<double,1> m_cache_log_weights;
-    mutable blitz::Array<double,1> m_cache_log_weighted_gaussian_likelihoods;
-    mutable blitz::Array<double,1> m_cache_P;
-    mutable blitz::Array<double,2> m_cache_Px;
 
+    /// The supervectors, lazily computed (under m_cache_mutex)
     mutable blitz::Array<double,1> m_cache_mean_supervector;
     mutable blitz::Array<double,1> m_cache_variance_supervector;
     mutable bool m_cache_supervector;
+    mutable boost::mutex m_cache_mutex;
 
 };
 
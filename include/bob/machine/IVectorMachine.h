@@ -39,7 +39,10 @@ namespace bob { namespace machine {
  * Reference:\n
  * "Front-End Factor Analysis For Speaker Verification",
  *    N. Dehak, P. Kenny, R. Dehak, P. Dumouchel, P. Ouellet, 
- *   IEEE Trans. on Audio, Speech and Language Processing
+ *   IEEE Trans. on Audio, Speech and Language Processing\n
+ * The extraction only uses thread-local working arrays: a single machine
+ * can be shared by several threads, as long as it is not modified
+ * concurrently.
  */
 class IVectorMachine: public bob::machine::Machine<bob::machine::GMMStats, blitz::Array<double,1> >
 {
@@ -258,11 +261,7 @@ class IVectorMachine: public bob::machine::Machine<bob::machine::GMMStats, blitz
      */
     void resizeCache();
     /**
-     * @brief Resize working arrays
-     */
-    void resizeTmp();
-    /**
-     * @brief Resize cache and working arrays before updating cache
+     * @brief Resize cache before updating it
      */
     void resizePrecompute();
 
@@ -280,11 +279,6 @@ class IVectorMachine: public bob::machine::Machine<bob::machine::GMMStats, blitz
 
     blitz::Array<double,3> m_cache_Tct_sigmacInv;
     blitz::Array<double,3> m_cache_Tct_sigmacInv_Tc;
-
-    mutable blitz::Array<double,1> m_tmp_d;
-    mutable blitz::Array<double,1> m_tmp_t1;
-    mutable blitz::Array<double,1> m_tmp_t2;
-    mutable blitz::Array<double,2> m_tmp_tt;
 };
 
 /**
@@ -258,10 +258,6 @@ class FABase
      * @brief Put GMM mean/variance supervector in cache
      */
     void updateCacheUbm();
-    /**
-     * @brief Resize working arrays
-     */
-    void resizeTmp();
     /**
      * @brief Computes (Id + U^T.Sigma^-1.U.N_{i,h}.U)^-1 =
      *   (Id + sum_{c=1..C} N_{i,h}.U_{c}^T.Sigma_{c}^-1.U_{c})^-1
@@ -299,12 +295,6 @@ class FABase
     blitz::Array<double,1> m_cache_mean;
     blitz::Array<double,1> m_cache_sigma;
     blitz::Array<double,2> m_cache_UtSigmaInv;
-
-    mutable blitz::Array<double,2> m_tmp_IdPlusUSProdInv;
-    mutable blitz::Array<double,1> m_tmp_Fn_x;
-    mutable blitz::Array<double,1> m_tmp_ru;
-    mutable blitz::Array<double,2> m_tmp_ruD;
-    mutable blitz::Array<double,2> m_tmp_ruru;
 };
 
 
@@ -936,10 +926,6 @@ class JFAMachine: public Machine<bob::machine::GMMStats, double>
      * @brief Resize latent variable according to the JFABase
      */
     void resize();
-    /**
-     * @brief Resize working arrays
-     */
-    void resizeTmp();
     /**
      * @brief Update the cache
      */
@@ -955,9 +941,6 @@ class JFAMachine: public Machine<bob::machine::GMMStats, double>
     // cache
     blitz::Array<double,1> m_cache_mVyDz;
     mutable blitz::Array<double,1> m_cache_x;
-
-    // x vector/factor in cache when computing scores
-    mutable blitz::Array<double,1> m_tmp_Ux;
 };
 
 /**
@@ -1143,10 +1126,6 @@ class ISVMachine: public Machine<bob::machine::GMMStats, double>
      * @ Update cache
      */
     void updateCache();
-    /**
-     * @brief Resize working arrays
-     */
-    void resizeTmp();
 
     // UBM
     boost::shared_ptr<bob::machine::ISVBase> m_isv_base;
@@ -1157,9 +1136,6 @@ class ISVMachine: public Machine<bob::machine::GMMStats, double>
     // cache
     blitz::Array<double,1> m_cache_mDz;
     mutable blitz::Array<double,1> m_cache_x;
-
-    // x vector/factor in cache when computing scores
-    mutable blitz::Array<double,1> m_tmp_Ux;
 };
 
 
@@ -199,6 +199,16 @@ class KMeansMachine: public Machine<blitz::Array<double,1>, double> {
     void getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2> &data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
     void getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
 
+    /**
+     * Re-entrant versions of the above methods, where the accumulated means
+     * are stored in the caller provided array (n_means x n_inputs) rather
+     * than in m_cache_means. Several threads may hence call them concurrently
+     * on the same machine, each one with its own accumulators.
+     */
+    void getVariancesAndWeightsForEachClusterInit(blitz::Array<double,2>& means, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
+    void getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2> &data, blitz::Array<double,2>& means, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
+    void getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& means, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
+
     /**
      * Get the m_cache_means array. 
      * @warning This variable should only be used in the case you want to parallelize the 
@@ -385,7 +385,6 @@ namespace bob { namespace machine {
       std::vector<blitz::Array<double, 1> > m_bias; ///< biases for the output
       boost::shared_ptr<Activation> m_hidden_activation; ///< currently set activation type
       boost::shared_ptr<Activation> m_output_activation; ///< currently set activation type
-      mutable std::vector<blitz::Array<double, 1> > m_buffer; ///< buffer for the outputs of each layer
   
   };
 
@@ -412,12 +412,11 @@ class PLDABase
      */
     std::map<size_t, double> m_cache_loglike_constterm;
 
-    // working arrays
-    mutable blitz::Array<double,1> m_tmp_d_1; ///< Cache vector of size dim_d
-    mutable blitz::Array<double,1> m_tmp_d_2; ///< Cache vector of size dim_d
-    mutable blitz::Array<double,2> m_tmp_d_ng_1; ///< Cache matrix of size dim_d x dim_g
-    mutable blitz::Array<double,2> m_tmp_nf_nf_1; ///< Cache matrix of size dim_f x dim_f
-    mutable blitz::Array<double,2> m_tmp_ng_ng_1; ///< Cache matrix of size dim_g x dim_g
+    // working arrays of the (non-const) precomputations. The const methods
+    // use thread-local scratch space instead, and can hence be called
+    // concurrently.
+    blitz::Array<double,2> m_tmp_d_ng_1; ///< Cache matrix of size dim_d x dim_g
+    blitz::Array<double,2> m_tmp_ng_ng_1; ///< Cache matrix of size dim_g x dim_g
 
     // private methods
     void resizeNoInit(const size_t dim_d, const size_t dim_f, const size_t dim_g);
@@ -446,7 +445,11 @@ class PLDABase
  * 2. 'Probabilistic Linear Discriminant Analysis for Inference About 
  *     Identity', Prince and Elder, ICCV'2007\n
  * 3. 'Probabilistic Models for Inference about Identity', Li, Fu, Mohammed, 
- *     Elder and Prince, TPAMI'2012
+ *     Elder and Prince, TPAMI'2012\n
+ * Scoring (forward() and computeLogLikelihood()) only uses thread-local
+ * working arrays: several threads can score against the same machine and
+ * PLDABase, as long as these are not modified concurrently (e.g. by the
+ * getAdd*() methods, which update the caches).
  */
 class PLDAMachine: public Machine<blitz::Array<double,1>, double>
 {
@@ -693,22 +696,10 @@ class PLDAMachine: public Machine<blitz::Array<double,1>, double>
      */
     std::map<size_t, double> m_cache_loglike_constterm;
 
-
-    // working arrays
-    mutable blitz::Array<double,1> m_tmp_d_1; ///< Cache vector of size dim_d
-    mutable blitz::Array<double,1> m_tmp_d_2; ///< Cache vector of size dim_d
-    mutable blitz::Array<double,1> m_tmp_nf_1; ///< Cache vector of size dim_f
-    mutable blitz::Array<double,1> m_tmp_nf_2; ///< Cache vector of size dim_f
-    mutable blitz::Array<double,2> m_tmp_nf_nf_1; ///< Cache vector of size dim_f dim_f
-
     /** 
      * @brief Resizes the PLDAMachine
      */
     void resize(const size_t dim_d, const size_t dim_f, const size_t dim_g);
-    /**
-     * @brief Resize working arrays
-     */
-    void resizeTmp();
 };
 
 /**
@@ -350,6 +350,44 @@ namespace bob { namespace machine {
         (const blitz::Array<double,1>& input,
          blitz::Array<double,1>& probabilities) const;
 
+      /**
+       * Predicts the classes of a batch of samples, organized row-wise, into
+       * classes (one entry per sample). Checks the input and output array
+       * sizes.
+       *
+       * For linear, polynomial, RBF and sigmoid kernels, the support vectors
+       * are kept in a dense matrix: the kernel values of a block of samples
+       * against all the support vectors are then computed with a single
+       * matrix product followed by elementwise operations, and the decision
+       * values are combined as libsvm does (one-vs-one voting for
+       * classification). Precomputed kernels fall back to predictClass_().
+       * Results may hence differ from the sample-wise variants by rounding
+       * errors.
+       *
+       * The samples are split across n_threads threads, and the kernel
+       * values may be computed in single precision, which halves the
+       * memory traffic of the matrix product.
+       */
+      void predictClasses(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& classes, const size_t n_threads=1,
+          const bool single_precision=false) const;
+
+      /**
+       * Same as above, but also outputs the decision values of each sample
+       * in the corresponding row of scores. There is one decision value per
+       * pair of classes (see numberOfDecisionValues()).
+       */
+      void predictClassesAndScores(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& classes, blitz::Array<double,2>& scores,
+          const size_t n_threads=1, const bool single_precision=false) const;
+
+      /**
+       * The number of decision values computed for each sample: one per
+       * pair of classes for classification, 1 otherwise. This is also
+       * outputSize() for problems with up to 3 classes.
+       */
+      size_t numberOfDecisionValues() const;
+
       /**
        * Saves the current model state to a file. With this variant, the model
        * is saved on simpler libsvm model file that does not include the
@@ -377,13 +415,20 @@ namespace bob { namespace machine {
        */
       void reset();
 
+      /**
+       * Batch prediction, without any checks. scores may be 0.
+       */
+      void predict(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& classes, blitz::Array<double,2>* scores,
+          const size_t n_threads, const bool single_precision) const;
+
     private: //representation
 
       boost::shared_ptr<svm_model> m_model; ///< libsvm model pointer
-      mutable boost::shared_array<svm_node> m_input_cache; ///< cache
       size_t m_input_size; ///< vector size expected as input for the SVM's
       blitz::Array<double,1> m_input_sub; ///< scaling: subtraction
       blitz::Array<double,1> m_input_div; ///< scaling: division
+      blitz::Array<double,2> m_svt; ///< support vectors, one per column (dense)
 
   };
 
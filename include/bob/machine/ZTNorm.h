@@ -22,7 +22,9 @@
 #ifndef BOB_MACHINE_ZTNORM_H
 #define BOB_MACHINE_ZTNORM_H
 
+#include <string>
 #include <blitz/array.h>
+#include <bob/io/HDF5File.h>
 
 namespace bob { namespace machine {
 /**
@@ -30,6 +32,85 @@ namespace bob { namespace machine {
  * @{
  */
 
+/**
+ * Cohort statistics of ZT-Norm, computed once by ztNormStatistics(), and
+ * then applied to the raw scores (models x probes) by ztNormApply(),
+ * possibly block by block. Standard deviations close to 0 are replaced
+ * by 1.
+ */
+struct ZTNormStatistics {
+  /// Z-Norm mean of each model (empty if Z-Norm does not apply)
+  blitz::Array<double,1> z_mean;
+  /// Z-Norm standard deviation of each model
+  blitz::Array<double,1> z_std;
+  /// T-Norm mean of each probe, computed on the Z-Normed T-Norm scores if
+  /// Z-Norm applies (empty if T-Norm does not apply)
+  blitz::Array<double,1> t_mean;
+  /// T-Norm standard deviation of each probe
+  blitz::Array<double,1> t_std;
+};
+
+/**
+ * Computes the cohort statistics of ZT-Norm. Z-Norm (resp. T-Norm) is
+ * skipped if rawscores_zprobes_vs_models (resp. rawscores_probes_vs_tmodels)
+ * is empty. The statistics of the models (resp. probes) are split across
+ * n_threads threads.
+ *
+ * @exception std::runtime_error matrix sizes are not consistent
+ *
+ * @param rawscores_zprobes_vs_models (n_models x n_zprobes)
+ * @param rawscores_probes_vs_tmodels (n_tmodels x n_probes)
+ * @param rawscores_zprobes_vs_tmodels (n_tmodels x n_zprobes)
+ * @param mask_zprobes_vs_tmodels_istruetrial (n_tmodels x n_zprobes)
+ * @param[out] statistics The cohort statistics
+ * @param n_threads The number of threads
+ */
+void ztNormStatistics(const blitz::Array<double,2>& rawscores_zprobes_vs_models,
+                      const blitz::Array<double,2>& rawscores_probes_vs_tmodels,
+                      const blitz::Array<double,2>& rawscores_zprobes_vs_tmodels,
+                      const blitz::Array<bool,2>& mask_zprobes_vs_tmodels_istruetrial,
+                      ZTNormStatistics& statistics, const size_t n_threads=1);
+
+/**
+ * Computes the cohort statistics of ZT-Norm.
+ * Assume that znorm and tnorm have no common subject id.
+ *
+ * @see ztNormStatistics()
+ */
+void ztNormStatistics(const blitz::Array<double,2>& rawscores_zprobes_vs_models,
+                      const blitz::Array<double,2>& rawscores_probes_vs_tmodels,
+                      const blitz::Array<double,2>& rawscores_zprobes_vs_tmodels,
+                      ZTNormStatistics& statistics, const size_t n_threads=1);
+
+/**
+ * Normalises a block of raw scores with precomputed cohort statistics.
+ * The block starts at model first_model and probe first_probe of the full
+ * score matrix, so that the raw scores never need to be loaded at once.
+ * The rows of the block are split across n_threads threads. The
+ * normalized scores may be the raw scores themselves (in-place).
+ *
+ * @exception std::runtime_error matrix sizes are not consistent
+ */
+void ztNormApply(const blitz::Array<double,2>& rawscores_probes_vs_models,
+                 const ZTNormStatistics& statistics, const int first_model,
+                 const int first_probe, blitz::Array<double,2>& normalizedscores,
+                 const size_t n_threads=1);
+
+/**
+ * Normalises raw scores with precomputed cohort statistics, and appends
+ * them, block_size models (rows) at a time, to the dataset at path of the
+ * HDF5 file. The dataset holds a (n_models x n_probes) array, which can be
+ * read back at once with readArray<double,2>() or block by block with
+ * readArrayRange(). Only the output is streamed: the raw scores are held in
+ * memory, while only block_size rows of normalized scores are.
+ *
+ * @exception std::runtime_error matrix sizes are not consistent
+ */
+void ztNormApply(const blitz::Array<double,2>& rawscores_probes_vs_models,
+                 const ZTNormStatistics& statistics, bob::io::HDF5File& file,
+                 const std::string& path, const size_t n_threads=1,
+                 const size_t block_size=256);
+
 /**
  * Normalise raw scores with ZT-Norm
  *
@@ -41,15 +122,18 @@ namespace bob { namespace machine {
  * @param rawscores_zprobes_vs_tmodels
  * @param mask_zprobes_vs_tmodels_istruetrial
  * @param[out] normalizedscores normalized scores
+ * @param n_threads The number of threads
  * @warning The destination score array should have the correct size
- *          (Same size as rawscores_probes_vs_models)
+ *          (Same size as rawscores_probes_vs_models). It may be
+ *          rawscores_probes_vs_models itself (in-place).
  */
 void ztNorm(const blitz::Array<double, 2>& rawscores_probes_vs_models,
             const blitz::Array<double, 2>& rawscores_zprobes_vs_models,
             const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
             const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
             const blitz::Array<bool,   2>& mask_zprobes_vs_tmodels_istruetrial,
-            blitz::Array<double, 2>& normalizedscores);
+            blitz::Array<double, 2>& normalizedscores,
+            const size_t n_threads=1);
 
 /**
  * Normalise raw scores with ZT-Norm.
@@ -62,14 +146,17 @@ void ztNorm(const blitz::Array<double, 2>& rawscores_probes_vs_models,
  * @param rawscores_probes_vs_tmodels
  * @param rawscores_zprobes_vs_tmodels
  * @param[out] normalizedscores normalized scores
+ * @param n_threads The number of threads
  * @warning The destination score array should have the correct size
- *          (Same size as rawscores_probes_vs_models)
+ *          (Same size as rawscores_probes_vs_models). It may be
+ *          rawscores_probes_vs_models itself (in-place).
  */
 void ztNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
             const blitz::Array<double,2>& rawscores_zprobes_vs_models,
             const blitz::Array<double,2>& rawscores_probes_vs_tmodels,
             const blitz::Array<double,2>& rawscores_zprobes_vs_tmodels,
-            blitz::Array<double,2>& normalizedscores);
+            blitz::Array<double,2>& normalizedscores,
+            const size_t n_threads=1);
 
 /**
  * Normalise raw scores with T-Norm.
@@ -79,12 +166,15 @@ void ztNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
  * @param rawscores_probes_vs_models
  * @param rawscores_probes_vs_tmodels
  * @param[out] normalizedscores normalized scores
+ * @param n_threads The number of threads
  * @warning The destination score array should have the correct size
- *          (Same size as rawscores_probes_vs_models)
+ *          (Same size as rawscores_probes_vs_models). It may be
+ *          rawscores_probes_vs_models itself (in-place).
  */
 void tNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
            const blitz::Array<double,2>& rawscores_probes_vs_tmodels,
-           blitz::Array<double,2>& normalizedscores);
+           blitz::Array<double,2>& normalizedscores,
+           const size_t n_threads=1);
 
 /**
  * Normalise raw scores with Z-Norm.
@@ -94,12 +184,15 @@ void tNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
  * @param rawscores_probes_vs_models
  * @param rawscores_zprobes_vs_models
  * @param[out] normalizedscores normalized scores
+ * @param n_threads The number of threads
  * @warning The destination score array should have the correct size
- *          (Same size as rawscores_probes_vs_models)
+ *          (Same size as rawscores_probes_vs_models). It may be
+ *          rawscores_probes_vs_models itself (in-place).
  */
 void zNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
            const blitz::Array<double,2>& rawscores_zprobes_vs_models,
-           blitz::Array<double,2>& normalizedscores);
+           blitz::Array<double,2>& normalizedscores,
+           const size_t n_threads=1);
 
 /**
  * @}
@@ -62,6 +62,43 @@ namespace math {
       C = blitz::sum(A(i,k) * B(k,j), k);
     }
 
+  /**
+   * @brief Performs the matrix multiplication C=A*B for double precision
+   * arrays, using the BLAS dgemm function (or dsyrk if B is the transpose
+   * view of A).
+   *
+   * Row-major (C-style) and transposed (Fortran-style) views with a positive
+   * leading dimension are passed to BLAS without any copy. Other strided
+   * views fall back to the generic blitz expression.
+   *
+   * @warning No checks are performed on the array sizes and is recommended
+   * only in scenarios where you have previously checked conformity and is
+   * focused only on speed.
+   *
+   * @param A The A matrix (left element of the multiplication) (size MxN)
+   * @param B The B matrix (right element of the multiplication) (size NxP)
+   * @param C The resulting matrix (size MxP)
+   */
+  void prod_(const blitz::Array<double,2>& A, const blitz::Array<double,2>& B,
+      blitz::Array<double,2>& C);
+
+  /**
+   * @brief Performs the matrix multiplication C=A*B for single precision
+   * arrays, using the BLAS sgemm function (or ssyrk if B is the transpose
+   * view of A). The same layouts as for double precision arrays are handed
+   * to BLAS without any copy.
+   *
+   * @warning No checks are performed on the array sizes and is recommended
+   * only in scenarios where you have previously checked conformity and is
+   * focused only on speed.
+   *
+   * @param A The A matrix (left element of the multiplication) (size MxN)
+   * @param B The B matrix (right element of the multiplication) (size NxP)
+   * @param C The resulting matrix (size MxP)
+   */
+  void prod_(const blitz::Array<float,2>& A, const blitz::Array<float,2>& B,
+      blitz::Array<float,2>& C);
+
   /**
    * @brief Performs the matrix multiplication C=A*B
    *
@@ -108,6 +145,22 @@ namespace math {
       c = blitz::sum(A(i,j) * b(j), j);
     }
 
+  /**
+   * @brief Performs the matrix-vector multiplication c=A*b for double
+   * precision arrays, using the BLAS dgemv function whenever the layout of
+   * A allows it, and the generic blitz expression otherwise.
+   *
+   * @warning No checks are performed on the array sizes and is recommended
+   * only in scenarios where you have previously checked conformity and is
+   * focused only on speed.
+   *
+   * @param A The A matrix (left element of the multiplication) (size MxN)
+   * @param b The b vector (right element of the multiplication) (size N)
+   * @param c The resulting vector (size M)
+   */
+  void prod_(const blitz::Array<double,2>& A, const blitz::Array<double,1>& b,
+      blitz::Array<double,1>& c);
+
   /**
    * @brief Performs the matrix-vector multiplication c=A*b
    *
@@ -153,6 +206,22 @@ namespace math {
       c = blitz::sum(a(j) * B(j,i), j);
     }
 
+  /**
+   * @brief Performs the vector-matrix multiplication c=a*B for double
+   * precision arrays, using the BLAS dgemv function whenever the layout of
+   * B allows it, and the generic blitz expression otherwise.
+   *
+   * @warning No checks are performed on the array sizes and is recommended
+   * only in scenarios where you have previously checked conformity and is
+   * focused only on speed.
+   *
+   * @param a The a vector (left element of the multiplication) (size M)
+   * @param B The B matrix (right element of the multiplication) (size MxN)
+   * @param c The resulting vector (size N)
+   */
+  void prod_(const blitz::Array<double,1>& a, const blitz::Array<double,2>& B,
+      blitz::Array<double,1>& c);
+
   /**
    * @brief Performs the vector-matrix multiplication c=a*B
    *
@@ -24,6 +24,8 @@
 #define BOB_MEASURE_ERROR_H
 
 #include <blitz/array.h>
+#include <algorithm>
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -120,14 +122,33 @@ namespace bob { namespace measure {
       return blitz::Array<bool,1>(negatives < threshold);
     }
 
+  /**
+   * Copies the scores into 'sorted', sorted ascendingly. Sorted scores allow
+   * the FA and FR ratios to be computed for any threshold by bisection (see
+   * sortedFarfrr()), so that curves and threshold searches only need to
+   * sort the scores once.
+   */
+  void sortScores(const blitz::Array<double,1>& scores,
+      std::vector<double>& sorted);
+
+  /**
+   * Calculates the FA ratio and the FR ratio, exactly as farfrr() does, but
+   * from scores sorted with sortScores(). This only costs
+   * O(log(#negatives) + log(#positives)).
+   */
+  std::pair<double, double> sortedFarfrr(
+      const std::vector<double>& sorted_negatives,
+      const std::vector<double>& sorted_positives, double threshold);
+
   /**
    * Recursively minimizes w.r.t. to the given predicate method. Please refer
    * to minimizingThreshold() for a full explanation. This method is only
    * supposed to be used through that method.
    */
   template <typename T>
-  static double recursive_minimization(const blitz::Array<double,1>& negatives,
-      const blitz::Array<double,1>& positives, T& predicate,
+  static double recursive_minimization(
+      const std::vector<double>& sorted_negatives,
+      const std::vector<double>& sorted_positives, T& predicate,
       double min, double max, size_t steps) {
     static const double QUIT_THRESHOLD = 1e-10;
     const double diff = max - min;
@@ -148,7 +169,7 @@ namespace bob { namespace measure {
       double threshold = ((double)i * step_size) + min;
 
       std::pair<double, double> ratios =
-        farfrr(negatives, positives, threshold);
+        sortedFarfrr(sorted_negatives, sorted_positives, threshold);
 
       double current_cost = predicate(ratios.first, ratios.second);
 
@@ -166,15 +187,35 @@ namespace bob { namespace measure {
     //we stop when it doesn't matter anymore to threshold.
     if (accumulator.size() != steps) {
       //still needs some refinement: pick-up the middle of the range and go
-      return recursive_minimization(negatives, positives, predicate,
-          accumulator[accumulator.size()/2]-step_size,
-          accumulator[accumulator.size()/2]+step_size,
-          steps);
+      return recursive_minimization(sorted_negatives, sorted_positives,
+          predicate, accumulator[accumulator.size()/2]-step_size,
+          accumulator[accumulator.size()/2]+step_size, steps);
     }
 
     return accumulator[accumulator.size()/2];
   }
 
+  /**
+   * Same as minimizingThreshold(), but from scores sorted with
+   * sortScores(). This is useful when several thresholds are computed on
+   * the same scores.
+   */
+  template <typename T> double
+    sortedMinimizingThreshold(const std::vector<double>& sorted_negatives,
+        const std::vector<double>& sorted_positives, T& predicate) {
+      const size_t N = 100; ///< number of steps in each iteration
+      //(same extrema as blitz::min() and blitz::max() for empty arrays)
+      const double huge = std::numeric_limits<double>::max();
+      double min = std::min(
+          sorted_negatives.empty() ? huge : sorted_negatives.front(),
+          sorted_positives.empty() ? huge : sorted_positives.front());
+      double max = std::max(
+          sorted_negatives.empty() ? -huge : sorted_negatives.back(),
+          sorted_positives.empty() ? -huge : sorted_positives.back());
+      return recursive_minimization(sorted_negatives, sorted_positives,
+          predicate, min, max, N);
+    }
+
   /**
    * This method can calculate a threshold based on a set of scores (positives
    * and negatives) given a certain minimization criteria, input as a
@@ -204,15 +245,18 @@ namespace bob { namespace measure {
    * The procedure continues until all calculated predicates in a given round
    * give the same minimum. At this point, the center threshold is picked up and
    * returned.
+   *
+   * The scores are sorted once, after which each threshold of each round
+   * is evaluated by bisection (see sortedFarfrr()).
    */
   template <typename T> double
     minimizingThreshold(const blitz::Array<double,1>& negatives,
         const blitz::Array<double,1>& positives, T& predicate) {
-      const size_t N = 100; ///< number of steps in each iteration
-      double min = std::min(blitz::min(negatives), blitz::min(positives));
-      double max = std::max(blitz::max(negatives), blitz::max(positives));
-      return recursive_minimization(negatives, positives, predicate, min,
-          max, N);
+      std::vector<double> sorted_negatives, sorted_positives;
+      sortScores(negatives, sorted_negatives);
+      sortScores(positives, sorted_positives);
+      return sortedMinimizingThreshold(sorted_negatives, sorted_positives,
+          predicate);
     }
 
   /**
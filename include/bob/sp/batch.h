@@ -0,0 +1,101 @@
+/**
+ * @file bob/sp/batch.h
+ * @date Fri Oct 16 14:21:05 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Batched FFT/DCT transforms, which apply the same transform to
+ * all the frames (rows of a 2D array) or blocks (2D slices of a 3D array)
+ * at once, using batched FFTW plans (of up to 64 transforms each).
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_SP_BATCH_H
+#define BOB_SP_BATCH_H
+
+#include <complex>
+#include <blitz/array.h>
+
+namespace bob { namespace sp {
+/**
+ * @ingroup SP
+ * @{
+ */
+
+/**
+ * @brief Computes the direct FFT of each row of src (one frame per row)
+ * @param src The input frames (size n_frames x length)
+ * @param dst The output spectra (size n_frames x length)
+ * @param n_threads The number of threads the frames are split across
+ */
+void fft1DBatch(const blitz::Array<std::complex<double>,2>& src,
+  blitz::Array<std::complex<double>,2>& dst, const size_t n_threads=1);
+
+/**
+ * @brief Computes the inverse FFT of each row of src (one frame per row)
+ * @param src The input spectra (size n_frames x length)
+ * @param dst The output frames (size n_frames x length)
+ * @param n_threads The number of threads the frames are split across
+ */
+void ifft1DBatch(const blitz::Array<std::complex<double>,2>& src,
+  blitz::Array<std::complex<double>,2>& dst, const size_t n_threads=1);
+
+/**
+ * @brief Computes the direct FFT of each row of a real input, using
+ * real-to-complex transforms. Only the non-redundant half of each spectrum
+ * is computed.
+ * @param src The input frames (size n_frames x length)
+ * @param dst The output half spectra (size n_frames x (length/2+1))
+ * @param n_threads The number of threads the frames are split across
+ */
+void rfft1DBatch(const blitz::Array<double,2>& src,
+  blitz::Array<std::complex<double>,2>& dst, const size_t n_threads=1);
+
+/**
+ * @brief Computes the inverse of rfft1DBatch(), using complex-to-real
+ * transforms.
+ * @param src The input half spectra (size n_frames x (length/2+1))
+ * @param dst The output frames (size n_frames x length)
+ * @param n_threads The number of threads the frames are split across
+ */
+void irfft1DBatch(const blitz::Array<std::complex<double>,2>& src,
+  blitz::Array<double,2>& dst, const size_t n_threads=1);
+
+/**
+ * @brief Computes the DCT of each block src(i,:,:), with the same
+ * normalization as DCT2D
+ * @param src The input blocks (size n_blocks x height x width)
+ * @param dst The output coefficients (size n_blocks x height x width)
+ * @param n_threads The number of threads the blocks are split across
+ */
+void dct2DBatch(const blitz::Array<double,3>& src,
+  blitz::Array<double,3>& dst, const size_t n_threads=1);
+
+/**
+ * @brief Computes the inverse DCT of each block src(i,:,:), with the same
+ * normalization as IDCT2D
+ * @param src The input coefficients (size n_blocks x height x width)
+ * @param dst The output blocks (size n_blocks x height x width)
+ * @param n_threads The number of threads the blocks are split across
+ */
+void idct2DBatch(const blitz::Array<double,3>& src,
+  blitz::Array<double,3>& dst, const size_t n_threads=1);
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_SP_BATCH_H */
@@ -0,0 +1,133 @@
+/**
+ * @file bob/sp/fftw.h
+ * @date Fri Oct 16 11:02:17 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Process-wide cache of FFTW plans, planning mode and wisdom
+ * management shared by the FFT/DCT classes.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_SP_FFTW_H
+#define BOB_SP_FFTW_H
+
+#include <complex>
+#include <string>
+#include <cstddef>
+
+namespace bob { namespace sp {
+/**
+ * @ingroup SP
+ * @{
+ */
+
+/**
+ * @brief The FFTW planner rigor used when a plan is not yet in the cache.
+ * Plans are cached per mode, so changing the mode only affects transforms
+ * of shapes which have not been planned with this mode yet.
+ */
+typedef enum {
+  FFTW_PLAN_ESTIMATE = 0,
+  FFTW_PLAN_MEASURE,
+  FFTW_PLAN_PATIENT,
+  FFTW_PLAN_EXHAUSTIVE
+} FFTWPlanningMode;
+
+/**
+ * @brief Sets the planner rigor used for the plans created from now on
+ */
+void setFFTWPlanningMode(const FFTWPlanningMode mode);
+
+/**
+ * @brief Gets the planner rigor used for the plans created from now on
+ */
+FFTWPlanningMode getFFTWPlanningMode();
+
+/**
+ * @brief Imports FFTW wisdom from the given file. Returns false if the
+ * file cannot be opened or does not contain valid wisdom.
+ */
+bool loadFFTWWisdom(const std::string& filename);
+
+/**
+ * @brief Exports the FFTW wisdom accumulated so far to the given file.
+ * Raises a std::runtime_error if the file cannot be written.
+ */
+void saveFFTWWisdom(const std::string& filename);
+
+/**
+ * @brief Destroys all the cached plans. Plans in use by transforms running
+ * concurrently remain valid until these transforms are over.
+ */
+void clearFFTWPlanCache();
+
+/**
+ * @brief Returns the number of plans currently in the cache
+ */
+size_t getFFTWPlanCacheSize();
+
+namespace detail {
+
+  /*
+   * The transforms below are executed by (cached) plans of power-of-two
+   * numbers of transforms, up to 64: the number of plans created for a
+   * given shape does not depend on the number of transforms requested.
+   */
+
+  /**
+   * @brief Executes howmany contiguous complex DFTs of the given rank and
+   * shape, using a cached plan (created on first use). sign is either
+   * FFTW_FORWARD or FFTW_BACKWARD. in and out may be equal (in-place
+   * transform).
+   */
+  void fftwDFT(const int rank, const int* n, const int howmany,
+    std::complex<double>* in, std::complex<double>* out, const int sign);
+
+  /**
+   * @brief Executes howmany contiguous real-to-real transforms of the given
+   * rank and shape, using a cached plan (created on first use). kinds
+   * contains one fftw_r2r_kind per dimension. in and out may be equal
+   * (in-place transform).
+   */
+  void fftwR2R(const int rank, const int* n, const int howmany, double* in,
+    double* out, const int* kinds);
+
+  /**
+   * @brief Executes howmany contiguous real-to-complex DFTs of the given
+   * rank and shape, using a cached plan (created on first use). Each output
+   * holds the n[0]x...x(n[rank-1]/2+1) non-redundant half of the spectrum.
+   * The transform cannot be performed in-place.
+   */
+  void fftwR2C(const int rank, const int* n, const int howmany, double* in,
+    std::complex<double>* out);
+
+  /**
+   * @brief Executes howmany contiguous complex-to-real (unnormalized
+   * inverse) DFTs of the given rank and shape, using a cached plan. The
+   * input is laid out as the output of fftwR2C().
+   * @warning As in FFTW, the input array is overwritten.
+   */
+  void fftwC2R(const int rank, const int* n, const int howmany,
+    std::complex<double>* in, double* out);
+
+}
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_SP_FFTW_H */
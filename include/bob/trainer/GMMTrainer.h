@@ -75,6 +75,11 @@ class GMMTrainer: public EMTrainer<bob::machine::GMMMachine, blitz::Array<double
      * and returns this in average_log_likelihood.
      * 
      * The statistics, m_ss, will be used in the mStep() that follows.
+     * If several threads are enabled (see setNThreads()), the data is
+     * split into contiguous chunks, each of them accumulated into its own
+     * GMMStats on its own thread. The statistics of the chunks are then
+     * summed in order, which makes the result reproducible for a given
+     * number of threads.
      * Implements EMTrainer::eStep(double &)
      */
     virtual void eStep(bob::machine::GMMMachine& gmm,
@@ -125,6 +130,20 @@ class GMMTrainer: public EMTrainer<bob::machine::GMMMachine, blitz::Array<double
      * E-step
      */
     void setGMMStats(const bob::machine::GMMStats& stats); 
+
+    /**
+     * @brief Returns the number of threads used by the E-step
+     */
+    size_t getNThreads() const
+    { return m_n_threads; }
+
+    /**
+     * @brief Sets the number of threads used by the E-step (1 by default).
+     * The statistics (and hence the trained machine) may differ by rounding
+     * errors from one number of threads to another.
+     */
+    void setNThreads(const size_t n_threads)
+    { m_n_threads = n_threads; }
      
   protected:
     /**
@@ -155,6 +174,11 @@ class GMMTrainer: public EMTrainer<bob::machine::GMMMachine, blitz::Array<double
      * because of numerical issue. This threshold is used to avoid such divisions.
      */
     double m_mean_var_update_responsibilities_threshold;
+
+    /**
+     * number of threads used by the E-step
+     */
+    size_t m_n_threads;
 };
 
 /**
@@ -24,6 +24,7 @@
 #include <bob/machine/KMeansMachine.h>
 #include <bob/trainer/EMTrainer.h>
 #include <boost/version.hpp>
+#include <vector>
 
 namespace bob { namespace trainer {
 /**
@@ -96,11 +97,27 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      * @brief The name for this trainer
      */
     virtual std::string name() const { return "KMeansTrainer"; }
+
+    /**
+     * @brief Trains the machine with the EM loop of EMTrainer::train().
+     * During this loop, the E-step maintains bounds on the distances from
+     * each sample to its closest and second closest means (Hamerly, "Making
+     * k-means even faster", SDM 2010), which allows it to skip the search
+     * over all the means for most of the samples once the means start to
+     * settle. The assignments are the same as the ones of the exhaustive
+     * search (up to ties between equidistant means).
+     */
+    virtual void train(bob::machine::KMeansMachine& kMeansMachine,
+      const blitz::Array<double,2>& sampler);
    
     /**
      * @brief Initialise the means randomly. 
      * Data is split into as many chunks as there are means, 
      * then each mean is set to a random example within each chunk.
+     * With KMEANS_PLUS_PLUS, the first mean is a random example, and each
+     * following one is drawn with a probability that increases with its
+     * distance to the closest mean selected so far (Arthur and 
+     * Vassilvitskii, "k-means++: the advantages of careful seeding", 2007).
      */
     virtual void initialize(bob::machine::KMeansMachine& kMeansMachine,
       const blitz::Array<double,2>& sampler);
@@ -109,6 +126,10 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      * @brief Accumulate across the dataset:
      * - zeroeth and first order statistics
      * - average (Square Euclidean) distance from the closest mean 
+     * If several threads are enabled (see setNThreads()), the data is split
+     * into contiguous chunks, each of them accumulated on its own thread.
+     * The statistics of the chunks are then summed in order, which makes
+     * the result reproducible for a given number of threads.
      * Implements EMTrainer::eStep(double &)
      */
     virtual void eStep(bob::machine::KMeansMachine& kmeans,
@@ -158,6 +179,22 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      * @brief Gets the initialization method used to generate the initial means
      */
     InitializationMethod getInitializationMethod() const { return m_initialization_method; }
+
+    /**
+     * @brief Returns the number of threads used by the E-step and by the
+     * K-Means++ initialization
+     */
+    size_t getNThreads() const
+    { return m_n_threads; }
+
+    /**
+     * @brief Sets the number of threads used by the E-step and by the
+     * K-Means++ initialization (1 by default). The statistics (and hence
+     * the trained machine) may differ by rounding errors from one number of
+     * threads to another.
+     */
+    void setNThreads(const size_t n_threads)
+    { m_n_threads = n_threads; }
   
     /**
      * @brief Returns the internal statistics. Useful to parallelize the E-step
@@ -203,6 +240,56 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      * equation 9.4, Bishop, "Pattern recognition and machine learning", 2006
      */
     blitz::Array<double,2> m_firstOrderStats;
+
+    /**
+     * @brief The number of threads used by the E-step and by the K-Means++
+     * initialization
+     */
+    size_t m_n_threads;
+
+  private:
+    /**
+     * @brief Statistics accumulated by the E-step over a chunk of samples
+     */
+    struct ChunkStats {
+      blitz::Array<double,1> zeroeth;
+      blitz::Array<double,2> first;
+      double sum_min_distance;
+    };
+
+    /**
+     * @brief Assigns the samples [start,start+count) to their closest
+     * mean and accumulates their statistics into stats[k], updating the
+     * distance bounds if use_bounds is set.
+     */
+    void eStepChunk(const bob::machine::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data, const bool use_bounds,
+      std::vector<ChunkStats>& stats, const int k, const int start,
+      const int count);
+
+    /**
+     * @brief Updates the distance bounds according to the drift of the
+     * means since the previous E-step. Returns false if the bounds cannot
+     * be used (first E-step, or non-finite means).
+     */
+    bool updateBounds(const bob::machine::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data);
+
+    /**
+     * @brief Distance bounds of the E-step, only maintained while train()
+     * runs: whether they are enabled and valid, the closest mean of each
+     * sample, an upper bound of the distance to this mean, a lower bound of
+     * the distance to any other mean, the means these bounds refer to, and
+     * half the distance from each mean to its closest other mean. Unlike
+     * the other distances of this class, these ones are not squared.
+     */
+    bool m_bounds_enabled;
+    bool m_bounds_valid;
+    blitz::Array<int,1> m_closest_mean;
+    blitz::Array<double,1> m_upper_bound;
+    blitz::Array<double,1> m_lower_bound;
+    blitz::Array<double,2> m_bound_means;
+    blitz::Array<double,1> m_half_min_separation;
 };
 
 /**
@@ -177,6 +177,21 @@ namespace bob { namespace trainer {
        */
       inline void setTrainBiases(bool v) { m_train_bias = v; }
 
+      /**
+       * @brief Returns the number of threads each batch is split across
+       */
+      size_t getNThreads() const { return m_n_threads; }
+
+      /**
+       * @brief Sets the number of threads each batch is split across (1 by
+       * default). Each thread forwards and back-propagates a contiguous
+       * chunk of the examples, and accumulates the derivatives of its chunk
+       * in its own buffers. These are summed in chunk order: results are
+       * reproducible for a given number of threads, and may differ by
+       * rounding errors from one number of threads to another.
+       */
+      void setNThreads(const size_t n_threads) { m_n_threads = n_threads; }
+
       /**
        * @brief Checks if a given machine is compatible with my inner settings.
        */
@@ -214,6 +229,15 @@ namespace bob { namespace trainer {
         const blitz::Array<double,2>& input,
         const blitz::Array<double,2>& target);
 
+      /**
+       * @brief Forward and backward steps at once -- same as calling
+       * forward_step() and then backward_step(), but the chunks of the batch
+       * are forwarded and back-propagated by the same threads.
+       */
+      void forward_backward_step(const bob::machine::MLP& machine,
+        const blitz::Array<double,2>& input,
+        const blitz::Array<double,2>& target);
+
       /**
        * @brief Calculates the cost for a given target. 
        *
@@ -303,11 +327,20 @@ namespace bob { namespace trainer {
        */
       void reset();
 
+      /**
+       * @brief Forwards (if forward is set) and back-propagates (if target
+       * is given) the batch, split in chunks across m_n_threads threads
+       */
+      void step(const bob::machine::MLP& machine,
+        const blitz::Array<double,2>& input,
+        const blitz::Array<double,2>* target, bool forward);
+
       /// training parameters:
       size_t m_batch_size; ///< the batch size
       boost::shared_ptr<bob::trainer::Cost> m_cost; ///< cost function to be minimized
       bool m_train_bias; ///< shall we be training biases? (default: true)
       size_t m_H; ///< number of hidden layers on the target machine
+      size_t m_n_threads; ///< number of threads each batch is split across
 
       std::vector<blitz::Array<double,2> > m_deriv; ///< derivatives of the cost wrt. the weights
       std::vector<blitz::Array<double,1> > m_deriv_bias; ///< derivatives of the cost wrt. the biases
@@ -315,6 +348,10 @@ namespace bob { namespace trainer {
       /// buffers that are dependent on the batch_size
       std::vector<blitz::Array<double,2> > m_error; ///< error (+deltas)
       std::vector<blitz::Array<double,2> > m_output; ///< layer output
+
+      /// derivatives of each chunk of the batch, when split across threads
+      std::vector<std::vector<blitz::Array<double,2> > > m_chunk_deriv;
+      std::vector<std::vector<blitz::Array<double,1> > > m_chunk_deriv_bias;
   };
 
   /**
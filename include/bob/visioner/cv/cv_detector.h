@@ -134,6 +134,8 @@ namespace bob { namespace visioner {
       // Getters and setters
       void set_scan_levels(uint64_t levels);
       uint64_t get_scan_levels() const { return m_levels; }
+      void set_scan_threads(uint64_t threads) { m_threads = threads; }
+      uint64_t get_scan_threads() const { return m_threads; }
 
       // Process detections
       static void sort_asc(std::vector<detection_t>& detections);
@@ -162,6 +164,21 @@ namespace bob { namespace visioner {
 
     private:
 
+      // Sub-windows scanned by a thread: thresholded detections + statistics
+      struct scan_t
+      {
+        scan_t() : m_sws(0), m_evals(0) {}
+
+        std::vector<detection_t> m_detections;
+        uint64_t        m_sws;
+        uint64_t        m_evals;
+      };
+
+      // Scan the range of sub-windows (indexed in the <scale, output, x, y>
+      //	order, see scan()) with the model of the given thread
+      void scan_mt(uint64_t ith, const std::pair<uint64_t, uint64_t>& range,
+          const std::vector<uint64_t>& sbegins, scan_t& result) const;
+
       static void threshold(std::vector<detection_t>& detections, double thres);
       static void cluster(std::vector<detection_t>& detections, double thres, uint64_t n_outputs);                 
 
@@ -184,6 +201,8 @@ namespace bob { namespace visioner {
       Matrix<uint64_t> m_lmodel_begins; ///< Level classifiers for each output:
       Matrix<uint64_t> m_lmodel_ends;   ///< [begin, end) LUT range
       uint64_t			m_levels;	       ///< number of levels (speed-up scanning)
+      uint64_t   m_threads;     ///< number of scanning threads (0: no thread)
+      mutable std::vector<boost::shared_ptr<Model> > m_tmodels; ///< Model copies of the scanning threads
       ipyramid_t  m_ipyramid;	     ///< Pyramid of images
       mutable stats_t m_stats;     ///< Scanning statistics
 
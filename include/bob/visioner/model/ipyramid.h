@@ -65,6 +65,7 @@ namespace bob { namespace visioner {
     public: //attributes
 
       Matrix<uint8_t>	m_image;	// Grayscale image
+      Matrix<uint32_t>	m_iimage;	// Integral image (empty if not computed by the pyramid)
       std::vector<Object>	m_objects;	// Ground truth data
 
       double	m_scale;	// Scale factor relative to the original image size		
@@ -79,7 +80,10 @@ namespace bob { namespace visioner {
   };
 
   /**
-   * A pyramid of scaled images.
+   * A pyramid of scaled images. Each level is downscaled from a larger level
+   * already built (not from the original image), and its integral image is
+   * computed once, so that several models can be evaluated on the same
+   * pyramid (e.g. detection then localization) read-only.
    */
   struct ipyramid_t : public Parametrizable {
 
@@ -120,6 +124,9 @@ namespace bob { namespace visioner {
 
     private:
 
+      // Build the scaled versions of the top of the pyramid (the original image)
+      void build(const std::vector<double>& scales);
+
       // Project a sub-window to another scale
       subwindow_t map(const subwindow_t& sw, int s, const param_t& param) const;
 
@@ -39,23 +39,54 @@ namespace bob { namespace visioner {
 
       // Constructor
       IIModel(const param_t& param = param_t())
-        :	Model(param)
+        :	Model(param), m_piimage(&m_iimage)
       {
       }
 
+      // Copy constructor & assignment operator (the integral image is not shared)
+      IIModel(const IIModel& other)
+        :	Model(other), m_iimage(other.m_iimage), m_piimage(&m_iimage)
+      {
+      }
+      IIModel& operator=(const IIModel& other)
+      {
+        Model::operator=(other);
+        m_iimage = other.m_iimage;
+        m_piimage = &m_iimage;
+        return *this;
+      }
+
       // Destructor
       virtual ~IIModel() {}
 
-      // Preprocess the current image
+      // Preprocess the current image:
+      //	the integral image computed by the pyramid is used directly (read-only) if available,
+      //	so it must outlive the calls to ::get() until the next ::preprocess().
       void preprocess(const ipscale_t& ipscale)
       {
-        integral(ipscale.m_image, m_iimage);
+        if (	ipscale.m_iimage.rows() == ipscale.rows() &&
+            ipscale.m_iimage.cols() == ipscale.cols() &&
+            ipscale.m_iimage.empty() == false)
+        {
+          m_piimage = &ipscale.m_iimage;
+        }
+        else
+        {
+          integral(ipscale.m_image, m_iimage);
+          m_piimage = &m_iimage;
+        }
       }
 
     protected:    
 
+      // Access functions
+      const Matrix<uint32_t>& iimage() const { return *m_piimage; }
+
+    private:
+
       // Attributes
-      Matrix<uint32_t>            m_iimage;       // Integral image
+      Matrix<uint32_t>            m_iimage;       // Integral image (if not provided by the pyramid)
+      const Matrix<uint32_t>*     m_piimage;      // Integral image in use
   };
 
 }}
@@ -26,92 +26,159 @@
 #define BOB_VISIONER_UTIL_THREADS_H
 
 #include <vector>
+#include <deque>
 
 #include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/exception_ptr.hpp>
 #include <boost/lambda/bind.hpp>
-#include <boost/shared_array.hpp>
 
 namespace bob { namespace visioner {
 
-  // Split some objects to process using multiple threads
+  // Long-lived pool of worker threads, shared by the thread_loop family.
+  //
+  // Each worker owns a queue of jobs: it runs its own jobs first (last in,
+  // first out) and steals the oldest jobs of the other workers when it runs
+  // out of work. A batch of tasks submitted with run() is processed by
+  // helper jobs pushed to the queues, which claim the tasks in order, and by
+  // the calling thread, which also runs other jobs while it waits. Batches
+  // can hence be submitted from within a task (nested loops) without
+  // deadlocking the pool.
+  class ThreadPool : private boost::noncopyable {
+
+    public:
+
+      // Access the process-wide pool (created with one worker per hardware
+      // thread on first use)
+      static ThreadPool& instance();
+
+      ~ThreadPool();
+
+      // Number of worker threads
+      size_t n_workers() const { return m_queues.size(); }
+
+      // Run the tasks on at most <num_of_threads> threads (including the
+      // calling thread) and return once they are all over. The first
+      // exception raised by a task is rethrown.
+      void run(const std::vector<boost::function<void()> >& tasks,
+          size_t num_of_threads);
+
+    private:
+
+      struct Batch;
+
+      // Job pushed to the queues of the workers
+      struct Job {
+        Job(): batch(0) {}
+        explicit Job(Batch* b): batch(b) {}
+        Batch* batch;
+      };
+
+      struct Queue {
+        boost::mutex mutex;
+        std::deque<Job> jobs;
+      };
+
+      explicit ThreadPool(size_t n_workers);
+
+      static void create();
+
+      void work(size_t worker);
+      bool pop(size_t first, Job& job);
+      void execute(const Job& job);
+      static void drain(Batch& batch);
+
+    private:
+
+      // Attributes
+      std::vector<Queue*>       m_queues;
+      boost::thread_group       m_threads;
+      boost::mutex              m_mutex;        // protects the counters below
+      boost::condition_variable m_cond;         // jobs pushed or batches over
+      size_t                    m_n_jobs;       // number of queued jobs
+      size_t                    m_next_queue;   // round-robin job placement
+      bool                      m_stop;
+  };
+
+  // Split some objects to process using multiple threads, in contiguous
+  // chunks of nearly equal sizes (none is empty if there are at least as
+  // many objects as threads)
   void thread_split(uint64_t n_objects, std::vector<uint64_t>& sbegins, 
       std::vector<uint64_t>& sends, size_t num_of_threads);
 
+  // Number of chunks a loop of the given size is split into, when
+  // scheduling it on <num_of_threads> threads of the pool: several chunks
+  // per thread balance uneven workloads.
+  uint64_t thread_chunks(uint64_t size, size_t num_of_threads);
+
   // Split a loop computation of the given size using multiple threads
   // NB: Stateless threads: op(<begin, end>)
   template <typename TOp> void thread_loop(TOp op, uint64_t size,
       size_t num_of_threads=boost::thread::hardware_concurrency()) {
-    
-    boost::shared_array<boost::thread> threads(new boost::thread[num_of_threads]);
-    std::vector<uint64_t> th_begins; th_begins.reserve(num_of_threads);
-    std::vector<uint64_t> th_ends; th_ends.reserve(num_of_threads);
 
-    thread_split(size, th_begins, th_ends, num_of_threads);		
+    const uint64_t n_chunks = thread_chunks(size, num_of_threads);
+    std::vector<uint64_t> th_begins; th_begins.reserve(n_chunks);
+    std::vector<uint64_t> th_ends; th_ends.reserve(n_chunks);
 
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      std::pair<uint64_t, uint64_t> range(th_begins[ith], th_ends[ith]);
-      boost::thread t(boost::bind(op, range));
-      threads[ith] = boost::move(t);
-    }
+    thread_split(size, th_begins, th_ends, n_chunks);
 
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      threads[ith].join();
+    std::vector<boost::function<void()> > tasks(n_chunks);
+    for (uint64_t ich = 0; ich < n_chunks; ich ++) {
+      std::pair<uint64_t, uint64_t> range(th_begins[ich], th_ends[ich]);
+      tasks[ich] = boost::bind(op, range);
     }
 
+    ThreadPool::instance().run(tasks, num_of_threads);
   }
 
   // Split a loop computation of the given size using multiple threads
   // NB: Stateless threads: op(thread_index, <begin, end>)
+  // NB: a single chunk per thread index, as the index may select some
+  //     per-thread state (e.g. random number generators).
   template <typename TOp> void thread_iloop(TOp op, uint64_t size,
       size_t num_of_threads=boost::thread::hardware_concurrency()) {
 
-    boost::shared_array<boost::thread> threads(new boost::thread[num_of_threads]);
     std::vector<uint64_t> th_begins; th_begins.reserve(num_of_threads);
     std::vector<uint64_t> th_ends; th_ends.reserve(num_of_threads);
 
     thread_split(size, th_begins, th_ends, num_of_threads);		
 
+    std::vector<boost::function<void()> > tasks(num_of_threads);
     for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
       std::pair<uint64_t, uint64_t> range(th_begins[ith], th_ends[ith]);
-      boost::thread t(boost::bind(op, ith, range));
-      threads[ith] = boost::move(t);
-    }
-
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      threads[ith].join();
+      tasks[ith] = boost::bind(op, ith, range);
     }
 
+    ThreadPool::instance().run(tasks, num_of_threads);
   }
 
   // Split a loop computation of the given size using multiple threads
-  // NB: State threads: op(<begin, end>, result&)
+  // NB: State threads: op(<begin, end>, result&), one result per chunk
   template <typename TOp, typename TResult> void thread_loop(TOp op, uint64_t size, std::vector<TResult>& results, size_t num_of_threads=boost::thread::hardware_concurrency()) {
 
-    boost::shared_array<boost::thread> threads(new boost::thread[num_of_threads]);
-    std::vector<uint64_t> th_begins; th_begins.reserve(num_of_threads);
-    std::vector<uint64_t> th_ends; th_ends.reserve(num_of_threads);
+    const uint64_t n_chunks = thread_chunks(size, num_of_threads);
+    std::vector<uint64_t> th_begins; th_begins.reserve(n_chunks);
+    std::vector<uint64_t> th_ends; th_ends.reserve(n_chunks);
 
-    thread_split(size, th_begins, th_ends, num_of_threads);		
+    thread_split(size, th_begins, th_ends, n_chunks);
 
-    results.resize(num_of_threads);
+    results.resize(n_chunks);
 
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      std::pair<uint64_t, uint64_t> range(th_begins[ith], th_ends[ith]);
-      boost::thread t(boost::bind(op, range, boost::ref(results[ith])));
-      threads[ith] = boost::move(t);
-    }
-
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      threads[ith].join();
+    std::vector<boost::function<void()> > tasks(n_chunks);
+    for (uint64_t ich = 0; ich < n_chunks; ich ++) {
+      std::pair<uint64_t, uint64_t> range(th_begins[ich], th_ends[ich]);
+      tasks[ich] = boost::bind(op, range, boost::ref(results[ich]));
     }
 
+    ThreadPool::instance().run(tasks, num_of_threads);
   }
 
   // Split a loop computation of the given size using multiple threads
   // NB: State threads: op(thread_index, <begin, end>, result&)
+  // NB: a single chunk per thread index (see thread_iloop above).
   template <typename TOp, typename TResult> void thread_iloop(TOp op, uint64_t size, std::vector<TResult>& results, size_t num_of_threads=boost::thread::hardware_concurrency()) {
 
-    boost::shared_array<boost::thread> threads(new boost::thread[num_of_threads]);
     std::vector<uint64_t> th_begins; th_begins.reserve(num_of_threads);
     std::vector<uint64_t> th_ends; th_ends.reserve(num_of_threads);
 
@@ -119,16 +186,13 @@ namespace bob { namespace visioner {
 
     results.resize(num_of_threads);
 
+    std::vector<boost::function<void()> > tasks(num_of_threads);
     for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
       std::pair<uint64_t, uint64_t> range(th_begins[ith], th_ends[ith]);
-      boost::thread t(boost::bind(op, ith, range, boost::ref(results[ith])));
-      threads[ith] = boost::move(t);
-    }
-
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      threads[ith].join();
+      tasks[ith] = boost::bind(op, ith, range, boost::ref(results[ith]));
     }
 
+    ThreadPool::instance().run(tasks, num_of_threads);
   }
 
 }}
@@ -43,6 +43,10 @@ namespace bob { namespace visioner {
   // Scale the image to a specific <scale> of the <src> source image
   bool scale(const Matrix<uint8_t>& src, double scale, Matrix<uint8_t>& dst);
 
+  // Downscale the <src> source image to <rows> x <cols> by averaging the source pixels
+  //  covered by each destination pixel (box filter), without going through <QImage>
+  bool downscale(const Matrix<uint8_t>& src, uint64_t rows, uint64_t cols, Matrix<uint8_t>& dst);
+
   // Convert from <Matrix<uint8_t>> to <QImage>
   QImage convert(const Matrix<uint8_t>& grays);
   bool convert(const QImage& qimage, Matrix<uint8_t>& grays);
@@ -231,6 +231,33 @@ def test_tensorfile():
   # complete transcoding test
   transcode(testutils.datafile('torch.tensor', __name__))
 
+def mapped_refer(extension, arrays):
+  """Checks arrays referring to memory-mapped files"""
+  tmpname = testutils.temporary_filename(suffix=extension)
+  try:
+    f = File(tmpname, 'w')
+    for k in arrays: f.append(k)
+    del f
+    f = File(tmpname, 'r')
+    g = File(tmpname, 'r') #shares the mapping
+    referred = [f.refer(k) for k in range(len(arrays))]
+    del f #the arrays keep the mapping alive
+    for k, array in enumerate(arrays):
+      assert numpy.array_equal(array, referred[k])
+      assert not referred[k].flags.writeable
+      assert numpy.array_equal(array, g.read(k))
+    nose.tools.assert_raises(RuntimeError, g.read, len(arrays))
+  finally:
+    if os.path.exists(tmpname): os.unlink(tmpname)
+
+@testutils.extension_available('.bindata')
+@testutils.extension_available('.tensor')
+def test_mapped_refer():
+
+  arrays = [numpy.random.normal(size=(7,)).astype('float32') for k in range(5)]
+  mapped_refer('.bindata', arrays)
+  mapped_refer('.tensor', arrays)
+
 @testutils.extension_available('.pgm')
 @testutils.extension_available('.pbm')
 @testutils.extension_available('.ppm')
@@ -284,3 +311,24 @@ def test_csv():
   arrayset_readwrite('.csv', a1, close=True)
   arrayset_readwrite(".csv", a2, close=True)
   arrayset_readwrite('.csv', a3, close=True)
+
+  # large files are scanned and parsed by blocks
+  a4 = numpy.random.normal(size=(40000,10)).astype('float64')
+  array_readwrite('.csv', a4, close=True)
+
+  # appends to an existing file
+  tmpname = testutils.temporary_filename(suffix='.csv')
+  try:
+    a5 = numpy.random.normal(size=(5,5)).astype('float64')
+    write(a5, tmpname)
+    f = File(tmpname, 'a')
+    assert len(f) == 5
+    f.append(a5[0])
+    assert numpy.allclose(a5[0], f.read(5))
+    del f
+    reloaded = load(tmpname)
+    assert reloaded.shape == (6,5)
+    assert numpy.allclose(a5, reloaded[:5])
+    assert numpy.allclose(a5[0], reloaded[5])
+  finally:
+    if os.path.exists(tmpname): os.unlink(tmpname)
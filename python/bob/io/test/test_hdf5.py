@@ -420,3 +420,103 @@ def test_append_compression():
   finally:
 
     os.unlink(tmpname)
+
+def test_chunked_read_range():
+
+  try:
+
+    tmpname = testutils.temporary_filename()
+    outfile = HDF5File(tmpname, 'w', cache_size=4*1024*1024)
+    assert outfile.cache_size == 4*1024*1024
+    outfile.chunk_size = 64*1024
+    assert outfile.chunk_size == 64*1024
+    data = numpy.random.random((500,20))
+    for k in range(len(data)): outfile.append('data', data[k])
+    for k in range(len(data)): outfile.append('scalars', data[k,0])
+    del outfile
+
+    infile = HDF5File(tmpname, 'r')
+    assert numpy.array_equal(data, infile.read('data'))
+    assert numpy.array_equal(data[100:350], infile.read_range('data', 100, 250))
+    assert numpy.array_equal(data[100:350,0], infile.read_range('scalars', 100, 250))
+    assert infile.read_range('data', 500, 0).shape == (0, 20)
+    nose.tools.assert_raises(RuntimeError, infile.read_range, 'data', 450, 51)
+
+  finally:
+
+    os.unlink(tmpname)
+
+def test_read_range_array():
+
+  try:
+
+    tmpname = testutils.temporary_filename()
+    outfile = HDF5File(tmpname, 'w')
+    vector = numpy.random.random((30,))
+    matrix = numpy.random.random((30,4))
+    column = numpy.random.random((30,1))
+    cube = numpy.random.random((30,3,2))
+    outfile.set('vector', vector)
+    outfile.set('matrix', matrix)
+    outfile.set('column', column)
+    outfile.set('cube', cube)
+    del outfile
+
+    # ranges of a single array are taken along its first dimension
+    infile = HDF5File(tmpname, 'r')
+    assert numpy.array_equal(vector[5:12], infile.read_range('vector', 5, 7))
+    assert numpy.array_equal(matrix[5:12], infile.read_range('matrix', 5, 7))
+    assert infile.read_range('column', 5, 7).shape == (7, 1)
+    assert numpy.array_equal(column[5:12], infile.read_range('column', 5, 7))
+    assert numpy.array_equal(cube[5:12], infile.read_range('cube', 5, 7))
+    assert infile.read_range('cube', 30, 0).shape == (0, 3, 2)
+    nose.tools.assert_raises(RuntimeError, infile.read_range, 'matrix', 25, 6)
+
+  finally:
+
+    os.unlink(tmpname)
+
+def test_cached_scalar_list():
+
+  try:
+
+    tmpname = testutils.temporary_filename()
+    outfile = HDF5File(tmpname, 'w')
+    data = numpy.random.random((5000,))
+    for k in range(len(data)): outfile.append('scalars', data[k])
+    del outfile
+
+    # scalar chunks are tiny: the cache must still open with a bounded table
+    infile = HDF5File(tmpname, 'r', cache_size=4*1024*1024)
+    assert numpy.array_equal(data, infile.read('scalars'))
+    assert infile.lread('scalars', 4321) == data[4321]
+    assert numpy.array_equal(data[10:20], infile.read_range('scalars', 10, 10))
+
+  finally:
+
+    os.unlink(tmpname)
+
+def test_lazy_group_access():
+
+  try:
+
+    tmpname = testutils.temporary_filename()
+    outfile = HDF5File(tmpname, 'w')
+    for k in range(20): outfile.set('group%02d/sub/data' % k, k)
+    del outfile
+
+    infile = HDF5File(tmpname, 'a')
+    assert infile.read('/group07/sub/data') == 7
+    infile.cd('/group13/sub')
+    assert infile.read('data') == 13
+    assert infile.has_group('/group19/sub')
+    assert not infile.has_group('/group20')
+    infile.cd('/')
+    assert len(infile.paths()) == 20
+    infile.unlink('/group03/sub/data')
+    assert '/group03/sub/data' not in infile
+    assert len(infile.paths()) == 19
+
+  finally:
+
+    os.unlink(tmpname)
@@ -61,6 +61,58 @@ def test_can_iterate():
 
   assert counter == len(video) #we have gone through all frames
 
+@testutils.ffmpeg_found()
+def test_can_prefetch():
+
+  # Decoding ahead of the reader, with several decoder threads, yields the
+  # same frames as the synchronous readout
+  from .. import VideoReader
+  reference = VideoReader(INPUT_VIDEO).load()
+  video = VideoReader(INPUT_VIDEO)
+  video.prefetch = 4
+  video.decoder_threads = 2
+  assert video.prefetch == 4
+  assert video.decoder_threads == 2
+  assert numpy.array_equal(video.load(), reference)
+
+  counter = 0
+  for frame_id, frame in enumerate(video):
+    assert numpy.array_equal(reference[frame_id], frame)
+    counter += 1
+  assert counter == len(video)
+
+  # Random access goes through keyframe seeks for long jumps
+  for k in (len(video)//2, len(video)-1):
+    assert numpy.array_equal(reference[k], video[k])
+
+@testutils.ffmpeg_found()
+def test_can_queue_frames():
+
+  # Frames encoded on a background thread are the same as those encoded by
+  # append()
+  from .. import VideoReader, VideoWriter
+  orig = VideoReader(INPUT_VIDEO)[:20]
+  (length, _, height, width) = orig.shape
+  fnames = [testutils.temporary_filename(suffix='.avi') for k in range(3)]
+
+  try:
+    for fname, threads, queue in zip(fnames, (1, 1, 2), (0, 4, 4)):
+      outv = VideoWriter(fname, height, width, encoder_threads=threads,
+          queue_size=queue)
+      assert outv.queue_size == queue
+      for k in orig: outv.append(k)
+      assert len(outv) == length
+      outv.close()
+
+    reference = VideoReader(fnames[0]).load()
+    assert len(reference) == length
+    assert numpy.array_equal(reference, VideoReader(fnames[1]).load())
+    assert len(VideoReader(fnames[2]).load()) == length
+
+  finally:
+    for fname in fnames:
+      if os.path.exists(fname): os.unlink(fname)
+
 @testutils.ffmpeg_found()
 def check_format_codec(function, shape, framerate, format, codec, maxdist):
 
@@ -24,6 +24,7 @@ import os, sys
 import unittest
 import bob
 import numpy
+import threading
 
 
 eps = 1e-4
@@ -94,3 +95,23 @@ class GaussianTest(unittest.TestCase):
     self.assertEqual(op1 != op4, True)
     self.assertEqual(op1 != op5, True)
     self.assertEqual(op1 != op6, True)
+
+  def test04_threads_smoke(self):
+    # Smoke test: filtering from several Python threads, each with its own
+    # Gaussian object, gives the same output as when run sequentially. This
+    # does not tell whether the threads actually ran concurrently.
+    n_threads = 4
+    images = [numpy.random.random_sample((256,256)) for k in range(n_threads)]
+    ops = [bob.ip.Gaussian(5,5,2.,2.) for k in range(n_threads)]
+    refs = [ops[k](images[k]) for k in range(n_threads)]
+
+    outputs = [numpy.ndarray(dtype=numpy.float64, shape=(256,256)) for k in range(n_threads)]
+    def run(k):
+      for i in range(3): ops[k](images[k], outputs[k])
+
+    threads = [threading.Thread(target=run, args=(k,)) for k in range(n_threads)]
+    for t in threads: t.start()
+    for t in threads: t.join()
+
+    for k in range(n_threads):
+      self.assertTrue(numpy.array_equal(outputs[k], refs[k]))
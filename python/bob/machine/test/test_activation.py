@@ -256,3 +256,35 @@ def test_4d_ndarray():
     assert is_close(op.f(x), Y_f.flat[k])
     assert is_close(op.f_prime(x), Y_f_prime.flat[k])
     assert is_close(op.f_prime_from_f(x), Y_f_prime_from_f.flat[k])
+
+def test_layer():
+
+  # matrices go through a single call for the whole array
+  X = numpy.random.rand(7, 5)
+  for op in (IdentityActivation(), LinearActivation(2.), \
+      HyperbolicTangentActivation(), \
+      MultipliedHyperbolicTangentActivation(2., 0.5), LogisticActivation()):
+
+    Y_f = op.f(X)
+    Y_f_prime_from_f = op.f_prime_from_f(X)
+
+    for k,x in enumerate(X.flat):
+      assert is_close(op.f(x), Y_f.flat[k])
+      assert is_close(op.f_prime_from_f(x), Y_f_prime_from_f.flat[k])
+
+def test_layer_inplace():
+
+  # the output may be the input itself
+  X = numpy.random.rand(7, 5)
+  for op in (IdentityActivation(), LinearActivation(2.), \
+      HyperbolicTangentActivation(), \
+      MultipliedHyperbolicTangentActivation(2., 0.5), LogisticActivation()):
+
+    Y_f = X.copy()
+    op.f(Y_f, Y_f)
+    Y_f_prime_from_f = X.copy()
+    op.f_prime_from_f(Y_f_prime_from_f, Y_f_prime_from_f)
+
+    for k,x in enumerate(X.flat):
+      assert is_close(op.f(x), Y_f.flat[k])
+      assert is_close(op.f_prime_from_f(x), Y_f_prime_from_f.flat[k])
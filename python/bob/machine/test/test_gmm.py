@@ -229,3 +229,30 @@ class GMMMachineTest(unittest.TestCase):
     # implementation
     matlab_ll_ref = -2.361583051672024e+02
     self.assertTrue( abs(gmm(data) - matlab_ll_ref) < 1e-10)
+
+  def test05_GMMMachine(self):
+    """Test a GMMMachine (batch log-likelihood and statistics)"""
+
+    arrayset = bob.io.load(F("faithful.torch3_f64.hdf5"))
+    gmm = bob.machine.GMMMachine(2, 2)
+    gmm.weights   = numpy.array([0.5, 0.5], 'float64')
+    gmm.means     = numpy.array([[3, 70], [4, 72]], 'float64')
+    gmm.variances = numpy.array([[1, 10], [2, 5]], 'float64')
+
+    # Log likelihoods of all the samples at once
+    ll = gmm.log_likelihood(arrayset)
+    self.assertEqual(ll.shape, (arrayset.shape[0],))
+    ll_ref = numpy.array([gmm.log_likelihood(x) for x in arrayset])
+    self.assertTrue( numpy.allclose(ll, ll_ref, rtol=1e-10, atol=1e-10) )
+
+    # Statistics accumulated at once vs. sample by sample
+    stats = bob.machine.GMMStats(2, 2)
+    gmm.acc_statistics(arrayset, stats)
+    stats_ref = bob.machine.GMMStats(2, 2)
+    for x in arrayset: gmm.acc_statistics(x, stats_ref)
+
+    self.assertTrue(stats.t == stats_ref.t)
+    self.assertTrue( abs(stats.log_likelihood - stats_ref.log_likelihood) < 1e-8 )
+    self.assertTrue( numpy.allclose(stats.n, stats_ref.n, rtol=1e-10, atol=1e-10) )
+    self.assertTrue( numpy.allclose(stats.sum_px, stats_ref.sum_px, rtol=1e-10, atol=1e-10) )
+    self.assertTrue( numpy.allclose(stats.sum_pxx, stats_ref.sum_pxx, rtol=1e-10, atol=1e-10) )
@@ -138,3 +138,13 @@ class LinearScoringTest(unittest.TestCase):
     self.assertTrue(abs(score - ref_scores_11[1,1]) < 1e-7)
     score = bob.machine.linear_scoring(model2.mean_supervector, ubm.mean_supervector, ubm.variance_supervector, stats3, test_channeloffset[2], True)
     self.assertTrue(abs(score - ref_scores_11[1,2]) < 1e-7)
+
+    # 4/ Split across threads and/or in single precision
+    scores = bob.machine.linear_scoring([model1, model2], ubm, [stats1, stats2, stats3], test_channeloffset, True, n_threads=2)
+    self.assertTrue((abs(scores - ref_scores_11) < 1e-7).all())
+    scores = bob.machine.linear_scoring([model1.mean_supervector, model2.mean_supervector], ubm.mean_supervector, ubm.variance_supervector, [stats1, stats2, stats3], n_threads=3)
+    self.assertTrue((abs(scores - ref_scores_00) < 1e-7).all())
+    scores = bob.machine.linear_scoring([model1, model2], ubm, [stats1, stats2, stats3], test_channeloffset, single_precision=True)
+    self.assertTrue((abs(scores - ref_scores_10) < 1e-5 * abs(ref_scores_10)).all())
+    scores = bob.machine.linear_scoring([model1.mean_supervector, model2.mean_supervector], ubm.mean_supervector, ubm.variance_supervector, [stats1, stats2, stats3], [], True, 2, True)
+    self.assertTrue((abs(scores - ref_scores_01) < 1e-5 * abs(ref_scores_01)).all())
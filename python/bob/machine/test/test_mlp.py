@@ -151,6 +151,21 @@ def test_100in_100_10_4out():
 
   X = numpy.random.rand(20,100)
   assert numpy.allclose(m(X), pymac.forward(X), rtol=1e-10, atol=1e-15)
+
+def test_batch_forward():
+
+  m = MLP((10,8,6,3))
+  m.randomize()
+  m.hidden_activation = LogisticActivation()
+  m.input_subtract = numpy.random.rand(10)
+  m.input_divide = 1. + numpy.random.rand(10)
+
+  # batches are forwarded by blocks of samples: compare to single samples
+  X = numpy.random.rand(600,10)
+  Y = m(X)
+  for k,x in enumerate(X):
+    assert numpy.allclose(m(x), Y[k], rtol=1e-10, atol=1e-15)
+
 def test_resize():
     
   m = MLP((2,3,5,1))
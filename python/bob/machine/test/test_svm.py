@@ -279,3 +279,31 @@ class SvmTest(unittest.TestCase):
     self.assertEqual(pred_labels, real_labels)
     self.assertTrue( numpy.all(abs(numpy.vstack(pred_probs) -
       numpy.vstack(real_probs)) < 1e-6) )
+
+  @utils.libsvm_available
+  def test07_dense_batch(self):
+
+    #the dense batch predictions should match libsvm's, up to rounding errors
+    for model, datafile in ((HEART_MACHINE, HEART_DATA), (IRIS_MACHINE,
+      IRIS_DATA)):
+      machine = bob.machine.SupportVector(model)
+      labels, data = bob.machine.SVMFile(datafile).read_all()
+      data = numpy.vstack(data)
+
+      ref_labels, ref_scores = machine.predict_classes_and_scores(data)
+      ref_scores = numpy.vstack(ref_scores)
+
+      for n_threads in (1, 3):
+        classes = machine.predict_classes_dense(data, n_threads=n_threads)
+        self.assertEqual( tuple(classes), ref_labels )
+
+        classes, scores = machine.predict_classes_and_scores_dense(data,
+            n_threads=n_threads)
+        self.assertEqual( tuple(classes), ref_labels )
+        self.assertEqual( scores.shape, (len(data),
+          machine.number_of_decision_values) )
+        self.assertTrue( numpy.allclose(scores, ref_scores, atol=1e-10) )
+
+        classes, scores = machine.predict_classes_and_scores_dense(data,
+            n_threads=n_threads, single_precision=True)
+        self.assertTrue( numpy.allclose(scores, ref_scores, atol=1e-3) )
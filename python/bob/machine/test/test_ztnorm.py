@@ -136,3 +136,19 @@ class ZTNormTest(unittest.TestCase):
     empty = numpy.zeros(shape=(0,0), dtype=numpy.float64)
     zA = bob.machine.ztnorm(my_A, my_B, empty, empty)
     self.assertTrue((abs(zA - zA_py) < 1e-7).all())
+
+  def test05_ztnorm_threads(self):
+    my_A = bob.io.load(F("ztnorm_eval_eval.mat"))
+    my_B = bob.io.load(F("ztnorm_znorm_eval.mat"))
+    my_C = bob.io.load(F("ztnorm_eval_tnorm.mat"))
+    my_D = bob.io.load(F("ztnorm_znorm_tnorm.mat"))
+
+    # The statistics and the normalisation are split across threads, but
+    # each score is computed in the same order
+    ref_scores = bob.io.load(F("ztnorm_result.mat"))
+    scores = bob.machine.ztnorm(my_A, my_B, my_C, my_D, n_threads=3)
+    self.assertTrue((abs(scores - ref_scores) < 1e-7).all())
+    self.assertTrue((scores == bob.machine.ztnorm(my_A, my_B, my_C, my_D)).all())
+
+    self.assertTrue((bob.machine.tnorm(my_A, my_C, n_threads=3) == bob.machine.tnorm(my_A, my_C)).all())
+    self.assertTrue((bob.machine.znorm(my_A, my_B, n_threads=3) == bob.machine.znorm(my_A, my_B)).all())
@@ -219,3 +219,25 @@ class TransformTest(unittest.TestCase):
 
       # call the test function
       _fft2D(M, N, t, 1e-3, self)
+
+  def test_fftw_wisdom(self):
+
+    # plans are cached, and the wisdom can be saved and loaded back
+    import tempfile
+    set_fftw_planning_mode(FFTWPlanningMode.MEASURE)
+    self.assertEqual(get_fftw_planning_mode(), FFTWPlanningMode.MEASURE)
+    t = numpy.array([random.uniform(1, 10) for i in range(64)], 'complex128')
+    _fft1D(64, t, 1e-3, self)
+    self.assertTrue(fftw_plan_cache_size() > 0)
+    set_fftw_planning_mode(FFTWPlanningMode.ESTIMATE)
+
+    (fd, filename) = tempfile.mkstemp('.wisdom')
+    os.close(fd)
+    try:
+      save_fftw_wisdom(filename)
+      clear_fftw_plan_cache()
+      self.assertEqual(fftw_plan_cache_size(), 0)
+      self.assertTrue(load_fftw_wisdom(filename))
+    finally:
+      os.unlink(filename)
+    self.assertFalse(load_fftw_wisdom(filename))
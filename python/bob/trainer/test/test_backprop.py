@@ -197,3 +197,34 @@ def test_20in_10_5_3out_with_momentum():
 
   for k in range(10):
     check_training(machine, cost, True, BATCH_SIZE, 0.1, 0.1)
+
+def test_20in_10_5_3out_threads():
+
+  machine = MLP((20, 10, 5, 3))
+  machine.randomize()
+  machine.hidden_activation = HyperbolicTangentActivation()
+  machine.output_activation = HyperbolicTangentActivation()
+  threaded_machine = MLP(machine)
+
+  BATCH_SIZE = 50
+  cost = SquareError(machine.output_activation)
+  X = numpy.random.rand(BATCH_SIZE, 20)
+  T = numpy.random.rand(BATCH_SIZE, 3)
+
+  trainer = MLPBackPropTrainer(BATCH_SIZE, cost, machine, True)
+  threaded_trainer = MLPBackPropTrainer(BATCH_SIZE, cost, threaded_machine, True)
+  threaded_trainer.n_threads = 4
+  assert threaded_trainer.n_threads == 4
+
+  # the batch is split across threads: same results, up to rounding errors
+  for i in range(10):
+    trainer.train(machine, X, T)
+    threaded_trainer.train(threaded_machine, X, T)
+    for k,D in enumerate(trainer.derivatives):
+      assert numpy.allclose(D, threaded_trainer.derivatives[k])
+    for k,D in enumerate(trainer.bias_derivatives):
+      assert numpy.allclose(D, threaded_trainer.bias_derivatives[k])
+  for k,W in enumerate(machine.weights):
+    assert numpy.allclose(W, threaded_machine.weights[k])
+  for k,B in enumerate(machine.biases):
+    assert numpy.allclose(B, threaded_machine.biases[k])
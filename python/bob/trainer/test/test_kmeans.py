@@ -197,3 +197,36 @@ class KMeansTest(unittest.TestCase):
     trainer.train(machine, data)
     self.assertFalse( numpy.isnan(machine.means).any())
 
+  def test04_kmeans_threads_and_bounds(self):
+
+    # Trains a KMeansMachine with several threads, and compares it with
+    # the plain (single-threaded, exhaustive) EM loop
+    data = bob.io.load(F("samplesFrom2G_f64.hdf5"))
+    data = numpy.vstack([data, data + 3., data - 7.])
+
+    def train(n_threads):
+      machine = bob.machine.KMeansMachine(6, 1)
+      trainer = bob.trainer.KMeansTrainer(0., 20, False)
+      trainer.rng = bob.core.random.mt19937(0)
+      trainer.n_threads = n_threads
+      trainer.train(machine, data)
+      return machine, trainer
+
+    machine1, trainer1 = train(1)
+    machine4, trainer4 = train(4)
+    self.assertTrue(equals(machine1.means, machine4.means, 1e-8))
+    self.assertTrue(equals(trainer1.zeroeth_order_statistics,
+      trainer4.zeroeth_order_statistics, 1e-8))
+
+    # train() prunes the search over the means with distance bounds, which
+    # should not change the assignments of the E-step
+    machine = bob.machine.KMeansMachine(6, 1)
+    trainer = bob.trainer.KMeansTrainer(0., 20, False)
+    trainer.rng = bob.core.random.mt19937(0)
+    trainer.initialize(machine, data)
+    trainer.e_step(machine, data)
+    for i in range(20):
+      trainer.m_step(machine, data)
+      trainer.e_step(machine, data)
+    self.assertTrue(equals(machine.means, machine1.means, 1e-8))
+    self.assertTrue((trainer.zeroeth_order_statistics == trainer1.zeroeth_order_statistics).all())
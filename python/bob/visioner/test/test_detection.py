@@ -38,6 +38,18 @@ def test_single():
   locdata = processor(ip.rgb_to_gray(io.load(IMAGE)))
   assert locdata is not None
 
+@utils.visioner_available
+def test_threads():
+
+  from .. import Detector
+  image = ip.rgb_to_gray(io.load(IMAGE))
+  processor = Detector(scanning_levels=10)
+  detections = processor(image)
+
+  # the sub-windows are split across threads, but merged in the same order
+  processor.scanning_threads = 3
+  assert processor(image) == detections
+
 @utils.visioner_available
 @utils.ffmpeg_found()
 def test_faster():
@@ -155,23 +155,26 @@ void bob::ap::Ceps::operator()(const blitz::Array<double,1>& input,
   int n_frames=feature_shape(0);
 
   blitz::Range r1(0,m_n_ceps-1);
-  for (int i=0; i<n_frames; ++i) 
+  // Update output with energy if required
+  if (m_with_energy)
   {
-    // Set padded frame to zero
-    extractNormalizeFrame(input, i, m_cache_frame_d);
-
-    // Update output with energy if required
-    if (m_with_energy)
+    for (int i=0; i<n_frames; ++i)
+    {
+      extractNormalizeFrame(input, i, m_cache_frame_d);
       ceps_matrix(i,(int)m_n_ceps) = logEnergy(m_cache_frame_d);
+    }
+  }
+
+  // Extract the frames, and take the power spectrum of the first part of
+  // their FFT
+  extractFrames(input, n_frames);
+  powerSpectrumFFT(m_cache_frames);
 
-    // Apply pre-emphasis
-    pre_emphasis(m_cache_frame_d);
-    // Apply the Hamming window
-    hammingWindow(m_cache_frame_d);
-    // Take the power spectrum of the first part of the FFT
-    powerSpectrumFFT(m_cache_frame_d);
+  for (int i=0; i<n_frames; ++i) 
+  {
+    blitz::Array<double,1> frame(m_cache_frames(i, blitz::Range::all()));
     // Filter with the triangular filter bank (either in linear or Mel domain)
-    filterBank(m_cache_frame_d);
+    filterBank(frame);
     // Apply DCT kernel and update the output 
     blitz::Array<double,1> ceps_matrix_row(ceps_matrix(i,r1));
     applyDct(ceps_matrix_row);
@@ -24,6 +24,7 @@
 #include <bob/core/check.h>
 #include <bob/core/assert.h>
 #include <bob/core/cast.h>
+#include <bob/sp/batch.h>
 
 bob::ap::Spectrogram::Spectrogram(const double sampling_frequency,
     const double win_length_ms, const double win_shift_ms,
@@ -33,7 +34,7 @@ bob::ap::Spectrogram::Spectrogram(const double sampling_frequency,
   m_n_filters(n_filters), m_f_min(f_min), m_f_max(f_max),
   m_pre_emphasis_coeff(pre_emphasis_coeff), m_mel_scale(mel_scale),
   m_fb_out_floor(1.), m_energy_filter(false), m_log_filter(true),
-  m_energy_bands(false), m_fft(1)
+  m_energy_bands(false)
 {
   // Check pre-emphasis coefficient
   if (pre_emphasis_coeff < 0. || pre_emphasis_coeff > 1.) {
@@ -58,7 +59,7 @@ bob::ap::Spectrogram::Spectrogram(const Spectrogram& other):
   m_pre_emphasis_coeff(other.m_pre_emphasis_coeff),
   m_mel_scale(other.m_mel_scale), m_fb_out_floor(other.m_fb_out_floor),
   m_energy_filter(other.m_energy_filter), m_log_filter(other.m_log_filter),
-  m_energy_bands(other.m_energy_bands), m_fft(other.m_fft)
+  m_energy_bands(other.m_energy_bands)
 {
   // Initialization
   initWinLength();
@@ -84,7 +85,6 @@ bob::ap::Spectrogram& bob::ap::Spectrogram::operator=(const bob::ap::Spectrogram
     m_energy_filter = other.m_energy_filter;
     m_log_filter = other.m_log_filter;
     m_energy_bands = other.m_energy_bands;
-    m_fft = other.m_fft;
 
     // Initialization
     initWinLength();
@@ -276,9 +276,6 @@ void bob::ap::Spectrogram::initWinLength()
 void bob::ap::Spectrogram::initWinSize()
 {
   bob::ap::Energy::initWinSize();
-  m_fft.reset(m_win_size);
-  m_cache_frame_c1.resize(m_win_size);
-  m_cache_frame_c2.resize(m_win_size);
 }
 
 void bob::ap::Spectrogram::pre_emphasis(blitz::Array<double,1> &data) const
@@ -300,17 +297,33 @@ void bob::ap::Spectrogram::hammingWindow(blitz::Array<double,1> &data) const
   data(r) *= m_hamming_kernel;
 }
 
-void bob::ap::Spectrogram::powerSpectrumFFT(blitz::Array<double,1>& x)
+void bob::ap::Spectrogram::extractFrames(const blitz::Array<double,1>& input,
+  const int n_frames)
 {
-  // Apply the FFT
-  m_cache_frame_c1 = bob::core::array::cast<std::complex<double> >(x);
-  m_fft(m_cache_frame_c1, m_cache_frame_c2);
+  m_cache_frames.resize(n_frames, m_win_size);
+  for (int i=0; i<n_frames; ++i)
+  {
+    blitz::Array<double,1> frame(m_cache_frames(i, blitz::Range::all()));
+    // Extract and normalize frame
+    extractNormalizeFrame(input, i, frame);
+    // Apply pre-emphasis
+    pre_emphasis(frame);
+    // Apply the Hamming window
+    hammingWindow(frame);
+  }
+}
+
+void bob::ap::Spectrogram::powerSpectrumFFT(blitz::Array<double,2>& frames)
+{
+  // Apply the FFT to all the frames at once (real input, only the first
+  // half of the spectrum is computed)
+  m_cache_spectra.resize(frames.extent(0), (int)m_win_size/2+1);
+  bob::sp::rfft1DBatch(frames, m_cache_spectra);
 
   // Take the the power spectrum of the first part of the output of the FFT
   blitz::Range r(0,(int)m_win_size/2);
-  blitz::Array<double,1> x_half(x(r));
-  blitz::Array<std::complex<double>,1> complex_half(m_cache_frame_c2(r));
-  x_half = blitz::abs(complex_half);
+  blitz::Array<double,2> x_half(frames(blitz::Range::all(), r));
+  x_half = blitz::abs(m_cache_spectra);
   if (m_energy_filter) // Apply the filter bank to the energy
     x_half = blitz::pow2(x_half);
 }
@@ -355,27 +368,24 @@ void bob::ap::Spectrogram::operator()(const blitz::Array<double,1>& input,
   blitz::Range r1 = blitz::Range(0,m_win_size/2);
   if (m_energy_bands)
     r1 = blitz::Range(0,m_n_filters-1);
+  // Extract the frames, and take the power spectrum of the first part of
+  // their FFT
+  extractFrames(input, n_frames);
+  powerSpectrumFFT(m_cache_frames);
+
   for (int i=0; i<n_frames; ++i)
   {
-    // Extract and normalize frame
-    extractNormalizeFrame(input, i, m_cache_frame_d);
-
-    // Apply pre-emphasis
-    pre_emphasis(m_cache_frame_d);
-    // Apply the Hamming window
-    hammingWindow(m_cache_frame_d);
-    // Take the power spectrum of the first part of the FFT
-    powerSpectrumFFT(m_cache_frame_d);
+    blitz::Array<double,1> frame(m_cache_frames(i, blitz::Range::all()));
 
     // Filter with the triangular filter bank (either in linear or Mel domain)
     if (m_energy_bands)
-      filterBank(m_cache_frame_d);
+      filterBank(frame);
 
     blitz::Array<double,1> spec_matrix_row(spectrogram_matrix(i,r1));
     if (m_energy_bands)
       spec_matrix_row = m_cache_filters(r1);
     else
-      spec_matrix_row = m_cache_frame_d(r1);
+      spec_matrix_row = frame(r1);
   }
 }
 
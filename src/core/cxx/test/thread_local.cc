@@ -0,0 +1,80 @@
+/**
+ * @file core/cxx/test/thread_local.cc
+ * @date Fri Oct 16 18:04:12 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Test the per-thread scratch space
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Core-thread_local Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <blitz/array.h>
+#include <bob/core/thread_local.h>
+
+namespace {
+  struct Scratch {
+    blitz::Array<double,1> a;
+    blitz::Array<double,2> b;
+  };
+
+  void getInstance(Scratch** instance) {
+    *instance = &bob::core::threadLocal<Scratch>();
+  }
+}
+
+BOOST_AUTO_TEST_SUITE( test_setup )
+
+BOOST_AUTO_TEST_CASE( test_thread_local_instance )
+{
+  // Same instance within a thread
+  Scratch& s = bob::core::threadLocal<Scratch>();
+  BOOST_CHECK_EQUAL( &s, &bob::core::threadLocal<Scratch>() );
+
+  // Distinct instances across threads
+  Scratch* other = 0;
+  boost::thread t(boost::bind(&getInstance, &other));
+  t.join();
+  BOOST_CHECK( other != 0 );
+  BOOST_CHECK( other != &s );
+}
+
+BOOST_AUTO_TEST_CASE( test_thread_local_ensure_extent )
+{
+  Scratch& s = bob::core::threadLocal<Scratch>();
+  bob::core::ensureExtent(s.a, 4);
+  bob::core::ensureExtent(s.b, 2, 3);
+  BOOST_CHECK_EQUAL( s.a.extent(0), 4 );
+  BOOST_CHECK_EQUAL( s.b.extent(0), 2 );
+  BOOST_CHECK_EQUAL( s.b.extent(1), 3 );
+  s.a = 1.;
+  const double* data = s.a.data();
+
+  // Same extent: no reallocation, the content is kept
+  bob::core::ensureExtent(s.a, 4);
+  BOOST_CHECK_EQUAL( s.a.data(), data );
+  BOOST_CHECK_EQUAL( s.a(3), 1. );
+
+  // Different extent: resized
+  bob::core::ensureExtent(s.a, 5);
+  BOOST_CHECK_EQUAL( s.a.extent(0), 5 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
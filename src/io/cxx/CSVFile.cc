@@ -21,21 +21,197 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
-#include <boost/filesystem.hpp>
 #include <boost/make_shared.hpp>
-#include <boost/tokenizer.hpp>
-
-#include <boost/shared_array.hpp>
-#include <boost/algorithm/string.hpp>
+#include <boost/thread.hpp>
 
+#include <bob/core/parallel.h>
 #include <bob/io/CodecRegistry.h>
+#include <bob/io/MappedFile.h>
+
+/**
+ * Files are scanned and parsed in blocks of this many bytes, and only files
+ * larger than s_parallel_size bytes are processed with several threads.
+ */
+static const size_t s_block_size = 1 << 20;
+static const size_t s_parallel_size = 4 << 20;
+
+/**
+ * Appended lines are written to the file once they take this many bytes
+ */
+static const size_t s_flush_size = 1 << 20;
+
+/**
+ * The number of threads used to process a file of the given size
+ */
+static size_t csv_threads(size_t size) {
+  if (size < s_parallel_size) return 1;
+  return std::max(1U, boost::thread::hardware_concurrency());
+}
+
+/**
+ * Returns the end of the line starting at p: its newline, or the end of the
+ * data.
+ */
+static const char* line_end(const char* p, const char* end) {
+  const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  return nl ? nl : end;
+}
+
+/**
+ * Returns the end of the entry starting at p: the next separator outside
+ * quotes, or the end of the line. Follows boost::escaped_list_separator:
+ * separators are commas, entries may be quoted with double quotes and
+ * characters may be escaped with a backslash.
+ */
+static const char* entry_end(const char* p, const char* end) {
+  bool quoted = false;
+  for (; p < end; ++p) {
+    if (*p == '\\') { if (p + 1 < end) ++p; }
+    else if (*p == '"') quoted = !quoted;
+    else if (*p == ',' && !quoted) break;
+  }
+  return p;
+}
+
+/**
+ * Counts the entries of the line [begin, end)
+ */
+static size_t count_entries(const char* begin, const char* end) {
+  size_t entries = 1;
+  for (const char* p = entry_end(begin, end); p < end;
+      p = entry_end(p + 1, end)) ++entries;
+  return entries;
+}
+
+/**
+ * Parses the line [begin, end), which holds the given number of entries,
+ * into out. Entries are converted in place (without any intermediate string)
+ * after removing surrounding blanks and quotes.
+ */
+static void parse_entries(const char* begin, const char* end, double* out,
+    size_t entries, size_t line, const std::string& filename) {
+
+  char number[64];
+  const char* p = begin;
+  for (size_t k=0; k<entries; ++k) {
+
+    const char* e = entry_end(p, end);
+    if (k + 1 < entries && e == end) {
+      boost::format m("line %d at file '%s' contains %d entries instead of %d (expected)");
+      m % (line+1) % filename % (k+1) % entries;
+      throw std::runtime_error(m.str());
+    }
+
+    const char* b = p;
+    const char* t = e;
+    while (b < t && (*b == ' ' || *b == '\t' || *b == '"')) ++b;
+    while (t > b && (t[-1] == ' ' || t[-1] == '\t' || t[-1] == '\r' ||
+          t[-1] == '"')) --t;
+
+    //strtod() needs a terminated string, which the (mapped) data is not
+    const size_t length = t - b;
+    char* parsed = number;
+    if (length && length < sizeof(number)) {
+      std::memcpy(number, b, length);
+      number[length] = 0;
+      out[k] = std::strtod(number, &parsed);
+    }
+    if (parsed != number + length || !length) {
+      boost::format m("cannot convert entry %d (`%s') of line %d at file '%s' to a number");
+      m % (k+1) % std::string(b, t) % (line+1) % filename;
+      throw std::runtime_error(m.str());
+    }
+
+    p = e + 1;
+  }
+
+  if (p <= end) {
+    boost::format m("line %d at file '%s' contains more than %d entries (expected)");
+    m % (line+1) % filename % entries;
+    throw std::runtime_error(m.str());
+  }
+}
 
-typedef boost::tokenizer<boost::escaped_list_separator<char> > Tokenizer;
+/**
+ * Formats an entry the way std::ostream does with a precision of 10, in
+ * scientific notation
+ */
+static void format_entry(double value, std::string& out) {
+  char number[32];
+  int length = std::snprintf(number, sizeof(number), "%.10e", value);
+  out.append(number, length);
+}
+
+/**
+ * The lines starting in a range of blocks of a file, and their number of
+ * entries, as found by ScanChunk.
+ */
+struct ScannedLines {
+  std::vector<size_t> starts; ///< offsets of the lines
+  size_t entries; ///< entries of the first line
+  size_t bad_line; ///< first line with a different number of entries
+  size_t bad_entries; ///< entries of that line
+};
+
+/**
+ * Finds the lines starting in blocks [start, start+count) of the data, and
+ * checks they all hold the same number of entries. A line belongs to the
+ * block its first character lies in.
+ */
+struct ScanChunk {
+  ScanChunk(const char* data, size_t size, std::vector<ScannedLines>& lines):
+    m_data(data), m_size(size), m_lines(&lines) {}
+  void operator()(const int k, const int start, const int count) const {
+    ScannedLines& r = (*m_lines)[k];
+    r.entries = 0;
+    r.bad_line = r.bad_entries = 0;
+    const char* end = m_data + m_size;
+    const char* block_end = m_data +
+      std::min(m_size, (start + count) * s_block_size);
+    const char* p = m_data + start * s_block_size;
+    if (p > m_data && p[-1] != '\n') {
+      p = line_end(p, end);
+      if (p < end) ++p;
+    }
+    while (p < block_end) {
+      const char* e = line_end(p, end);
+      const size_t entries = count_entries(p, e);
+      if (r.starts.empty()) r.entries = entries;
+      else if (entries != r.entries && !r.bad_entries) {
+        r.bad_line = r.starts.size();
+        r.bad_entries = entries;
+      }
+      r.starts.push_back(p - m_data);
+      if (e == end) break;
+      p = e + 1;
+    }
+  }
+  const char* m_data;
+  size_t m_size;
+  std::vector<ScannedLines>* m_lines;
+};
+
+class CSVFile;
+
+/**
+ * Parses lines [start, start+count) of a mapped file into consecutive rows
+ * of an array
+ */
+struct ParseChunk {
+  ParseChunk(const CSVFile& file, double* out): m_file(&file), m_out(out) {}
+  void operator()(const int, const int start, const int count) const;
+  const CSVFile* m_file;
+  double* m_out;
+};
 
 class CSVFile: public bob::io::File {
 
@@ -44,37 +220,52 @@ class CSVFile: public bob::io::File {
     /**
      * Peeks the file contents for a type. We assume the element type to be
      * always doubles. This method, effectively, only peaks for the total
-     * number of lines and the number of columns in the file.
+     * number of lines and the number of columns in the file. The offset of
+     * each line is recorded, so lines can be parsed independently later on.
+     *
+     * The file is scanned through a (shared) memory mapping, in blocks
+     * processed in parallel for large files.
      */
     void peek() {
 
-      std::string line;
-      size_t line_number = 0;
+      m_mapping = bob::io::detail::MappedFile::open(m_filename);
+      m_size = m_mapping->size();
+      const char* data = m_mapping->data();
+
+      const int n_blocks = (m_size + s_block_size - 1) / s_block_size;
+      std::vector<ScannedLines> lines(bob::core::getNChunks(n_blocks,
+            csv_threads(m_size)));
+      bob::core::parallelChunks(n_blocks, csv_threads(m_size),
+          ScanChunk(data, m_size, lines));
+
       size_t entries = 0;
-      std::streampos cur_pos = 0;
-
-      m_file.seekg(0); //< returns to the begin of file and start reading...
-
-      while (std::getline(m_file,line)) {
-        ++line_number;
-        m_pos.push_back(cur_pos);
-        cur_pos = m_file.tellg();
-        Tokenizer tok(line);
-        size_t size = std::distance(tok.begin(), tok.end());
-        if (!entries) entries = size;
-        else if (entries != size) {
+      m_pos.clear();
+      for (size_t k=0; k<lines.size(); ++k) {
+        if (lines[k].starts.empty()) continue;
+        if (!entries) entries = lines[k].entries;
+        size_t bad_line = m_pos.size();
+        size_t bad_entries = lines[k].entries;
+        if (bad_entries == entries && lines[k].bad_entries) {
+          bad_line += lines[k].bad_line;
+          bad_entries = lines[k].bad_entries;
+        }
+        if (bad_entries != entries) {
           boost::format m("line %d at file '%s' contains %d entries instead of %d (expected)");
-          m % line_number % m_filename % size % entries;
+          m % (bad_line+1) % m_filename % bad_entries % entries;
           throw std::runtime_error(m.str());
         }
+        m_pos.insert(m_pos.end(), lines[k].starts.begin(),
+            lines[k].starts.end());
       }
+      m_mapped = m_pos.size();
 
-      if (!line_number) {
+      if (!m_mapped) {
         m_newfile = true;
-        m_pos.clear();
         return;
       }
 
+      m_newline = (data[m_size-1] != '\n');
+
       m_arrayset_type.dtype = bob::core::array::t_float64;
       m_arrayset_type.nd = 1;
       m_arrayset_type.shape[0] = entries;
@@ -89,11 +280,14 @@ class CSVFile: public bob::io::File {
 
     CSVFile(const std::string& path, char mode):
       m_filename(path),
-      m_newfile(false) {
+      m_newfile(false),
+      m_size(0),
+      m_mapped(0),
+      m_newline(false) {
 
         if (mode == 'r' || (mode == 'a' && boost::filesystem::exists(path))) { //try peeking
-          
-          if (mode == 'r') 
+
+          if (mode == 'r')
             m_file.open(m_filename.c_str(), std::ios::in);
           else if (mode == 'a')
             m_file.open(m_filename.c_str(), std::ios::app|std::ios::in|std::ios::out);
@@ -107,7 +301,7 @@ class CSVFile: public bob::io::File {
         }
         else {
           m_file.open(m_filename.c_str(), std::ios::trunc|std::ios::in|std::ios::out);
-          
+
           if (!m_file.is_open()) {
             boost::format m("cannot open file '%s' for writing");
             m % path;
@@ -117,13 +311,11 @@ class CSVFile: public bob::io::File {
           m_newfile = true;
         }
 
-        //general precision settings, in case output is needed...
-        m_file.precision(10);
-        m_file.setf(std::ios_base::scientific, std::ios_base::floatfield);
-
       }
 
-    virtual ~CSVFile() { }
+    virtual ~CSVFile() {
+      flush();
+    }
 
     virtual const std::string& filename() const {
       return m_filename;
@@ -151,17 +343,11 @@ class CSVFile: public bob::io::File {
 
       if (!buffer.type().is_compatible(m_array_type)) buffer.set(m_array_type);
 
-      //read contents
-      std::string line;
-      if (m_file.eof()) m_file.clear(); ///< clear current "end" state.
-      m_file.seekg(0);
       double* p = static_cast<double*>(buffer.ptr());
-      while (std::getline(m_file, line)) {
-        Tokenizer tok(line);
-        for(Tokenizer::iterator k=tok.begin(); k!=tok.end(); ++k) {
-          std::istringstream(*k) >> *(p++);
-        }
-      }
+      bob::core::parallelChunks(m_mapped, csv_threads(m_size),
+          ParseChunk(*this, p));
+      for (size_t k=m_mapped; k<m_pos.size(); ++k)
+        read_line(k, p + k*m_arrayset_type.shape[0]);
     }
 
     virtual void read(bob::core::array::interface& buffer, size_t index) {
@@ -169,7 +355,7 @@ class CSVFile: public bob::io::File {
       if (m_newfile)
         throw std::runtime_error("uninitialized CSV file cannot be read");
 
-      if (!buffer.type().is_compatible(m_arrayset_type)) 
+      if (!buffer.type().is_compatible(m_arrayset_type))
         buffer.set(m_arrayset_type);
 
       if (index >= m_pos.size()) {
@@ -178,20 +364,7 @@ class CSVFile: public bob::io::File {
         throw std::runtime_error(m.str());
       }
 
-      //reads a specific line from the file.
-      std::string line;
-      if (m_file.eof()) m_file.clear(); ///< clear current "end" state.
-      m_file.seekg(m_pos[index]);
-      if (!std::getline(m_file, line)) {
-        boost::format m("could not seek to line %u (offset %u) while reading file '%s'");
-        m % index % m_pos[index] % m_filename;
-        throw std::runtime_error(m.str());
-      }
-      Tokenizer tok(line);
-      double* p = static_cast<double*>(buffer.ptr());
-      for(Tokenizer::iterator k=tok.begin(); k!=tok.end(); ++k) {
-        std::istringstream(*k) >> *(p++);
-      }
+      read_line(index, static_cast<double*>(buffer.ptr()));
 
     }
 
@@ -207,6 +380,7 @@ class CSVFile: public bob::io::File {
         }
         m_pos.clear();
         m_arrayset_type = m_array_type = type;
+        m_array_type.nd = 2;
         m_array_type.shape[1] = m_arrayset_type.shape[0];
         m_newfile = false;
       }
@@ -222,11 +396,18 @@ class CSVFile: public bob::io::File {
 
       }
 
+      //lines are gathered in memory, and written in batches
       const double* p = static_cast<const double*>(buffer.ptr());
-      if (m_pos.size()) m_file << std::endl; ///< adds a new line
-      m_pos.push_back(m_file.tellp()); ///< register start of line
-      for (size_t k=1; k<type.shape[0]; ++k) m_file << *(p++) << ",";
-      m_file << *(p++);
+      if (m_newline) write_pending("\n"); ///< adds a new line
+      m_pos.push_back(m_size); ///< register start of line
+      std::string line;
+      for (size_t k=1; k<type.shape[0]; ++k) {
+        format_entry(*(p++), line);
+        line += ',';
+      }
+      format_entry(*(p++), line);
+      write_pending(line);
+      m_newline = true;
       m_array_type.shape[0] = m_pos.size();
       m_array_type.update_strides();
       return (m_pos.size()-1);
@@ -244,13 +425,20 @@ class CSVFile: public bob::io::File {
           throw std::runtime_error(m.str());
         }
         const double* p = static_cast<const double*>(buffer.ptr());
-        for (size_t l=1; l<type.shape[0]; ++l) {
-          m_pos.push_back(m_file.tellp());
-          for (size_t k=1; k<type.shape[1]; ++k) m_file << *(p++) << ",";
-          m_file << *(p++) << std::endl;
+        std::string line;
+        for (size_t l=0; l<type.shape[0]; ++l) {
+          if (l) write_pending("\n");
+          m_pos.push_back(m_size);
+          line.clear();
+          for (size_t k=1; k<type.shape[1]; ++k) {
+            format_entry(*(p++), line);
+            line += ',';
+          }
+          format_entry(*(p++), line);
+          write_pending(line);
         }
-        for (size_t k=1; k<type.shape[1]; ++k) m_file << *(p++) << ",";
-        m_file << *(p++);
+        flush();
+        m_newline = true;
         m_arrayset_type = type;
         m_arrayset_type.nd = 1;
         m_arrayset_type.shape[0] = type.shape[1];
@@ -265,18 +453,87 @@ class CSVFile: public bob::io::File {
 
     }
 
+    /**
+     * Parses the given line, which lies in the mapping of the file, into
+     * out. Does not change the state of this object.
+     */
+    void parse_mapped(size_t index, double* out) const {
+      const char* data = m_mapping->data();
+      const char* begin = data + m_pos[index];
+      parse_entries(begin, line_end(begin, data + m_mapping->size()), out,
+          m_arrayset_type.shape[0], index, m_filename);
+    }
+
+  private: //api
+
+    /**
+     * Parses the given line into out: from the mapping if possible, or from
+     * the file itself, for lines appended after it was mapped.
+     */
+    void read_line(size_t index, double* out) {
+      if (index < m_mapped) {
+        parse_mapped(index, out);
+        return;
+      }
+
+      flush();
+      if (m_file.eof()) m_file.clear(); ///< clear current "end" state.
+      m_file.seekg(m_pos[index]);
+      if (!std::getline(m_file, m_line)) {
+        boost::format m("could not seek to line %u (offset %u) while reading file '%s'");
+        m % index % m_pos[index] % m_filename;
+        throw std::runtime_error(m.str());
+      }
+      parse_entries(m_line.data(), m_line.data() + m_line.size(), out,
+          m_arrayset_type.shape[0], index, m_filename);
+    }
+
+    /**
+     * Adds data to the end of the file, through the batch of pending writes
+     */
+    void write_pending(const std::string& data) {
+      m_pending += data;
+      m_size += data.size();
+      if (m_pending.size() >= s_flush_size) flush();
+    }
+
+    /**
+     * Writes the pending data to the file
+     */
+    void flush() {
+      if (m_pending.empty()) return;
+      m_file.clear();
+      m_file.seekp(0, std::ios::end);
+      m_file.write(m_pending.data(), m_pending.size());
+      m_file.flush();
+      m_pending.clear();
+    }
+
   private: //representation
     std::fstream m_file;
     std::string m_filename;
     bool m_newfile;
     bob::core::array::typeinfo m_array_type;
     bob::core::array::typeinfo m_arrayset_type;
-    std::vector<std::streampos> m_pos; ///< dictionary of line starts
+    std::vector<size_t> m_pos; ///< dictionary of line starts
+    size_t m_size; ///< size of the file, including pending writes
+    boost::shared_ptr<bob::io::detail::MappedFile> m_mapping;
+    size_t m_mapped; ///< number of lines lying in the mapping
+    bool m_newline; ///< if the next line appended needs a new line first
+    std::string m_pending; ///< appended data not written yet
+    std::string m_line; ///< lines read from the file, not from the mapping
 
     static std::string s_codecname;
 
 };
 
+void ParseChunk::operator()(const int, const int start,
+    const int count) const {
+  const size_t entries = m_file->type().shape[0];
+  for (int k=start; k<start+count; ++k)
+    m_file->parse_mapped(k, m_out + k*entries);
+}
+
 std::string CSVFile::s_codecname = "bob.csv";
 
 /**
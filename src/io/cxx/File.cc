@@ -21,3 +21,7 @@
 #include <bob/io/File.h>
 
 bob::io::File::~File() { }
+
+void bob::io::File::refer(bob::core::array::interface& buffer, size_t index) {
+  read(buffer, index);
+}
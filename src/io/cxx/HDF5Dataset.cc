@@ -20,6 +20,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/shared_array.hpp>
@@ -49,7 +50,8 @@ static void delete_h5dataset (hid_t* p) {
 }
 
 static boost::shared_ptr<hid_t> open_dataset
-(boost::shared_ptr<bob::io::detail::hdf5::Group>& par, const std::string& name) {
+(boost::shared_ptr<bob::io::detail::hdf5::Group>& par, const std::string& name,
+ hid_t dapl=H5P_DEFAULT) {
   if (!name.size() || name == "." || name == "..") {
     boost::format m("Cannot open dataset with illegal name `%s' at `%s:%s'");
     m % name % par->file()->filename() % par->path();
@@ -58,7 +60,7 @@ static boost::shared_ptr<hid_t> open_dataset
 
   boost::shared_ptr<hid_t> retval(new hid_t(-1),
       std::ptr_fun(delete_h5dataset));
-  *retval = H5Dopen2(*par->location(), name.c_str(), H5P_DEFAULT);
+  *retval = H5Dopen2(*par->location(), name.c_str(), dapl);
   if (*retval < 0) {
     throw status_error("H5Dopen2", *retval);
   }
@@ -113,6 +115,79 @@ static boost::shared_ptr<hid_t> open_plist(hid_t classid) {
   return retval;
 }
 
+/**
+ * Returns the size, in bytes, of a chunk of a dataset, or zero if it is not
+ * chunked.
+ */
+static size_t get_chunk_bytes(const boost::shared_ptr<hid_t>& ds) {
+  boost::shared_ptr<hid_t> dcpl(new hid_t(-1), std::ptr_fun(delete_h5plist));
+  *dcpl = H5Dget_create_plist(*ds);
+  if (*dcpl < 0) throw status_error("H5Dget_create_plist", *dcpl);
+  if (H5Pget_layout(*dcpl) != H5D_CHUNKED) return 0;
+
+  int rank = H5Pget_chunk(*dcpl, 0, 0);
+  if (rank < 0) throw status_error("H5Pget_chunk", rank);
+  bob::io::HDF5Shape chunk(rank);
+  rank = H5Pget_chunk(*dcpl, rank, chunk.get());
+  if (rank < 0) throw status_error("H5Pget_chunk", rank);
+
+  return chunk.product() * H5Tget_size(*open_datatype(ds));
+}
+
+/**
+ * The default size of the HDF5 raw data chunk cache (1 MiB)
+ */
+static const size_t DEFAULT_CHUNK_CACHE = 1048576;
+
+/**
+ * The maximum number of hash table slots of a chunk cache (a prime)
+ */
+static const size_t MAX_CHUNK_CACHE_SLOTS = 10007;
+
+/**
+ * Returns the number of hash table slots of a chunk cache holding a given
+ * number of chunks. HDF5 advises a prime number, at least 10 times the
+ * number of chunks to limit collisions. The table is allocated for each open
+ * dataset, so we stay at this lower bound and cap it: datasets with tiny
+ * chunks (e.g. lists of scalars) would otherwise get millions of slots.
+ */
+static size_t chunk_cache_slots(size_t chunks) {
+  size_t n = std::max<size_t>(521, 10*chunks); //521 is HDF5's default
+  n = std::min(n, MAX_CHUNK_CACHE_SLOTS);
+  for (;; ++n) {
+    bool prime = true;
+    for (size_t d=2; d*d<=n && prime; ++d) prime = (n % d) != 0;
+    if (prime) return n;
+  }
+}
+
+/**
+ * Opens a dataset, sizing its raw data chunk cache after the settings of the
+ * file: if no size was set, chunks that do not fit in the default cache
+ * would be read from disk (and decompressed) again on every access, so the
+ * cache is then enlarged to hold one chunk.
+ */
+static boost::shared_ptr<hid_t> open_cached_dataset
+(boost::shared_ptr<bob::io::detail::hdf5::Group>& par, const std::string& name) {
+  boost::shared_ptr<hid_t> retval = open_dataset(par, name);
+
+  size_t chunk_bytes = get_chunk_bytes(retval);
+  if (!chunk_bytes) return retval; //not chunked, no cache
+
+  size_t cache_bytes = par->file()->cache_size();
+  if (!cache_bytes && chunk_bytes <= DEFAULT_CHUNK_CACHE) return retval;
+  cache_bytes = std::max(cache_bytes, chunk_bytes);
+
+  boost::shared_ptr<hid_t> dapl = open_plist(H5P_DATASET_ACCESS);
+  herr_t status = H5Pset_chunk_cache(*dapl,
+      chunk_cache_slots(cache_bytes / chunk_bytes), cache_bytes,
+      H5D_CHUNK_CACHE_W0_DEFAULT);
+  if (status < 0) throw status_error("H5Pset_chunk_cache", status);
+
+  retval.reset(); //closes it before re-opening with the new settings
+  return open_dataset(par, name, *dapl);
+}
+
 /**
  * Opens an "auto-destructible" HDF5 dataspace
  */
@@ -222,7 +297,7 @@ bob::io::detail::hdf5::Dataset::Dataset(boost::shared_ptr<Group> parent,
     const std::string& name) :
   m_parent(parent),
   m_name(name),
-  m_id(open_dataset(parent, name)),
+  m_id(open_cached_dataset(parent, name)),
   m_dt(open_datatype(m_id)),
   m_filespace(open_filespace(m_id)),
   m_descr(),
@@ -276,10 +351,20 @@ static void create_dataset (boost::shared_ptr<bob::io::detail::hdf5::Group> par,
   //supposed to be a list -- HDF5 only supports expandability like this.
   boost::shared_ptr<hid_t> dcpl = open_plist(H5P_DATASET_CREATE);
 
+  boost::shared_ptr<hid_t> cls = type.htype();
+
   //according to the HDF5 manual, chunks have to have the same rank as the
-  //array shape.
+  //array shape. Chunks hold a single entry along the first dimension, unless
+  //the file asks for chunks of a given size: these hold as many entries as
+  //fit in that size, so sequential reads and writes touch fewer chunks.
   bob::io::HDF5Shape chunking(xshape);
   chunking[0] = 1;
+  size_t chunk_size = par->file()->chunk_size();
+  if (chunk_size) {
+    hsize_t entry_bytes = chunking.product() * H5Tget_size(*cls);
+    chunking[0] = std::max<hsize_t>(1, chunk_size / entry_bytes);
+    if (!list) chunking[0] = std::min(chunking[0], xshape[0]);
+  }
   if (list || compression) { ///< note: compression requires chunking
     herr_t status = H5Pset_chunk(*dcpl, chunking.n(), chunking.get());
     if (status < 0) throw status_error("H5Pset_chunk", status);
@@ -301,8 +386,6 @@ static void create_dataset (boost::shared_ptr<bob::io::detail::hdf5::Group> par,
   //please note that we don't define the fill value as in the example, but
   //according to the HDF5 documentation, this value is set to zero by default.
 
-  boost::shared_ptr<hid_t> cls = type.htype();
-
   //finally create the dataset on the file.
   boost::shared_ptr<hid_t> dataset(new hid_t(-1),
       std::ptr_fun(delete_h5dataset));
@@ -389,7 +472,7 @@ bob::io::detail::hdf5::Dataset::Dataset(boost::shared_ptr<Group> parent,
   }
   else H5Dclose(set_id); //close it, will re-open it properly
 
-  m_id = open_dataset(parent, m_name);
+  m_id = open_cached_dataset(parent, m_name);
   m_dt = open_datatype(m_id);
   m_filespace = open_filespace(m_id);
   bob::io::HDF5Type file_type(m_dt, get_extents(m_filespace));
@@ -495,10 +578,70 @@ bob::io::detail::hdf5::Dataset::select (size_t index, const bob::io::HDF5Type& d
 
 void bob::io::detail::hdf5::Dataset::read_buffer (size_t index, const bob::io::HDF5Type& dest, void* buffer) {
 
-  std::vector<bob::io::HDF5Descriptor>::iterator it = select(index, dest);
+  //finds compatibility type
+  std::vector<bob::io::HDF5Descriptor>::iterator it = find_type_index(m_descr, dest);
 
-  herr_t status = H5Dread(*m_id, *it->type.htype(),
-      *m_memspace, *m_filespace, H5P_DEFAULT, buffer);
+  //if we cannot find a compatible type, we throw
+  if (it == m_descr.end()) {
+    boost::format m("trying to read or write `%s' at `%s' that only accepts `%s'");
+    m % dest.str() % url() % m_descr[0].type.str();
+    throw std::runtime_error(m.str());
+  }
+
+  //checks indexing
+  if (index >= it->size) {
+    boost::format m("trying to access element %d in Dataset '%s' that only contains %d elements");
+    m % index % url() % it->size;
+    throw std::runtime_error(m.str());
+  }
+
+  //a single entry is a range of one: this does not touch the shared
+  //selection, so concurrent reads on this dataset do not race
+  read_range_buffer(index, 1, dest, buffer);
+}
+
+void bob::io::detail::hdf5::Dataset::read_range_buffer (size_t start,
+    size_t count, const bob::io::HDF5Type& dest, void* buffer) {
+
+  //finds compatibility type
+  std::vector<bob::io::HDF5Descriptor>::iterator it = find_type_index(m_descr, dest);
+
+  //if we cannot find a compatible type, we throw
+  if (it == m_descr.end()) {
+    boost::format m("trying to read or write `%s' at `%s' that only accepts `%s'");
+    m % dest.str() % url() % m_descr[0].type.str();
+    throw std::runtime_error(m.str());
+  }
+
+  //checks indexing
+  if (start + count > it->size) {
+    boost::format m("trying to access elements [%d, %d[ in Dataset '%s' that only contains %d elements");
+    m % start % (start + count) % url() % it->size;
+    throw std::runtime_error(m.str());
+  }
+
+  if (!count) return;
+
+  //a single hyperslab spanning the requested entries, which are laid out
+  //one after the other in the (flat) user buffer
+  bob::io::HDF5Shape hyperslab_start(it->hyperslab_start);
+  bob::io::HDF5Shape hyperslab_count(it->hyperslab_count);
+  hyperslab_start[0] = start;
+  hyperslab_count[0] = count;
+
+  //the selection is made on a private copy of the file dataspace, so that
+  //concurrent reads do not overwrite each other's selections
+  boost::shared_ptr<hid_t> filespace = open_filespace(m_id);
+  herr_t status = H5Sselect_hyperslab(*filespace, H5S_SELECT_SET,
+      hyperslab_start.get(), 0, hyperslab_count.get(), 0);
+  if (status < 0) throw status_error("H5Sselect_hyperslab", status);
+
+  hsize_t elements = count * it->type.shape().product();
+  bob::io::HDF5Shape memshape(1, &elements);
+  boost::shared_ptr<hid_t> memspace = open_memspace(memshape);
+
+  status = H5Dread(*m_id, *it->type.htype(),
+      *memspace, *filespace, H5P_DEFAULT, buffer);
 
   if (status < 0) throw status_error("H5Dread", status);
 }
@@ -555,6 +698,70 @@ void bob::io::detail::hdf5::Dataset::extend_buffer (const bob::io::HDF5Type& des
   write_buffer(tmp[0]-1, dest, buffer);
 }
 
+void bob::io::detail::hdf5::Dataset::extend_range_buffer (size_t count,
+    const bob::io::HDF5Type& dest, const void* buffer) {
+
+  //finds compatibility type
+  std::vector<bob::io::HDF5Descriptor>::iterator it = find_type_index(m_descr, dest);
+
+  //if we cannot find a compatible type, we throw
+  if (it == m_descr.end()) {
+    boost::format m("trying to read or write `%s' at `%s' that only accepts `%s'");
+    m % dest.str() % url() % m_descr[0].type.str();
+    throw std::runtime_error(m.str());
+  }
+
+  if (!it->expandable) {
+    boost::format m("trying to append to '%s' that is not expandible");
+    m % url();
+    throw std::runtime_error(m.str());
+  }
+
+  if (!count) return;
+
+  //if it is expandible, try expansion
+  const size_t start = it->size;
+  bob::io::HDF5Shape tmp(it->type.shape());
+  tmp >>= 1;
+  tmp[0] = start + count;
+  herr_t status = H5Dset_extent(*m_id, tmp.get());
+  if (status < 0) throw status_error("H5Dset_extent", status);
+
+  //if expansion succeeded, update all compatible types
+  for (size_t k=0; k<m_descr.size(); ++k) {
+    if (m_descr[k].expandable) { //updated only the length
+      m_descr[k].size += count;
+    }
+    else { //not expandable, update the shape/count for a straight read/write
+      m_descr[k].type.shape()[0] += count;
+      m_descr[k].hyperslab_count[0] += count;
+    }
+  }
+
+  m_filespace = open_filespace(m_id); //update filespace
+
+  //a single hyperslab spanning the new entries, which are laid out one after
+  //the other in the (flat) user buffer
+  bob::io::HDF5Shape hyperslab_start(it->hyperslab_start);
+  bob::io::HDF5Shape hyperslab_count(it->hyperslab_count);
+  hyperslab_start[0] = start;
+  hyperslab_count[0] = count;
+
+  boost::shared_ptr<hid_t> filespace = open_filespace(m_id);
+  status = H5Sselect_hyperslab(*filespace, H5S_SELECT_SET,
+      hyperslab_start.get(), 0, hyperslab_count.get(), 0);
+  if (status < 0) throw status_error("H5Sselect_hyperslab", status);
+
+  hsize_t elements = count * it->type.shape().product();
+  bob::io::HDF5Shape memshape(1, &elements);
+  boost::shared_ptr<hid_t> memspace = open_memspace(memshape);
+
+  status = H5Dwrite(*m_id, *it->type.htype(),
+      *memspace, *filespace, H5P_DEFAULT, buffer);
+
+  if (status < 0) throw status_error("H5Dwrite", status);
+}
+
 void bob::io::detail::hdf5::Dataset::gettype_attribute(const std::string& name,
           bob::io::HDF5Type& type) const {
   bob::io::detail::hdf5::gettype_attribute(m_id, name, type);
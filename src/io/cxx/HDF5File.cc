@@ -38,8 +38,10 @@ static unsigned int getH5Access (bob::io::HDF5File::mode_t v) {
   }
 }
 
-bob::io::HDF5File::HDF5File(const std::string& filename, mode_t mode):
-  m_file(new bob::io::detail::hdf5::File(filename, getH5Access(mode))),
+bob::io::HDF5File::HDF5File(const std::string& filename, mode_t mode,
+    size_t cache_size):
+  m_file(new bob::io::detail::hdf5::File(filename, getH5Access(mode), 0,
+        cache_size)),
   m_cwd(m_file->root()) ///< we start by looking at the root directory
 {
 }
@@ -152,6 +154,17 @@ void bob::io::HDF5File::read_buffer (const std::string& path, size_t pos,
   (*m_cwd)[path]->read_buffer(pos, type, buffer);
 }
 
+void bob::io::HDF5File::read_range_buffer (const std::string& path,
+    size_t start, size_t count, const bob::io::HDF5Type& type,
+    void* buffer) const {
+  (*m_cwd)[path]->read_range_buffer(start, count, type, buffer);
+}
+
+boost::shared_ptr<bob::io::detail::hdf5::Dataset>
+bob::io::HDF5File::dataset (const std::string& path) const {
+  return (*m_cwd)[path];
+}
+
 void bob::io::HDF5File::write_buffer (const std::string& path,
     size_t pos, const bob::io::HDF5Type& type, const void* buffer) {
   if (!m_file->writeable()) {
@@ -71,7 +71,8 @@ static boost::shared_ptr<hid_t> open_group(boost::shared_ptr<hid_t> g,
 bob::io::detail::hdf5::Group::Group(boost::shared_ptr<Group> parent, const std::string& name):
   m_name(name),
   m_id(create_new_group(parent->location(), name)),
-  m_parent(parent)
+  m_parent(parent),
+  m_loaded(true) ///< a new group is empty
 {
 }
 
@@ -103,16 +104,16 @@ herr_t bob::io::detail::hdf5::Group::iterate_callback(hid_t self, const char *na
     throw std::runtime_error(m.str());
   }
 
+  //only records the name, objects are opened on first access. Objects that
+  //are already open (e.g. created before listing) are kept.
   switch(obj_info.type) {
     case H5O_TYPE_GROUP:
-      //creates with recursion
-      m_groups[name] = boost::make_shared<bob::io::detail::hdf5::Group>(shared_from_this(),
-          name, true);
-      m_groups[name]->open_recursively();
+      m_groups.insert(std::make_pair(std::string(name),
+            boost::shared_ptr<bob::io::detail::hdf5::Group>()));
       break;
     case H5O_TYPE_DATASET:
-      m_datasets[name] = boost::make_shared<bob::io::detail::hdf5::Dataset>(shared_from_this(),
-          std::string(name));
+      m_datasets.insert(std::make_pair(std::string(name),
+            boost::shared_ptr<bob::io::detail::hdf5::Dataset>()));
       break;
     default:
       break;
@@ -125,7 +126,8 @@ bob::io::detail::hdf5::Group::Group(boost::shared_ptr<Group> parent,
     const std::string& name, bool):
   m_name(name),
   m_id(open_group(parent->location(), name.c_str())),
-  m_parent(parent)
+  m_parent(parent),
+  m_loaded(false)
 {
   //checks name
   if (!m_name.size() || m_name == "." || m_name == "..") {
@@ -135,8 +137,9 @@ bob::io::detail::hdf5::Group::Group(boost::shared_ptr<Group> parent,
   }
 }
 
-void bob::io::detail::hdf5::Group::open_recursively() {
-  //iterates over this group only and instantiates what needs to be instantiated
+void bob::io::detail::hdf5::Group::load() {
+  if (m_loaded) return;
+  //iterates over this group only and records what is in there
   herr_t status = H5Literate(*m_id, H5_INDEX_NAME,
       H5_ITER_NATIVE, 0, group_iterate_callback, static_cast<void*>(this));
   if (status < 0) {
@@ -144,12 +147,69 @@ void bob::io::detail::hdf5::Group::open_recursively() {
     m % status % bob::io::format_hdf5_error();
     throw std::runtime_error(m.str());
   }
+  m_loaded = true;
+}
+
+boost::shared_ptr<bob::io::detail::hdf5::Group>
+bob::io::detail::hdf5::Group::child_group(const std::string& name) {
+  boost::shared_ptr<bob::io::detail::hdf5::Group>& g = m_groups[name];
+  if (!g) g = boost::make_shared<bob::io::detail::hdf5::Group>(shared_from_this(), name, true);
+  return g;
+}
+
+boost::shared_ptr<bob::io::detail::hdf5::Dataset>
+bob::io::detail::hdf5::Group::child_dataset(const std::string& name) {
+  boost::shared_ptr<bob::io::detail::hdf5::Dataset>& d = m_datasets[name];
+  if (!d) d = boost::make_shared<bob::io::detail::hdf5::Dataset>(shared_from_this(), name);
+  return d;
+}
+
+void bob::io::detail::hdf5::Group::open_recursively() {
+  load();
+  typedef std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Group> > group_map_type;
+  for (group_map_type::const_iterator it = m_groups.begin();
+      it != m_groups.end(); ++it) {
+    child_group(it->first)->open_recursively();
+  }
+
+  typedef std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Dataset> >
+    dataset_map_type;
+  for (dataset_map_type::const_iterator it = m_datasets.begin();
+      it != m_datasets.end(); ++it) {
+    child_dataset(it->first);
+  }
+}
+
+const std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Group> >&
+bob::io::detail::hdf5::Group::groups() const {
+  bob::io::detail::hdf5::Group* self = const_cast<bob::io::detail::hdf5::Group*>(this);
+  self->load();
+  typedef std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Group> > group_map_type;
+  for (group_map_type::const_iterator it = m_groups.begin();
+      it != m_groups.end(); ++it) {
+    self->child_group(it->first);
+  }
+  return m_groups;
+}
+
+const std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Dataset> >&
+bob::io::detail::hdf5::Group::datasets() const {
+  bob::io::detail::hdf5::Group* self = const_cast<bob::io::detail::hdf5::Group*>(this);
+  self->load();
+  typedef std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Dataset> >
+    dataset_map_type;
+  for (dataset_map_type::const_iterator it = m_datasets.begin();
+      it != m_datasets.end(); ++it) {
+    self->child_dataset(it->first);
+  }
+  return m_datasets;
 }
 
 bob::io::detail::hdf5::Group::Group(boost::shared_ptr<File> parent):
   m_name(""),
   m_id(open_group(parent->location(), "/")),
-  m_parent()
+  m_parent(),
+  m_loaded(false)
 {
 }
 
@@ -210,7 +270,7 @@ boost::shared_ptr<bob::io::detail::hdf5::Group> bob::io::detail::hdf5::Group::cd
       throw std::runtime_error(m.str());
     }
     //else, just return the named group
-    return m_groups[dir];
+    return child_group(dir);
   }
 
   //if you get to this point, we are just traversing
@@ -224,7 +284,7 @@ boost::shared_ptr<bob::io::detail::hdf5::Group> bob::io::detail::hdf5::Group::cd
   }
 
   //else, just recurse to the next group
-  return m_groups[mydir]->cd(dir.substr(pos+1));
+  return child_group(mydir)->cd(dir.substr(pos+1));
 }
 
 const boost::shared_ptr<bob::io::detail::hdf5::Group> bob::io::detail::hdf5::Group::cd(const std::string& dir) const {
@@ -239,7 +299,7 @@ boost::shared_ptr<bob::io::detail::hdf5::Dataset> bob::io::detail::hdf5::Group::
       m % dir % url();
       throw std::runtime_error(m.str());
     }
-    return m_datasets[dir];
+    return child_dataset(dir);
   }
 
   //if you get to this point, the search routine needs to be performed on
@@ -257,6 +317,7 @@ const boost::shared_ptr<bob::io::detail::hdf5::Dataset> bob::io::detail::hdf5::G
 }
 
 void bob::io::detail::hdf5::Group::reset() {
+  load();
   typedef std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Group> > group_map_type;
   for (group_map_type::const_iterator it = m_groups.begin();
       it != m_groups.end(); ++it) {
@@ -299,9 +360,7 @@ void bob::io::detail::hdf5::Group::remove_group(const std::string& dir) {
       m % status % bob::io::format_hdf5_error();
       throw std::runtime_error(m.str());
     }
-    typedef std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Group> > map_type;
-    map_type::iterator it = m_groups.find(dir);
-    m_groups.erase(it);
+    m_groups.erase(dir);
     return;
   }
 
@@ -365,13 +424,9 @@ void bob::io::detail::hdf5::Group::copy_group(const boost::shared_ptr<Group> oth
       throw std::runtime_error(m.str());
     }
 
-    //read new group contents
-    boost::shared_ptr<bob::io::detail::hdf5::Group> copied =
-      boost::make_shared<bob::io::detail::hdf5::Group>(shared_from_this(), use_name);
-    copied->open_recursively();
-
-    //index it
-    m_groups[use_name] = copied;
+    //index the new group, its contents are read on first access
+    m_groups[use_name] =
+      boost::make_shared<bob::io::detail::hdf5::Group>(shared_from_this(), use_name, true);
 
     return;
   }
@@ -390,6 +445,7 @@ bool bob::io::detail::hdf5::Group::has_group(const std::string& dir) const {
   std::string::size_type pos = dir.find_last_of('/');
   if (pos == std::string::npos) { //search on the current group
     if (dir == "." || dir == "..") return true; //special case
+    const_cast<bob::io::detail::hdf5::Group*>(this)->load();
     typedef std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Group> > map_type;
     map_type::const_iterator it = m_groups.find(dir);
     return (it != m_groups.end());
@@ -441,9 +497,7 @@ void bob::io::detail::hdf5::Group::remove_dataset(const std::string& dir) {
       m % status % bob::io::format_hdf5_error();
       throw std::runtime_error(m.str());
     }
-    typedef std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Dataset> > map_type;
-    map_type::iterator it = m_datasets.find(dir);
-    m_datasets.erase(it);
+    m_datasets.erase(dir);
     return;
   }
 
@@ -500,6 +554,7 @@ void bob::io::detail::hdf5::Group::copy_dataset(const boost::shared_ptr<Dataset>
 bool bob::io::detail::hdf5::Group::has_dataset(const std::string& dir) const {
   std::string::size_type pos = dir.find_last_of('/');
   if (pos == std::string::npos) { //search on the current group
+    const_cast<bob::io::detail::hdf5::Group*>(this)->load();
     typedef std::map<std::string, boost::shared_ptr<bob::io::detail::hdf5::Dataset> > map_type;
     map_type::const_iterator it = m_datasets.find(dir);
     return (it != m_datasets.end());
@@ -114,11 +114,13 @@ static boost::shared_ptr<hid_t> create_fcpl(hsize_t userblock_size) {
 }
 
 bob::io::detail::hdf5::File::File(const boost::filesystem::path& path, unsigned int flags,
-    size_t userblock_size):
+    size_t userblock_size, size_t cache_size):
   m_path(path),
   m_flags(flags),
   m_fcpl(create_fcpl(userblock_size)),
-  m_id(open_file(m_path, m_flags, m_fcpl))
+  m_id(open_file(m_path, m_flags, m_fcpl)),
+  m_cache_size(cache_size),
+  m_chunk_size(0)
 {
 }
 
@@ -127,8 +129,8 @@ bob::io::detail::hdf5::File::~File() {
 
 boost::shared_ptr<bob::io::detail::hdf5::RootGroup> bob::io::detail::hdf5::File::root() {
   if (!m_root) {
+    //sub-groups and datasets are opened on first access
     m_root = boost::make_shared<bob::io::detail::hdf5::RootGroup>(shared_from_this());
-    m_root->open_recursively();
   }
   return m_root;
 }
@@ -0,0 +1,178 @@
+/**
+ * @file io/cxx/MappedFile.cc
+ * @date Fri Oct 16 21:07:45 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Implements the shared memory mapping of files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <cstring>
+#include <boost/format.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
+
+//some infrastructure to identify the file
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <bob/io/MappedFile.h>
+
+/**
+ * The mappings currently open, indexed by a key which changes whenever the
+ * file is replaced or modified.
+ */
+typedef std::map<std::string, boost::weak_ptr<bob::io::detail::MappedFile> >
+  mapping_map_type;
+
+static mapping_map_type& mappings() {
+  static mapping_map_type instance;
+  return instance;
+}
+
+static boost::mutex& mappings_mutex() {
+  static boost::mutex instance;
+  return instance;
+}
+
+/**
+ * Returns a key identifying the current contents of a file (device, inode,
+ * size and modification time), and its size.
+ */
+static std::string mapping_key(const std::string& path, size_t& size) {
+  struct stat filestatus;
+  if (stat(path.c_str(), &filestatus) != 0) {
+    boost::format m("cannot open file `%s'");
+    m % path;
+    throw std::runtime_error(m.str());
+  }
+  size = filestatus.st_size;
+  boost::format key("%d:%d:%d:%d");
+  key % filestatus.st_dev % filestatus.st_ino % filestatus.st_size %
+    filestatus.st_mtime;
+  return key.str();
+}
+
+/**
+ * An array referring to a part of a mapping, which it keeps alive
+ */
+class mapped_array: public bob::core::array::interface {
+
+  public: //api
+
+    mapped_array(boost::shared_ptr<bob::io::detail::MappedFile> file,
+        size_t offset, const bob::core::array::typeinfo& info):
+      m_type(info),
+      m_ptr(file->data() + offset),
+      m_owner(file, file->data() + offset) { }
+
+    virtual ~mapped_array() { }
+
+    virtual void set(const bob::core::array::interface& other) {
+      if (!m_type.is_compatible(other.type())) {
+        boost::format m("cannot copy an array of type %s into an array of type %s referring to a memory-mapped file");
+        m % other.type().str() % m_type.str();
+        throw std::runtime_error(m.str());
+      }
+      std::memcpy(m_ptr, other.ptr(), m_type.buffer_size());
+    }
+
+    virtual void set(boost::shared_ptr<bob::core::array::interface> other) {
+      m_type = other->type();
+      m_ptr = other->ptr();
+      m_owner = other->owner();
+    }
+
+    virtual void set(const bob::core::array::typeinfo& req) {
+      if (m_type.is_compatible(req)) return;
+      boost::format m("cannot re-allocate an array of type %s referring to a memory-mapped file as %s");
+      m % m_type.str() % req.str();
+      throw std::runtime_error(m.str());
+    }
+
+    virtual const bob::core::array::typeinfo& type() const { return m_type; }
+
+    virtual void* ptr() { return m_ptr; }
+    virtual const void* ptr() const { return m_ptr; }
+
+    virtual boost::shared_ptr<void> owner() { return m_owner; }
+    virtual boost::shared_ptr<const void> owner() const { return m_owner; }
+
+  private: //representation
+
+    bob::core::array::typeinfo m_type;
+    void* m_ptr;
+    boost::shared_ptr<void> m_owner; ///< keeps the mapping alive
+
+};
+
+bob::io::detail::MappedFile::MappedFile(const std::string& path):
+  m_filename(path),
+  m_file(),
+  m_size(0),
+  m_data(0),
+  m_key(mapping_key(path, m_size))
+{
+  if (!m_size) return; //empty files cannot be mapped
+
+  boost::iostreams::mapped_file_params params(path);
+  params.flags = boost::iostreams::mapped_file::priv;
+  try {
+    m_file.open(params);
+  }
+  catch (std::exception& e) {
+    boost::format m("cannot map file `%s' in memory: %s");
+    m % path % e.what();
+    throw std::runtime_error(m.str());
+  }
+  m_size = m_file.size();
+  m_data = m_file.data();
+}
+
+bob::io::detail::MappedFile::~MappedFile() {
+  //forgets about this mapping, unless it was already replaced
+  boost::mutex::scoped_lock lock(mappings_mutex());
+  mapping_map_type::iterator it = mappings().find(m_key);
+  if (it != mappings().end() && it->second.expired()) mappings().erase(it);
+}
+
+boost::shared_ptr<bob::io::detail::MappedFile>
+bob::io::detail::MappedFile::open(const std::string& path) {
+  size_t size;
+  std::string key = mapping_key(path, size);
+
+  boost::mutex::scoped_lock lock(mappings_mutex());
+  boost::shared_ptr<MappedFile> retval = mappings()[key].lock();
+  if (!retval) {
+    retval.reset(new MappedFile(path));
+    mappings()[retval->m_key] = retval;
+  }
+  return retval;
+}
+
+bool bob::io::detail::MappedFile::can_refer(size_t offset,
+    const bob::core::array::typeinfo& info) const {
+  if (!m_data || offset + info.buffer_size() > m_size) return false;
+  size_t item_size = info.item_size();
+  return item_size && (reinterpret_cast<size_t>(m_data + offset) % item_size) == 0;
+}
+
+boost::shared_ptr<bob::core::array::interface>
+bob::io::detail::MappedFile::refer(size_t offset,
+    const bob::core::array::typeinfo& info) {
+  return boost::shared_ptr<bob::core::array::interface>(new mapped_array(shared_from_this(), offset, info));
+}
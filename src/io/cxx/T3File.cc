@@ -32,6 +32,7 @@
  */
 
 #include <fstream>
+#include <cstring>
 #include <boost/filesystem.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/format.hpp>
@@ -44,6 +45,7 @@
 #include <bob/core/check.h>
 #include <bob/core/blitz_array.h>
 #include <bob/io/CodecRegistry.h>
+#include <bob/io/MappedFile.h>
 
 static inline size_t get_filesize(const std::string& filename) {
   struct stat filestatus;
@@ -99,6 +101,9 @@ class T3File: public bob::io::File {
           m_type_arrayset.set_shape<size_t>(1, &shape[1]);
           m_newfile = false;
 
+          //read-only files are read through a (shared) memory mapping
+          if (mode == 'r') m_mapping = bob::io::detail::MappedFile::open(path);
+
         }
       }
 
@@ -134,6 +139,12 @@ class T3File: public bob::io::File {
 
       if (!buffer.type().is_compatible(m_type_array)) buffer.set(m_type_array);
 
+      if (m_mapping) { //skips the header, single copy from the mapping
+        std::memcpy(buffer.ptr(), m_mapping->data() + 8,
+            buffer.type().buffer_size());
+        return;
+      }
+
       //open the file, now for reading the contents...
       std::ifstream ifile(m_filename.c_str(), std::ios::binary|std::ios::in);
 
@@ -155,6 +166,12 @@ class T3File: public bob::io::File {
 
       if (!buffer.type().is_compatible(m_type_arrayset)) buffer.set(m_type_arrayset);
 
+      if (m_mapping) { //single copy from the mapping
+        std::memcpy(buffer.ptr(), m_mapping->data() + offset(index),
+            type.buffer_size());
+        return;
+      }
+
       //open the file, now for reading the contents...
       std::ifstream ifile(m_filename.c_str(), std::ios::binary|std::ios::in);
 
@@ -164,6 +181,23 @@ class T3File: public bob::io::File {
 
     }
 
+    /**
+     * Samples are stored one after the other, in native byte order: when the
+     * file is mapped, the buffer can refer to them directly (as long as they
+     * are aligned).
+     */
+    virtual void refer(bob::core::array::interface& buffer, size_t index) {
+
+      if (m_mapping && index < m_length &&
+          m_mapping->can_refer(offset(index), m_type_arrayset)) {
+        buffer.set(m_mapping->refer(offset(index), m_type_arrayset));
+        return;
+      }
+
+      read(buffer, index);
+
+    }
+
     virtual size_t append (const bob::core::array::interface& buffer) {
 
       const bob::core::array::typeinfo& info = buffer.type();
@@ -269,6 +303,21 @@ class T3File: public bob::io::File {
 
     }
 
+  private: //api
+
+    /**
+     * The position of a given sample in the file: the header holds two
+     * 32-bit integers.
+     */
+    size_t offset(size_t index) const {
+      if (index >= m_length) {
+        boost::format m("request to read list item at position %d which is outside the bounds of declared object with size %d");
+        m % index % m_length;
+        throw std::runtime_error(m.str());
+      }
+      return 8 + index * m_type_arrayset.buffer_size();
+    }
+
   private: //representation
 
     std::string m_filename;
@@ -276,6 +325,7 @@ class T3File: public bob::io::File {
     bob::core::array::typeinfo m_type_array;
     bob::core::array::typeinfo m_type_arrayset;
     size_t m_length;
+    boost::shared_ptr<bob::io::detail::MappedFile> m_mapping;
 
     static std::string s_codecname;
 
@@ -73,6 +73,15 @@ class TensorArrayFile: public bob::io::File {
 
     }
 
+    virtual void refer(bob::core::array::interface& buffer, size_t index) {
+
+      if(!m_file) 
+        throw std::runtime_error("uninitialized binary file cannot be read");
+
+      m_file.refer(index, buffer);
+
+    }
+
     virtual size_t append (const bob::core::array::interface& buffer) {
 
       m_file.write(buffer);
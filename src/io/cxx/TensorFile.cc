@@ -72,6 +72,9 @@ bob::io::TensorFile::TensorFile(const std::string& filename,
       if (flag & bob::io::TensorFile::append) {
         throw std::runtime_error("cannot append data in read only mode");
       }
+
+      // Read-only files are read through a (shared) memory mapping
+      m_mapping = bob::io::detail::MappedFile::open(filename);
     }
   }
   else {
@@ -93,6 +96,12 @@ void bob::io::TensorFile::close() {
   if(m_openmode & bob::io::TensorFile::out) m_header.write(m_stream);
 
   m_stream.close();
+  m_mapping.reset();
+}
+
+bool bob::io::TensorFile::mapped(size_t index) const {
+  return m_mapping && m_header.getArrayIndex(index) +
+    m_header.m_type.buffer_size() <= m_mapping->size();
 }
 
 void bob::io::TensorFile::initHeader(const bob::core::array::typeinfo& info) {
@@ -150,12 +159,21 @@ void bob::io::TensorFile::read (bob::core::array::interface& buf) {
 void bob::io::TensorFile::read (size_t index, bob::core::array::interface& buf) {
 
   // Check that we are reaching an existing array
-  if( index > m_header.m_n_samples ) {
+  if( index >= m_header.m_n_samples ) {
     boost::format m("request to read list item at position %d which is outside the bounds of declared object with size %d");
     m % index % m_header.m_n_samples;
     throw std::runtime_error(m.str());
   }
 
+  if (mapped(index)) {
+    // Reorders the data straight from the mapping
+    if(!buf.type().is_compatible(m_header.m_type)) buf.set(m_header.m_type);
+    bob::io::col_to_row_order(m_mapping->data() +
+        m_header.getArrayIndex(index), buf.ptr(), m_header.m_type);
+    m_current_array = index + 1;
+    return;
+  }
+
   // Set the stream pointer at the correct position
   m_stream.seekg( m_header.getArrayIndex(index) );
   m_current_array = index;
@@ -163,3 +181,21 @@ void bob::io::TensorFile::read (size_t index, bob::core::array::interface& buf)
   // Put the content of the stream in the blitz array.
   read(buf);
 }
+
+void bob::io::TensorFile::refer (size_t index, bob::core::array::interface& buf) {
+
+  // Row- and column-major orders only match if a single dimension is larger
+  // than one
+  size_t non_singleton = 0;
+  for (size_t i=0; i<m_header.m_type.nd; ++i)
+    if (m_header.m_type.shape[i] > 1) ++non_singleton;
+
+  if (index < m_header.m_n_samples && non_singleton <= 1 && mapped(index) &&
+      m_mapping->can_refer(m_header.getArrayIndex(index), m_header.m_type)) {
+    buf.set(m_mapping->refer(m_header.getArrayIndex(index), m_header.m_type));
+    m_current_array = index + 1;
+    return;
+  }
+
+  read(index, buf);
+}
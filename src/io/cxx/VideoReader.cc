@@ -26,6 +26,8 @@
 #include <stdexcept>
 #include <boost/format.hpp>
 #include <boost/preprocessor.hpp>
+#include <boost/thread.hpp>
+#include <boost/exception_ptr.hpp>
 #include <limits>
 
 #include <bob/core/check.h>
@@ -36,7 +38,15 @@
 #define AV_PIX_FMT_RGB24 PIX_FMT_RGB24
 #endif
 
-bob::io::VideoReader::VideoReader(const std::string& filename, bool check) {
+/**
+ * Jumps of at least this number of frames are done by seeking a keyframe
+ */
+static const size_t SEEK_MIN_FRAMES = 16;
+
+bob::io::VideoReader::VideoReader(const std::string& filename, bool check):
+  m_decoder_threads(1),
+  m_prefetch(0)
+{
   open(filename, check);
 }
 
@@ -45,12 +55,15 @@ bob::io::VideoReader::VideoReader(const bob::io::VideoReader& other) {
 }
 
 bob::io::VideoReader& bob::io::VideoReader::operator= (const bob::io::VideoReader& other) {
+  m_decoder_threads = other.m_decoder_threads;
+  m_prefetch = other.m_prefetch;
   open(other.filename(), other.m_check);
   return *this;
 }
 
 void bob::io::VideoReader::open(const std::string& filename, bool check) {
   m_filepath = filename;
+  m_check = check;
 
   boost::shared_ptr<AVFormatContext> format_ctxt =
     bob::io::detail::ffmpeg::make_input_format_context(m_filepath);
@@ -175,6 +188,152 @@ size_t bob::io::VideoReader::load(bob::core::array::interface& b,
   return frames_read;
 }
 
+/**
+ * Decodes the frames of an iterator ahead of time, on a background thread
+ * which uses the ffmpeg infrastructure of the iterator until it is stopped.
+ * The outcome of each decoding attempt is kept in a bounded ring buffer, in
+ * the order read() would have produced it.
+ */
+class bob::io::VideoReader::const_iterator::prefetcher {
+
+  public:
+
+    /**
+     * The outcome of a decoding attempt
+     */
+    struct slot {
+      blitz::Array<uint8_t,3> rgb; ///< decoded frame (height, width, bands)
+      bool ok; ///< the frame was decoded
+      boost::exception_ptr error; ///< the error raised while decoding
+    };
+
+    /**
+     * Starts decoding the frames of the iterator from its current frame on
+     */
+    prefetcher(const const_iterator& it, size_t capacity, bool throw_on_error):
+      m_filename(it.m_parent->m_filepath),
+      m_nframes(it.m_parent->m_nframes),
+      m_frame(it.m_current_frame),
+      m_stream_index(it.m_stream_index),
+      m_format_context(it.m_format_context),
+      m_codec_context(it.m_codec_context),
+      m_swscaler(it.m_swscaler),
+      m_context_frame(it.m_context_frame),
+      m_throw_on_error(throw_on_error),
+      m_slots(std::max<size_t>(capacity, 1)),
+      m_head(0),
+      m_count(0),
+      m_stop(false),
+      m_done(false)
+    {
+      for (size_t k=0; k<m_slots.size(); ++k)
+        m_slots[k].rgb.resize(it.m_rgb_array.shape());
+      m_thread = boost::thread(&prefetcher::run, this);
+    }
+
+    /**
+     * Stops the background thread: the ffmpeg infrastructure is then
+     * positioned after the last frame decoded
+     */
+    ~prefetcher() {
+      {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_stop = true;
+      }
+      m_not_full.notify_one();
+      m_thread.join();
+    }
+
+    /**
+     * Waits for the next decoding outcome, which remains valid until pop()
+     * is called. Returns 0 if the background thread is over.
+     */
+    const slot* front() {
+      boost::mutex::scoped_lock lock(m_mutex);
+      while (m_count == 0 && !m_done) m_not_empty.wait(lock);
+      if (m_count == 0) return 0;
+      return &m_slots[m_head];
+    }
+
+    /**
+     * Releases the outcome returned by front()
+     */
+    void pop() {
+      {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_head = (m_head + 1) % m_slots.size();
+        --m_count;
+      }
+      m_not_full.notify_one();
+    }
+
+  private:
+
+    /**
+     * Decodes frames until the end of the stream, the first exception or
+     * until stopped. Only the slot past the last outcome is written to.
+     */
+    void run() {
+
+      bool failed = false;
+      while (m_frame < m_nframes && !failed) {
+        size_t tail;
+        {
+          boost::mutex::scoped_lock lock(m_mutex);
+          while (m_count == m_slots.size() && !m_stop) m_not_full.wait(lock);
+          if (m_stop) break;
+          tail = (m_head + m_count) % m_slots.size();
+        }
+
+        slot& s = m_slots[tail];
+        s.error = boost::exception_ptr();
+        try {
+          s.ok = bob::io::detail::ffmpeg::read_video_frame(m_filename,
+              m_frame, m_stream_index, m_format_context, m_codec_context,
+              m_swscaler, m_context_frame, s.rgb.data(), m_throw_on_error);
+        }
+        catch (...) {
+          s.ok = false;
+          s.error = boost::current_exception();
+          failed = true;
+        }
+        if (s.ok) ++m_frame;
+
+        {
+          boost::mutex::scoped_lock lock(m_mutex);
+          ++m_count;
+        }
+        m_not_empty.notify_one();
+      }
+
+      {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_done = true;
+      }
+      m_not_empty.notify_one();
+    }
+
+    std::string m_filename; ///< the file being decoded
+    size_t m_nframes; ///< the number of frames in the file
+    size_t m_frame; ///< the next frame to be decoded
+    int m_stream_index; ///< which stream in the file points to the video
+    boost::shared_ptr<AVFormatContext> m_format_context; ///< format context
+    boost::shared_ptr<AVCodecContext> m_codec_context; ///< codec context
+    boost::shared_ptr<SwsContext> m_swscaler; ///< software scaler
+    boost::shared_ptr<AVFrame> m_context_frame; ///< from file
+    bool m_throw_on_error; ///< error reporting behavior while decoding
+    std::vector<slot> m_slots; ///< ring buffer of decoding outcomes
+    size_t m_head; ///< the next outcome to be read
+    size_t m_count; ///< the number of outcomes available
+    bool m_stop; ///< requests the background thread to stop
+    bool m_done; ///< the background thread is over
+    boost::mutex m_mutex;
+    boost::condition_variable m_not_empty;
+    boost::condition_variable m_not_full;
+    boost::thread m_thread;
+
+};
+
 bob::io::VideoReader::const_iterator bob::io::VideoReader::begin() const {
   return bob::io::VideoReader::const_iterator(this);
 }
@@ -224,8 +383,10 @@ void bob::io::VideoReader::const_iterator::init() {
   m_format_context = bob::io::detail::ffmpeg::make_input_format_context(filename);
   m_stream_index = bob::io::detail::ffmpeg::find_video_stream(filename, m_format_context);
   m_codec = bob::io::detail::ffmpeg::find_decoder(filename, m_format_context, m_stream_index);
+  size_t n_threads = m_parent->m_decoder_threads;
+  if (n_threads == 0) n_threads = boost::thread::hardware_concurrency();
   m_codec_context = bob::io::detail::ffmpeg::make_codec_context(filename, 
-        m_format_context->streams[m_stream_index], m_codec);
+        m_format_context->streams[m_stream_index], m_codec, n_threads);
   m_swscaler = bob::io::detail::ffmpeg::make_scaler(filename, m_codec_context,
       m_codec_context->pix_fmt, PIX_FMT_RGB24);
   m_context_frame = bob::io::detail::ffmpeg::make_empty_frame(filename);
@@ -244,6 +405,7 @@ void bob::io::VideoReader::const_iterator::init() {
 }
 
 void bob::io::VideoReader::const_iterator::reset() {
+  m_prefetcher.reset(); //stops decoding before releasing ffmpeg
   m_context_frame.reset();
   m_swscaler.reset();
   m_codec_context.reset();
@@ -290,10 +452,33 @@ bool bob::io::VideoReader::const_iterator::read(bob::core::array::interface& dat
     throw std::runtime_error(s.str());
   }
 
-  //we are going to need another copy step - use our internal array
-  bool ok = bob::io::detail::ffmpeg::read_video_frame(m_parent->m_filepath, m_current_frame,
-      m_stream_index, m_format_context, m_codec_context, m_swscaler,
-      m_context_frame, m_rgb_array.data(), throw_on_error);
+  //we are going to need another copy step - use our internal array (or the
+  //frame decoded ahead of time)
+  bool ok = false;
+  const blitz::Array<uint8_t,3>* rgb = &m_rgb_array;
+  const prefetcher::slot* decoded = 0;
+
+  if (m_prefetcher || m_parent->m_prefetch) {
+    if (!m_prefetcher) m_prefetcher.reset(new prefetcher(*this,
+          m_parent->m_prefetch, throw_on_error));
+    decoded = m_prefetcher->front();
+    if (!decoded) { //the background thread has stopped on an error
+      reset();
+      return false;
+    }
+    if (decoded->error) {
+      boost::exception_ptr error = decoded->error;
+      m_prefetcher->pop();
+      boost::rethrow_exception(error);
+    }
+    ok = decoded->ok;
+    rgb = &decoded->rgb;
+  }
+  else {
+    ok = bob::io::detail::ffmpeg::read_video_frame(m_parent->m_filepath, m_current_frame,
+        m_stream_index, m_format_context, m_codec_context, m_swscaler,
+        m_context_frame, m_rgb_array.data(), throw_on_error);
+  }
 
   if (ok) {
 
@@ -306,11 +491,13 @@ bool bob::io::VideoReader::const_iterator::read(bob::core::array::interface& dat
     blitz::Array<uint8_t,3> dst(static_cast<uint8_t*>(data.ptr()), 
         shape, stride, blitz::neverDeleteData);
 
-    dst = m_rgb_array.transpose(2,0,1);
+    dst = rgb->transpose(2,0,1);
     ++m_current_frame;
 
   }
 
+  if (decoded) m_prefetcher->pop();
+
   return ok;
 }
 
@@ -330,6 +517,17 @@ bob::io::VideoReader::const_iterator& bob::io::VideoReader::const_iterator::oper
     return *this;
   }
 
+  //the frame may already have been decoded ahead of time
+  if (m_prefetcher) {
+    const prefetcher::slot* decoded = m_prefetcher->front();
+    if (!decoded || decoded->error) reset();
+    else {
+      if (decoded->ok) ++m_current_frame;
+      m_prefetcher->pop();
+    }
+    return *this;
+  }
+
   //we are going to need another copy step - use our internal array
   try {
     bool ok = bob::io::detail::ffmpeg::skip_video_frame(m_parent->m_filepath, m_current_frame,
@@ -344,7 +542,41 @@ bob::io::VideoReader::const_iterator& bob::io::VideoReader::const_iterator::oper
   return *this;
 }
 
+bool bob::io::VideoReader::const_iterator::seek(size_t frame) {
+  if (!m_parent || frame >= m_parent->numberOfFrames()) return false;
+
+  //the stream is positioned after the frames decoded ahead of time
+  bool rewind = (m_prefetcher.get() != 0);
+  m_prefetcher.reset();
+
+  try {
+    if (bob::io::detail::ffmpeg::seek_video_frame(m_parent->m_filepath, frame,
+          m_stream_index, m_format_context, m_codec_context, m_context_frame)) {
+      m_current_frame = frame;
+      return true;
+    }
+  }
+  catch (std::runtime_error& e) {
+    bob::core::debug << "keyframe seek failed, skipping frames instead: " 
+      << e.what() << std::endl;
+    rewind = true;
+  }
+
+  if (rewind) { //restarts from the first frame
+    const VideoReader* parent = m_parent;
+    reset();
+    m_parent = parent;
+    init();
+  }
+  return false;
+}
+
 bob::io::VideoReader::const_iterator& bob::io::VideoReader::const_iterator::operator+= (size_t frames) {
+  if (frames >= SEEK_MIN_FRAMES && m_parent) {
+    const size_t target = m_current_frame + frames;
+    if (seek(target)) return *this;
+    if (m_parent) frames = target - m_current_frame;
+  }
   for (size_t i=0; i<frames; ++i) ++(*this);
   return *this;
 }
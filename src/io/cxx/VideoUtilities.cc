@@ -959,7 +959,8 @@ static void deallocate_codec_context(AVCodecContext* c) {
 }
 
 boost::shared_ptr<AVCodecContext> bob::io::detail::ffmpeg::make_codec_context(
-    const std::string& filename, AVStream* stream, AVCodec* codec) {
+    const std::string& filename, AVStream* stream, AVCodec* codec,
+    size_t n_threads) {
 
   AVCodecContext* retval = stream->codec;
 
@@ -980,6 +981,14 @@ boost::shared_ptr<AVCodecContext> bob::io::detail::ffmpeg::make_codec_context(
 
 # else //fmpeg >= 0.7
 
+  // Multi-threaded decoding/encoding, which must be set before opening
+  if (n_threads > 1) {
+    retval->thread_count = n_threads;
+#   ifdef FF_THREAD_FRAME
+    retval->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+#   endif
+  }
+
   int ok = avcodec_open2(retval, codec, 0);
   if (ok < 0) {
     boost::format m("bob::io::detail::ffmpeg::avcodec_open2(codec=`%s'(0x%x) == `%s') failed: cannot open codec context to start reading or writing video file `%s' - ffmpeg reports error %d == `%s'");
@@ -1515,3 +1524,72 @@ bool bob::io::detail::ffmpeg::skip_video_frame (const std::string& filename,
 
   return true;
 }
+
+bool bob::io::detail::ffmpeg::seek_video_frame (const std::string& filename,
+    size_t frame, int stream_index,
+    boost::shared_ptr<AVFormatContext> format_context,
+    boost::shared_ptr<AVCodecContext> codec_context,
+    boost::shared_ptr<AVFrame> context_frame) {
+
+  AVStream* stream = format_context->streams[stream_index];
+  const AVRational rate = stream->r_frame_rate;
+  if (rate.num <= 0 || rate.den <= 0 || stream->time_base.num <= 0 ||
+      stream->time_base.den <= 0) return false;
+
+  const AVRational frame_duration = av_inv_q(rate);
+  const int64_t start = (stream->start_time == (int64_t)AV_NOPTS_VALUE) ?
+    0 : stream->start_time;
+
+  // Timestamp of the requested frame, assuming a constant frame rate
+  const int64_t timestamp = start + 
+    av_rescale_q(frame, frame_duration, stream->time_base);
+  if (av_seek_frame(format_context.get(), stream_index, timestamp,
+        AVSEEK_FLAG_BACKWARD) < 0) return false;
+  avcodec_flush_buffers(codec_context.get());
+
+  // The first packet of the video stream is the keyframe we landed on
+  boost::shared_ptr<AVPacket> pkt = make_packet();
+  int ok = 0;
+  while ((ok = av_read_frame(format_context.get(), pkt.get())) >= 0) {
+    if (pkt->stream_index == stream_index) break;
+    av_free_packet(pkt.get());
+  }
+  if (ok < 0) {
+    boost::format m("bob::io::detail::ffmpeg::seek_video_frame() failed: could not find a video packet after seeking frame %d of file `%s' - ffmpeg reports error %d == `%s'");
+    m % frame % filename % ok % ffmpeg_error(ok);
+    throw std::runtime_error(m.str());
+  }
+
+  const int64_t pts = (pkt->pts != (int64_t)AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+  const bool is_key = (pkt->flags & AV_PKT_FLAG_KEY);
+  av_free_packet(pkt.get());
+
+  const int64_t keyframe = (pts == (int64_t)AV_NOPTS_VALUE) ? -1 :
+    av_rescale_q(pts - start, stream->time_base, frame_duration);
+  if (!is_key || keyframe < 0 || keyframe > (int64_t)frame) {
+    boost::format m("bob::io::detail::ffmpeg::seek_video_frame() failed: could not determine the keyframe reached when seeking frame %d of file `%s'");
+    m % frame % filename;
+    throw std::runtime_error(m.str());
+  }
+
+  // Rewinds to the keyframe (we already consumed its packet) and skips the
+  // frames up to the requested one
+  if (av_seek_frame(format_context.get(), stream_index, pts,
+        AVSEEK_FLAG_BACKWARD) < 0) {
+    boost::format m("bob::io::detail::ffmpeg::seek_video_frame() failed: could not rewind to keyframe %d of file `%s'");
+    m % keyframe % filename;
+    throw std::runtime_error(m.str());
+  }
+  avcodec_flush_buffers(codec_context.get());
+
+  for (int64_t current = keyframe; current < (int64_t)frame; ++current) {
+    if (!skip_video_frame(filename, current, stream_index, format_context,
+          codec_context, context_frame, true)) {
+      boost::format m("bob::io::detail::ffmpeg::seek_video_frame() failed: could not skip frame %d of file `%s'");
+      m % current % filename;
+      throw std::runtime_error(m.str());
+    }
+  }
+
+  return true;
+}
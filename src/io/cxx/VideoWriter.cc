@@ -23,7 +23,10 @@
 
 #include <boost/format.hpp>
 #include <boost/preprocessor.hpp>
+#include <boost/thread.hpp>
+#include <boost/exception_ptr.hpp>
 #include <bob/io/VideoWriter.h>
+#include <bob/core/logging.h>
 
 #if LIBAVFORMAT_VERSION_INT < 0x361764 /* 54.23.100 @ ffmpeg-0.11 */
 #define FFMPEG_VIDEO_BUFFER_SIZE 200000
@@ -35,6 +38,123 @@
 #define AV_PIX_FMT_RGB24 PIX_FMT_RGB24
 #endif
 
+/**
+ * Encodes the frames queued by a writer on a background thread, which is the
+ * only one to use the ffmpeg infrastructure of the writer until finished.
+ * The frames are copied into a bounded ring buffer: producers block when it
+ * is full.
+ */
+class bob::io::VideoWriter::encoder {
+
+  public:
+
+    /**
+     * Starts the background thread
+     */
+    encoder(bob::io::VideoWriter& writer, size_t capacity):
+      m_writer(writer),
+      m_slots(capacity),
+      m_head(0),
+      m_count(0),
+      m_stop(false)
+    {
+      for (size_t k=0; k<m_slots.size(); ++k)
+        m_slots[k].resize(3, writer.m_height, writer.m_width);
+      m_thread = boost::thread(&encoder::run, this);
+    }
+
+    /**
+     * Encodes the remaining frames and stops the background thread
+     */
+    ~encoder() {
+      finish();
+    }
+
+    /**
+     * Copies a frame in the queue, waiting for a free slot if required.
+     * Rethrows the error that stopped the encoding, if any.
+     */
+    void push(const blitz::Array<uint8_t,3>& data) {
+      size_t tail;
+      {
+        boost::mutex::scoped_lock lock(m_mutex);
+        while (m_count == m_slots.size() && !m_error) m_not_full.wait(lock);
+        if (m_error) boost::rethrow_exception(m_error);
+        tail = (m_head + m_count) % m_slots.size();
+      }
+
+      m_slots[tail] = data;
+
+      {
+        boost::mutex::scoped_lock lock(m_mutex);
+        ++m_count;
+      }
+      m_not_empty.notify_one();
+    }
+
+    /**
+     * Waits for all queued frames to be encoded and stops the background
+     * thread. Returns the error that stopped the encoding, if any.
+     */
+    boost::exception_ptr finish() {
+      {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_stop = true;
+      }
+      m_not_empty.notify_one();
+      if (m_thread.joinable()) m_thread.join();
+      return m_error;
+    }
+
+  private:
+
+    /**
+     * Encodes the queued frames until stopped and the queue is empty. After
+     * an error, the remaining frames are dropped.
+     */
+    void run() {
+      while (true) {
+        size_t head;
+        {
+          boost::mutex::scoped_lock lock(m_mutex);
+          while (m_count == 0 && !m_stop) m_not_empty.wait(lock);
+          if (m_count == 0) break;
+          head = m_head;
+        }
+
+        boost::exception_ptr error;
+        try {
+          m_writer.encode(m_slots[head]);
+        }
+        catch (...) {
+          error = boost::current_exception();
+        }
+
+        {
+          boost::mutex::scoped_lock lock(m_mutex);
+          if (error && !m_error) m_error = error;
+          m_head = (m_head + 1) % m_slots.size();
+          --m_count;
+        }
+        m_not_full.notify_one();
+
+        if (error) break;
+      }
+    }
+
+    bob::io::VideoWriter& m_writer; ///< the writer owning the ffmpeg objects
+    std::vector<blitz::Array<uint8_t,3> > m_slots; ///< queued frames
+    size_t m_head; ///< the next frame to be encoded
+    size_t m_count; ///< the number of queued frames
+    bool m_stop; ///< no more frames will be queued
+    boost::exception_ptr m_error; ///< the error that stopped the encoding
+    boost::mutex m_mutex;
+    boost::condition_variable m_not_empty;
+    boost::condition_variable m_not_full;
+    boost::thread m_thread;
+
+};
+
 bob::io::VideoWriter::VideoWriter(
     const std::string& filename,
     size_t height,
@@ -44,14 +164,17 @@ bob::io::VideoWriter::VideoWriter(
     size_t gop,
     const std::string& codec,
     const std::string& format,
-    bool check) :
+    bool check,
+    size_t encoder_threads,
+    size_t queue_size) :
   m_filename(filename),
   m_opened(false),
   m_format_context(bob::io::detail::ffmpeg::make_output_format_context(filename, format)),
   m_codec(bob::io::detail::ffmpeg::find_encoder(filename, m_format_context, codec)),
   m_stream(bob::io::detail::ffmpeg::make_stream(filename, m_format_context, codec, height,
         width, framerate, bitrate, gop, m_codec)),
-  m_codec_context(bob::io::detail::ffmpeg::make_codec_context(filename, m_stream.get(), m_codec)),
+  m_codec_context(bob::io::detail::ffmpeg::make_codec_context(filename, m_stream.get(), m_codec,
+        encoder_threads ? encoder_threads : boost::thread::hardware_concurrency())),
   m_context_frame(bob::io::detail::ffmpeg::make_frame(filename, m_codec_context, m_stream->codec->pix_fmt)),
 #if LIBAVCODEC_VERSION_INT >= 0x352a00 //53.42.0 @ ffmpeg-0.9
   m_swscaler(bob::io::detail::ffmpeg::make_scaler(filename, m_codec_context, PIX_FMT_GBRP, m_stream->codec->pix_fmt)),
@@ -67,7 +190,8 @@ bob::io::VideoWriter::VideoWriter(
   m_gop(gop),
   m_codecname(codec),
   m_formatname(format),
-  m_current_frame(0)
+  m_current_frame(0),
+  m_queue_size(queue_size)
 {
   //runs a codec/format check if the user asked so
   if (check) {
@@ -107,16 +231,31 @@ bob::io::VideoWriter::VideoWriter(
   m_context_frame->pts = 0;
 
   m_opened = true; ///< file is now considered opened for bussiness
+
+  if (m_queue_size) m_encoder.reset(new encoder(*this, m_queue_size));
 }
 
 bob::io::VideoWriter::~VideoWriter() {
-  close();
+  try {
+    close();
+  }
+  catch (std::exception& e) {
+    bob::core::error << "error while closing video file `" << m_filename 
+      << "': " << e.what() << std::endl;
+  }
 }
 
 void bob::io::VideoWriter::close() {
 
   if (!m_opened) return;
 
+  //encodes the queued frames first
+  boost::exception_ptr error;
+  if (m_encoder) {
+    error = m_encoder->finish();
+    m_encoder.reset();
+  }
+
   bob::io::detail::ffmpeg::flush_encoder(m_filename, m_format_context, m_stream, m_codec,
       m_buffer, FFMPEG_VIDEO_BUFFER_SIZE);
   bob::io::detail::ffmpeg::close_output_file(m_filename, m_format_context);
@@ -131,6 +270,22 @@ void bob::io::VideoWriter::close() {
   m_format_context.reset();
 
   m_opened = false; ///< file is now considered closed
+
+  //reports errors raised while encoding queued frames
+  if (error) boost::rethrow_exception(error);
+}
+
+void bob::io::VideoWriter::encode(const blitz::Array<uint8_t,3>& data) {
+  bob::io::detail::ffmpeg::write_video_frame(data, m_filename, m_format_context,
+      m_stream, m_context_frame, m_rgb24_frame, m_swscaler, m_buffer,
+      FFMPEG_VIDEO_BUFFER_SIZE);
+}
+
+void bob::io::VideoWriter::write(const blitz::Array<uint8_t,3>& data) {
+  if (m_encoder) m_encoder->push(data);
+  else encode(data);
+  ++m_current_frame;
+  m_typeinfo_video.shape[0] += 1;
 }
 
 std::string bob::io::VideoWriter::info() const {
@@ -174,11 +329,7 @@ void bob::io::VideoWriter::append(const blitz::Array<uint8_t,4>& data) {
 
   blitz::Range a = blitz::Range::all();
   for(int i=data.lbound(0); i<(data.extent(0)+data.lbound(0)); ++i) {
-    bob::io::detail::ffmpeg::write_video_frame(data(i, a, a, a), m_filename, m_format_context,
-        m_stream, m_context_frame, m_rgb24_frame, m_swscaler, m_buffer,
-        FFMPEG_VIDEO_BUFFER_SIZE);
-    ++m_current_frame;
-    m_typeinfo_video.shape[0] += 1;
+    write(data(i, a, a, a));
   }
 }
 
@@ -198,11 +349,7 @@ void bob::io::VideoWriter::append(const blitz::Array<uint8_t,3>& data) {
     throw std::runtime_error(m.str());
   }
 
-  bob::io::detail::ffmpeg::write_video_frame(data, m_filename, m_format_context,
-      m_stream, m_context_frame, m_rgb24_frame, m_swscaler, m_buffer,
-      FFMPEG_VIDEO_BUFFER_SIZE);
-  ++m_current_frame;
-  m_typeinfo_video.shape[0] += 1;
+  write(data);
 }
 
 void bob::io::VideoWriter::append(const bob::core::array::interface& data) {
@@ -234,11 +381,7 @@ void bob::io::VideoWriter::append(const bob::core::array::interface& data) {
     shape = 3, m_height, m_width;
     blitz::Array<uint8_t,3> tmp(const_cast<uint8_t*>(static_cast<const uint8_t*>(data.ptr())), shape,
         blitz::neverDeleteData);
-    bob::io::detail::ffmpeg::write_video_frame(tmp, m_filename, m_format_context,
-        m_stream, m_context_frame, m_rgb24_frame, m_swscaler, m_buffer,
-        FFMPEG_VIDEO_BUFFER_SIZE);
-    ++m_current_frame;
-    m_typeinfo_video.shape[0] += 1;
+    write(tmp);
   }
   
   else if ( type.nd == 4 ) { //appends a sequence of frames
@@ -258,11 +401,7 @@ void bob::io::VideoWriter::append(const bob::core::array::interface& data) {
 
     for(size_t i=0; i<type.shape[0]; ++i) {
       blitz::Array<uint8_t,3> tmp(ptr, shape, blitz::neverDeleteData);
-      bob::io::detail::ffmpeg::write_video_frame(tmp, m_filename, m_format_context,
-          m_stream, m_context_frame, m_rgb24_frame, m_swscaler, m_buffer,
-          FFMPEG_VIDEO_BUFFER_SIZE);
-      ++m_current_frame;
-      m_typeinfo_video.shape[0] += 1;
+      write(tmp);
       ptr += frame_size;
     }
   }
@@ -146,4 +146,30 @@ BOOST_AUTO_TEST_CASE( hdf5_write_on_readonly )
   boost::filesystem::remove(filename);
 }
 
+BOOST_AUTO_TEST_CASE( hdf5_append_range )
+{
+  // Append the rows of a 2D array and a list of scalars, in two blocks
+  const std::string filename = bob::core::tmpfile();
+  bob::io::HDF5File::mode_t flag = bob::io::HDF5File::inout;
+  bob::io::HDF5File config(filename, flag);
+  blitz::Range all = blitz::Range::all();
+  config.appendArrayRange("a", a(blitz::Range(0,2), all));
+  config.appendArrayRange("a", a(blitz::Range(3,3), all));
+  config.appendArrayRange("c", c(blitz::Range(0,1)));
+  config.appendArrayRange("c", c(blitz::Range(2,4)));
+  BOOST_CHECK_EQUAL(config.describe("a")[0].size, (size_t)4);
+  BOOST_CHECK_EQUAL(config.describe("c")[0].size, (size_t)5);
+
+  // Read them as a whole and compare to the originals
+  blitz::Array<double,2> a_read;
+  a_read.reference(config.readArray<double,2>("a"));
+  check_equal(a, a_read);
+  blitz::Array<double,1> c_read;
+  c_read.reference(config.readArray<double,1>("c"));
+  check_equal(c, c_read);
+
+  // Clean-up
+  boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -41,6 +41,12 @@ static object file_read(bob::io::File& f, size_t index) {
   return a.pyobject(); //shallow copy
 }
 
+static object file_refer(bob::io::File& f, size_t index) {
+  bob::python::py_array a(f.type());
+  f.refer(a, index);
+  return a.pyobject(); //read-only if referring to the file
+}
+
 static boost::shared_ptr<bob::io::File> string_open1 (const std::string& filename,
     const std::string& mode) {
   return bob::io::open(filename, mode[0]);
@@ -85,6 +91,7 @@ void bind_io_file() {
     .def("__len__", &bob::io::File::size, (arg("self")), "Size of the file if it is supposed to be read as a set of arrays instead of performing a single read")
     .def("read", &file_read, (arg("self"), arg("index")), "Reads a single array from the file considering it to be an arrayset list")
     .def("__getitem__", &file_read, (arg("self"), arg("index")), "Reads a single array from the file considering it to be an arrayset list")
+    .def("refer", &file_refer, (arg("self"), arg("index")), "Reads a single array from the file like read(index), but returns a read-only array referring to the data of the file instead of a copy, if the codec supports it (e.g. .tensor and .bindata files opened for reading are memory-mapped)")
     .def("append", &file_append, (arg("self"), arg("array")), "Appends an array to a file. Compatibility requirements may be enforced.")
     ;
 
@@ -49,6 +49,14 @@ using namespace boost::python;
  */
 static inline object pass_through(object const& o) { return o; }
 
+/**
+ * Checks for keyboard interrupts while decoding with the GIL released
+ */
+static void check_signals_no_gil() {
+  bob::python::gil lock;
+  bob::python::check_signals();
+}
+
 /**
  * Python wrapper to make the Video::Reader::const_iterator look like a python
  * iterator
@@ -67,7 +75,11 @@ struct iterator_wrapper {
 
     //load the next frame: if an error is detected internally, throw
     bob::python::py_array retval(reader->frame_type());
-    bool ok = o.read(retval); //note that this will advance the iterator
+    bool ok;
+    {
+      bob::python::no_gil unlock;
+      ok = o.read(retval); //note that this will advance the iterator
+    }
     if (!ok) PYTHON_ERROR(StopIteration, "iteration finished");
     return retval.pyobject();
   }
@@ -99,9 +111,12 @@ static object videoreader_getitem (bob::io::VideoReader& v, object intobj) {
   }
 
   bob::python::py_array retval(v.frame_type());
-  bob::io::VideoReader::const_iterator it = v.begin();
-  it += frame;
-  it.read(retval); //read and throw if a problem occurs
+  {
+    bob::python::no_gil unlock;
+    bob::io::VideoReader::const_iterator it = v.begin();
+    it += frame;
+    it.read(retval); //read and throw if a problem occurs
+  }
   return retval.pyobject();
 }
 
@@ -159,7 +174,10 @@ static object videoreader_getslice (bob::io::VideoReader& v, slice sobj) {
   for (size_t i=start; it.parent() && i<stop; i+=step, it+=(step-1)) {
     bob::python::check_signals(); //catches keyboard interruption
     bob::python::py_array tmp(v.frame_type());
-    it.read(tmp); //throw if a problem occurs while reading the video
+    {
+      bob::python::no_gil unlock;
+      it.read(tmp); //throw if a problem occurs while reading the video
+    }
     retval.append(tmp.pyobject());
   }
 
@@ -171,7 +189,11 @@ static object videoreader_load(bob::io::VideoReader& reader,
   bool raise_on_error=false) {
   bob::python::py_array tmp(reader.video_type());
   size_t frames_read = 0;
-  frames_read = reader.load(tmp, raise_on_error, bob::python::check_signals);
+  bob::python::check_signals();
+  {
+    bob::python::no_gil unlock;
+    frames_read = reader.load(tmp, raise_on_error, check_signals_no_gil);
+  }
   return make_tuple(frames_read, tmp.pyobject());
 }
 
@@ -183,15 +205,22 @@ static void videowriter_append(bob::io::VideoWriter& writer, object a) {
   if (result != bob::python::IMPOSSIBLE) {
     bob::python::dtype dtype(writer.frame_type().dtype);
     bob::python::py_array tmp(a, dtype.self());
+    bob::python::no_gil unlock;
     writer.append(tmp);
   }
   else {
     bob::python::dtype dtype(writer.video_type().dtype);
     bob::python::py_array tmp(a, dtype.self());
+    bob::python::no_gil unlock;
     writer.append(tmp);
   }
 }
 
+static void videowriter_close(bob::io::VideoWriter& writer) {
+  bob::python::no_gil unlock; //may wait for the queued frames to be encoded
+  writer.close();
+}
+
 /**
  * Describes a given codec or returns an empty dictionary, in case the codec
  * cannot be accessed
@@ -454,6 +483,8 @@ void bind_io_video() {
     .add_property("info", make_function(&bob::io::VideoReader::info, return_value_policy<copy_const_reference>()), "Informative string containing many details of this video and available ffmpeg bindings that will read it")
     .add_property("video_type", make_function(&bob::io::VideoReader::video_type, return_value_policy<copy_const_reference>()), "Typing information to load all of the file at once")
     .add_property("frame_type", make_function(&bob::io::VideoReader::frame_type, return_value_policy<copy_const_reference>()), "Typing information to load the file frame by frame.")
+    .add_property("decoder_threads", &bob::io::VideoReader::decoderThreads, &bob::io::VideoReader::setDecoderThreads, "The number of threads `FFmpeg` may use to decode the frames (frame and/or slice threading, depending on what the codec supports), for the iterators created from now on. The default (1) decodes on the calling thread; 0 uses as many threads as there are cores.")
+    .add_property("prefetch", &bob::io::VideoReader::prefetch, &bob::io::VideoReader::setPrefetch, "The number of frames decoded ahead of the reader, on a background thread, by the iterators created from now on (and by ``load()``). The default (0) decodes each frame when it is read.")
     .def("__load__", &videoreader_load, videoreader_load_overloads((arg("self"), arg("raise_on_error")=false), "Loads all of the video stream in a numpy ndarray organized in this way: (frames, color-bands, height, width). I'll dynamically allocate the output array and return it to you. The flag ``raise_on_error``, which is set to ``False`` by default influences the error reporting in case problems are found with the video file. If you set it to ``True``, we will report problems raising exceptions. If you either don't set it or set it to ``False``, we will truncate the file at the frame with problems and will not report anything. It is your task to verify if the number of frames returned matches the expected number of frames as reported by the property ``number_of_frames`` in this object."))
     .def("__iter__", &bob::io::VideoReader::begin, with_custodian_and_ward_postcall<0,1>())
     .def("__getitem__", &videoreader_getitem)
@@ -462,7 +493,7 @@ void bind_io_video() {
 
   class_<bob::io::VideoWriter, boost::shared_ptr<bob::io::VideoWriter>, boost::noncopyable>("VideoWriter",
      "Use objects of this class to create and write video files using `FFmpeg <http://ffmpeg.org>`_ (or `libav <http://libav.org>`_ if FFmpeg is not available).",
-     init<const std::string&, size_t, size_t, optional<float, float, size_t, const std::string&, const std::string&, bool> >((arg("self"), arg("filename"), arg("height"), arg("width"), arg("framerate")=25., arg("bitrate")=1500000., arg("gop")=12, arg("codec")="", arg("format")="", arg("check")=true), "Creates a new output file given the input parameters. The format and codec to be used will be derived from the filename extension unless you define them explicetly (you can set both or just one of these two optional parameters)")
+     init<const std::string&, size_t, size_t, optional<float, float, size_t, const std::string&, const std::string&, bool, size_t, size_t> >((arg("self"), arg("filename"), arg("height"), arg("width"), arg("framerate")=25., arg("bitrate")=1500000., arg("gop")=12, arg("codec")="", arg("format")="", arg("check")=true, arg("encoder_threads")=1, arg("queue_size")=0), "Creates a new output file given the input parameters. The format and codec to be used will be derived from the filename extension unless you define them explicetly (you can set both or just one of these two optional parameters). ``encoder_threads`` sets the number of threads `FFmpeg` may use to encode the frames (0 uses as many threads as there are cores). If ``queue_size`` is larger than 0, ``append()`` copies the frames into a queue of that many frames, which are encoded on a background thread: it only blocks when the queue is full, and errors raised while encoding are reported by the next call to ``append()`` or ``close()``.")
      )
     .add_property("filename", make_function(&bob::io::VideoReader::filename, return_value_policy<copy_const_reference>()), "The full path to the file that will be encoded by this object")
     .add_property("height", &bob::io::VideoWriter::height, "The height of the output video file (must be a multiple of 2)")
@@ -478,8 +509,9 @@ void bind_io_video() {
     .add_property("bit_rate", &bob::io::VideoWriter::bitRate, "The indicative bit rate for this video file, given as a hint to `FFmpeg` (compression levels are subject to the picture textures)")
     .add_property("gop", &bob::io::VideoWriter::gop, "Group of pictures setting (see the `Wikipedia entry <http://en.wikipedia.org/wiki/Group_of_pictures>`_ for details on this setting)")
     .add_property("info", &bob::io::VideoWriter::info, "Informative string containing many details of this video and available ffmpeg bindings that will read it")
+    .add_property("queue_size", &bob::io::VideoWriter::queueSize, "The size of the queue of frames encoded on a background thread (0 if frames are encoded by ``append()``)")
     .add_property("is_opened", &bob::io::VideoWriter::is_opened, "A boolean flag, indicating if the video is still opened for writing (or has already been closed by the user using ``close()``)")
-    .def("close", &bob::io::VideoWriter::close, (arg("self")), "Closes the current video stream and forces writing the trailer. After this point the video is finalized and cannot be written to anymore.")
+    .def("close", &videowriter_close, (arg("self")), "Closes the current video stream and forces writing the trailer. Queued frames are encoded first. After this point the video is finalized and cannot be written to anymore.")
     .add_property("video_type", make_function(&bob::io::VideoWriter::video_type, return_value_policy<copy_const_reference>()), "Typing information to load all of the file at once")
     .add_property("frame_type", make_function(&bob::io::VideoWriter::frame_type, return_value_policy<copy_const_reference>()), "Typing information to load the file frame by frame.")
     .def("append", &videowriter_append, (arg("self"), arg("frame")), "Writes a new frame or set of frames to the file. The frame should be setup as a array with 3 dimensions organized in this way (RGB color-bands, height, width). Sets of frames should be setup as a 4D array in this way: (frame-number, RGB color-bands, height, width).\n\n.. note::\n\n  At present time we only support arrays that have C-style storages (if you pass reversed arrays or arrays with Fortran-style storage, the result is undefined).")
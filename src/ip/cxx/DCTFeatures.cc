@@ -35,7 +35,6 @@ bob::ip::DCTFeatures::operator=(const bob::ip::DCTFeatures& other)
     m_n_dct_coefs = other.m_n_dct_coefs;
     m_norm_block = other.m_norm_block;
     m_norm_dct = other.m_norm_dct;
-    m_dct2d.reset(m_block_h, m_block_w);
     m_square_pattern = other.m_square_pattern;
     m_norm_epsilon = other.m_norm_epsilon;
     setCheckSqrtNDctCoefs();
@@ -60,16 +59,9 @@ void bob::ip::DCTFeatures::setCheckSqrtNDctCoefs()
 
 void bob::ip::DCTFeatures::resetCache() const
 {
-  resetCacheBlock();
   resetCacheDct();
 }
 
-void bob::ip::DCTFeatures::resetCacheBlock() const
-{
-  m_cache_block1.resize(m_block_h, m_block_w);
-  m_cache_block2.resize(m_block_h, m_block_w);
-}
-
 void bob::ip::DCTFeatures::resetCacheDct() const
 {
   m_cache_dct_full.resize(m_n_dct_coefs);
@@ -98,34 +90,51 @@ bob::ip::DCTFeatures::operator!=(const bob::ip::DCTFeatures& b) const
 }
 
 void
-bob::ip::DCTFeatures::normalizeBlock(const blitz::Array<double,2>& b) const
+bob::ip::DCTFeatures::normalizeBlock(const blitz::Array<double,2>& b,
+  blitz::Array<double,2>& dst) const
 {
-  // Normalize block if required and extract DCT for the current block
+  // Normalize block if required
   if(m_norm_block)
   {
     double mean = blitz::mean(b);
     double var = blitz::sum(blitz::pow2(b - mean)) / (double)(m_block_h * m_block_w);
     double std = 1.;
     if(var >= m_norm_epsilon) std = sqrt(var);
-    m_cache_block1 = (b - mean) / std;
-    m_dct2d(m_cache_block1, m_cache_block2);
+    dst = (b - mean) / std;
   }
   else
-    m_dct2d(bob::core::array::ccopy(b), m_cache_block2);
+    dst = b;
 }
 
 void
-bob::ip::DCTFeatures::extractRowDCTCoefs(blitz::Array<double,1>& dst_row) const
+bob::ip::DCTFeatures::dctBlocks(const std::list<blitz::Array<double,2> >& blocks) const
+{
+  // Stacks all the (normalized) blocks, and extracts their DCT at once
+  m_cache_blocks.resize(blocks.size(), m_block_h, m_block_w);
+  m_cache_dct_blocks.resize(m_cache_blocks.shape());
+  int i=0;
+  for(std::list<blitz::Array<double,2> >::const_iterator it = blocks.begin();
+    it != blocks.end(); ++it, ++i)
+  {
+    blitz::Array<double,2> block = m_cache_blocks(i, blitz::Range::all(), blitz::Range::all());
+    normalizeBlock(*it, block);
+  }
+  bob::sp::dct2DBatch(m_cache_blocks, m_cache_dct_blocks);
+}
+
+void
+bob::ip::DCTFeatures::extractRowDCTCoefs(const blitz::Array<double,2>& dct_block,
+  blitz::Array<double,1>& dst_row) const
 {
   if (!m_square_pattern)
   {
     if (m_norm_block)
     {
-      zigzag(m_cache_block2, m_cache_dct_full);
+      zigzag(dct_block, m_cache_dct_full);
       dst_row = m_cache_dct_full(blitz::Range(1,m_n_dct_coefs-1));
     }
     else
-      zigzag(m_cache_block2, dst_row);
+      zigzag(dct_block, dst_row);
   }
   else
   {
@@ -133,13 +142,13 @@ bob::ip::DCTFeatures::extractRowDCTCoefs(blitz::Array<double,1>& dst_row) const
     int beg=0;
     if (m_norm_block)
     {
-      dst_row(blitz::Range(0,m_sqrt_n_dct_coefs-2)) = m_cache_block2(r,blitz::Range(1,m_sqrt_n_dct_coefs-1));
+      dst_row(blitz::Range(0,m_sqrt_n_dct_coefs-2)) = dct_block(r,blitz::Range(1,m_sqrt_n_dct_coefs-1));
       r += 1;
       beg = m_sqrt_n_dct_coefs-1;
     }
     blitz::Range ra(0,m_sqrt_n_dct_coefs-1);
     for(; r<(int)m_sqrt_n_dct_coefs; ++r, beg+=m_sqrt_n_dct_coefs)
-      dst_row(blitz::Range(beg,beg+m_sqrt_n_dct_coefs-1)) = m_cache_block2(r,ra);
+      dst_row(blitz::Range(beg,beg+m_sqrt_n_dct_coefs-1)) = dct_block(r,ra);
   }
 }
 
@@ -157,18 +166,15 @@ void bob::ip::DCTFeatures::operator()<double>(const blitz::Array<double,2>& src,
   std::list<blitz::Array<double,2> > blocks;
   blockReference(src, blocks, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
  
-  /// dct extract each block
-  int i=0;
-  for(std::list<blitz::Array<double,2> >::const_iterator it = blocks.begin();
-    it != blocks.end(); ++it, ++i) 
+  /// dct extract all the blocks
+  dctBlocks(blocks);
+  for(int i=0; i<m_cache_dct_blocks.extent(0); ++i)
   {
-    // Normalize input block (if required)
-    normalizeBlock(*it);
-
     // Extract the required number of coefficients using the zigzag pattern
     // and push it in the right dst row
+    blitz::Array<double,2> dct_block = m_cache_dct_blocks(i, blitz::Range::all(), blitz::Range::all());
     blitz::Array<double,1> dst_row = dst(i, blitz::Range::all());
-    extractRowDCTCoefs(dst_row);
+    extractRowDCTCoefs(dct_block, dst_row);
   }
 
   // Normalize dct if required
@@ -199,19 +205,17 @@ void bob::ip::DCTFeatures::operator()<double>(const blitz::Array<double,2>& src,
   blockReference(src, blocks, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
   const blitz::TinyVector<int,4> block_shape = getBlock4DOutputShape(src, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
 
-  /// dct extract each block
+  /// dct extract all the blocks
+  dctBlocks(blocks);
   int i=0;
   int j=0;
-  for(std::list<blitz::Array<double,2> >::const_iterator it = blocks.begin();
-    it != blocks.end(); ++it) 
+  for(int b=0; b<m_cache_dct_blocks.extent(0); ++b)
   {
-    // Normalize block if required and extract DCT for the current block
-    normalizeBlock(*it);
-
     // Extract the required number of coefficients using the zigzag pattern
     // and push it in the right dst row
+    blitz::Array<double,2> dct_block = m_cache_dct_blocks(b, blitz::Range::all(), blitz::Range::all());
     blitz::Array<double,1> dst_row = dst(i, j, blitz::Range::all());
-    extractRowDCTCoefs(dst_row);
+    extractRowDCTCoefs(dct_block, dst_row);
     // Increment block indices
     if (j>=shape(1)-1)
     {
@@ -41,7 +41,8 @@ bob::ip::LBP::LBP(const int P, const double R_y, const double R_x , const bool c
   m_rotation_invariant(rotation_invariant),
   m_eLBP_type(eLBP_type),
   m_lut(0),
-  m_positions(0,0)
+  m_positions(0,0),
+  m_int_positions(0,0)
 {
   // sanity check
   if (m_eLBP_type == ELBP_DIRECTION_CODED && m_P%2) {
@@ -63,7 +64,8 @@ bob::ip::LBP::LBP(const int P, const double R, const bool circular,
   m_rotation_invariant(rotation_invariant),
   m_eLBP_type(eLBP_type),
   m_lut(0),
-  m_positions(0,0)
+  m_positions(0,0),
+  m_int_positions(0,0)
 {
   // sanity check
   if (m_eLBP_type == ELBP_DIRECTION_CODED && m_P%2) {
@@ -84,7 +86,8 @@ bob::ip::LBP::LBP(const bob::ip::LBP& other):
   m_rotation_invariant(other.m_rotation_invariant),
   m_eLBP_type(other.m_eLBP_type),
   m_lut(0),
-  m_positions(0,0)
+  m_positions(0,0),
+  m_int_positions(0,0)
 {
   // sanity check
   if (m_eLBP_type == ELBP_DIRECTION_CODED && m_P%2) {
@@ -169,6 +172,17 @@ void bob::ip::LBP::init()
     }
   }
 
+  // pre-compute the interpolation points of the neighbors
+  m_int_positions.resize(m_P,4);
+  for (int p = 0; p < m_P; ++p){
+    for (int d = 0; d < 2; ++d){
+      // since the central pixel has integral coordinates, these are the
+      // floor and ceil of the absolute positions
+      m_int_positions(p,d) = static_cast<int>(floor(m_positions(p,d)));
+      m_int_positions(p,d+2) = static_cast<int>(ceil(m_positions(p,d)));
+    }
+  }
+
   // initialize the look up table for the current setup
   // initialize all values with 0
   m_lut.resize(1 << m_P);
@@ -238,6 +252,22 @@ void bob::ip::LBP::init()
   }
 }
 
+void bob::ip::LBP::getSampling(const int stride_y, const int stride_x, bob::ip::LBP::Sampling& sampling) const
+{
+  for (int p = 0; p < m_P; ++p){
+    const int y_low = m_int_positions(p,0), x_low = m_int_positions(p,1);
+    const int y_high = m_int_positions(p,2), x_high = m_int_positions(p,3);
+    sampling.offsets[p][0] = y_low * stride_y + x_low * stride_x;
+    sampling.offsets[p][1] = y_low * stride_y + x_high * stride_x;
+    sampling.offsets[p][2] = y_high * stride_y + x_low * stride_x;
+    sampling.offsets[p][3] = y_high * stride_y + x_high * stride_x;
+    sampling.positions[p][0] = m_positions(p,0);
+    sampling.positions[p][1] = m_positions(p,1);
+    sampling.high[p][0] = y_high;
+    sampling.high[p][1] = x_high;
+  }
+}
+
 int bob::ip::LBP::getMaxLabel() const {
   if (m_rotation_invariant){
     if (m_uniform)
@@ -0,0 +1,152 @@
+/**
+ * @file ip/cxx/Median.cc
+ * @date Fri Oct 16 16:48:12 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Histogram-based median filters for 8-bit and 16-bit images
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/ip/Median.h>
+
+namespace {
+
+  /**
+   * Returns the value of rank pos (starting at 0) of a two-level histogram
+   * with n_coarse bins of n_fine values each
+   */
+  inline int histogramRank(const int* coarse, const int* fine,
+      const int n_fine, int pos)
+  {
+    int k = 0;
+    while (pos >= coarse[k]) pos -= coarse[k++];
+    int v = k * n_fine;
+    while (pos >= fine[v]) pos -= fine[v++];
+    return v;
+  }
+
+}
+
+void bob::ip::detail::medianHistogram(const blitz::Array<uint8_t,2>& src,
+  blitz::Array<uint8_t,2>& dst, const int radius_y, const int radius_x)
+{
+  if (dst.extent(0) == 0 || dst.extent(1) == 0) return;
+
+  const int width = src.extent(1);
+  const int h = 2*radius_y+1, w = 2*radius_x+1;
+  const int median_pos = h*w/2;
+  const int s_y = src.stride(0), s_x = src.stride(1);
+  const uint8_t* data = src.data();
+
+  // Histograms of the h values of each column of the image below the
+  // current row of kernels, with 256 fine and 16 coarse bins
+  std::vector<int> columns(width*256, 0), columns_coarse(width*16, 0);
+  for (int y=0; y<h; ++y)
+    for (int c=0; c<width; ++c) {
+      const uint8_t v = data[y*s_y + c*s_x];
+      ++columns[c*256 + v];
+      ++columns_coarse[c*16 + (v>>4)];
+    }
+
+  int kernel[256], kernel_coarse[16];
+  for (int j=0; j<dst.extent(0); ++j)
+  {
+    // Moves the column histograms one row down
+    if (j > 0)
+      for (int c=0; c<width; ++c) {
+        const uint8_t v_out = data[(j-1)*s_y + c*s_x];
+        const uint8_t v_in = data[(j+h-1)*s_y + c*s_x];
+        --columns[c*256 + v_out];
+        --columns_coarse[c*16 + (v_out>>4)];
+        ++columns[c*256 + v_in];
+        ++columns_coarse[c*16 + (v_in>>4)];
+      }
+
+    // Kernel histogram of the first window of the row
+    std::fill(kernel, kernel+256, 0);
+    std::fill(kernel_coarse, kernel_coarse+16, 0);
+    for (int c=0; c<w; ++c) {
+      for (int k=0; k<256; ++k) kernel[k] += columns[c*256 + k];
+      for (int k=0; k<16; ++k) kernel_coarse[k] += columns_coarse[c*16 + k];
+    }
+    dst(j,0) = histogramRank(kernel_coarse, kernel, 16, median_pos);
+
+    // Slides the kernel histogram along the row: one column histogram is
+    // added and one removed, whatever the size of the kernel
+    for (int i=1; i<dst.extent(1); ++i)
+    {
+      const int* c_in = &columns[(i+w-1)*256];
+      const int* c_out = &columns[(i-1)*256];
+      for (int k=0; k<256; ++k) kernel[k] += c_in[k] - c_out[k];
+      const int* cc_in = &columns_coarse[(i+w-1)*16];
+      const int* cc_out = &columns_coarse[(i-1)*16];
+      for (int k=0; k<16; ++k) kernel_coarse[k] += cc_in[k] - cc_out[k];
+      dst(j,i) = histogramRank(kernel_coarse, kernel, 16, median_pos);
+    }
+  }
+}
+
+void bob::ip::detail::medianHistogram(const blitz::Array<uint16_t,2>& src,
+  blitz::Array<uint16_t,2>& dst, const int radius_y, const int radius_x)
+{
+  if (dst.extent(0) == 0 || dst.extent(1) == 0) return;
+
+  const int h = 2*radius_y+1, w = 2*radius_x+1;
+  const int median_pos = h*w/2;
+  const int s_y = src.stride(0), s_x = src.stride(1);
+  const uint16_t* data = src.data();
+
+  // Histogram of the kernel, with 65536 fine and 256 coarse bins
+  std::vector<int> kernel(65536, 0), kernel_coarse(256, 0);
+  for (int j=0; j<dst.extent(0); ++j)
+  {
+    const uint16_t* row = data + j*s_y;
+    // Kernel histogram of the first window of the row
+    for (int y=0; y<h; ++y)
+      for (int x=0; x<w; ++x) {
+        const uint16_t v = row[y*s_y + x*s_x];
+        ++kernel[v];
+        ++kernel_coarse[v>>8];
+      }
+    dst(j,0) = histogramRank(&kernel_coarse[0], &kernel[0], 256, median_pos);
+
+    // Slides the kernel histogram along the row: the h values of one
+    // column are removed and the ones of a new column are added
+    for (int i=1; i<dst.extent(1); ++i)
+    {
+      const uint16_t* c_out = row + (i-1)*s_x;
+      const uint16_t* c_in = row + (i+w-1)*s_x;
+      for (int y=0; y<h; ++y) {
+        const uint16_t v_out = c_out[y*s_y], v_in = c_in[y*s_y];
+        --kernel[v_out];
+        --kernel_coarse[v_out>>8];
+        ++kernel[v_in];
+        ++kernel_coarse[v_in>>8];
+      }
+      dst(j,i) = histogramRank(&kernel_coarse[0], &kernel[0], 256, median_pos);
+    }
+
+    // Empties the kernel histogram, by removing the values of the last
+    // window of the row
+    const uint16_t* last = row + (dst.extent(1)-1)*s_x;
+    for (int y=0; y<h; ++y)
+      for (int x=0; x<w; ++x) {
+        const uint16_t v = last[y*s_y + x*s_x];
+        --kernel[v];
+        --kernel_coarse[v>>8];
+      }
+  }
+}
@@ -31,6 +31,7 @@
 #include "bob/ip/LBP.h"
 
 #include <iostream>
+#include <vector>
 
 struct T {
   blitz::Array<uint8_t,2> a1, a2;
@@ -270,6 +271,41 @@ BOOST_AUTO_TEST_CASE( test_lbp_image )
   BOOST_CHECK_EQUAL( lbp_8_a2, result(0,0) );
 }
 
+BOOST_AUTO_TEST_CASE( test_lbp_image_variants )
+{
+  // the image extraction (which has dedicated code paths for rectangular
+  // and interpolated LBP codes) should match the extraction per pixel
+  blitz::Array<uint8_t,2> image(12,13);
+  blitz::Array<double,2> image_d(12,13);
+  for (int y = 0; y < image.extent(0); ++y)
+    for (int x = 0; x < image.extent(1); ++x){
+      image(y,x) = (7 * y + 3 * x * x) % 5;
+      image_d(y,x) = image(y,x);
+    }
+
+  std::vector<bob::ip::LBP> ops;
+  ops.push_back(bob::ip::LBP(4));
+  ops.push_back(bob::ip::LBP(8));
+  ops.push_back(bob::ip::LBP(8, 1., false, false, false, true, true));
+  ops.push_back(bob::ip::LBP(8, 1., true));
+  ops.push_back(bob::ip::LBP(8, 2., true, true, true));
+  ops.push_back(bob::ip::LBP(16, 2., true, false, false, true));
+  ops.push_back(bob::ip::LBP(8, 1., true, false, false, false, false, bob::ip::ELBP_TRANSITIONAL));
+  ops.push_back(bob::ip::LBP(8, 1., true, false, false, false, false, bob::ip::ELBP_DIRECTION_CODED));
+
+  for (size_t i = 0; i < ops.size(); ++i){
+    const int r = (int)ceil(ops[i].getRadius());
+    blitz::Array<uint16_t,2> result(ops[i].getLBPShape(image)), result_d(ops[i].getLBPShape(image_d));
+    ops[i](image, result);
+    ops[i](image_d, result_d);
+    for (int y = 0; y < result.extent(0); ++y)
+      for (int x = 0; x < result.extent(1); ++x){
+        BOOST_CHECK_EQUAL( ops[i](image, y+r, x+r), result(y,x) );
+        BOOST_CHECK_EQUAL( result(y,x), result_d(y,x) );
+      }
+  }
+}
+
 
 BOOST_AUTO_TEST_CASE( test_lbp_other )
 {
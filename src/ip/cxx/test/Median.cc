@@ -26,6 +26,8 @@
 #include <boost/test/unit_test.hpp>
 #include <blitz/array.h>
 #include "bob/ip/Median.h"
+#include <vector>
+#include <algorithm>
 
 struct T {
   double eps;
@@ -67,4 +69,52 @@ BOOST_AUTO_TEST_CASE( test_median_2d )
   checkBlitzEqual(dst, ref);
 }
 
+/**
+ * Reference implementation, which sorts the values of each window
+ */
+template<typename T>
+void medianReference(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst,
+  const int radius_y, const int radius_x)
+{
+  std::vector<T> window;
+  for( int j=0; j<dst.extent(0); ++j)
+    for( int i=0; i<dst.extent(1); ++i)
+    {
+      window.clear();
+      for( int y=0; y<2*radius_y+1; ++y)
+        for( int x=0; x<2*radius_x+1; ++x)
+          window.push_back(src(j+y,i+x));
+      std::sort(window.begin(), window.end());
+      dst(j,i) = window[window.size()/2];
+    }
+}
+
+template<typename T>
+void checkMedian(const int max_value)
+{
+  // covers the sorting networks (3x3 and 5x5), the histogram-based filters
+  // and the generic selection
+  for( int radius_y=0; radius_y<5; ++radius_y)
+    for( int radius_x=0; radius_x<5; ++radius_x)
+    {
+      blitz::Array<T,2> src(17,19);
+      for( int j=0; j<src.extent(0); ++j)
+        for( int i=0; i<src.extent(1); ++i)
+          src(j,i) = static_cast<T>((31*j + 17*i*i + 7*i*j) % max_value);
+      blitz::Array<T,2> dst(17-2*radius_y, 19-2*radius_x), ref(dst.shape());
+      bob::ip::Median<T> filter(radius_y, radius_x);
+      filter(src, dst);
+      medianReference(src, ref, radius_y, radius_x);
+      checkBlitzEqual(dst, ref);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_median_kernels )
+{
+  checkMedian<uint8_t>(256);
+  checkMedian<uint8_t>(3);
+  checkMedian<uint16_t>(65536);
+  checkMedian<double>(1000);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
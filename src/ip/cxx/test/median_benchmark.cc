@@ -0,0 +1,191 @@
+/**
+ * @file ip/cxx/test/median_benchmark.cc
+ * @date Fri Oct 16 22:41:27 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Benchmarks bob::ip::Median against the former median filter,
+ * which kept the window in sorted linked lists of heap-allocated pixels.
+ *
+ * Usage: bob_ip_median_benchmark [height width repeats]
+ *
+ * Prints, for each pixel type and radius, the average time (in ms) taken
+ * by both filters on random images (256x256 by default), and checks that
+ * both give the same output.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <list>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <boost/shared_ptr.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <blitz/array.h>
+#include <bob/ip/Median.h>
+
+namespace {
+
+  /**
+   * The former implementation of bob::ip::Median (2D only), kept as the
+   * baseline of this benchmark
+   */
+  template <typename T>
+  class ListMedian {
+
+    public:
+
+      ListMedian(const int radius_y, const int radius_x):
+        m_radius_y(radius_y), m_radius_x(radius_x),
+        m_median_pos((2*radius_y+1)*(2*radius_x+1)/2) {}
+
+      void operator()(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst) {
+        initLists(src);
+        for (int j=0; j<dst.extent(0); ++j) {
+          for (int i=0; i<dst.extent(1); ++i) {
+            dst(j,i) = valueAt(m_median_pos, m_list_current);
+            if (i<dst.extent(1)-1) removeAddColumn(j, i, src, m_list_current);
+          }
+          if (j<dst.extent(0)-1) {
+            removeAddRow(j, 0, src, m_list_first_col);
+            m_list_current = m_list_first_col;
+          }
+        }
+      }
+
+    private:
+
+      struct Pixel {
+        int y;
+        int x;
+        T value;
+        Pixel(int b, int a, T v): y(b), x(a), value(v) {}
+      };
+
+      typedef std::list<boost::shared_ptr<Pixel> > PixelList;
+
+      static void insert(const boost::shared_ptr<Pixel> p, PixelList& l) {
+        typename PixelList::iterator it = l.begin();
+        for ( ; it!=l.end(); ++it)
+          if (p->value > (*it)->value) break;
+        l.insert(it, p);
+      }
+
+      static T valueAt(const int pos, const PixelList& l) {
+        typename PixelList::const_iterator it = l.begin();
+        for (int c=0; it!=l.end(); ++it, ++c)
+          if (c==pos) return (*it)->value;
+        throw std::runtime_error("reached the end of method w/o returning");
+      }
+
+      void initLists(const blitz::Array<T,2>& src) {
+        m_list_first_col.clear();
+        m_list_current.clear();
+        for (int j=0; j<2*m_radius_y+1; ++j)
+          for (int i=0; i<2*m_radius_x+1; ++i)
+            insert(boost::shared_ptr<Pixel>(new Pixel(j,i,src(j,i))),
+                m_list_first_col);
+        m_list_current = m_list_first_col;
+      }
+
+      void removeAddColumn(const int j, const int i,
+          const blitz::Array<T,2>& src, PixelList& l) {
+        for (typename PixelList::iterator it=l.begin(); it!=l.end(); ) {
+          if ((*it)->x == i) it = l.erase(it);
+          else ++it;
+        }
+        const int x = i+2*m_radius_x+1;
+        for (int k=0; k<2*m_radius_y+1; ++k)
+          insert(boost::shared_ptr<Pixel>(new Pixel(j+k,x,src(j+k,x))), l);
+      }
+
+      void removeAddRow(const int j, const int i,
+          const blitz::Array<T,2>& src, PixelList& l) {
+        for (typename PixelList::iterator it=l.begin(); it!=l.end(); ) {
+          if ((*it)->y == j) it = l.erase(it);
+          else ++it;
+        }
+        const int y = j+2*m_radius_y+1;
+        for (int k=0; k<2*m_radius_x+1; ++k)
+          insert(boost::shared_ptr<Pixel>(new Pixel(y,i+k,src(y,i+k))), l);
+      }
+
+      int m_radius_y;
+      int m_radius_x;
+      int m_median_pos;
+      PixelList m_list_current;
+      PixelList m_list_first_col;
+  };
+
+  double now() {
+    static const boost::posix_time::ptime s_epoch =
+      boost::posix_time::microsec_clock::local_time();
+    return (boost::posix_time::microsec_clock::local_time() - s_epoch)
+      .total_microseconds() / 1000.;
+  }
+
+  template <typename T>
+  void benchmark(const char* name, const double max_value, const int height,
+      const int width, const int radius, const int repeats) {
+    blitz::Array<T,2> src(height, width);
+    for (int y=0; y<height; ++y)
+      for (int x=0; x<width; ++x)
+        src(y,x) = static_cast<T>((std::rand() / (RAND_MAX + 1.)) * max_value);
+    blitz::Array<T,2> dst_old(height-2*radius, width-2*radius);
+    blitz::Array<T,2> dst_new(height-2*radius, width-2*radius);
+
+    ListMedian<T> old_filter(radius, radius);
+    bob::ip::Median<T> new_filter(radius, radius);
+
+    double start = now();
+    for (int r=0; r<repeats; ++r) old_filter(src, dst_old);
+    const double t_old = (now() - start) / repeats;
+
+    start = now();
+    for (int r=0; r<repeats; ++r) new_filter(src, dst_new);
+    const double t_new = (now() - start) / repeats;
+
+    const bool same = blitz::all(dst_old == dst_new);
+    std::printf("  %-7s r=%-2d %9.1f %9.1f %s\n", name, radius, t_old, t_new,
+        same ? "" : "(outputs differ!)");
+  }
+
+}
+
+int main(int argc, char** argv) {
+  int height = 256, width = 256, repeats = 3;
+  if (argc == 4) {
+    height = std::atoi(argv[1]);
+    width = std::atoi(argv[2]);
+    repeats = std::atoi(argv[3]);
+  }
+  else if (argc != 1) {
+    std::fprintf(stderr, "usage: %s [height width repeats]\n", argv[0]);
+    return 1;
+  }
+
+  std::srand(0);
+  std::printf("Median filter on %dx%d random images, in ms (average of %d runs)\n",
+      height, width, repeats);
+  std::printf("                    old       new\n");
+  benchmark<uint8_t>("uint8", 256., height, width, 1, repeats);
+  benchmark<uint8_t>("uint8", 256., height, width, 2, repeats);
+  benchmark<uint8_t>("uint8", 256., height, width, 5, repeats);
+  benchmark<uint16_t>("uint16", 65536., height, width, 1, repeats);
+  benchmark<uint16_t>("uint16", 65536., height, width, 5, repeats);
+  benchmark<double>("float64", 1., height, width, 1, repeats);
+  benchmark<double>("float64", 1., height, width, 5, repeats);
+  return 0;
+}
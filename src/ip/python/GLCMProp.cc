@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/ip/GLCMProp.h>
 
 using namespace boost::python;
@@ -39,7 +40,11 @@ static object call_angular_second_moment_p(const bob::ip::GLCMProp& op, bob::pyt
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.angular_second_moment(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.angular_second_moment(input_, output_);
+  }
   return output.self();
 }   
 
@@ -55,7 +60,11 @@ static object call_energy_p(const bob::ip::GLCMProp& op, bob::python::const_ndar
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.energy(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.energy(input_, output_);
+  }
   return output.self();
 }   
   
@@ -71,7 +80,11 @@ static object call_variance_p(const bob::ip::GLCMProp& op, bob::python::const_nd
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.variance(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.variance(input_, output_);
+  }
   return output.self();
 }     
 
@@ -87,7 +100,11 @@ static object call_contrast_p(const bob::ip::GLCMProp& op, bob::python::const_nd
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.contrast(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.contrast(input_, output_);
+  }
   return output.self();
 }   
 
@@ -103,7 +120,11 @@ static object call_auto_correlation_p(const bob::ip::GLCMProp& op, bob::python::
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.auto_correlation(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.auto_correlation(input_, output_);
+  }
   return output.self();
 }   
 
@@ -119,7 +140,11 @@ static object call_correlation_p(const bob::ip::GLCMProp& op, bob::python::const
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.correlation(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.correlation(input_, output_);
+  }
   return output.self();
 }   
 
@@ -134,7 +159,11 @@ static object call_correlation_m_p(const bob::ip::GLCMProp& op, bob::python::con
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.correlation_m(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.correlation_m(input_, output_);
+  }
   return output.self();
 }   
 
@@ -149,7 +178,11 @@ static object call_inv_diff_mom_p(const bob::ip::GLCMProp& op, bob::python::cons
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.inv_diff_mom(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.inv_diff_mom(input_, output_);
+  }
   return output.self();
 }
 
@@ -164,7 +197,11 @@ static object call_sum_avg_p(const bob::ip::GLCMProp& op, bob::python::const_nda
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.sum_avg(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.sum_avg(input_, output_);
+  }
   return output.self();
 }
 
@@ -179,7 +216,11 @@ static object call_sum_var_p(const bob::ip::GLCMProp& op, bob::python::const_nda
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.sum_var(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.sum_var(input_, output_);
+  }
   return output.self();
 }
 
@@ -194,7 +235,11 @@ static object call_sum_entropy_p(const bob::ip::GLCMProp& op, bob::python::const
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.sum_entropy(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.sum_entropy(input_, output_);
+  }
   return output.self();
 }
 
@@ -210,7 +255,11 @@ static object call_entropy_p(const bob::ip::GLCMProp& op, bob::python::const_nda
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.entropy(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.entropy(input_, output_);
+  }
   return output.self();
 }
 
@@ -225,7 +274,11 @@ static object call_diff_var_p(const bob::ip::GLCMProp& op, bob::python::const_nd
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.diff_var(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.diff_var(input_, output_);
+  }
   return output.self();
 }
 
@@ -240,7 +293,11 @@ static object call_diff_entropy_p(const bob::ip::GLCMProp& op, bob::python::cons
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.diff_entropy(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.diff_entropy(input_, output_);
+  }
   return output.self();
 }
 
@@ -256,7 +313,11 @@ static object call_dissimilarity_p(const bob::ip::GLCMProp& op, bob::python::con
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.dissimilarity(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.dissimilarity(input_, output_);
+  }
   return output.self();
 }
 
@@ -272,7 +333,11 @@ static object call_homogeneity_p(const bob::ip::GLCMProp& op, bob::python::const
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.homogeneity(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.homogeneity(input_, output_);
+  }
   return output.self();
 }
 
@@ -287,7 +352,11 @@ static object call_cluster_prom_p(const bob::ip::GLCMProp& op, bob::python::cons
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.cluster_prom(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.cluster_prom(input_, output_);
+  }
   return output.self();
 }
 
@@ -302,7 +371,11 @@ static object call_cluster_shade_p(const bob::ip::GLCMProp& op, bob::python::con
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.cluster_shade(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.cluster_shade(input_, output_);
+  }
   return output.self();
 }
 
@@ -317,7 +390,11 @@ static object call_max_prob_p(const bob::ip::GLCMProp& op, bob::python::const_nd
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.max_prob(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.max_prob(input_, output_);
+  }
   return output.self();
 }
 
@@ -332,7 +409,11 @@ static object call_inf_meas_corr1_p(const bob::ip::GLCMProp& op, bob::python::co
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.inf_meas_corr1(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.inf_meas_corr1(input_, output_);
+  }
   return output.self();
 }
 
@@ -347,7 +428,11 @@ static object call_inf_meas_corr2_p(const bob::ip::GLCMProp& op, bob::python::co
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.inf_meas_corr2(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.inf_meas_corr2(input_, output_);
+  }
   return output.self();
 }
 
@@ -363,7 +448,11 @@ static object call_inv_diff_p(const bob::ip::GLCMProp& op, bob::python::const_nd
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.inv_diff(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.inv_diff(input_, output_);
+  }
   return output.self();
 }
 
@@ -379,7 +468,11 @@ static object call_inv_diff_norm_p(const bob::ip::GLCMProp& op, bob::python::con
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.inv_diff_norm(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.inv_diff_norm(input_, output_);
+  }
   return output.self();
 }
 
@@ -394,7 +487,11 @@ static object call_inv_diff_mom_norm_p(const bob::ip::GLCMProp& op, bob::python:
   const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
   bob::python::ndarray output(bob::core::array::t_float64, sh(0));
   blitz::Array<double,1> output_ = output.bz<double,1>();
-  op.inv_diff_mom_norm(input.bz<double,3>(), output_);
+  blitz::Array<double,3> input_ = input.bz<double,3>();
+  {
+    bob::python::no_gil unlock;
+    op.inv_diff_mom_norm(input_, output_);
+  }
   return output.self();
 }
 
@@ -23,6 +23,7 @@
 
 #include <boost/python.hpp>
 #include "bob/python/ndarray.h"
+#include "bob/python/gil.h"
 #include "bob/core/array_type.h"
 
 #include "bob/ip/GaborWaveletTransform.h"
@@ -36,7 +37,11 @@
 template <class T>
 static inline const blitz::Array<std::complex<double>,2> complex_cast (bob::python::const_ndarray input){
   blitz::Array<T,2> gray(input.type().shape[1],input.type().shape[2]);
-  bob::ip::rgb_to_gray(input.bz<T,3>(), gray);
+  blitz::Array<T,3> input_ = input.bz<T,3>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::rgb_to_gray(input_, gray);
+  }
   return bob::core::array::cast<std::complex<double> >(gray);
 }
 
@@ -79,6 +84,7 @@ static void gabor_wavelet_transform_1 (bob::ip::GaborKernel& kernel, bob::python
   // cast output image to complex type
   blitz::Array<std::complex<double>,2> output = output_image.bz<std::complex<double>,2>();
   // transform input to output
+  bob::python::no_gil unlock;
   transform(kernel, input, output);
 }
 
@@ -89,7 +95,10 @@ static blitz::Array<std::complex<double>,2> gabor_wavelet_transform_2 (bob::ip::
   blitz::Array<std::complex<double>,2> output(input.extent(0), input.extent(1));
 
   // transform input to output
-  transform(kernel, input, output);
+  {
+    bob::python::no_gil unlock;
+    transform(kernel, input, output);
+  }
 
   // return the nd array
   return output;
@@ -105,13 +114,17 @@ static blitz::Array<std::complex<double>,3> empty_trafo_image (bob::ip::GaborWav
 static void perform_gwt_1 (bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_trafo_image){
   const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
   blitz::Array<std::complex<double>,3> trafo_image = output_trafo_image.bz<std::complex<double>,3>();
+  bob::python::no_gil unlock;
   gwt.performGWT(image, trafo_image);
 }
 
 static blitz::Array<std::complex<double>,3> perform_gwt_2 (bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image){
   const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
   blitz::Array<std::complex<double>,3> trafo_image(gwt.numberOfKernels(), image.shape()[0], image.shape()[1]);
-  gwt.performGWT(image, trafo_image);
+  {
+    bob::python::no_gil unlock;
+    gwt.performGWT(image, trafo_image);
+  }
   return trafo_image;
 }
 
@@ -129,9 +142,11 @@ static void compute_jets_1(bob::ip::GaborWaveletTransform& gwt, bob::python::con
   if (output_jet_image.type().nd == 3){
     // compute jet image with absolute values only
     blitz::Array<double,3> jet_image = output_jet_image.bz<double,3>();
+    bob::python::no_gil unlock;
     gwt.computeJetImage(image, jet_image, normalized);
   } else if (output_jet_image.type().nd == 4){
     blitz::Array<double,4> jet_image = output_jet_image.bz<double,4>();
+    bob::python::no_gil unlock;
     gwt.computeJetImage(image, jet_image, normalized);
   } else {
     boost::format m("parameter `output_jet_image' has an unexpected shape: %s");
@@ -19,6 +19,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/ip/SIFT.h>
 
 #include <boost/python/stl_iterator.hpp>
@@ -40,7 +41,10 @@ static object inner_compute_descr_p(bob::ip::SIFT& op,
   bob::python::ndarray dst(bob::core::array::t_float64, (int)len(kp), sift_shape(0), sift_shape(1), sift_shape(2));
   const blitz::Array<T,2> src_ = src.bz<T,2>();
   blitz::Array<double,4> dst_ = dst.bz<double,4>();
-  op.computeDescriptor(src_, vkp_ref, dst_);
+  {
+    bob::python::no_gil unlock;
+    op.computeDescriptor(src_, vkp_ref, dst_);
+  }
 
   return dst.self();
 }
@@ -23,6 +23,7 @@
 #include <bob/ip/SpatioTemporalGradient.h>
 #include <bob/core/cast.h>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 
 using namespace boost::python;
 
@@ -85,7 +86,10 @@ static void forward_gradient_2(const bob::ip::ForwardGradient& g,
       break;
     case bob::core::array::t_float64:
       {
-        g(i1.bz<double,2>(), i2.bz<double,2>(), Ex_, Ey_, Et_);
+        blitz::Array<double,2> i1_ = i1.bz<double,2>();
+        blitz::Array<double,2> i2_ = i2.bz<double,2>();
+        bob::python::no_gil unlock;
+        g(i1_, i2_, Ex_, Ey_, Et_);
       }
       break;
     default:
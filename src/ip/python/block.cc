@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/ip/block.h>
 
 using namespace boost::python;
@@ -41,7 +42,9 @@ static void inner_block_3d(bob::python::const_ndarray input,
   const size_t c, const size_t d) 
 {
   blitz::Array<T,3> output_ = output.bz<T,3>();
-  bob::ip::block<T>(input.bz<T,2>(), output_, a, b, c, d);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  bob::python::no_gil unlock;
+  bob::ip::block<T>(input_, output_, a, b, c, d);
 }
 
 template <typename T> 
@@ -50,7 +53,9 @@ static void inner_block_4d(bob::python::const_ndarray input,
   const size_t c, const size_t d) 
 {
   blitz::Array<T,4> output_ = output.bz<T,4>();
-  bob::ip::block<T>(input.bz<T,2>(), output_, a, b, c, d);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  bob::python::no_gil unlock;
+  bob::ip::block<T>(input_, output_, a, b, c, d);
 }
 
 static void block(bob::python::const_ndarray input, 
@@ -22,6 +22,7 @@
 
 #include <bob/ip/color.h>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 
 using namespace boost::python;
 
@@ -265,19 +266,25 @@ void py_rgb_to_hsv (bob::python::const_ndarray from, bob::python::ndarray to)
     case bob::core::array::t_uint8:
       {
         blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::rgb_to_hsv(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> from_ = from.bz<uint8_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_hsv(from_, to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
         blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::rgb_to_hsv(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> from_ = from.bz<uint16_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_hsv(from_, to_);
       }
       break;
     case bob::core::array::t_float64:
       {
         blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::rgb_to_hsv(from.bz<double,3>(), to_);
+        blitz::Array<double,3> from_ = from.bz<double,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_hsv(from_, to_);
       }
       break;
     default:
@@ -301,19 +308,25 @@ void py_hsv_to_rgb (bob::python::const_ndarray from, bob::python::ndarray to)
     case bob::core::array::t_uint8:
       {
         blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::hsv_to_rgb(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> from_ = from.bz<uint8_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::hsv_to_rgb(from_, to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
         blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::hsv_to_rgb(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> from_ = from.bz<uint16_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::hsv_to_rgb(from_, to_);
       }
       break;
     case bob::core::array::t_float64:
       {
         blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::hsv_to_rgb(from.bz<double,3>(), to_);
+        blitz::Array<double,3> from_ = from.bz<double,3>();
+        bob::python::no_gil unlock;
+        bob::ip::hsv_to_rgb(from_, to_);
       }
       break;
     default:
@@ -337,19 +350,25 @@ void py_rgb_to_hsl (bob::python::const_ndarray from, bob::python::ndarray to)
     case bob::core::array::t_uint8:
       {
         blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::rgb_to_hsl(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> from_ = from.bz<uint8_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_hsl(from_, to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
         blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::rgb_to_hsl(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> from_ = from.bz<uint16_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_hsl(from_, to_);
       }
       break;
     case bob::core::array::t_float64:
       {
         blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::rgb_to_hsl(from.bz<double,3>(), to_);
+        blitz::Array<double,3> from_ = from.bz<double,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_hsl(from_, to_);
       }
       break;
     default:
@@ -373,19 +392,25 @@ void py_hsl_to_rgb (bob::python::const_ndarray from, bob::python::ndarray to)
     case bob::core::array::t_uint8:
       {
         blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::hsl_to_rgb(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> from_ = from.bz<uint8_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::hsl_to_rgb(from_, to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
         blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::hsl_to_rgb(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> from_ = from.bz<uint16_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::hsl_to_rgb(from_, to_);
       }
       break;
     case bob::core::array::t_float64:
       {
         blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::hsl_to_rgb(from.bz<double,3>(), to_);
+        blitz::Array<double,3> from_ = from.bz<double,3>();
+        bob::python::no_gil unlock;
+        bob::ip::hsl_to_rgb(from_, to_);
       }
       break;
     default:
@@ -409,19 +434,25 @@ void py_rgb_to_yuv (bob::python::const_ndarray from, bob::python::ndarray to)
     case bob::core::array::t_uint8:
       {
         blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::rgb_to_yuv(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> from_ = from.bz<uint8_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_yuv(from_, to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
         blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::rgb_to_yuv(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> from_ = from.bz<uint16_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_yuv(from_, to_);
       }
       break;
     case bob::core::array::t_float64:
       {
         blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::rgb_to_yuv(from.bz<double,3>(), to_);
+        blitz::Array<double,3> from_ = from.bz<double,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_yuv(from_, to_);
       }
       break;
     default:
@@ -445,19 +476,25 @@ void py_yuv_to_rgb (bob::python::const_ndarray from, bob::python::ndarray to)
     case bob::core::array::t_uint8:
       {
         blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::yuv_to_rgb(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> from_ = from.bz<uint8_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::yuv_to_rgb(from_, to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
         blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::yuv_to_rgb(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> from_ = from.bz<uint16_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::yuv_to_rgb(from_, to_);
       }
       break;
     case bob::core::array::t_float64:
       {
         blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::yuv_to_rgb(from.bz<double,3>(), to_);
+        blitz::Array<double,3> from_ = from.bz<double,3>();
+        bob::python::no_gil unlock;
+        bob::ip::yuv_to_rgb(from_, to_);
       }
       break;
     default:
@@ -481,19 +518,25 @@ void py_rgb_to_gray (bob::python::const_ndarray from, bob::python::ndarray to)
     case bob::core::array::t_uint8:
       {
         blitz::Array<uint8_t,2> to_ = to.bz<uint8_t,2>();
-        bob::ip::rgb_to_gray(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> from_ = from.bz<uint8_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_gray(from_, to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
         blitz::Array<uint16_t,2> to_ = to.bz<uint16_t,2>();
-        bob::ip::rgb_to_gray(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> from_ = from.bz<uint16_t,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_gray(from_, to_);
       }
       break;
     case bob::core::array::t_float64:
       {
         blitz::Array<double,2> to_ = to.bz<double,2>();
-        bob::ip::rgb_to_gray(from.bz<double,3>(), to_);
+        blitz::Array<double,3> from_ = from.bz<double,3>();
+        bob::python::no_gil unlock;
+        bob::ip::rgb_to_gray(from_, to_);
       }
       break;
     default:
@@ -523,19 +566,25 @@ void py_gray_to_rgb (bob::python::const_ndarray from, bob::python::ndarray to)
     case bob::core::array::t_uint8:
       {
         blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::gray_to_rgb(from.bz<uint8_t,2>(), to_);
+        blitz::Array<uint8_t,2> from_ = from.bz<uint8_t,2>();
+        bob::python::no_gil unlock;
+        bob::ip::gray_to_rgb(from_, to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
         blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::gray_to_rgb(from.bz<uint16_t,2>(), to_);
+        blitz::Array<uint16_t,2> from_ = from.bz<uint16_t,2>();
+        bob::python::no_gil unlock;
+        bob::ip::gray_to_rgb(from_, to_);
       }
       break;
     case bob::core::array::t_float64:
       {
         blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::gray_to_rgb(from.bz<double,2>(), to_);
+        blitz::Array<double,2> from_ = from.bz<double,2>();
+        bob::python::no_gil unlock;
+        bob::ip::gray_to_rgb(from_, to_);
       }
       break;
     default:
@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/ip/crop.h>
 #include <bob/ip/shift.h>
 
@@ -32,7 +33,9 @@ static void inner_crop1(bob::python::const_ndarray src,
   const size_t w, const bool allow_out, const bool zero_out) 
 {
   blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  bob::ip::crop<T>(src.bz<T,N>(), dst_, y, x, h, w, allow_out, zero_out);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::ip::crop<T>(src_, dst_, y, x, h, w, allow_out, zero_out);
 }
 
 template <int N>
@@ -163,7 +166,9 @@ static void inner_shift1(bob::python::const_ndarray src,
   const bool zero_out) 
 {
   blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  bob::ip::shift<T>(src.bz<T,N>(), dst_, y, x, allow_out, zero_out);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::ip::shift<T>(src_, dst_, y, x, allow_out, zero_out);
 }
 
 template <int N>
@@ -21,6 +21,7 @@
  */
 
 #include "bob/python/ndarray.h"
+#include "bob/python/gil.h"
 #include "bob/ip/extrapolateMask.h"
 
 using namespace boost::python;
@@ -30,7 +31,9 @@ static void inner_extrapolateMask(bob::python::const_ndarray src,
   bob::python::ndarray img) 
 {
   blitz::Array<T,2> img_ = img.bz<T,2>();
-  bob::ip::extrapolateMask<T>(src.bz<bool,2>(), img_);
+  blitz::Array<bool,2> src_ = src.bz<bool,2>();
+  bob::python::no_gil unlock;
+  bob::ip::extrapolateMask<T>(src_, img_);
 }
 
 static void extrapolate_mask(bob::python::const_ndarray src, 
@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/ip/flipflop.h>
 
 using namespace boost::python;
@@ -30,7 +31,9 @@ static void inner_flip(bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  bob::ip::flip<T>(src.bz<T,N>(), dst_);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::ip::flip<T>(src_, dst_);
 }
 
 template <int N>
@@ -96,7 +99,9 @@ static void inner_flop(bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  bob::ip::flop<T>(src.bz<T,N>(), dst_);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::ip::flop<T>(src_, dst_);
 }
 
 template <int N>
@@ -22,6 +22,7 @@
 
 #include <bob/ip/HornAndSchunckFlow.h>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/core/cast.h>
 
 using namespace boost::python;
@@ -42,7 +43,12 @@ static tuple vanillahs_call(const bob::ip::optflow::VanillaHornAndSchunckFlow& f
           bob::core::array::cast<double,uint8_t>(i2.bz<uint8_t,2>()), u_, v_);
       break;
     case bob::core::array::t_float64:
-      f(alpha, iterations, i1.bz<double,2>(), i2.bz<double,2>(), u_, v_);
+      {
+        blitz::Array<double,2> i1_ = i1.bz<double,2>();
+        blitz::Array<double,2> i2_ = i2.bz<double,2>();
+        bob::python::no_gil unlock;
+        f(alpha, iterations, i1_, i2_, u_, v_);
+      }
       break;
     default:
       PYTHON_ERROR(TypeError, "vanilla Horn&Schunck operator does not support array with type '%s'", info.str().c_str());
@@ -61,7 +67,12 @@ static void vanillahs_call2(const bob::ip::optflow::VanillaHornAndSchunckFlow& f
           bob::core::array::cast<double,uint8_t>(i2.bz<uint8_t,2>()), u_, v_);
       break;
     case bob::core::array::t_float64:
-      f(alpha, iterations, i1.bz<double,2>(), i2.bz<double,2>(), u_, v_);
+      {
+        blitz::Array<double,2> i1_ = i1.bz<double,2>();
+        blitz::Array<double,2> i2_ = i2.bz<double,2>();
+        bob::python::no_gil unlock;
+        f(alpha, iterations, i1_, i2_, u_, v_);
+      }
       break;
     default:
       PYTHON_ERROR(TypeError, "vanilla Horn&Schunck operator does not support array with type '%s'", i1.type().str().c_str());
@@ -73,7 +84,12 @@ static object vanillahs_ec2(const bob::ip::optflow::VanillaHornAndSchunckFlow& f
   const bob::core::array::typeinfo& info = u.type();
   bob::python::ndarray error(info);
   blitz::Array<double,2> error_ = error.bz<double,2>();
-  f.evalEc2(u.bz<double,2>(), v.bz<double,2>(), error_);
+  blitz::Array<double,2> u_ = u.bz<double,2>();
+  blitz::Array<double,2> v_ = v.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    f.evalEc2(u_, v_, error_);
+  }
   return error.self();
 }
 
@@ -149,7 +165,12 @@ static object hs_ec2(const bob::ip::optflow::HornAndSchunckFlow& f,
   const bob::core::array::typeinfo& info = u.type();
   bob::python::ndarray error(info);
   blitz::Array<double,2> error_ = error.bz<double,2>();
-  f.evalEc2(u.bz<double,2>(), v.bz<double,2>(), error_);
+  blitz::Array<double,2> u_ = u.bz<double,2>();
+  blitz::Array<double,2> v_ = v.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    f.evalEc2(u_, v_, error_);
+  }
   return error.self();
 }
 
@@ -197,14 +218,22 @@ static object flow_error(bob::python::const_ndarray i1, bob::python::const_ndarr
 static object laplacian_avg_hs_opencv(bob::python::const_ndarray i) {
   bob::python::ndarray o(i.type());
   blitz::Array<double,2> o_ = o.bz<double,2>();
-  bob::ip::optflow::laplacian_avg_hs_opencv(i.bz<double,2>(), o_);
+  blitz::Array<double,2> i_ = i.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::optflow::laplacian_avg_hs_opencv(i_, o_);
+  }
   return o.self();
 }
 
 static object laplacian_avg_hs(bob::python::const_ndarray i) {
   bob::python::ndarray o(i.type());
   blitz::Array<double,2> o_ = o.bz<double,2>();
-  bob::ip::optflow::laplacian_avg_hs(i.bz<double,2>(), o_);
+  blitz::Array<double,2> i_ = i.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::optflow::laplacian_avg_hs(i_, o_);
+  }
   return o.self();
 }
 
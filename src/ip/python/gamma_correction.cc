@@ -22,6 +22,7 @@
 
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/ip/gammaCorrection.h>
 
 using namespace boost::python;
@@ -31,7 +32,9 @@ static void inner_gammaCorrection_c(bob::python::const_ndarray src,
   bob::python::ndarray dst, const double g) 
 {
   blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::gammaCorrection<T>(src.bz<T,N>(), dst_, g);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::ip::gammaCorrection<T>(src_, dst_, g);
 }
 
 static void py_gamma_correction_c(bob::python::const_ndarray src,
@@ -61,7 +64,11 @@ static object inner_gammaCorrection_p(bob::python::const_ndarray src,
   bob::python::ndarray dst(bob::core::array::t_float64, info.shape[0],
     info.shape[1]);
   blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::gammaCorrection<T>(src.bz<T,N>(), dst_, g);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::gammaCorrection<T>(src_, dst_, g);
+  }
   return dst.self();
 }
 
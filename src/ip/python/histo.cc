@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/ip/histo.h>
 
 using namespace boost::python;
@@ -30,7 +31,11 @@ static object inner_histo1 (bob::python::const_ndarray input) {
   int size = bob::ip::detail::getHistoSize<T>();
   bob::python::ndarray out(bob::core::array::t_uint64, size);
   blitz::Array<uint64_t,1> out_ = out.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, false);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::histogram(input_, out_, false);
+  }
   return out.self();
 }
 
@@ -48,7 +53,9 @@ template <typename T>
 static void inner_histo2 (bob::python::const_ndarray input, bob::python::ndarray output,
     bool accumulate) {
   blitz::Array<uint64_t,1> out_ = output.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, accumulate);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  bob::python::no_gil unlock;
+  bob::ip::histogram(input_, out_, accumulate);
 }
 
 static void histo2 (bob::python::const_ndarray input, bob::python::ndarray output,
@@ -69,7 +76,9 @@ static void inner_histo3 (bob::python::const_ndarray input, bob::python::ndarray
     object max, bool accumulate) {
   blitz::Array<uint64_t,1> out_ = output.bz<uint64_t,1>();
   T tmax = extract<T>(max);
-  bob::ip::histogram(input.bz<T,2>(), out_, (T)0, tmax, (uint32_t)(tmax+1), accumulate);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  bob::python::no_gil unlock;
+  bob::ip::histogram(input_, out_, (T)0, tmax, (uint32_t)(tmax+1), accumulate);
 }
 
 static void histo3 (bob::python::const_ndarray input, bob::python::ndarray output, object max,
@@ -109,7 +118,9 @@ static void inner_histo4 (bob::python::const_ndarray input, bob::python::ndarray
   blitz::Array<uint64_t,1> out_ = output.bz<uint64_t,1>();
   T tmin = extract<T>(min);
   T tmax = extract<T>(max);
-  bob::ip::histogram(input.bz<T,2>(), out_, tmin, tmax, (uint32_t)(tmax-tmin+1), accumulate);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  bob::python::no_gil unlock;
+  bob::ip::histogram(input_, out_, tmin, tmax, (uint32_t)(tmax-tmin+1), accumulate);
 }
 
 static void histo4 (bob::python::const_ndarray input, bob::python::ndarray output,
@@ -149,7 +160,9 @@ static void inner_histo5 (bob::python::const_ndarray input, bob::python::ndarray
   blitz::Array<uint64_t,1> out_ = output.bz<uint64_t,1>();
   T tmin = extract<T>(min);
   T tmax = extract<T>(max);
-  bob::ip::histogram(input.bz<T,2>(), out_, tmin, tmax, nbins, accumulate);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  bob::python::no_gil unlock;
+  bob::ip::histogram(input_, out_, tmin, tmax, nbins, accumulate);
 }
 
 static void histo5 (bob::python::const_ndarray input, bob::python::ndarray output,
@@ -189,7 +202,11 @@ static object inner_histo3a (bob::python::const_ndarray input, object max) {
   uint32_t size = (uint32_t)(tmax + 1);
   bob::python::ndarray out(bob::core::array::t_uint64, size);
   blitz::Array<uint64_t,1> out_ = out.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, (T)0, tmax, size, false);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::histogram(input_, out_, (T)0, tmax, size, false);
+  }
   return out.self();
 }
 
@@ -218,7 +235,11 @@ static object inner_histo4a (bob::python::const_ndarray input, object min, objec
   int64_t size = (int64_t)(tmax - tmin + 1);
   bob::python::ndarray out(bob::core::array::t_uint64, size);
   blitz::Array<uint64_t,1> out_ = out.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, tmin, tmax, size, false);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::histogram(input_, out_, tmin, tmax, size, false);
+  }
   return out.self();
 }
 
@@ -257,7 +278,11 @@ static object inner_histo5a (bob::python::const_ndarray input, object min, objec
   T tmax = extract<T>(max);
   bob::python::ndarray out(bob::core::array::t_uint64, nbins);
   blitz::Array<uint64_t,1> out_ = out.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, tmin, tmax, nbins, false);
+  blitz::Array<T,2> input_ = input.bz<T,2>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::histogram(input_, out_, tmin, tmax, nbins, false);
+  }
   return out.self();
 }
 
@@ -294,6 +319,7 @@ template <typename T1, typename T2>
 static void inner_histogram_equalization2(bob::python::const_ndarray src, bob::python::ndarray dst){
   const blitz::Array<T1,2> src_array = src.bz<T1,2>();
   blitz::Array<T2,2> dst_array = dst.bz<T2,2>();
+  bob::python::no_gil unlock;
   bob::ip::histogram_equalize<T1,T2>(src_array, dst_array);
 }
 
@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/ip/shear.h>
 
 using namespace boost::python;
@@ -68,7 +69,9 @@ static void inner_shear_x(bob::python::const_ndarray src,
   bob::python::ndarray dst, double a, bool aa) 
 {
   blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::shearX<T>(src.bz<T,N>(), dst_, a, aa);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::ip::shearX<T>(src_, dst_, a, aa);
 }
 
 static void shear_x(bob::python::const_ndarray src, 
@@ -94,7 +97,11 @@ static object inner_shear_x_p(bob::python::const_ndarray src, double a,
   const blitz::TinyVector<int,2> shape = bob::ip::getShearXShape<T>(src.bz<T,2>(), a);
   bob::python::ndarray dst(bob::core::array::t_float64, shape(0), shape(1));
   blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::shearX<T>(src.bz<T,N>(), dst_, a, aa);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::shearX<T>(src_, dst_, a, aa);
+  }
   return dst.self();
 }
 
@@ -120,7 +127,9 @@ static void inner_shear_y(bob::python::const_ndarray src,
   bob::python::ndarray dst, double a, bool aa) 
 {
   blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::shearY<T>(src.bz<T,N>(), dst_, a, aa);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::ip::shearY<T>(src_, dst_, a, aa);
 }
 
 static void shear_y(bob::python::const_ndarray src, 
@@ -146,7 +155,11 @@ static object inner_shear_y_p(bob::python::const_ndarray src, double a,
   const blitz::TinyVector<int,2> shape = bob::ip::getShearYShape<T>(src.bz<T,2>(), a);
   bob::python::ndarray dst(bob::core::array::t_float64, shape(0), shape(1));
   blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::shearY<T>(src.bz<T,N>(), dst_, a, aa);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  {
+    bob::python::no_gil unlock;
+    bob::ip::shearY<T>(src_, dst_, a, aa);
+  }
   return dst.self();
 }
 
@@ -173,7 +186,10 @@ static void inner_shear_x2 (bob::python::const_ndarray src,
 {
   blitz::Array<double,N> dst_ = dst.bz<double,N>();
   blitz::Array<bool,N> dmask_ = dmask.bz<bool,N>();
-  bob::ip::shearX<T>(src.bz<T,N>(), src.bz<bool,N>(), dst_, dmask_, a, aa);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  blitz::Array<bool,N> smask_ = smask.bz<bool,N>();
+  bob::python::no_gil unlock;
+  bob::ip::shearX<T>(src_, smask_, dst_, dmask_, a, aa);
 }
 
 static void shear_x2(bob::python::const_ndarray src, 
@@ -203,7 +219,10 @@ static void inner_shear_y2(bob::python::const_ndarray src,
 {
   blitz::Array<double,N> dst_ = dst.bz<double,N>();
   blitz::Array<bool,N> dmask_ = dmask.bz<bool,N>();
-  bob::ip::shearY<T>(src.bz<T,N>(), src.bz<bool,N>(), dst_, dmask_, a, aa);
+  blitz::Array<T,N> src_ = src.bz<T,N>();
+  blitz::Array<bool,N> smask_ = smask.bz<bool,N>();
+  bob::python::no_gil unlock;
+  bob::ip::shearY<T>(src_, smask_, dst_, dmask_, a, aa);
 }
 
 static void shear_y2(bob::python::const_ndarray src, 
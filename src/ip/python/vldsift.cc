@@ -21,19 +21,26 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/ip/VLDSIFT.h>
 
 using namespace boost::python;
 
 static void call_vldsift_(bob::ip::VLDSIFT& op, bob::python::const_ndarray src, bob::python::ndarray dst) {
   blitz::Array<float,2> dst_ = dst.bz<float,2>();
-  op(src.bz<float,2>(), dst_);
+  blitz::Array<float,2> src_ = src.bz<float,2>();
+  bob::python::no_gil unlock;
+  op(src_, dst_);
 }
 
 static object call_vldsift(bob::ip::VLDSIFT& op, bob::python::const_ndarray src) {
   bob::python::ndarray dst(bob::core::array::t_float32, op.getNKeypoints(), op.getDescriptorSize());
   blitz::Array<float,2> dst_ = dst.bz<float,2>();
-  op(src.bz<float,2>(), dst_);
+  blitz::Array<float,2> src_ = src.bz<float,2>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst_);
+  }
   return dst.self();
 }
 
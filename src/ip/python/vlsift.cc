@@ -21,6 +21,7 @@
  */
 
 #include "bob/python/ndarray.h"
+#include "bob/python/gil.h"
 #include "bob/ip/VLSIFT.h"
 
 using namespace boost::python;
@@ -28,7 +29,11 @@ using namespace boost::python;
 static object call_vlsift(bob::ip::VLSIFT& op, bob::python::const_ndarray src) 
 {
   std::vector<blitz::Array<double,1> > dst;
-  op(src.bz<uint8_t,2>(), dst);
+  blitz::Array<uint8_t,2> src_ = src.bz<uint8_t,2>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst);
+  }
   list t;
   for(size_t i=0; i<dst.size(); ++i) t.append(dst[i]);
   return t;
@@ -37,7 +42,12 @@ static object call_vlsift(bob::ip::VLSIFT& op, bob::python::const_ndarray src)
 static object call_kp_vlsift(bob::ip::VLSIFT& op, bob::python::const_ndarray src, bob::python::const_ndarray kp) 
 {
   std::vector<blitz::Array<double,1> > dst;
-  op(src.bz<uint8_t,2>(), kp.bz<double,2>(), dst);
+  blitz::Array<uint8_t,2> src_ = src.bz<uint8_t,2>();
+  blitz::Array<double,2> kp_ = kp.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, kp_, dst);
+  }
   list t;
   for(size_t i=0; i<dst.size(); ++i) t.append(dst[i]);
   return t;
@@ -21,6 +21,7 @@
  */
 
 #include "bob/python/ndarray.h"
+#include "bob/python/gil.h"
 #include "bob/ip/zigzag.h"
 
 using namespace boost::python;
@@ -29,7 +30,9 @@ template <typename T>
 static void inner_zigzag(bob::python::const_ndarray src, 
   blitz::Array<T,1>& dst, const bool rf) 
 {
-  bob::ip::zigzag(src.bz<T,2>(), dst, rf);
+  blitz::Array<T,2> src_ = src.bz<T,2>();
+  bob::python::no_gil unlock;
+  bob::ip::zigzag(src_, dst, rf);
 }
 
 static object py_zigzag(bob::python::const_ndarray src, 
@@ -24,14 +24,149 @@
 #include "bob/machine/Activation.h"
 #include "bob/machine/ActivationRegistry.h"
 
+namespace {
+
+  /**
+   * Replaces each element z(i,j) by f(z(i,j) + bias(j)). Rows of contiguous
+   * elements are processed through plain pointers, in loops the compiler
+   * can inline f into (and vectorize).
+   */
+  template <typename F>
+  void apply_layer(blitz::Array<double,2>& z,
+      const blitz::Array<double,1>& bias, const F& f) {
+    const int rows = z.extent(0);
+    const int cols = z.extent(1);
+    if (z.stride(1) == 1 && bias.stride(0) == 1) {
+      const double* b = bias.data();
+      for (int i=0; i<rows; ++i) {
+        double* r = &z(z.lbound(0)+i, z.lbound(1));
+        for (int j=0; j<cols; ++j) r[j] = f(r[j] + b[j]);
+      }
+    }
+    else {
+      for (int i=z.lbound(0); i<=z.ubound(0); ++i)
+        for (int j=0; j<cols; ++j)
+          z(i,z.lbound(1)+j) = f(z(i,z.lbound(1)+j) + bias(bias.lbound(0)+j));
+    }
+  }
+
+  /**
+   * Multiplies each element error(i,j) by f_prime_from_f(a(i,j))
+   */
+  template <typename F>
+  void apply_derivative(const blitz::Array<double,2>& a,
+      blitz::Array<double,2>& error, const F& f_prime_from_f) {
+    const int rows = error.extent(0);
+    const int cols = error.extent(1);
+    if (a.stride(1) == 1 && error.stride(1) == 1) {
+      for (int i=0; i<rows; ++i) {
+        const double* ar = &a(a.lbound(0)+i, a.lbound(1));
+        double* er = &error(error.lbound(0)+i, error.lbound(1));
+        for (int j=0; j<cols; ++j) er[j] *= f_prime_from_f(ar[j]);
+      }
+    }
+    else {
+      for (int i=0; i<rows; ++i)
+        for (int j=0; j<cols; ++j)
+          error(error.lbound(0)+i, error.lbound(1)+j) *=
+            f_prime_from_f(a(a.lbound(0)+i, a.lbound(1)+j));
+    }
+  }
+
+  /**
+   * Element-wise functions passed to apply_layer() and apply_derivative().
+   * The generic ones go through the virtual methods of an Activation, the
+   * others are the inlined counterparts of each activation.
+   */
+  struct ActivationF {
+    ActivationF(const bob::machine::Activation& a): m_a(a) {}
+    double operator()(double x) const { return m_a.f(x); }
+    const bob::machine::Activation& m_a;
+  };
+
+  struct ActivationFPrimeFromF {
+    ActivationFPrimeFromF(const bob::machine::Activation& a): m_a(a) {}
+    double operator()(double x) const { return m_a.f_prime_from_f(x); }
+    const bob::machine::Activation& m_a;
+  };
+
+  struct IdentityF {
+    double operator()(double x) const { return x; }
+  };
+
+  struct LinearF {
+    LinearF(double C): m_C(C) {}
+    double operator()(double x) const { return m_C * x; }
+    double m_C;
+  };
+
+  struct ConstantF {
+    ConstantF(double C): m_C(C) {}
+    double operator()(double) const { return m_C; }
+    double m_C;
+  };
+
+  struct HyperbolicTangentF {
+    double operator()(double x) const { return std::tanh(x); }
+  };
+
+  struct HyperbolicTangentFPrimeFromF {
+    double operator()(double x) const { return (1. - (x*x)); }
+  };
+
+  struct MultipliedHyperbolicTangentF {
+    MultipliedHyperbolicTangentF(double C, double M): m_C(C), m_M(M) {}
+    double operator()(double x) const { return m_C * std::tanh(m_M * x); }
+    double m_C;
+    double m_M;
+  };
+
+  struct MultipliedHyperbolicTangentFPrimeFromF {
+    MultipliedHyperbolicTangentFPrimeFromF(double C, double M):
+      m_C(C), m_M(M) {}
+    double operator()(double x) const
+    { return m_C * m_M * (1. - (x/m_C)*(x/m_C)); }
+    double m_C;
+    double m_M;
+  };
+
+  struct LogisticF {
+    double operator()(double x) const { return 1. / ( 1. + std::exp(-x) ); }
+  };
+
+  struct LogisticFPrimeFromF {
+    double operator()(double x) const { return x * (1. - x); }
+  };
+
+}
+
 namespace bob { namespace machine {
 
+  void Activation::f_layer (blitz::Array<double,2>& z,
+      const blitz::Array<double,1>& bias) const {
+    apply_layer(z, bias, ActivationF(*this));
+  }
+
+  void Activation::f_prime_from_f_layer (const blitz::Array<double,2>& a,
+      blitz::Array<double,2>& error) const {
+    apply_derivative(a, error, ActivationFPrimeFromF(*this));
+  }
+
   double IdentityActivation::f (double z) const { return z; }
 
   double IdentityActivation::f_prime (double) const { return 1.; }
   
   double IdentityActivation::f_prime_from_f (double) const { return 1.; }
 
+  void IdentityActivation::f_layer (blitz::Array<double,2>& z,
+      const blitz::Array<double,1>& bias) const {
+    apply_layer(z, bias, IdentityF());
+  }
+
+  void IdentityActivation::f_prime_from_f_layer (const blitz::Array<double,2>&,
+      blitz::Array<double,2>&) const {
+  }
+
   void IdentityActivation::save(bob::io::HDF5File& f) const {
     f.set("id", unique_identifier());
   }
@@ -57,6 +192,16 @@ namespace bob { namespace machine {
   
   double LinearActivation::f_prime_from_f (double a) const { return m_C; }
 
+  void LinearActivation::f_layer (blitz::Array<double,2>& z,
+      const blitz::Array<double,1>& bias) const {
+    apply_layer(z, bias, LinearF(m_C));
+  }
+
+  void LinearActivation::f_prime_from_f_layer (const blitz::Array<double,2>& a,
+      blitz::Array<double,2>& error) const {
+    apply_derivative(a, error, ConstantF(m_C));
+  }
+
   double LinearActivation::C() const { return m_C; }
 
   void LinearActivation::save(bob::io::HDF5File& f) const {
@@ -84,6 +229,16 @@ namespace bob { namespace machine {
 
   double HyperbolicTangentActivation::f_prime_from_f (double a) const { return (1. - (a*a)); }
 
+  void HyperbolicTangentActivation::f_layer (blitz::Array<double,2>& z,
+      const blitz::Array<double,1>& bias) const {
+    apply_layer(z, bias, HyperbolicTangentF());
+  }
+
+  void HyperbolicTangentActivation::f_prime_from_f_layer
+    (const blitz::Array<double,2>& a, blitz::Array<double,2>& error) const {
+    apply_derivative(a, error, HyperbolicTangentFPrimeFromF());
+  }
+
   void HyperbolicTangentActivation::save(bob::io::HDF5File& f) const {
     f.set("id", unique_identifier());
   }
@@ -111,6 +266,17 @@ namespace bob { namespace machine {
   double MultipliedHyperbolicTangentActivation::f_prime_from_f (double a) const
   { return m_C * m_M * (1. - std::pow(a/m_C,2)); }
 
+  void MultipliedHyperbolicTangentActivation::f_layer
+    (blitz::Array<double,2>& z, const blitz::Array<double,1>& bias) const {
+    apply_layer(z, bias, MultipliedHyperbolicTangentF(m_C, m_M));
+  }
+
+  void MultipliedHyperbolicTangentActivation::f_prime_from_f_layer
+    (const blitz::Array<double,2>& a, blitz::Array<double,2>& error) const {
+    apply_derivative(a, error,
+        MultipliedHyperbolicTangentFPrimeFromF(m_C, m_M));
+  }
+
   double MultipliedHyperbolicTangentActivation::C() const { return m_C; }
 
   double MultipliedHyperbolicTangentActivation::M() const { return m_M; }
@@ -143,6 +309,16 @@ namespace bob { namespace machine {
 
   double LogisticActivation::f_prime_from_f (double a) const { return a * (1. - a); }
 
+  void LogisticActivation::f_layer (blitz::Array<double,2>& z,
+      const blitz::Array<double,1>& bias) const {
+    apply_layer(z, bias, LogisticF());
+  }
+
+  void LogisticActivation::f_prime_from_f_layer
+    (const blitz::Array<double,2>& a, blitz::Array<double,2>& error) const {
+    apply_derivative(a, error, LogisticFPrimeFromF());
+  }
+
   void LogisticActivation::save(bob::io::HDF5File& f) const {
     f.set("id", unique_identifier());
   }
@@ -31,6 +31,20 @@
 #include <bob/math/linear.h>
 #include <bob/core/assert.h>
 #include <bob/core/check.h>
+#include <bob/core/thread_local.h>
+
+namespace {
+
+  /**
+   * Differences to the class means and their projections, private to each
+   * thread
+   */
+  struct BICScratch {
+    blitz::Array<double,1> diff_I, diff_E;
+    blitz::Array<double,1> proj_I, proj_E;
+  };
+
+}
 
 /**
  * Initializes an empty BIC Machine
@@ -163,13 +177,6 @@ bool bob::machine::BICMachine::is_similar_to(const BICMachine& other,
 
 
 
-void bob::machine::BICMachine::initialize(bool clazz, int input_length, int projected_length){
-  blitz::Array<double,1>& diff = clazz ? m_diff_E : m_diff_I;
-  blitz::Array<double,1>& proj = clazz ? m_proj_E : m_proj_I;
-  diff.resize(input_length);
-  proj.resize(projected_length);
-}
-
 /**
  * Sets the parameters of the given class that are required for computing the IEC scores (Guenther, Wuertz)
  *
@@ -243,9 +250,6 @@ void bob::machine::BICMachine::setBIC(
 
   // check that rho has a reasonable value (if it is used)
   if (m_use_DFFS && rho_ < 1e-12) throw std::runtime_error("The given average eigenvalue (rho) is too close to zero");
-
-  // initialize temporaries
-  initialize(clazz, Phi.shape()[0], Phi.shape()[1]);
 }
 
 /**
@@ -271,7 +275,6 @@ void bob::machine::BICMachine::load(bob::io::HDF5File& config){
   if (m_project_data){
     m_use_DFFS = config.read<bool>("use_DFFS");
     m_Phi_I.reference(config.readArray<double,2>("intra_subspace"));
-    initialize(false, m_Phi_I.shape()[0], m_Phi_I.shape()[1]);
     m_rho_I = config.read<double>("intra_rho");
   }
 
@@ -279,7 +282,6 @@ void bob::machine::BICMachine::load(bob::io::HDF5File& config){
   m_lambda_E.reference(config.readArray<double,1>("extra_variance"));
   if (m_project_data){
     m_Phi_E.reference(config.readArray<double,2>("extra_subspace"));
-    initialize(true, m_Phi_E.shape()[0], m_Phi_E.shape()[1]);
     m_rho_E = config.read<double>("extra_rho");
   }
   // check that rho has reasonable values
@@ -320,22 +322,27 @@ void bob::machine::BICMachine::save(bob::io::HDF5File& config) const{
  */
 void bob::machine::BICMachine::forward_(const blitz::Array<double,1>& input, double& output) const{
   if (m_project_data){
+    BICScratch& s = bob::core::threadLocal<BICScratch>();
+    bob::core::ensureExtent(s.diff_I, m_Phi_I.extent(0));
+    bob::core::ensureExtent(s.diff_E, m_Phi_E.extent(0));
+    bob::core::ensureExtent(s.proj_I, m_Phi_I.extent(1));
+    bob::core::ensureExtent(s.proj_E, m_Phi_E.extent(1));
     // subtract mean
-    m_diff_I = input - m_mu_I;
-    m_diff_E = input - m_mu_E;
+    s.diff_I = input - m_mu_I;
+    s.diff_E = input - m_mu_E;
     // project data to intrapersonal and extrapersonal subspace
-    bob::math::prod(m_diff_I, m_Phi_I, m_proj_I);
-    bob::math::prod(m_diff_E, m_Phi_E, m_proj_E);
+    bob::math::prod(s.diff_I, m_Phi_I, s.proj_I);
+    bob::math::prod(s.diff_E, m_Phi_E, s.proj_E);
 
     // compute Mahalanobis distance
-    output = blitz::sum(blitz::pow2(m_proj_E) / m_lambda_E) - blitz::sum(blitz::pow2(m_proj_I) / m_lambda_I);
+    output = blitz::sum(blitz::pow2(s.proj_E) / m_lambda_E) - blitz::sum(blitz::pow2(s.proj_I) / m_lambda_I);
 
     // add the DFFS?
     if (m_use_DFFS){
-      output += blitz::sum(blitz::pow2(m_diff_E) - blitz::pow2(m_proj_E)) / m_rho_E;
-      output -= blitz::sum(blitz::pow2(m_diff_I) - blitz::pow2(m_proj_I)) / m_rho_I;
+      output += blitz::sum(blitz::pow2(s.diff_E) - blitz::pow2(s.proj_E)) / m_rho_E;
+      output -= blitz::sum(blitz::pow2(s.diff_I) - blitz::pow2(s.proj_I)) / m_rho_I;
     }
-    output /= (m_proj_E.extent(0) + m_proj_I.extent(0));
+    output /= (s.proj_E.extent(0) + s.proj_I.extent(0));
   } else {
     // forward without projection
     output = blitz::mean( blitz::pow2(input - m_mu_E) / m_lambda_E
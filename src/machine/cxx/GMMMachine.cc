@@ -22,6 +22,34 @@
 #include <bob/machine/GMMMachine.h>
 #include <bob/core/assert.h>
 #include <bob/math/log.h>
+#include <bob/math/linear.h>
+#include <bob/core/thread_local.h>
+#include <algorithm>
+
+namespace {
+
+  /**
+   * Scratch space of the per-sample computations, private to each thread
+   */
+  struct GMMScratch {
+    blitz::Array<double,1> log_weighted_gaussian_likelihoods;
+    blitz::Array<double,1> P;
+  };
+
+  GMMScratch& getScratch(const size_t n_gaussians) {
+    GMMScratch& s = bob::core::threadLocal<GMMScratch>();
+    bob::core::ensureExtent(s.log_weighted_gaussian_likelihoods, n_gaussians);
+    bob::core::ensureExtent(s.P, n_gaussians);
+    return s;
+  }
+
+  /**
+   * Number of samples processed at once by the batch computations, which
+   * bounds the size of the workspaces (n_samples x n_gaussians and
+   * n_samples x 2*n_inputs) independently of the number of samples
+   */
+  const int GMM_BATCH_BLOCK_SIZE = 256;
+}
 
 bob::machine::GMMMachine::GMMMachine(): m_gaussians(0) {
   resize(0,0);
@@ -260,13 +288,142 @@ double bob::machine::GMMMachine::logLikelihood(const blitz::Array<double, 1> &x)
   bob::core::array::assertSameDimensionLength(x.extent(0), m_n_inputs);
   // Call the other logLikelihood_ (overloaded) function
   // (log_weighted_gaussian_likelihoods will be discarded)
-  return logLikelihood_(x,m_cache_log_weighted_gaussian_likelihoods);
+  return logLikelihood_(x,getScratch(m_n_gaussians).log_weighted_gaussian_likelihoods);
 }
 
 double bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 1> &x) const {
   // Call the other logLikelihood (overloaded) function
   // (log_weighted_gaussian_likelihoods will be discarded)
-  return logLikelihood_(x,m_cache_log_weighted_gaussian_likelihoods);
+  return logLikelihood_(x,getScratch(m_n_gaussians).log_weighted_gaussian_likelihoods);
+}
+
+void bob::machine::GMMMachine::logLikelihood(const blitz::Array<double,2> &input,
+  blitz::Array<double,2> &log_weighted_gaussian_likelihoods,
+  blitz::Array<double,1> &log_likelihoods) const
+{
+  // Check dimensions
+  bob::core::array::assertSameDimensionLength(input.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(log_weighted_gaussian_likelihoods.extent(0), input.extent(0));
+  bob::core::array::assertSameDimensionLength(log_weighted_gaussian_likelihoods.extent(1), m_n_gaussians);
+  bob::core::array::assertSameDimensionLength(log_likelihoods.extent(0), input.extent(0));
+  logLikelihood_(input, log_weighted_gaussian_likelihoods, log_likelihoods);
+}
+
+void bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double,2> &input,
+  blitz::Array<double,2> &log_weighted_gaussian_likelihoods,
+  blitz::Array<double,1> &log_likelihoods) const
+{
+  const int n_samples = input.extent(0);
+  if (n_samples == 0) return;
+
+  const int G = m_n_gaussians;
+  const int D = m_n_inputs;
+  blitz::Array<double,1> center(D), constants(G);
+  blitz::Array<double,2> params(G, 2*D);
+  getBatchParameters(center, params, constants);
+
+  const int block_size = std::min(n_samples, GMM_BATCH_BLOCK_SIZE);
+  blitz::Array<double,2> features_(block_size, 2*D);
+  blitz::Array<double,2> L_(block_size, G);
+  blitz::Array<double,1> ll_(block_size);
+  blitz::Range a = blitz::Range::all();
+
+  for (int start=0; start<n_samples; start+=block_size) {
+    const int n = std::min(block_size, n_samples-start);
+    blitz::Range block(start, start+n-1), rows(0, n-1);
+    blitz::Array<double,2> features = features_(rows, a);
+    blitz::Array<double,2> L = L_(rows, a);
+    blitz::Array<double,1> ll = ll_(rows);
+    logLikelihoodBlock(input, start, center, params, constants, features,
+      L, ll);
+    log_weighted_gaussian_likelihoods(block, a) = L;
+    log_likelihoods(block) = ll;
+  }
+}
+
+void bob::machine::GMMMachine::logLikelihood(const blitz::Array<double,2> &input,
+  blitz::Array<double,1> &log_likelihoods) const
+{
+  // Check dimensions
+  bob::core::array::assertSameDimensionLength(input.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(log_likelihoods.extent(0), input.extent(0));
+  logLikelihood_(input, log_likelihoods);
+}
+
+void bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double,2> &input,
+  blitz::Array<double,1> &log_likelihoods) const
+{
+  // (log_weighted_gaussian_likelihoods will be discarded)
+  blitz::Array<double,2> log_weighted_gaussian_likelihoods(input.extent(0),
+    m_n_gaussians);
+  logLikelihood_(input, log_weighted_gaussian_likelihoods, log_likelihoods);
+}
+
+void bob::machine::GMMMachine::getBatchParameters(blitz::Array<double,1> &center,
+  blitz::Array<double,2> &params, blitz::Array<double,1> &constants) const
+{
+  // The Gaussians might have been updated since the last call
+  // (e.g. by a trainer, through updateGaussian()): gathers their parameters
+  const int D = m_n_inputs;
+  center = 0.;
+  for (size_t i=0; i<m_n_gaussians; ++i) center += m_gaussians[i]->getMean();
+  if (m_n_gaussians > 0) center /= static_cast<double>(m_n_gaussians);
+
+  for (size_t i=0; i<m_n_gaussians; ++i) {
+    const blitz::Array<double,1>& mean = m_gaussians[i]->getMean();
+    const blitz::Array<double,1>& variance = m_gaussians[i]->getVariance();
+    double c = m_cache_log_weights(i) - 0.5 * D * bob::math::Log::Log2Pi;
+    for (int d=0; d<D; ++d) {
+      const double m = mean(d) - center(d);
+      const double v = variance(d);
+      params(i,d) = m / v;
+      params(i,D+d) = -0.5 / v;
+      c -= 0.5 * (log(v) + m*m/v);
+    }
+    constants(i) = c;
+  }
+}
+
+void bob::machine::GMMMachine::logLikelihoodBlock(const blitz::Array<double,2> &input,
+  const int start, const blitz::Array<double,1> &center, const blitz::Array<double,2> &params,
+  const blitz::Array<double,1> &constants, blitz::Array<double,2> &features,
+  blitz::Array<double,2> &log_weighted_gaussian_likelihoods,
+  blitz::Array<double,1> &log_likelihoods) const
+{
+  const int n = log_likelihoods.extent(0);
+  const int G = m_n_gaussians;
+  const int D = m_n_inputs;
+
+  // features = [x - center, (x - center)^2]
+  for (int t=0; t<n; ++t) {
+    double* f = features.data() + t*2*D;
+    for (int d=0; d<D; ++d) {
+      const double v = input(start+t,d) - center(d);
+      f[d] = v;
+      f[D+d] = v*v;
+    }
+  }
+
+  // log(weight_i*p(x_t|gaussian_i)) = features_t . params_i + constants_i
+  bob::math::prod_(features, params.transpose(1,0),
+    log_weighted_gaussian_likelihoods);
+
+  // log(p(x_t|GMMMachine)) with a log-sum-exp over each row
+  for (int t=0; t<n; ++t) {
+    double* l = log_weighted_gaussian_likelihoods.data() + t*G;
+    double max = bob::math::Log::LogZero;
+    for (int i=0; i<G; ++i) {
+      l[i] += constants(i);
+      if (l[i] > max) max = l[i];
+    }
+    if (max <= bob::math::Log::LogZero) {
+      log_likelihoods(t) = bob::math::Log::LogZero;
+      continue;
+    }
+    double sum = 0.;
+    for (int i=0; i<G; ++i) sum += exp(l[i] - max);
+    log_likelihoods(t) = max + log(sum);
+  }
 }
 
 void bob::machine::GMMMachine::forward(const blitz::Array<double,1>& input, double& output) const {
@@ -286,24 +443,73 @@ void bob::machine::GMMMachine::forward_(const blitz::Array<double,1>& input,
 
 void bob::machine::GMMMachine::accStatistics(const blitz::Array<double,2>& input,
     bob::machine::GMMStats& stats) const {
-  // iterate over data
-  blitz::Range a = blitz::Range::all();
-  for(int i=0; i<input.extent(0); ++i) {
-    // Get example
-    blitz::Array<double,1> x(input(i,a));
-    // Accumulate statistics
-    accStatistics(x,stats);
-  }
+  // check dimensions
+  bob::core::array::assertSameDimensionLength(input.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(stats.n.extent(0), m_n_gaussians);
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(0), m_n_gaussians);
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(stats.sumPxx.extent(0), m_n_gaussians);
+  bob::core::array::assertSameDimensionLength(stats.sumPxx.extent(1), m_n_inputs);
+
+  accStatistics_(input, stats);
 }
 
 void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double,2>& input, bob::machine::GMMStats& stats) const {
-  // iterate over data
+  const int n_samples = input.extent(0);
+  if (n_samples == 0) return;
+
+  const int G = m_n_gaussians;
+  const int D = m_n_inputs;
+  blitz::Array<double,1> center(D), constants(G);
+  blitz::Array<double,2> params(G, 2*D);
+  getBatchParameters(center, params, constants);
+
+  // Workspaces, shared by all the blocks
+  const int block_size = std::min(n_samples, GMM_BATCH_BLOCK_SIZE);
+  blitz::Array<double,2> features_(block_size, 2*D);
+  blitz::Array<double,2> P_(block_size, G);
+  blitz::Array<double,1> ll_(block_size);
+  blitz::Array<double,2> S(G, 2*D);
   blitz::Range a = blitz::Range::all();
-  for(int i=0; i<input.extent(0); ++i) {
-    // Get example
-    blitz::Array<double,1> x(input(i, a));
-    // Accumulate statistics
-    accStatistics_(x,stats);
+  blitz::Range first(0, D-1), second(D, 2*D-1);
+
+  for (int start=0; start<n_samples; start+=block_size) {
+    const int n = std::min(block_size, n_samples-start);
+    blitz::Range rows(0, n-1);
+    blitz::Array<double,2> features = features_(rows, a);
+    blitz::Array<double,2> P = P_(rows, a);
+    blitz::Array<double,1> ll = ll_(rows);
+
+    // Calculate Gaussian and GMM likelihoods of the block
+    logLikelihoodBlock(input, start, center, params, constants, features,
+      P, ll);
+
+    // Calculate responsibilities (in place) and accumulate
+    // - total likelihood and number of samples
+    // - responsibilities
+    for (int t=0; t<n; ++t) {
+      double* p = P.data() + t*G;
+      const double l = ll(t);
+      for (int i=0; i<G; ++i) {
+        p[i] = exp(p[i] - l);
+        stats.n(i) += p[i];
+      }
+      stats.log_likelihood += l;
+    }
+    stats.T += n;
+
+    // - first and second order stats: P^T * [x, x^2]
+    for (int t=0; t<n; ++t) {
+      double* f = features.data() + t*2*D;
+      for (int d=0; d<D; ++d) {
+        const double v = input(start+t,d);
+        f[d] = v;
+        f[D+d] = v*v;
+      }
+    }
+    bob::math::prod_(P.transpose(1,0), features, S);
+    stats.sumPx += S(a, first);
+    stats.sumPxx += S(a, second);
   }
 }
 
@@ -313,27 +519,31 @@ void bob::machine::GMMMachine::accStatistics(const blitz::Array<double, 1>& x, b
   bob::core::array::assertSameDimensionLength(stats.sumPx.extent(1), m_n_inputs);
 
   // Calculate Gaussian and GMM likelihoods
-  // - m_cache_log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
+  // - lwgl(i) = log(weight_i*p(x|gaussian_i))
   // - log_likelihood = log(sum_i(weight_i*p(x|gaussian_i)))
-  double log_likelihood = logLikelihood(x, m_cache_log_weighted_gaussian_likelihoods);
+  blitz::Array<double,1>& lwgl = getScratch(m_n_gaussians).log_weighted_gaussian_likelihoods;
+  double log_likelihood = logLikelihood(x, lwgl);
 
-  accStatisticsInternal(x, stats, log_likelihood);
+  accStatisticsInternal(x, lwgl, stats, log_likelihood);
 }
 
 void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double, 1>& x, bob::machine::GMMStats& stats) const {
   // Calculate Gaussian and GMM likelihoods
-  // - m_cache_log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
+  // - lwgl(i) = log(weight_i*p(x|gaussian_i))
   // - log_likelihood = log(sum_i(weight_i*p(x|gaussian_i)))
-  double log_likelihood = logLikelihood_(x, m_cache_log_weighted_gaussian_likelihoods);
+  blitz::Array<double,1>& lwgl = getScratch(m_n_gaussians).log_weighted_gaussian_likelihoods;
+  double log_likelihood = logLikelihood_(x, lwgl);
 
-  accStatisticsInternal(x, stats, log_likelihood);
+  accStatisticsInternal(x, lwgl, stats, log_likelihood);
 }
 
 void bob::machine::GMMMachine::accStatisticsInternal(const blitz::Array<double, 1>& x,
+  const blitz::Array<double,1>& log_weighted_gaussian_likelihoods,
   bob::machine::GMMStats& stats, const double log_likelihood) const
 {
   // Calculate responsibilities
-  m_cache_P = blitz::exp(m_cache_log_weighted_gaussian_likelihoods - log_likelihood);
+  blitz::Array<double,1>& P = getScratch(m_n_gaussians).P;
+  P = blitz::exp(log_weighted_gaussian_likelihoods - log_likelihood);
 
   // Accumulate statistics
   // - total likelihood
@@ -343,18 +553,17 @@ void bob::machine::GMMMachine::accStatisticsInternal(const blitz::Array<double,
   stats.T++;
 
   // - responsibilities
-  stats.n += m_cache_P;
-
-  // - first order stats
-  blitz::firstIndex i;
-  blitz::secondIndex j;
-
-  m_cache_Px = m_cache_P(i) * x(j);
-
-  stats.sumPx += m_cache_Px;
-
-  // - second order stats
-  stats.sumPxx += (m_cache_Px(i,j) * x(j));
+  stats.n += P;
+
+  // - first and second order stats
+  for (size_t i=0; i<m_n_gaussians; ++i) {
+    const double p = P(i);
+    for (size_t j=0; j<m_n_inputs; ++j) {
+      const double px = p * x(j);
+      stats.sumPx(i,j) += px;
+      stats.sumPxx(i,j) += px * x(j);
+    }
+  }
 }
 
 boost::shared_ptr<const bob::machine::Gaussian> bob::machine::GMMMachine::getGaussian(const size_t i) const {
@@ -432,24 +641,24 @@ void bob::machine::GMMMachine::initCache() const {
   // Initialise cache arrays
   m_cache_log_weights.resize(m_n_gaussians);
   recomputeLogWeights();
-  m_cache_log_weighted_gaussian_likelihoods.resize(m_n_gaussians);
-  m_cache_P.resize(m_n_gaussians);
-  m_cache_Px.resize(m_n_gaussians,m_n_inputs);
   m_cache_supervector = false;
 }
 
 void bob::machine::GMMMachine::reloadCacheSupervectors() const {
+  boost::mutex::scoped_lock lock(m_cache_mutex);
   if(!m_cache_supervector)
     updateCacheSupervectors();
 }
 
 const blitz::Array<double,1>& bob::machine::GMMMachine::getMeanSupervector() const {
+  boost::mutex::scoped_lock lock(m_cache_mutex);
   if(!m_cache_supervector)
     updateCacheSupervectors();
   return m_cache_mean_supervector;
 }
 
 const blitz::Array<double,1>& bob::machine::GMMMachine::getVarianceSupervector() const {
+  boost::mutex::scoped_lock lock(m_cache_mutex);
   if(!m_cache_supervector)
     updateCacheSupervectors();
   return m_cache_variance_supervector;
@@ -21,9 +21,31 @@
 #include <bob/machine/IVectorMachine.h>
 #include <bob/core/array_copy.h>
 #include <bob/core/check.h>
+#include <bob/core/thread_local.h>
 #include <bob/math/linear.h>
 #include <bob/math/linsolve.h>
 
+namespace {
+
+  /**
+   * Working arrays of the i-vector extraction, private to each thread
+   */
+  struct IVectorScratch {
+    blitz::Array<double,1> d;
+    blitz::Array<double,1> t1;
+    blitz::Array<double,2> tt;
+  };
+
+  IVectorScratch& getScratch(const size_t dim_d, const size_t rt) {
+    IVectorScratch& s = bob::core::threadLocal<IVectorScratch>();
+    bob::core::ensureExtent(s.d, dim_d);
+    bob::core::ensureExtent(s.t1, rt);
+    bob::core::ensureExtent(s.tt, rt, rt);
+    return s;
+  }
+
+}
+
 bob::machine::IVectorMachine::IVectorMachine()
 {
 }
@@ -190,7 +212,6 @@ void bob::machine::IVectorMachine::precompute()
 void bob::machine::IVectorMachine::resizePrecompute()
 {
   resizeCache();
-  resizeTmp();
   precompute();
 }
 
@@ -205,15 +226,6 @@ void bob::machine::IVectorMachine::resizeCache()
   }
 }
 
-void bob::machine::IVectorMachine::resizeTmp()
-{
-  if (m_ubm)
-    m_tmp_d.resize(m_ubm->getNInputs());
-  m_tmp_t1.resize(m_rt);
-  m_tmp_t2.resize(m_rt);
-  m_tmp_tt.resize(m_rt, m_rt);
-}
-
 void bob::machine::IVectorMachine::forward(const bob::machine::GMMStats& gs,
   blitz::Array<double,1>& ivector) const
 {
@@ -225,37 +237,57 @@ void bob::machine::IVectorMachine::computeIdTtSigmaInvT(
   const bob::machine::GMMStats& gs, blitz::Array<double,2>& output) const
 { 
   // Computes \f$(Id + \sum_{c=1}^{C} N_{i,j,c} T^{T} \Sigma_{c}^{-1} T)\f$
-  blitz::Range rall = blitz::Range::all();
+  // The precomputed blocks are only read through their elements: slicing
+  // them would update their (non-atomic) reference counts, which is not
+  // safe when several threads use the same machine.
+  const int rt = (int)m_rt;
   bob::math::eye(output);
   for (int c=0; c<(int)getDimC(); ++c)
-    output += gs.n(c) * m_cache_Tct_sigmacInv_Tc(c, rall, rall);
+  {
+    const double n_c = gs.n(c);
+    for (int i=0; i<rt; ++i)
+      for (int j=0; j<rt; ++j)
+        output(i,j) += n_c * m_cache_Tct_sigmacInv_Tc(c,i,j);
+  }
 }
 
 void bob::machine::IVectorMachine::computeTtSigmaInvFnorm(
   const bob::machine::GMMStats& gs, blitz::Array<double,1>& output) const
 {
   // Computes \f$T^{T} \Sigma^{-1} \sum_{c=1}^{C} (F_c - N_c ubmmean_{c})\f$
-  blitz::Range rall = blitz::Range::all();
+  // As above, the precomputed blocks are only read through their elements
+  const int D = (int)getDimD();
+  const int rt = (int)m_rt;
+  IVectorScratch& s = getScratch(getDimD(), m_rt);
   output = 0;
   for (int c=0; c<(int)getDimC(); ++c)
   {
-    m_tmp_d = gs.sumPx(c,rall) - gs.n(c) * m_ubm->getGaussian(c)->getMean();
-    blitz::Array<double,2> Tct_sigmacInv = m_cache_Tct_sigmacInv(c, rall, rall);
-    bob::math::prod(Tct_sigmacInv, m_tmp_d, m_tmp_t2);
-    output += m_tmp_t2;
+    const double n_c = gs.n(c);
+    const blitz::Array<double,1>& mean = m_ubm->getGaussian(c)->getMean();
+    for (int k=0; k<D; ++k)
+      s.d(k) = gs.sumPx(c,k) - n_c * mean(k);
+    for (int i=0; i<rt; ++i)
+    {
+      double sum = 0.;
+      for (int k=0; k<D; ++k)
+        sum += m_cache_Tct_sigmacInv(c,i,k) * s.d(k);
+      output(i) += sum;
+    }
   }
 }
 
 void bob::machine::IVectorMachine::forward_(const bob::machine::GMMStats& gs, 
   blitz::Array<double,1>& ivector) const
 {
+  IVectorScratch& s = getScratch(getDimD(), m_rt);
+
   // Computes \f$(Id + \sum_{c=1}^{C} N_{i,j,c} T^{T} \Sigma_{c}^{-1} T)\f$
-  computeIdTtSigmaInvT(gs, m_tmp_tt);
+  computeIdTtSigmaInvT(gs, s.tt);
 
   // Computes \f$T^{T} \Sigma^{-1} \sum_{c=1}^{C} (F_c - N_c ubmmean_{c})\f$
-  computeTtSigmaInvFnorm(gs, m_tmp_t1);
+  computeTtSigmaInvFnorm(gs, s.t1);
 
-  // Solves m_tmp_tt.ivector = m_tmp_t1
-  bob::math::linsolve(m_tmp_tt, ivector, m_tmp_t1);
+  // Solves tt.ivector = t1
+  bob::math::linsolve(s.tt, ivector, s.t1);
 }
 
@@ -21,11 +21,38 @@
 
 #include <bob/machine/JFAMachine.h>
 #include <bob/core/array_copy.h>
+#include <bob/core/thread_local.h>
 #include <bob/math/linear.h>
 #include <bob/math/inv.h>
 #include <bob/machine/LinearScoring.h>
 #include <limits>
 
+namespace {
+
+  /**
+   * Working arrays of the estimation of x and of the scoring, private to
+   * each thread
+   */
+  struct FAScratch {
+    blitz::Array<double,2> IdPlusUSProdInv;
+    blitz::Array<double,1> Fn_x;
+    blitz::Array<double,1> ru;
+    blitz::Array<double,2> ruru;
+    blitz::Array<double,1> Ux;
+  };
+
+  FAScratch& getScratch(const size_t ru, const size_t cd) {
+    FAScratch& s = bob::core::threadLocal<FAScratch>();
+    bob::core::ensureExtent(s.IdPlusUSProdInv, ru, ru);
+    bob::core::ensureExtent(s.Fn_x, cd);
+    bob::core::ensureExtent(s.ru, ru);
+    bob::core::ensureExtent(s.ruru, ru, ru);
+    bob::core::ensureExtent(s.Ux, cd);
+    return s;
+  }
+
+}
+
 
 //////////////////// FABase ////////////////////
 bob::machine::FABase::FABase():
@@ -216,16 +243,6 @@ void bob::machine::FABase::updateCache()
 {
   updateCacheUbm();
   updateCacheUbmUVD();
-  resizeTmp();
-}
-
-void bob::machine::FABase::resizeTmp()
-{
-  m_tmp_IdPlusUSProdInv.resize(getDimRu(),getDimRu());
-  m_tmp_Fn_x.resize(getDimCD());
-  m_tmp_ru.resize(getDimRu());
-  m_tmp_ruD.resize(getDimRu(), getDimD());
-  m_tmp_ruru.resize(getDimRu(), getDimRu());
 }
 
 void bob::machine::FABase::updateCacheUbm()
@@ -258,31 +275,29 @@ void bob::machine::FABase::computeIdPlusUSProdInv(const bob::machine::GMMStats&
   // Computes (Id + U^T.Sigma^-1.U.N_{i,h}.U)^-1 =
   // (Id + sum_{c=1..C} N_{i,h}.U_{c}^T.Sigma_{c}^-1.U_{c})^-1
 
-  // Blitz compatibility: ugly fix (const_cast, as old blitz version does not
-  // provide a non-const version of transpose())
-  blitz::Array<double,2> Ut = const_cast<blitz::Array<double,2>&>(m_U).transpose(1,0);
-
-  blitz::firstIndex i;
-  blitz::secondIndex j;
-  blitz::Range rall = blitz::Range::all();
-
-  bob::math::eye(m_tmp_ruru); // m_tmp_ruru = Id
-  // Loop and add N_{i,h}.U_{c}^T.Sigma_{c}^-1.U_{c} to m_tmp_ruru at each iteration
-  const size_t dim_c = getDimC();
-  const size_t dim_d = getDimD();
-  for(size_t c=0; c<dim_c; ++c) {
-    blitz::Range rc(c*dim_d,(c+1)*dim_d-1);
-    blitz::Array<double,2> Ut_c = Ut(rall,rc);
-    blitz::Array<double,1> sigma_c = m_cache_sigma(rc);
-    m_tmp_ruD = Ut_c(i,j) / sigma_c(j); // U_{c}^T.Sigma_{c}^-1
-    blitz::Array<double,2> U_c = m_U(rc,rall);
-    // Use m_cache_IdPlusUSProdInv as an intermediate array
-    bob::math::prod(m_tmp_ruD, U_c, output); // U_{c}^T.Sigma_{c}^-1.U_{c}
-    // Finally, add N_{i,h}.U_{c}^T.Sigma_{c}^-1.U_{c} to m_tmp_ruru
-    m_tmp_ruru += output * gmm_stats.n(c);
+  // The members are only read through their elements: slicing them would
+  // update their (non-atomic) reference counts, which is not safe when
+  // several threads use the same machine.
+  blitz::Array<double,2>& ruru = getScratch(getDimRu(), getDimCD()).ruru;
+  bob::math::eye(ruru); // ruru = Id
+  // Loop and add N_{i,h}.U_{c}^T.Sigma_{c}^-1.U_{c} to ruru at each iteration
+  const int dim_c = (int)getDimC();
+  const int dim_d = (int)getDimD();
+  const int ru = (int)getDimRu();
+  for(int c=0; c<dim_c; ++c) {
+    const double n_c = gmm_stats.n(c);
+    const int start = c*dim_d;
+    for(int i=0; i<ru; ++i)
+      for(int j=0; j<ru; ++j) {
+        // U_{c}^T.Sigma_{c}^-1.U_{c}
+        double sum = 0.;
+        for(int k=start; k<start+dim_d; ++k)
+          sum += m_cache_UtSigmaInv(i,k) * m_U(k,j);
+        ruru(i,j) += n_c * sum;
+      }
   }
   // Computes the inverse
-  bob::math::inv(m_tmp_ruru, output);
+  bob::math::inv(ruru, output);
 }
 
 
@@ -290,33 +305,33 @@ void bob::machine::FABase::computeFn_x(const bob::machine::GMMStats& gmm_stats,
   blitz::Array<double,1>& output) const
 {
   // Compute Fn_x = sum_{sessions h}(N*(o - m) (Normalised first order statistics)
-  blitz::Range rall = blitz::Range::all();
-  const size_t dim_c = getDimC();
-  const size_t dim_d = getDimD();
-  for(size_t c=0; c<dim_c; ++c) {
-    blitz::Range rc(c*dim_d,(c+1)*dim_d-1);
-    blitz::Array<double,1> Fn_x_c = output(rc);
-    blitz::Array<double,1> mean_c = m_cache_mean(rc);
-    Fn_x_c = gmm_stats.sumPx(c,rall) - mean_c*gmm_stats.n(c);
+  const int dim_c = (int)getDimC();
+  const int dim_d = (int)getDimD();
+  for(int c=0; c<dim_c; ++c) {
+    const double n_c = gmm_stats.n(c);
+    for(int d=0; d<dim_d; ++d)
+      output(c*dim_d+d) = gmm_stats.sumPx(c,d) - m_cache_mean(c*dim_d+d)*n_c;
   }
 }
 
 void bob::machine::FABase::estimateX(const blitz::Array<double,2>& IdPlusUSProdInv,
   const blitz::Array<double,1>& Fn_x, blitz::Array<double,1>& x) const
 {
-  // m_tmp_ru = UtSigmaInv * Fn_x = Ut*diag(sigma)^-1 * N*(o - m)
-  bob::math::prod(m_cache_UtSigmaInv, Fn_x, m_tmp_ru);
+  // ru = UtSigmaInv * Fn_x = Ut*diag(sigma)^-1 * N*(o - m)
+  blitz::Array<double,1>& ru = getScratch(getDimRu(), getDimCD()).ru;
+  bob::math::prod(m_cache_UtSigmaInv, Fn_x, ru);
   // x = IdPlusUSProdInv * m_cache_UtSigmaInv * Fn_x
-  bob::math::prod(IdPlusUSProdInv, m_tmp_ru, x);
+  bob::math::prod(IdPlusUSProdInv, ru, x);
 }
 
 
 void bob::machine::FABase::estimateX(const bob::machine::GMMStats& gmm_stats, blitz::Array<double,1>& x) const
 {
   if (!m_ubm) throw std::runtime_error("No UBM was set in the JFA machine.");
-  computeIdPlusUSProdInv(gmm_stats, m_tmp_IdPlusUSProdInv); // Computes first term
-  computeFn_x(gmm_stats, m_tmp_Fn_x); // Computes last term
-  estimateX(m_tmp_IdPlusUSProdInv, m_tmp_Fn_x, x); // Estimates the value of x
+  FAScratch& s = getScratch(getDimRu(), getDimCD());
+  computeIdPlusUSProdInv(gmm_stats, s.IdPlusUSProdInv); // Computes first term
+  computeFn_x(gmm_stats, s.Fn_x); // Computes last term
+  estimateX(s.IdPlusUSProdInv, s.Fn_x, x); // Estimates the value of x
 }
 
 
@@ -446,7 +461,6 @@ bob::machine::ISVBase::operator=(const bob::machine::ISVBase& other)
 bob::machine::JFAMachine::JFAMachine():
   m_y(1), m_z(1)
 {
-  resizeTmp();
 }
 
 bob::machine::JFAMachine::JFAMachine(const boost::shared_ptr<bob::machine::JFABase> jfa_base):
@@ -455,7 +469,6 @@ bob::machine::JFAMachine::JFAMachine(const boost::shared_ptr<bob::machine::JFABa
 {
   if (!m_jfa_base->getUbm()) throw std::runtime_error("No UBM was set in the JFA machine.");
   updateCache();
-  resizeTmp();
 }
 
 
@@ -465,7 +478,6 @@ bob::machine::JFAMachine::JFAMachine(const bob::machine::JFAMachine& other):
   m_z(bob::core::array::ccopy(other.m_z))
 {
   updateCache();
-  resizeTmp();
 }
 
 bob::machine::JFAMachine::JFAMachine(bob::io::HDF5File& config)
@@ -529,7 +541,6 @@ void bob::machine::JFAMachine::load(bob::io::HDF5File& config)
   setZ(z);
   // update cache
   updateCache();
-  resizeTmp();
 }
 
 
@@ -571,15 +582,6 @@ void bob::machine::JFAMachine::resize()
   m_y.resizeAndPreserve(getDimRv());
   m_z.resizeAndPreserve(getDimCD());
   updateCache();
-  resizeTmp();
-}
-
-void bob::machine::JFAMachine::resizeTmp()
-{
-  if (m_jfa_base)
-  {
-    m_tmp_Ux.resize(getDimCD());
-  }
 }
 
 void bob::machine::JFAMachine::updateCache()
@@ -626,11 +628,12 @@ void bob::machine::JFAMachine::forward_(const bob::machine::GMMStats& input,
 
   // Ux and GMMStats
   estimateX(input, m_cache_x);
-  bob::math::prod(m_jfa_base->getU(), m_cache_x, m_tmp_Ux);
+  blitz::Array<double,1>& Ux = getScratch(getDimRu(), getDimCD()).Ux;
+  bob::math::prod(m_jfa_base->getU(), m_cache_x, Ux);
 
   score = bob::machine::linearScoring(m_cache_mVyDz,
             m_jfa_base->getUbm()->getMeanSupervector(), m_jfa_base->getUbm()->getVarianceSupervector(),
-            input, m_tmp_Ux, true);
+            input, Ux, true);
 }
 
 
@@ -639,7 +642,6 @@ void bob::machine::JFAMachine::forward_(const bob::machine::GMMStats& input,
 bob::machine::ISVMachine::ISVMachine():
   m_z(1)
 {
-  resizeTmp();
 }
 
 bob::machine::ISVMachine::ISVMachine(const boost::shared_ptr<bob::machine::ISVBase> isv_base):
@@ -649,7 +651,6 @@ bob::machine::ISVMachine::ISVMachine(const boost::shared_ptr<bob::machine::ISVBa
   if (!m_isv_base->getUbm())
     throw std::runtime_error("No UBM was set in the JFA machine.");
   updateCache();
-  resizeTmp();
 }
 
 
@@ -658,7 +659,6 @@ bob::machine::ISVMachine::ISVMachine(const bob::machine::ISVMachine& other):
   m_z(bob::core::array::ccopy(other.m_z))
 {
   updateCache();
-  resizeTmp();
 }
 
 bob::machine::ISVMachine::ISVMachine(bob::io::HDF5File& config)
@@ -713,7 +713,6 @@ void bob::machine::ISVMachine::load(bob::io::HDF5File& config)
   setZ(z);
   // update cache
   updateCache();
-  resizeTmp();
 }
 
 void bob::machine::ISVMachine::setZ(const blitz::Array<double,1>& z)
@@ -741,15 +740,6 @@ void bob::machine::ISVMachine::resize()
 {
   m_z.resizeAndPreserve(getDimCD());
   updateCache();
-  resizeTmp();
-}
-
-void bob::machine::ISVMachine::resizeTmp()
-{
-  if (m_isv_base)
-  {
-    m_tmp_Ux.resize(getDimCD());
-  }
 }
 
 void bob::machine::ISVMachine::updateCache()
@@ -795,10 +785,11 @@ void bob::machine::ISVMachine::forward_(const bob::machine::GMMStats& input,
 
   // Ux and GMMStats
   estimateX(input, m_cache_x);
-  bob::math::prod(m_isv_base->getU(), m_cache_x, m_tmp_Ux);
+  blitz::Array<double,1>& Ux = getScratch(getDimRu(), getDimCD()).Ux;
+  bob::math::prod(m_isv_base->getU(), m_cache_x, Ux);
 
   score = bob::machine::linearScoring(m_cache_mDz,
             m_isv_base->getUbm()->getMeanSupervector(), m_isv_base->getUbm()->getVarianceSupervector(),
-            input, m_tmp_Ux, true);
+            input, Ux, true);
 }
 
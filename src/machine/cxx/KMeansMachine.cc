@@ -163,24 +163,39 @@ double bob::machine::KMeansMachine::getMinDistance(const blitz::Array<double,1>&
 }
 
 void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterInit(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
+{
+  getVariancesAndWeightsForEachClusterInit(m_cache_means, variances, weights);
+}
+
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2>& data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
+{
+  getVariancesAndWeightsForEachClusterAcc(data, m_cache_means, variances, weights);
+}
+
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
+{
+  getVariancesAndWeightsForEachClusterFin(m_cache_means, variances, weights);
+}
+
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterInit(blitz::Array<double,2>& means, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
 {
   // check arguments
+  bob::core::array::assertSameShape(means, m_means);
   bob::core::array::assertSameShape(variances, m_means);
   bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
 
   // initialise output arrays
-  bob::core::array::assertSameShape(variances, m_means);
-  bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
   variances = 0;
   weights = 0;
 
   // initialise (temporary) mean array
-  m_cache_means = 0;
+  means = 0;
 }
 
-void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2>& data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2>& data, blitz::Array<double,2>& means, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
 {
   // check arguments
+  bob::core::array::assertSameShape(means, m_means);
   bob::core::array::assertSameShape(variances, m_means);
   bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
 
@@ -196,15 +211,16 @@ void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterAcc(const
     getClosestMean(x,closest_mean,min_distance);
 
     // - accumulate stats
-    m_cache_means(closest_mean, blitz::Range::all()) += x;
+    means(closest_mean, blitz::Range::all()) += x;
     variances(closest_mean, blitz::Range::all()) += blitz::pow2(x);
     ++weights(closest_mean);
   }
 }
 
-void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& means, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
 {
   // check arguments
+  bob::core::array::assertSameShape(means, m_means);
   bob::core::array::assertSameShape(variances, m_means);
   bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
 
@@ -213,11 +229,11 @@ void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz:
   blitz::secondIndex idx2;
 
   // find means
-  m_cache_means = m_cache_means(idx1,idx2) / weights(idx1);
+  means = means(idx1,idx2) / weights(idx1);
 
   // find variances
   variances = variances(idx1,idx2) / weights(idx1);
-  variances -= blitz::pow2(m_cache_means);
+  variances -= blitz::pow2(means);
 
   // find weights
   weights = weights / blitz::sum(weights);
@@ -231,12 +247,14 @@ void bob::machine::KMeansMachine::setCacheMeans(const blitz::Array<double,2> &ca
 
 void bob::machine::KMeansMachine::getVariancesAndWeightsForEachCluster(const blitz::Array<double,2>& data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
 {
+  // (local) accumulator of the means, which keeps this method re-entrant
+  blitz::Array<double,2> means(m_means.shape());
   // initialise
-  getVariancesAndWeightsForEachClusterInit(variances, weights);
+  getVariancesAndWeightsForEachClusterInit(means, variances, weights);
   // accumulate
-  getVariancesAndWeightsForEachClusterAcc(data, variances, weights);
+  getVariancesAndWeightsForEachClusterAcc(data, means, variances, weights);
   // merge/finalize
-  getVariancesAndWeightsForEachClusterFin(variances, weights);
+  getVariancesAndWeightsForEachClusterFin(means, variances, weights);
 }
 
 void bob::machine::KMeansMachine::forward(const blitz::Array<double,1>& input, double& output) const
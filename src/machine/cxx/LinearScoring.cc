@@ -19,70 +19,196 @@
  */
 #include <bob/machine/LinearScoring.h>
 #include <bob/math/linear.h>
+#include <bob/core/check.h>
+#include <bob/core/parallel.h>
+#include <limits>
 
 namespace bob { namespace machine {
 
-namespace detail {
+namespace {
 
-  void linearScoring(const std::vector<blitz::Array<double,1> >& models,
+  /**
+   * The functors below are called by bob::core::parallelChunks(). They only
+   * access the (shared) arrays through their elements.
+   */
+
+  /**
+   * Fills the rows of the model matrix A (n_models x CD) with the model
+   * offsets normalized by the UBM variance
+   */
+  template <typename T>
+  struct ModelChunk {
+    ModelChunk(const std::vector<blitz::Array<double,1> >& models,
+        const blitz::Array<double,1>& ubm_mean,
+        const blitz::Array<double,1>& ubm_variance, blitz::Array<T,2>& A):
+      m_models(models), m_ubm_mean(ubm_mean), m_ubm_variance(ubm_variance),
+      m_A(A) {}
+    void operator()(const int, const int start, const int count) const {
+      const int CD = m_A.extent(1);
+      for (int t=start; t<start+count; ++t) {
+        const blitz::Array<double,1>& model = m_models[t];
+        for (int s=0; s<CD; ++s)
+          m_A(t,s) = (model(s) - m_ubm_mean(s)) / m_ubm_variance(s);
+      }
+    }
+    const std::vector<blitz::Array<double,1> >& m_models;
+    const blitz::Array<double,1>& m_ubm_mean;
+    const blitz::Array<double,1>& m_ubm_variance;
+    blitz::Array<T,2>& m_A;
+  };
+
+  /**
+   * Fills the rows of the statistics matrix B (n_test_stats x CD) with the
+   * centered (and optionally normalized) first order statistics
+   */
+  template <typename T>
+  struct StatsChunk {
+    StatsChunk(const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
+        const blitz::Array<double,1>& ubm_mean,
+        const std::vector<blitz::Array<double,1> >* test_channelOffset,
+        const bool frame_length_normalisation, blitz::Array<T,2>& B):
+      m_test_stats(test_stats), m_ubm_mean(ubm_mean),
+      m_test_channelOffset(test_channelOffset),
+      m_frame_length_normalisation(frame_length_normalisation), m_B(B) {}
+    void operator()(const int, const int start, const int count) const {
+      for (int t=start; t<start+count; ++t) {
+        const bob::machine::GMMStats& stats = *m_test_stats[t];
+        const int C = stats.sumPx.extent(0);
+        const int D = stats.sumPx.extent(1);
+        // Apply the normalisation if needed
+        bool zero = false;
+        double sum_N = 1.;
+        if (m_frame_length_normalisation) {
+          sum_N = stats.T;
+          zero = (sum_N <= std::numeric_limits<double>::epsilon() && sum_N >= -std::numeric_limits<double>::epsilon());
+        }
+        for (int c=0, s=0; c<C; ++c) {
+          const double n = stats.n(c);
+          for (int d=0; d<D; ++d, ++s) {
+            double value;
+            if (m_test_channelOffset == 0)
+              value = stats.sumPx(c,d) - (m_ubm_mean(s) * n);
+            else
+              value = stats.sumPx(c,d) - (n * (m_ubm_mean(s) + (*m_test_channelOffset)[t](s)));
+            if (m_frame_length_normalisation)
+              value = (zero ? 0. : value / sum_N);
+            m_B(t,s) = value;
+          }
+        }
+      }
+    }
+    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& m_test_stats;
+    const blitz::Array<double,1>& m_ubm_mean;
+    const std::vector<blitz::Array<double,1> >* m_test_channelOffset;
+    bool m_frame_length_normalisation;
+    blitz::Array<T,2>& m_B;
+  };
+
+  /**
+   * Computes the scores of all the models against a block of test
+   * statistics with a single matrix product. The blocks are sliced
+   * beforehand by the calling thread.
+   */
+  template <typename T>
+  struct ProdChunk {
+    ProdChunk(const blitz::Array<T,2>& A,
+        const std::vector<blitz::Array<T,2> >& Bt,
+        std::vector<blitz::Array<T,2> >& scores):
+      m_A(A), m_Bt(Bt), m_scores(scores) {}
+    void operator()(const int k, const int, const int) const {
+      bob::math::prod_(m_A, m_Bt[k], m_scores[k]);
+    }
+    const blitz::Array<T,2>& m_A;
+    const std::vector<blitz::Array<T,2> >& m_Bt;
+    std::vector<blitz::Array<T,2> >& m_scores;
+  };
+
+  /**
+   * Computes the matrix of scores, scores being a C-style contiguous array
+   */
+  template <typename T>
+  void scoreMatrix(const std::vector<blitz::Array<double,1> >& models,
                      const blitz::Array<double,1>& ubm_mean,
                      const blitz::Array<double,1>& ubm_variance,
                      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                      const std::vector<blitz::Array<double,1> >* test_channelOffset,
                      const bool frame_length_normalisation,
-                     blitz::Array<double,2>& scores) 
+                     blitz::Array<T,2>& scores, const size_t n_threads)
   {
-    int C = test_stats[0]->sumPx.extent(0);
-    int D = test_stats[0]->sumPx.extent(1);
-    int CD = C*D;
+    int CD = ubm_mean.extent(0);
     int Tt = test_stats.size();
     int Tm = models.size();
 
-    // Check output size
-    bob::core::array::assertSameDimensionLength(scores.extent(0), models.size());
-    bob::core::array::assertSameDimensionLength(scores.extent(1), test_stats.size());
+    // 1) Compute A (one model per row)
+    blitz::Array<T,2> A(Tm, CD);
+    bob::core::parallelChunks(Tm, n_threads,
+      ModelChunk<T>(models, ubm_mean, ubm_variance, A));
 
-    blitz::Array<double,2> A(Tm, CD);
-    blitz::Array<double,2> B(CD, Tt);
+    // 2) Compute B (one test trial per row)
+    blitz::Array<T,2> B(Tt, CD);
+    bob::core::parallelChunks(Tt, n_threads,
+      StatsChunk<T>(test_stats, ubm_mean, test_channelOffset,
+        frame_length_normalisation, B));
 
-    // 1) Compute A
-    for(int t=0; t<Tm; ++t) {
-      blitz::Array<double, 1> tmp = A(t, blitz::Range::all());
-      tmp = (models[t] - ubm_mean) / ubm_variance;
+    // 3) Compute LLR = A * B^T, the test trials being split across threads
+    const int n_chunks = bob::core::getNChunks(Tt, n_threads);
+    std::vector<blitz::Array<T,2> > Bt(n_chunks), scores_(n_chunks);
+    blitz::Range a = blitz::Range::all();
+    for (int k=0; k<n_chunks; ++k) {
+      int start, count;
+      bob::core::getChunk(Tt, n_chunks, k, start, count);
+      Bt[k].reference(B(blitz::Range(start, start+count-1), a).transpose(1,0));
+      scores_[k].reference(scores(a, blitz::Range(start, start+count-1)));
     }
+    bob::core::parallelChunks(Tt, n_threads, ProdChunk<T>(A, Bt, scores_));
+  }
 
-    // 2) Compute B
-    if(test_channelOffset == 0) {
-      for(int t=0; t<Tt; ++t) 
-        for(int s=0; s<CD; ++s)
-          B(s, t) = test_stats[t]->sumPx(s/D, s%D) - (ubm_mean(s) * test_stats[t]->n(s/D));
-    }
-    else {
-      bob::core::array::assertSameDimensionLength((*test_channelOffset).size(), Tt);
-      
-      for(int t=0; t<Tt; ++t) {
-        bob::core::array::assertSameDimensionLength((*test_channelOffset)[t].extent(0), CD);
-        for(int s=0; s<CD; ++s) 
-          B(s, t) = test_stats[t]->sumPx(s/D, s%D) - (test_stats[t]->n(s/D) * (ubm_mean(s) + (*test_channelOffset)[t](s)));
-      }
-    }
+}
 
-    // Apply the normalisation if needed
-    if(frame_length_normalisation) {
-      for(int t=0; t<Tt; ++t) {
-        double sum_N = test_stats[t]->T;
-        blitz::Array<double, 1> v_t = B(blitz::Range::all(),t);
+namespace detail {
 
-        if (sum_N <= std::numeric_limits<double>::epsilon() && sum_N >= -std::numeric_limits<double>::epsilon())
-          v_t = 0;
-        else 
-          v_t /= sum_N;
-      }
+  void linearScoring(const std::vector<blitz::Array<double,1> >& models,
+                     const blitz::Array<double,1>& ubm_mean,
+                     const blitz::Array<double,1>& ubm_variance,
+                     const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
+                     const std::vector<blitz::Array<double,1> >* test_channelOffset,
+                     const bool frame_length_normalisation,
+                     blitz::Array<double,2>& scores,
+                     const size_t n_threads, const bool single_precision)
+  {
+    // Check output size
+    bob::core::array::assertSameDimensionLength(scores.extent(0), models.size());
+    bob::core::array::assertSameDimensionLength(scores.extent(1), test_stats.size());
+    // Check input sizes
+    const int CD = ubm_mean.extent(0);
+    bob::core::array::assertSameDimensionLength(ubm_variance.extent(0), CD);
+    for (size_t t=0; t<models.size(); ++t)
+      bob::core::array::assertSameDimensionLength(models[t].extent(0), CD);
+    for (size_t t=0; t<test_stats.size(); ++t)
+      bob::core::array::assertSameDimensionLength(test_stats[t]->sumPx.extent(0) * test_stats[t]->sumPx.extent(1), CD);
+    if (test_channelOffset) {
+      bob::core::array::assertSameDimensionLength((*test_channelOffset).size(), test_stats.size());
+      for (size_t t=0; t<test_stats.size(); ++t)
+        bob::core::array::assertSameDimensionLength((*test_channelOffset)[t].extent(0), CD);
     }
+    if (models.size() == 0 || test_stats.size() == 0) return;
 
-    // 3) Compute LLR
-    bob::math::prod(A, B, scores);
-  } 
+    if (single_precision) {
+      blitz::Array<float,2> scores_(scores.extent(0), scores.extent(1));
+      scoreMatrix(models, ubm_mean, ubm_variance, test_stats,
+        test_channelOffset, frame_length_normalisation, scores_, n_threads);
+      scores = blitz::cast<double>(scores_);
+    }
+    else if (!bob::core::array::isCZeroBaseContiguous(scores)) {
+      blitz::Array<double,2> scores_(scores.extent(0), scores.extent(1));
+      scoreMatrix(models, ubm_mean, ubm_variance, test_stats,
+        test_channelOffset, frame_length_normalisation, scores_, n_threads);
+      scores = scores_;
+    }
+    else
+      scoreMatrix(models, ubm_mean, ubm_variance, test_stats,
+        test_channelOffset, frame_length_normalisation, scores, n_threads);
+  }
 }
 
 
@@ -91,25 +217,28 @@ void linearScoring(const std::vector<blitz::Array<double,1> >& models,
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const std::vector<blitz::Array<double,1> >& test_channelOffset,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores)
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads, const bool single_precision)
 {
-  detail::linearScoring(models, ubm_mean, ubm_variance, test_stats, &test_channelOffset, frame_length_normalisation, scores);
+  detail::linearScoring(models, ubm_mean, ubm_variance, test_stats, &test_channelOffset, frame_length_normalisation, scores, n_threads, single_precision);
 }
 
 void linearScoring(const std::vector<blitz::Array<double,1> >& models,
                    const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores)
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads, const bool single_precision)
 {
-  detail::linearScoring(models, ubm_mean, ubm_variance, test_stats, 0, frame_length_normalisation, scores);
+  detail::linearScoring(models, ubm_mean, ubm_variance, test_stats, 0, frame_length_normalisation, scores, n_threads, single_precision);
 }
 
 void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMachine> >& models,
                    const bob::machine::GMMMachine& ubm,
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores) 
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads, const bool single_precision) 
 {
   int C = test_stats[0]->sumPx.extent(0);
   int D = test_stats[0]->sumPx.extent(1);
@@ -123,7 +252,7 @@ void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMa
   }
   const blitz::Array<double,1>& ubm_mean = ubm.getMeanSupervector();
   const blitz::Array<double,1>& ubm_variance = ubm.getVarianceSupervector();
-  detail::linearScoring(models_b, ubm_mean, ubm_variance, test_stats, 0, frame_length_normalisation, scores);
+  detail::linearScoring(models_b, ubm_mean, ubm_variance, test_stats, 0, frame_length_normalisation, scores, n_threads, single_precision);
 }
 
 void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMachine> >& models,
@@ -131,7 +260,8 @@ void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMa
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const std::vector<blitz::Array<double,1> >& test_channelOffset,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores) 
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads, const bool single_precision) 
 {
   int C = test_stats[0]->sumPx.extent(0);
   int D = test_stats[0]->sumPx.extent(1);
@@ -145,7 +275,7 @@ void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMa
   }
   const blitz::Array<double,1>& ubm_mean = ubm.getMeanSupervector();
   const blitz::Array<double,1>& ubm_variance = ubm.getVarianceSupervector();
-  detail::linearScoring(models_b, ubm_mean, ubm_variance, test_stats, &test_channelOffset, frame_length_normalisation, scores);
+  detail::linearScoring(models_b, ubm_mean, ubm_variance, test_stats, &test_channelOffset, frame_length_normalisation, scores, n_threads, single_precision);
 }
 
 
@@ -22,23 +22,53 @@
 
 #include <sys/time.h>
 #include <cmath>
+#include <algorithm>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 
 #include <bob/core/check.h>
 #include <bob/core/array_copy.h>
 #include <bob/core/assert.h>
+#include <bob/core/thread_local.h>
 #include <bob/machine/MLP.h>
 #include <bob/math/linear.h>
 
+namespace {
+
+  /**
+   * Scratch space of the forward methods, private to each thread: the
+   * (normalized) input and the outputs of the hidden layers, for a single
+   * sample or for a block of samples.
+   */
+  struct MLPScratch {
+    std::vector<blitz::Array<double,1> > sample;
+    std::vector<blitz::Array<double,2> > layer;
+  };
+
+  /**
+   * Number of samples forwarded at once by the batch forward, which bounds
+   * the size of the workspaces independently of the number of samples
+   */
+  const int MLP_BATCH_BLOCK_SIZE = 256;
+
+  /**
+   * A view of a vector as a matrix with a single row
+   */
+  blitz::Array<double,2> as_row(blitz::Array<double,1>& a) {
+    return blitz::Array<double,2>(a.data(), blitz::shape(1, a.extent(0)),
+        blitz::shape(a.extent(0) * a.stride(0), a.stride(0)),
+        blitz::neverDeleteData);
+  }
+
+}
+
 bob::machine::MLP::MLP (size_t input, size_t output):
   m_input_sub(input),
   m_input_div(input),
   m_weight(1),
   m_bias(1),
   m_hidden_activation(boost::make_shared<bob::machine::HyperbolicTangentActivation>()),
-  m_output_activation(m_hidden_activation),
-  m_buffer(1)
+  m_output_activation(m_hidden_activation)
 {
   resize(input, output);
   m_input_sub = 0;
@@ -53,8 +83,7 @@ bob::machine::MLP::MLP (size_t input, size_t hidden, size_t output):
   m_weight(2),
   m_bias(2),
   m_hidden_activation(boost::make_shared<bob::machine::HyperbolicTangentActivation>()),
-  m_output_activation(m_hidden_activation),
-  m_buffer(2)
+  m_output_activation(m_hidden_activation)
 {
   resize(input, hidden, output);
   m_input_sub = 0;
@@ -69,8 +98,7 @@ bob::machine::MLP::MLP (size_t input, const std::vector<size_t>& hidden, size_t
   m_weight(hidden.size()+1),
   m_bias(hidden.size()+1),
   m_hidden_activation(boost::make_shared<bob::machine::HyperbolicTangentActivation>()),
-  m_output_activation(m_hidden_activation),
-  m_buffer(hidden.size()+1)
+  m_output_activation(m_hidden_activation)
 {
   resize(input, hidden, output);
   m_input_sub = 0;
@@ -96,13 +124,11 @@ bob::machine::MLP::MLP (const bob::machine::MLP& other):
   m_weight(other.m_weight.size()),
   m_bias(other.m_bias.size()),
   m_hidden_activation(other.m_hidden_activation),
-  m_output_activation(other.m_output_activation),
-  m_buffer(other.m_buffer.size())
+  m_output_activation(other.m_output_activation)
 {
   for (size_t i=0; i<other.m_weight.size(); ++i) {
     m_weight[i].reference(bob::core::array::ccopy(other.m_weight[i]));
     m_bias[i].reference(bob::core::array::ccopy(other.m_bias[i]));
-    m_buffer[i].reference(bob::core::array::ccopy(other.m_buffer[i]));
   }
 }
 
@@ -121,11 +147,9 @@ bob::machine::MLP& bob::machine::MLP::operator= (const MLP& other) {
     m_bias.resize(other.m_bias.size());
     m_hidden_activation = other.m_hidden_activation;
     m_output_activation = other.m_output_activation;
-    m_buffer.resize(other.m_buffer.size());
     for (size_t i=0; i<other.m_weight.size(); ++i) {
       m_weight[i].reference(bob::core::array::ccopy(other.m_weight[i]));
       m_bias[i].reference(bob::core::array::ccopy(other.m_bias[i]));
-      m_buffer[i].reference(bob::core::array::ccopy(other.m_buffer[i]));
     }
   }
   return *this;
@@ -160,7 +184,6 @@ void bob::machine::MLP::load (bob::io::HDF5File& config) {
   uint8_t nhidden = config.read<uint8_t>("nhidden");
   m_weight.resize(nhidden+1);
   m_bias.resize(nhidden+1);
-  m_buffer.resize(nhidden+1);
 
   //configures the input
   m_input_sub.reference(config.readArray<double,1>("input_sub"));
@@ -189,13 +212,6 @@ void bob::machine::MLP::load (bob::io::HDF5File& config) {
     m_hidden_activation = bob::machine::make_deprecated_activation(act);
     m_output_activation = m_hidden_activation;
   }
-
-  //setup buffers: first, input
-  m_buffer[0].reference(blitz::Array<double,1>(m_input_sub.shape()));
-  for (size_t i=1; i<m_weight.size(); ++i) {
-    //buffers have to be sized the same as the input for the next layer
-    m_buffer[i].reference(blitz::Array<double,1>(m_weight[i].extent(0)));
-  }
 }
 
 void bob::machine::MLP::save (bob::io::HDF5File& config) const {
@@ -225,23 +241,23 @@ void bob::machine::MLP::forward_ (const blitz::Array<double,1>& input,
     blitz::Array<double,1>& output) {
 
   //doesn't check input, just computes
-  m_buffer[0] = (input - m_input_sub) / m_input_div;
+  MLPScratch& s = bob::core::threadLocal<MLPScratch>();
+  s.sample.resize(m_weight.size());
+  for (size_t j=0; j<m_weight.size(); ++j)
+    bob::core::ensureExtent(s.sample[j], m_weight[j].extent(0));
+  s.sample[0] = (input - m_input_sub) / m_input_div;
 
   //input -> hidden[0]; hidden[0] -> hidden[1], ..., hidden[N-2] -> hidden[N-1]
   for (size_t j=1; j<m_weight.size(); ++j) {
-    bob::math::prod_(m_buffer[j-1], m_weight[j-1], m_buffer[j]);
-    m_buffer[j] += m_bias[j-1];
-    for (int i=0; i<m_buffer[j].extent(0); ++i) {
-      m_buffer[j](i) = m_hidden_activation->f(m_buffer[j](i));
-    }
+    bob::math::prod_(s.sample[j-1], m_weight[j-1], s.sample[j]);
+    blitz::Array<double,2> row = as_row(s.sample[j]);
+    m_hidden_activation->f_layer(row, m_bias[j-1]);
   }
 
   //hidden[N-1] -> output
-  bob::math::prod_(m_buffer.back(), m_weight.back(), output);
-  output += m_bias.back();
-  for (int i=0; i<output.extent(0); ++i) {
-    output(i) = m_output_activation->f(output(i));
-  }
+  bob::math::prod_(s.sample.back(), m_weight.back(), output);
+  blitz::Array<double,2> row = as_row(output);
+  m_output_activation->f_layer(row, m_bias.back());
 }
 
 void bob::machine::MLP::forward (const blitz::Array<double,1>& input,
@@ -264,11 +280,43 @@ void bob::machine::MLP::forward (const blitz::Array<double,1>& input,
 void bob::machine::MLP::forward_ (const blitz::Array<double,2>& input,
     blitz::Array<double,2>& output) {
 
+  //doesn't check input, just computes: each layer is computed for a block of
+  //samples at once, with one matrix product and one activation call
+  const int n_samples = input.extent(0);
+  if (!n_samples) return;
+  const int block = std::min(n_samples, MLP_BATCH_BLOCK_SIZE);
+
+  MLPScratch& s = bob::core::threadLocal<MLPScratch>();
+  s.layer.resize(m_weight.size());
+  bob::core::ensureExtent(s.layer[0], block, m_weight[0].extent(0));
+  for (size_t j=1; j<m_weight.size(); ++j)
+    bob::core::ensureExtent(s.layer[j], block, m_weight[j].extent(0));
+
   blitz::Range all = blitz::Range::all();
-  for (int i=0; i<input.extent(0); ++i) {
-    blitz::Array<double,1> inref(input(i,all));
-    blitz::Array<double,1> outref(output(i,all));
-    forward_(inref, outref);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  for (int start=0; start<n_samples; start+=block) {
+    const int n = std::min(block, n_samples - start);
+    blitz::Range samples(start, start+n-1);
+    blitz::Range rows(0, n-1);
+
+    const blitz::Array<double,2> x = input(samples, all);
+    blitz::Array<double,2> in = s.layer[0](rows, all);
+    in = (x(i,j) - m_input_sub(j)) / m_input_div(j);
+
+    //input -> hidden[0]; hidden[0] -> hidden[1], ..., hidden[N-2] -> hidden[N-1]
+    for (size_t k=1; k<m_weight.size(); ++k) {
+      blitz::Array<double,2> prev = s.layer[k-1](rows, all);
+      blitz::Array<double,2> cur = s.layer[k](rows, all);
+      bob::math::prod_(prev, m_weight[k-1], cur);
+      m_hidden_activation->f_layer(cur, m_bias[k-1]);
+    }
+
+    //hidden[N-1] -> output
+    blitz::Array<double,2> last = s.layer.back()(rows, all);
+    blitz::Array<double,2> out = output(samples, all);
+    bob::math::prod_(last, m_weight.back(), out);
+    m_output_activation->f_layer(out, m_bias.back());
   }
 }
 
@@ -300,8 +348,6 @@ void bob::machine::MLP::resize (size_t input, size_t output) {
   m_weight[0].reference(blitz::Array<double,2>(input, output));
   m_bias.resize(1);
   m_bias[0].reference(blitz::Array<double,1>(output));
-  m_buffer.resize(1);
-  m_buffer[0].reference(blitz::Array<double,1>(input));
   setWeights(0);
   setBiases(0);
 }
@@ -325,25 +371,21 @@ void bob::machine::MLP::resize (size_t input, const std::vector<size_t>& hidden,
   m_input_div = 1;
   m_weight.resize(hidden.size()+1);
   m_bias.resize(hidden.size()+1);
-  m_buffer.resize(hidden.size()+1);
   
   //initializes first layer
   m_weight[0].reference(blitz::Array<double,2>(input, hidden[0]));
   m_bias[0].reference(blitz::Array<double,1>(hidden[0]));
-  m_buffer[0].reference(blitz::Array<double,1>(input));
 
   //initializes hidden layers
   const size_t NH1 = hidden.size()-1;
   for (size_t i=0; i<NH1; ++i) {
     m_weight[i+1].reference(blitz::Array<double,2>(hidden[i], hidden[i+1]));
     m_bias[i+1].reference(blitz::Array<double,1>(hidden[i+1]));
-    m_buffer[i+1].reference(blitz::Array<double,1>(hidden[i]));
   }
 
   //initializes the last layer
   m_weight.back().reference(blitz::Array<double,2>(hidden.back(), output));
   m_bias.back().reference(blitz::Array<double,1>(output));
-  m_buffer.back().reference(blitz::Array<double,1>(hidden.back()));
   
   setWeights(0);
   setBiases(0);
@@ -23,6 +23,7 @@
 #include <bob/core/assert.h>
 #include <bob/core/check.h>
 #include <bob/core/array_copy.h>
+#include <bob/core/thread_local.h>
 #include <bob/machine/PLDAMachine.h>
 #include <bob/math/linear.h>
 #include <bob/math/det.h>
@@ -32,6 +33,34 @@
 #include <boost/lexical_cast.hpp>
 #include <string>
 
+namespace {
+
+  /**
+   * Scratch space of the const methods of PLDABase and PLDAMachine,
+   * private to each thread
+   */
+  struct PLDAScratch {
+    blitz::Array<double,1> d_1;
+    blitz::Array<double,1> d_2;
+    blitz::Array<double,1> nf_1;
+    blitz::Array<double,1> nf_2;
+    blitz::Array<double,2> nf_nf_1;
+    blitz::Array<double,2> base_nf_nf_1; ///< used by PLDABase::computeGamma()
+  };
+
+  PLDAScratch& getScratch(const size_t dim_d, const size_t dim_f) {
+    PLDAScratch& s = bob::core::threadLocal<PLDAScratch>();
+    bob::core::ensureExtent(s.d_1, dim_d);
+    bob::core::ensureExtent(s.d_2, dim_d);
+    bob::core::ensureExtent(s.nf_1, dim_f);
+    bob::core::ensureExtent(s.nf_2, dim_f);
+    bob::core::ensureExtent(s.nf_nf_1, dim_f, dim_f);
+    bob::core::ensureExtent(s.base_nf_nf_1, dim_f, dim_f);
+    return s;
+  }
+
+}
+
 bob::machine::PLDABase::PLDABase():
   m_variance_threshold(0.)
 {
@@ -325,10 +354,7 @@ void bob::machine::PLDABase::resizeNoInit(const size_t dim_d, const size_t dim_f
 
 void bob::machine::PLDABase::resizeTmp()
 {
-  m_tmp_d_1.resize(m_dim_d);
-  m_tmp_d_2.resize(m_dim_d);
   m_tmp_d_ng_1.resize(m_dim_d, m_dim_g);
-  m_tmp_nf_nf_1.resize(m_dim_f, m_dim_f);
   m_tmp_ng_ng_1.resize(m_dim_g, m_dim_g);
 }
 
@@ -496,16 +522,18 @@ void bob::machine::PLDABase::computeGamma(const size_t a,
   // gamma = (Id + a.F^T.beta.F)^-1
 
   // Checks destination size
-  bob::core::array::assertSameShape(res, m_tmp_nf_nf_1);
-  // m_tmp_nf_nf_1 = F^T.beta.F
-  bob::math::prod(m_cache_Ft_beta, m_F, m_tmp_nf_nf_1);
-   // m_tmp_nf_nf_1 = a.F^T.beta.F
-  m_tmp_nf_nf_1 *= static_cast<double>(a);
-  // m_tmp_nf_nf_1 = Id + a.F^T.beta.F
-  for(int i=0; i<m_tmp_nf_nf_1.extent(0); ++i) m_tmp_nf_nf_1(i,i) += 1;
+  bob::core::array::assertSameDimensionLength(res.extent(0), m_dim_f);
+  bob::core::array::assertSameDimensionLength(res.extent(1), m_dim_f);
+  blitz::Array<double,2>& tmp_nf_nf_1 = getScratch(m_dim_d, m_dim_f).base_nf_nf_1;
+  // tmp_nf_nf_1 = F^T.beta.F
+  bob::math::prod(m_cache_Ft_beta, m_F, tmp_nf_nf_1);
+   // tmp_nf_nf_1 = a.F^T.beta.F
+  tmp_nf_nf_1 *= static_cast<double>(a);
+  // tmp_nf_nf_1 = Id + a.F^T.beta.F
+  for(int i=0; i<tmp_nf_nf_1.extent(0); ++i) tmp_nf_nf_1(i,i) += 1;
 
   // res = (Id + a.F^T.beta.F)^-1
-  bob::math::inv(m_tmp_nf_nf_1, res);
+  bob::math::inv(tmp_nf_nf_1, res);
 }
 
 void bob::machine::PLDABase::precomputeLogDetAlpha()
@@ -572,14 +600,15 @@ double bob::machine::PLDABase::computeLogLikelihoodPointEstimate(
   // Computes: -D/2 log(2pi) -1/2 log(det(\Sigma)) 
   //   -1/2 {(x_{ij}-(\mu+Fh_{i}+Gw_{ij}))^{T}\Sigma^{-1}(x_{ij}-(\mu+Fh_{i}+Gw_{ij}))}
   double res = -0.5*((double)m_dim_d)*log(2*M_PI) - 0.5*m_cache_logdet_sigma;
-  // m_tmp_d_1 = (x_{ij} - (\mu+Fh_{i}+Gw_{ij}))
-  m_tmp_d_1 = xij - m_mu;
-  bob::math::prod(m_F, hi, m_tmp_d_2);
-  m_tmp_d_1 -= m_tmp_d_2;
-  bob::math::prod(m_G, wij, m_tmp_d_2);
-  m_tmp_d_1 -= m_tmp_d_2;
+  PLDAScratch& s = getScratch(m_dim_d, m_dim_f);
+  // tmp_d_1 = (x_{ij} - (\mu+Fh_{i}+Gw_{ij}))
+  s.d_1 = xij - m_mu;
+  bob::math::prod(m_F, hi, s.d_2);
+  s.d_1 -= s.d_2;
+  bob::math::prod(m_G, wij, s.d_2);
+  s.d_1 -= s.d_2;
   // add third term to res
-  res += -0.5*blitz::sum(blitz::pow2(m_tmp_d_1) * m_cache_isigma);
+  res += -0.5*blitz::sum(blitz::pow2(s.d_1) * m_cache_isigma);
   return res;
 }
 
@@ -604,8 +633,7 @@ namespace bob{
 bob::machine::PLDAMachine::PLDAMachine():
   m_plda_base(),
   m_n_samples(0), m_nh_sum_xit_beta_xi(0), m_weighted_sum(0), 
-  m_loglikelihood(0), m_cache_gamma(), m_cache_loglike_constterm(),
-  m_tmp_d_1(0), m_tmp_d_2(0), m_tmp_nf_1(0), m_tmp_nf_2(0), m_tmp_nf_nf_1(0,0)
+  m_loglikelihood(0), m_cache_gamma(), m_cache_loglike_constterm()
 {
 }
 
@@ -614,7 +642,6 @@ bob::machine::PLDAMachine::PLDAMachine(const boost::shared_ptr<bob::machine::PLD
   m_n_samples(0), m_nh_sum_xit_beta_xi(0), m_weighted_sum(plda_base->getDimF()),
   m_loglikelihood(0), m_cache_gamma(), m_cache_loglike_constterm()
 {
-  resizeTmp();
 }
 
 
@@ -627,7 +654,6 @@ bob::machine::PLDAMachine::PLDAMachine(const bob::machine::PLDAMachine& other):
   m_cache_loglike_constterm(other.m_cache_loglike_constterm)
 {
   bob::core::array::ccopy(other.m_cache_gamma, m_cache_gamma);
-  resizeTmp();
 }
 
 bob::machine::PLDAMachine::PLDAMachine(bob::io::HDF5File& config,
@@ -652,7 +678,6 @@ bob::machine::PLDAMachine& bob::machine::PLDAMachine::operator=
     m_loglikelihood = other.m_loglikelihood;
     bob::core::array::ccopy(other.m_cache_gamma, m_cache_gamma);
     m_cache_loglike_constterm = other.m_cache_loglike_constterm;
-    resizeTmp();
   }
   return *this;
 }
@@ -722,7 +747,6 @@ void bob::machine::PLDAMachine::load(bob::io::HDF5File& config)
       m_cache_loglike_constterm[a_indices(i)] = config.read<double>(str2);
     }
   }
-  resizeTmp();
 }
 
 void bob::machine::PLDAMachine::save(bob::io::HDF5File& config) const 
@@ -756,7 +780,6 @@ void bob::machine::PLDAMachine::setPLDABase(const boost::shared_ptr<bob::machine
   m_plda_base = plda_base; 
   m_weighted_sum.resizeAndPreserve(getDimF());
   clearMaps();
-  resizeTmp();
 }
 
 
@@ -850,28 +873,27 @@ double bob::machine::PLDAMachine::computeLogLikelihood(const blitz::Array<double
   const blitz::Array<double,2>& Ft_beta = getPLDABase()->getFtBeta();
   const blitz::Array<double,1>& mu = getPLDABase()->getMu();
   double terma = (enrol?m_nh_sum_xit_beta_xi:0.);
+  PLDAScratch& s = getScratch(getDimD(), getDimF());
   // sumWeighted
-  if (enrol && m_n_samples > 0) m_tmp_nf_1 = m_weighted_sum;
-  else m_tmp_nf_1 = 0;
+  if (enrol && m_n_samples > 0) s.nf_1 = m_weighted_sum;
+  else s.nf_1 = 0;
   
   // terma += -1 / 2. * (xi^t*beta*xi)
-  m_tmp_d_1 = sample - mu;
-  bob::math::prod(beta, m_tmp_d_1, m_tmp_d_2);
-  terma += -1 / 2. * (blitz::sum(m_tmp_d_1*m_tmp_d_2));
+  s.d_1 = sample - mu;
+  bob::math::prod(beta, s.d_1, s.d_2);
+  terma += -1 / 2. * (blitz::sum(s.d_1*s.d_2));
     
   // sumWeighted
-  bob::math::prod(Ft_beta, m_tmp_d_1, m_tmp_nf_2);
-  m_tmp_nf_1 += m_tmp_nf_2;
-  blitz::Array<double,2> gamma_a;
-  if (hasGamma(n_samples) || m_plda_base->hasGamma(n_samples))
-    gamma_a.reference(getGamma(n_samples));
-  else
-  {
-    gamma_a.reference(m_tmp_nf_nf_1);
-    m_plda_base->computeGamma(n_samples, gamma_a);
-  }
-  bob::math::prod(gamma_a, m_tmp_nf_1, m_tmp_nf_2);
-  double termb = 1 / 2. * (blitz::sum(m_tmp_nf_1*m_tmp_nf_2));
+  bob::math::prod(Ft_beta, s.d_1, s.nf_2);
+  s.nf_1 += s.nf_2;
+  // gamma_a is bound by const reference, as referencing the cached array
+  // would update its (non-atomic) reference count from concurrent threads
+  const bool has_gamma = hasGamma(n_samples) || m_plda_base->hasGamma(n_samples);
+  if (!has_gamma) m_plda_base->computeGamma(n_samples, s.nf_nf_1);
+  const blitz::Array<double,2>& gamma_a =
+    has_gamma ? getGamma(n_samples) : s.nf_nf_1;
+  bob::math::prod(gamma_a, s.nf_1, s.nf_2);
+  double termb = 1 / 2. * (blitz::sum(s.nf_1*s.nf_2));
 
   // 1/2/ Constant term of the log likelihood:
   //      1/ First term of the likelihood: -Nsamples*D/2*log(2*PI)
@@ -903,32 +925,29 @@ double bob::machine::PLDAMachine::computeLogLikelihood(const blitz::Array<double
   const blitz::Array<double,2>& Ft_beta = getPLDABase()->getFtBeta();
   const blitz::Array<double,1>& mu = getPLDABase()->getMu();
   double terma = (enrol?m_nh_sum_xit_beta_xi:0.);
+  PLDAScratch& s = getScratch(getDimD(), getDimF());
   // sumWeighted
-  if (enrol && m_n_samples > 0) m_tmp_nf_1 = m_weighted_sum;
-  else m_tmp_nf_1 = 0;
+  if (enrol && m_n_samples > 0) s.nf_1 = m_weighted_sum;
+  else s.nf_1 = 0;
   for (int k=0; k<samples.extent(0); ++k) 
   {
-    blitz::Array<double,1> samp = samples(k,blitz::Range::all());
-    m_tmp_d_1 = samp - mu;
+    for (int j=0; j<s.d_1.extent(0); ++j) s.d_1(j) = samples(k,j) - mu(j);
     // terma += -1 / 2. * (xi^t*beta*xi)
-    bob::math::prod(beta, m_tmp_d_1, m_tmp_d_2);
-    terma += -1 / 2. * (blitz::sum(m_tmp_d_1*m_tmp_d_2));
+    bob::math::prod(beta, s.d_1, s.d_2);
+    terma += -1 / 2. * (blitz::sum(s.d_1*s.d_2));
     
     // sumWeighted
-    bob::math::prod(Ft_beta, m_tmp_d_1, m_tmp_nf_2);
-    m_tmp_nf_1 += m_tmp_nf_2;
+    bob::math::prod(Ft_beta, s.d_1, s.nf_2);
+    s.nf_1 += s.nf_2;
   }
 
-  blitz::Array<double,2> gamma_a;
-  if (hasGamma(n_samples) || m_plda_base->hasGamma(n_samples))
-    gamma_a.reference(getGamma(n_samples));
-  else
-  {
-    gamma_a.reference(m_tmp_nf_nf_1);
-    m_plda_base->computeGamma(n_samples, gamma_a);
-  }
-  bob::math::prod(gamma_a, m_tmp_nf_1, m_tmp_nf_2);
-  double termb = 1 / 2. * (blitz::sum(m_tmp_nf_1*m_tmp_nf_2));
+  // gamma_a is bound by const reference (see above)
+  const bool has_gamma = hasGamma(n_samples) || m_plda_base->hasGamma(n_samples);
+  if (!has_gamma) m_plda_base->computeGamma(n_samples, s.nf_nf_1);
+  const blitz::Array<double,2>& gamma_a =
+    has_gamma ? getGamma(n_samples) : s.nf_nf_1;
+  bob::math::prod(gamma_a, s.nf_1, s.nf_2);
+  double termb = 1 / 2. * (blitz::sum(s.nf_1*s.nf_2));
 
   // 1/2/ Constant term of the log likelihood:
   //      1/ First term of the likelihood: -Nsamples*D/2*log(2*PI)
@@ -950,17 +969,4 @@ void bob::machine::PLDAMachine::resize(const size_t dim_d, const size_t dim_f,
 {
   m_weighted_sum.resizeAndPreserve(dim_f);
   clearMaps();
-  resizeTmp();
-}
-
-void bob::machine::PLDAMachine::resizeTmp()
-{
-  if (m_plda_base)
-  {
-    m_tmp_d_1.resize(getDimD());
-    m_tmp_d_2.resize(getDimD());
-    m_tmp_nf_1.resize(getDimF());
-    m_tmp_nf_2.resize(getDimF());
-    m_tmp_nf_nf_1.resize(getDimF(), getDimF());
-  }
 }
@@ -28,12 +28,15 @@
 #include <bob/machine/SVM.h>
 #include <bob/core/check.h>
 #include <bob/core/logging.h>
+#include <bob/core/parallel.h>
+#include <bob/math/linear.h>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <algorithm>
+#include <vector>
 
 static bool is_colon(char i) { return i == ':'; }
 
@@ -224,13 +227,23 @@ void bob::machine::SupportVector::reset() {
     }
   }
 
-  //create and reset cache
-  m_input_cache.reset(new svm_node[1 + m_input_size]);
-
   m_input_sub.resize(inputSize());
   m_input_sub = 0.0;
   m_input_div.resize(inputSize());
   m_input_div = 1.0;
+
+  //keeps a dense copy of the support vectors for the batch predictions, one
+  //per column, so that predictions never have to build views on it
+  if (kernelType() == PRECOMPUTED) {
+    m_svt.resize(0, 0);
+    return;
+  }
+  m_svt.resize(inputSize(), m_model->l);
+  m_svt = 0.0;
+  for (int k=0; k<m_model->l; ++k) {
+    for (svm_node* it = m_model->SV[k]; it->index != -1; ++it)
+      m_svt(it->index-1, k) = it->value;
+  }
 }
 
 bob::machine::SupportVector::SupportVector(const std::string& model_file):
@@ -339,13 +352,16 @@ void bob::machine::SupportVector::setInputDivision(const blitz::Array<double,1>&
 }
 
 /**
- * Copies the user input to a locally pre-allocated cache. Apply normalization
- * at the same occasion.
+ * Copies the user input to a sparse libsvm input. Apply normalization at the
+ * same occasion. The input is allocated per call, so that predictions can run
+ * concurrently on the same machine.
  */
 static inline void copy(const blitz::Array<double,1>& input,
-    boost::shared_array<svm_node>& cache, const blitz::Array<double,1>& sub,
+    std::vector<svm_node>& cache, const blitz::Array<double,1>& sub,
     const blitz::Array<double,1>& div) {
 
+  cache.resize(1 + input.extent(0));
+
   size_t cur = 0; ///< currently used index
 
   for (size_t k=0; k<(size_t)input.extent(0); ++k) {
@@ -361,8 +377,9 @@ static inline void copy(const blitz::Array<double,1>& input,
 
 int bob::machine::SupportVector::predictClass_
 (const blitz::Array<double,1>& input) const {
-  copy(input, m_input_cache, m_input_sub, m_input_div);
-  int retval = round(svm_predict(m_model.get(), m_input_cache.get()));
+  std::vector<svm_node> cache;
+  copy(input, cache, m_input_sub, m_input_div);
+  int retval = round(svm_predict(m_model.get(), &cache[0]));
   return retval;
 }
 
@@ -381,12 +398,13 @@ int bob::machine::SupportVector::predictClass
 int bob::machine::SupportVector::predictClassAndScores_
 (const blitz::Array<double,1>& input,
  blitz::Array<double,1>& scores) const {
-  copy(input, m_input_cache, m_input_sub, m_input_div);
+  std::vector<svm_node> cache;
+  copy(input, cache, m_input_sub, m_input_div);
 #if LIBSVM_VERSION > 290
-  int retval = round(svm_predict_values(m_model.get(), m_input_cache.get(), scores.data()));
+  int retval = round(svm_predict_values(m_model.get(), &cache[0], scores.data()));
 #else
-  svm_predict_values(m_model.get(), m_input_cache.get(), scores.data());
-  int retval = round(svm_predict(m_model.get(), m_input_cache.get()));
+  svm_predict_values(m_model.get(), &cache[0], scores.data());
+  int retval = round(svm_predict(m_model.get(), &cache[0]));
 #endif
   return retval;
 }
@@ -417,8 +435,9 @@ int bob::machine::SupportVector::predictClassAndScores
 int bob::machine::SupportVector::predictClassAndProbabilities_
 (const blitz::Array<double,1>& input,
  blitz::Array<double,1>& probabilities) const {
-  copy(input, m_input_cache, m_input_sub, m_input_div);
-  int retval = round(svm_predict_probability(m_model.get(), m_input_cache.get(), probabilities.data()));
+  std::vector<svm_node> cache;
+  copy(input, cache, m_input_sub, m_input_div);
+  int retval = round(svm_predict_probability(m_model.get(), &cache[0], probabilities.data()));
   return retval;
 }
 
@@ -449,6 +468,291 @@ int bob::machine::SupportVector::predictClassAndProbabilities
   return predictClassAndProbabilities_(input, probabilities);
 }
 
+namespace {
+
+  /**
+   * Size (in bytes) of the per-thread workspaces holding a block of
+   * samples and their kernel values against all the support vectors. The
+   * number of samples per block is derived from it, so that memory stays
+   * bounded whatever the number of samples and support vectors.
+   */
+  const size_t SVM_BATCH_BLOCK_BYTES = 4 << 20;
+
+  /**
+   * Integer power, as computed by libsvm for polynomial kernels
+   */
+  inline double powi(double base, int times) {
+    double tmp = base, ret = 1.0;
+    for (int t=times; t>0; t/=2) {
+      if (t%2 == 1) ret *= tmp;
+      tmp *= tmp;
+    }
+    return ret;
+  }
+
+  /**
+   * The (transposed) support vectors, in the precision used for the kernel
+   * values. The machine's array is shared by concurrent predictions: it is
+   * returned as is or copied element-wise, never referenced.
+   */
+  inline const blitz::Array<double,2>& dense_svt(
+      const blitz::Array<double,2>& svt, blitz::Array<double,2>&) {
+    return svt;
+  }
+
+  inline const blitz::Array<float,2>& dense_svt(
+      const blitz::Array<double,2>& svt, blitz::Array<float,2>& tmp) {
+    tmp.resize(svt.extent(0), svt.extent(1));
+    tmp = blitz::cast<float>(svt);
+    return tmp;
+  }
+
+  /**
+   * Combines the kernel values of a sample against all the support vectors
+   * into its decision values (dec), the same way svm_predict_values() does,
+   * and returns the prediction. start holds the index of the first support
+   * vector of each class, and votes has one entry per class.
+   */
+  template <typename T>
+  double decide(const svm_model& model, const std::vector<int>& start,
+      const T* kvalue, double* dec, std::vector<int>& votes) {
+
+    const int svm_type = model.param.svm_type;
+    if (svm_type == bob::machine::SupportVector::ONE_CLASS ||
+        svm_type == bob::machine::SupportVector::EPSILON_SVR ||
+        svm_type == bob::machine::SupportVector::NU_SVR) {
+      const double* coef = model.sv_coef[0];
+      double sum = 0.;
+      for (int i=0; i<model.l; ++i) sum += coef[i] * kvalue[i];
+      sum -= model.rho[0];
+      dec[0] = sum;
+      if (svm_type == bob::machine::SupportVector::ONE_CLASS)
+        return (sum > 0) ? 1 : -1;
+      return sum;
+    }
+
+    const int nr_class = model.nr_class;
+    std::fill(votes.begin(), votes.end(), 0);
+    int p = 0;
+    for (int i=0; i<nr_class; ++i) {
+      for (int j=i+1; j<nr_class; ++j) {
+        const int si = start[i], sj = start[j];
+        const int ci = model.nSV[i], cj = model.nSV[j];
+        const double* coef1 = model.sv_coef[j-1];
+        const double* coef2 = model.sv_coef[i];
+        double sum = 0.;
+        for (int k=0; k<ci; ++k) sum += coef1[si+k] * kvalue[si+k];
+        for (int k=0; k<cj; ++k) sum += coef2[sj+k] * kvalue[sj+k];
+        sum -= model.rho[p];
+        dec[p] = sum;
+        if (sum > 0) ++votes[i];
+        else ++votes[j];
+        ++p;
+      }
+    }
+
+    int vote_max = 0;
+    for (int i=1; i<nr_class; ++i)
+      if (votes[i] > votes[vote_max]) vote_max = i;
+    return model.label[vote_max];
+  }
+
+  /**
+   * Predicts a contiguous range of samples, block by block. The shared
+   * arrays are only accessed through their elements.
+   */
+  template <typename T>
+  struct PredictChunk {
+    PredictChunk(const svm_model& model, const blitz::Array<double,2>& input,
+        const blitz::Array<double,1>& sub, const blitz::Array<double,1>& div,
+        const blitz::Array<T,2>& svt, const std::vector<double>& sv2,
+        const std::vector<int>& start, blitz::Array<int,1>& classes,
+        blitz::Array<double,2>* scores):
+      m_model(model), m_input(input), m_sub(sub), m_div(div), m_svt(svt),
+      m_sv2(sv2), m_start(start), m_classes(classes), m_scores(scores) {}
+
+    void operator()(const int, const int start, const int count) const {
+      const int d = m_input.extent(1);
+      const int l = m_svt.extent(1);
+      const int n_dec = m_model.nr_class * (m_model.nr_class - 1) / 2;
+      const svm_parameter& param = m_model.param;
+
+      blitz::Array<T,2> X, K;
+      std::vector<double> x2;
+      std::vector<double> dec(std::max(n_dec, 1));
+      std::vector<int> votes(m_model.nr_class);
+
+      const int block = std::max(1, std::min(count,
+            static_cast<int>(SVM_BATCH_BLOCK_BYTES / ((l+d) * sizeof(T)))));
+
+      for (int b=start; b<start+count; b+=block) {
+        const int n = std::min(block, start+count-b);
+        if (X.extent(0) != n) {
+          X.resize(n, d);
+          K.resize(n, l);
+          x2.resize(n);
+        }
+
+        //1. normalizes the block of samples
+        for (int i=0; i<n; ++i) {
+          double norm2 = 0.;
+          for (int j=0; j<d; ++j) {
+            X(i,j) = static_cast<T>((m_input(b+i,j) - m_sub(j)) / m_div(j));
+            norm2 += static_cast<double>(X(i,j)) * X(i,j);
+          }
+          x2[i] = norm2;
+        }
+
+        //2. dot products against all the support vectors
+        bob::math::prod_(X, m_svt, K);
+
+        //3. kernel values, then decisions
+        T* kvalue = K.data();
+        for (int i=0; i<n; ++i, kvalue+=l) {
+          switch (param.kernel_type) {
+            case bob::machine::SupportVector::LINEAR:
+              break;
+            case bob::machine::SupportVector::POLY:
+              for (int k=0; k<l; ++k)
+                kvalue[k] = static_cast<T>(powi(param.gamma*kvalue[k] + param.coef0, param.degree));
+              break;
+            case bob::machine::SupportVector::RBF:
+              for (int k=0; k<l; ++k) {
+                const double dist2 = std::max(0., x2[i] + m_sv2[k] - 2.*kvalue[k]);
+                kvalue[k] = static_cast<T>(std::exp(-param.gamma*dist2));
+              }
+              break;
+            case bob::machine::SupportVector::SIGMOID:
+              for (int k=0; k<l; ++k)
+                kvalue[k] = static_cast<T>(std::tanh(param.gamma*kvalue[k] + param.coef0));
+              break;
+          }
+          m_classes(b+i) = round(decide(m_model, m_start, kvalue, &dec[0], votes));
+          if (m_scores)
+            for (int p=0; p<m_scores->extent(1); ++p) (*m_scores)(b+i,p) = dec[p];
+        }
+      }
+    }
+
+    const svm_model& m_model;
+    const blitz::Array<double,2>& m_input;
+    const blitz::Array<double,1>& m_sub;
+    const blitz::Array<double,1>& m_div;
+    const blitz::Array<T,2>& m_svt;
+    const std::vector<double>& m_sv2;
+    const std::vector<int>& m_start;
+    blitz::Array<int,1>& m_classes;
+    blitz::Array<double,2>* m_scores;
+  };
+
+  template <typename T>
+  void predict_dense(const svm_model& model, const blitz::Array<double,2>& svt_,
+      const blitz::Array<double,2>& input, const blitz::Array<double,1>& sub,
+      const blitz::Array<double,1>& div, blitz::Array<int,1>& classes,
+      blitz::Array<double,2>* scores, const size_t n_threads) {
+
+    blitz::Array<T,2> tmp;
+    const blitz::Array<T,2>& svt = dense_svt(svt_, tmp);
+
+    std::vector<double> sv2(svt.extent(1), 0.);
+    for (int j=0; j<svt.extent(0); ++j)
+      for (int k=0; k<svt.extent(1); ++k)
+        sv2[k] += static_cast<double>(svt(j,k)) * svt(j,k);
+
+    //index of the first support vector of each class (classification only)
+    std::vector<int> start(model.nr_class, 0);
+    if (model.nSV)
+      for (int i=1; i<model.nr_class; ++i)
+        start[i] = start[i-1] + model.nSV[i-1];
+
+    bob::core::parallelChunks(input.extent(0), n_threads,
+      PredictChunk<T>(model, input, sub, div, svt, sv2, start, classes,
+        scores));
+  }
+
+}
+
+size_t bob::machine::SupportVector::numberOfDecisionValues() const {
+  size_t nr_class = svm_get_nr_class(m_model.get());
+  return std::max<size_t>(1, nr_class*(nr_class-1)/2);
+}
+
+void bob::machine::SupportVector::predictClasses
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& classes,
+ const size_t n_threads, const bool single_precision) const {
+
+  if ((size_t)input.extent(1) != inputSize()) {
+    boost::format s("input for this SVM should have %d columns, but you provided an array with %d columns instead");
+    s % inputSize() % input.extent(1);
+    throw std::runtime_error(s.str());
+  }
+
+  if (classes.extent(0) != input.extent(0)) {
+    boost::format s("output classes should have %d entries (one per input row), but you provided an array with %d elements instead");
+    s % input.extent(0) % classes.extent(0);
+    throw std::runtime_error(s.str());
+  }
+
+  predict(input, classes, 0, n_threads, single_precision);
+}
+
+void bob::machine::SupportVector::predictClassesAndScores
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& classes,
+ blitz::Array<double,2>& scores, const size_t n_threads,
+ const bool single_precision) const {
+
+  if ((size_t)input.extent(1) != inputSize()) {
+    boost::format s("input for this SVM should have %d columns, but you provided an array with %d columns instead");
+    s % inputSize() % input.extent(1);
+    throw std::runtime_error(s.str());
+  }
+
+  if (classes.extent(0) != input.extent(0)) {
+    boost::format s("output classes should have %d entries (one per input row), but you provided an array with %d elements instead");
+    s % input.extent(0) % classes.extent(0);
+    throw std::runtime_error(s.str());
+  }
+
+  if (scores.extent(0) != input.extent(0) ||
+      (size_t)scores.extent(1) != numberOfDecisionValues()) {
+    boost::format s("output scores for this SVM should have shape (%d, %d), but you provided an array with shape (%d, %d) instead");
+    s % input.extent(0) % numberOfDecisionValues() % scores.extent(0) % scores.extent(1);
+    throw std::runtime_error(s.str());
+  }
+
+  predict(input, classes, &scores, n_threads, single_precision);
+}
+
+void bob::machine::SupportVector::predict
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& classes,
+ blitz::Array<double,2>* scores, const size_t n_threads,
+ const bool single_precision) const {
+
+  if (!input.extent(0)) return;
+
+  if (kernelType() != PRECOMPUTED) {
+    if (single_precision)
+      predict_dense<float>(*m_model, m_svt, input, m_input_sub, m_input_div,
+          classes, scores, n_threads);
+    else
+      predict_dense<double>(*m_model, m_svt, input, m_input_sub, m_input_div,
+          classes, scores, n_threads);
+    return;
+  }
+
+  //precomputed kernels: sample-wise prediction through libsvm
+  blitz::Range all = blitz::Range::all();
+  blitz::Array<double,1> dec(numberOfDecisionValues());
+  for (int k=0; k<input.extent(0); ++k) {
+    blitz::Array<double,1> tmp = input(k,all);
+    if (scores) {
+      classes(k) = predictClassAndScores_(tmp, dec);
+      (*scores)(k,all) = dec;
+    }
+    else classes(k) = predictClass_(tmp);
+  }
+}
+
 void bob::machine::SupportVector::save(const std::string& filename) const {
   if (svm_save_model(filename.c_str(), m_model.get())) {
     boost::format s("cannot save SVM model to file '%s'");
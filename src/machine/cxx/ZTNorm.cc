@@ -21,47 +21,193 @@
 
 #include <bob/machine/ZTNorm.h>
 #include <bob/core/assert.h>
+#include <bob/core/parallel.h>
+#include <boost/format.hpp>
+#include <algorithm>
 #include <limits>
+#include <stdexcept>
 
 namespace bob { 
 namespace machine {
 
+namespace {
+
+  // Constant to check if the std is close to 0. 
+  const double eps = std::numeric_limits<double>::min();
+
+  /**
+   * The functors below are called by bob::core::parallelChunks(). They only
+   * access the (shared) arrays through their elements.
+   */
+
+  /**
+   * Mean and standard deviation of each row of the Z-Norm scores
+   * (zprobes_vs_models)
+   */
+  struct ZStatisticsChunk {
+    ZStatisticsChunk(const blitz::Array<double,2>& B,
+        blitz::Array<double,1>& mean, blitz::Array<double,1>& std):
+      m_B(B), m_mean(mean), m_std(std) {}
+    void operator()(const int, const int start, const int count) const {
+      const int size_znorm = m_B.extent(1);
+      for (int i=start; i<start+count; ++i) {
+        double sum = 0.;
+        for (int j=0; j<size_znorm; ++j) sum += m_B(i,j);
+        const double mean = sum / size_znorm;
+        double std = 0.; // 1 single value -> std = 0
+        if (size_znorm > 1) {
+          double sumsq = 0.;
+          for (int j=0; j<size_znorm; ++j) {
+            const double diff = m_B(i,j) - mean;
+            sumsq += diff * diff;
+          }
+          std = sqrt(sumsq / (size_znorm - 1));
+        }
+        m_mean(i) = mean;
+        m_std(i) = (std <= eps ? 1. : std);
+      }
+    }
+    const blitz::Array<double,2>& m_B;
+    blitz::Array<double,1>& m_mean;
+    blitz::Array<double,1>& m_std;
+  };
+
+  /**
+   * Mean and standard deviation of each row of the scores of the T-Norm
+   * models against the Z-Norm probes (D), only with impostors
+   */
+  struct DStatisticsChunk {
+    DStatisticsChunk(const blitz::Array<double,2>& D,
+        const blitz::Array<bool,2>* mask, blitz::Array<double,1>& mean,
+        blitz::Array<double,1>& std):
+      m_D(D), m_mask(mask), m_mean(mean), m_std(std) {}
+    void operator()(const int, const int start, const int count) const {
+      const int size_znorm = m_D.extent(1);
+      for (int i=start; i<start+count; ++i) {
+        double sum = 0;
+        double sumsq = 0;
+        double count = 0;
+        for (int j=0; j<size_znorm; ++j) {
+          // The second part is never executed if m_mask==NULL
+          bool keep = (m_mask == NULL) || !(*m_mask)(i, j);
+          double value = keep * m_D(i, j);
+          sum += value;
+          sumsq += value*value;
+          count += keep;
+        }
+        double mean = sum / count;
+        double std = 0; // 1 single value -> std = 0
+        if (count > 1)
+          std = sqrt((sumsq - count * mean * mean) / (count -1));
+        m_mean(i) = mean;
+        m_std(i) = (std <= eps ? 1. : std);
+      }
+    }
+    const blitz::Array<double,2>& m_D;
+    const blitz::Array<bool,2>* m_mask;
+    blitz::Array<double,1>& m_mean;
+    blitz::Array<double,1>& m_std;
+  };
+
+  /**
+   * Mean and standard deviation of each column (probe) of the T-Norm
+   * scores (probes_vs_tmodels), after Z-Norm of their rows if D_mean is not
+   * empty. The rows are traversed in order, for all the columns of a chunk.
+   */
+  struct TStatisticsChunk {
+    TStatisticsChunk(const blitz::Array<double,2>& C,
+        const blitz::Array<double,1>& D_mean,
+        const blitz::Array<double,1>& D_std, blitz::Array<double,1>& mean,
+        blitz::Array<double,1>& std):
+      m_C(C), m_D_mean(D_mean), m_D_std(D_std), m_mean(mean), m_std(std) {}
+    double zC(const int i, const int j) const {
+      if (m_D_mean.extent(0) == 0) return m_C(i,j);
+      return (m_C(i,j) - m_D_mean(i)) / m_D_std(i);
+    }
+    void operator()(const int, const int start, const int count) const {
+      const int size_tnorm = m_C.extent(0);
+      const int end = start + count;
+      for (int j=start; j<end; ++j) m_mean(j) = 0.;
+      for (int i=0; i<size_tnorm; ++i)
+        for (int j=start; j<end; ++j) m_mean(j) += zC(i,j);
+      for (int j=start; j<end; ++j) {
+        m_mean(j) /= size_tnorm;
+        m_std(j) = 0.; // 1 single value -> std = 0
+      }
+      if (size_tnorm > 1) {
+        for (int i=0; i<size_tnorm; ++i)
+          for (int j=start; j<end; ++j) {
+            const double diff = zC(i,j) - m_mean(j);
+            m_std(j) += diff * diff;
+          }
+        for (int j=start; j<end; ++j)
+          m_std(j) = sqrt(m_std(j) / (size_tnorm - 1));
+      }
+      for (int j=start; j<end; ++j)
+        if (m_std(j) <= eps) m_std(j) = 1.;
+    }
+    const blitz::Array<double,2>& m_C;
+    const blitz::Array<double,1>& m_D_mean;
+    const blitz::Array<double,1>& m_D_std;
+    blitz::Array<double,1>& m_mean;
+    blitz::Array<double,1>& m_std;
+  };
+
+  /**
+   * Normalises the rows of a block of raw scores
+   */
+  struct ApplyChunk {
+    ApplyChunk(const blitz::Array<double,2>& A, const ZTNormStatistics& stats,
+        const int first_model, const int first_probe,
+        blitz::Array<double,2>& scores):
+      m_A(A), m_stats(stats), m_first_model(first_model),
+      m_first_probe(first_probe), m_scores(scores) {}
+    void operator()(const int, const int start, const int count) const {
+      const bool znorm = m_stats.z_mean.extent(0) > 0;
+      const bool tnorm = m_stats.t_mean.extent(0) > 0;
+      const int n_probes = m_A.extent(1);
+      for (int i=start; i<start+count; ++i) {
+        const int model = m_first_model + i;
+        for (int j=0; j<n_probes; ++j) {
+          double value = m_A(i,j);
+          // zA = (A - mean(B)) / std(B)         [znorm on oringinal scores]
+          if (znorm)
+            value = (value - m_stats.z_mean(model)) / m_stats.z_std(model);
+          // ztA = (zA - mean(zC)) / std(zC)     [ztnorm on eval scores]
+          if (tnorm) {
+            const int probe = m_first_probe + j;
+            value = (value - m_stats.t_mean(probe)) / m_stats.t_std(probe);
+          }
+          m_scores(i,j) = value;
+        }
+      }
+    }
+    const blitz::Array<double,2>& m_A;
+    const ZTNormStatistics& m_stats;
+    int m_first_model;
+    int m_first_probe;
+    blitz::Array<double,2>& m_scores;
+  };
+
+}
+
 namespace detail {
-  void ztNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
-              const blitz::Array<double,2>* rawscores_zprobes_vs_models,
-              const blitz::Array<double,2>* rawscores_probes_vs_tmodels,
-              const blitz::Array<double,2>* rawscores_zprobes_vs_tmodels,
-              const blitz::Array<bool,2>* mask_zprobes_vs_tmodels_istruetrial,
-              blitz::Array<double,2>& scores)
+  void ztNormStatistics(const blitz::Array<double,2>* rawscores_zprobes_vs_models,
+                        const blitz::Array<double,2>* rawscores_probes_vs_tmodels,
+                        const blitz::Array<double,2>* rawscores_zprobes_vs_tmodels,
+                        const blitz::Array<bool,2>* mask_zprobes_vs_tmodels_istruetrial,
+                        ZTNormStatistics& statistics, const size_t n_threads)
   {
     // Rename variables
-    const blitz::Array<double,2>& A = rawscores_probes_vs_models;
     const blitz::Array<double,2>* B = rawscores_zprobes_vs_models;
     const blitz::Array<double,2>* C = rawscores_probes_vs_tmodels;
     const blitz::Array<double,2>* D = rawscores_zprobes_vs_tmodels;
 
     // Compute the sizes
-    int size_eval  = A.extent(0);
-    int size_enrol = A.extent(1);
     int size_tnorm = (C ? C->extent(0) : 0);
     int size_znorm = (B ? B->extent(1) : 0);
 
     // Check the inputs
-    bob::core::array::assertSameDimensionLength(A.extent(0), size_eval);
-    bob::core::array::assertSameDimensionLength(A.extent(1), size_enrol);
-
-    if (B) {
-      bob::core::array::assertSameDimensionLength(B->extent(1), size_znorm);
-      if (size_znorm > 0)
-        bob::core::array::assertSameDimensionLength(B->extent(0), size_eval);
-    }
-
-    if (C) {
-      bob::core::array::assertSameDimensionLength(C->extent(0), size_tnorm);
-      if (size_tnorm > 0)
-        bob::core::array::assertSameDimensionLength(C->extent(1), size_enrol);
-    }
-
     if (D && size_znorm > 0 && size_tnorm > 0) {
       bob::core::array::assertSameDimensionLength(D->extent(0), size_tnorm);
       bob::core::array::assertSameDimensionLength(D->extent(1), size_znorm);
@@ -72,91 +218,134 @@ namespace detail {
       bob::core::array::assertSameDimensionLength(mask_zprobes_vs_tmodels_istruetrial->extent(1), size_znorm);
     }
 
-    bob::core::array::assertSameDimensionLength(scores.extent(0), size_eval);
-    bob::core::array::assertSameDimensionLength(scores.extent(1), size_enrol);
-
-    // Declare needed IndexPlaceholder
-    blitz::firstIndex ii;
-    blitz::secondIndex jj;
-
-    // Constant to check if the std is close to 0. 
-    const double eps = std::numeric_limits<double>::min();
-    
-    // zA
-    blitz::Array<double,2> zA(A.shape());
+    // Znorm  -->      zA  = (A - mean(B) ) / std(B)    [znorm on oringinal scores]
     if (B && size_znorm > 0) {
-      // Znorm  -->      zA  = (A - mean(B) ) / std(B)    [znorm on oringinal scores]
-      // mean(B)
-      blitz::Array<double,1> mean_B(blitz::mean(*B, jj));
-      // std(B)
-      blitz::Array<double,2> B2n(B->shape());
-      B2n = blitz::pow2((*B)(ii, jj) - mean_B(ii));
-      blitz::Array<double,1> std_B(B->extent(0));
-      if(size_znorm>1)
-        std_B = blitz::sqrt(blitz::sum(B2n, jj) / (size_znorm - 1));
-      else // 1 single value -> std = 0
-        std_B = 0; 
-      std_B = blitz::where( std_B <= eps, 1., std_B);
-
-      zA = (A(ii, jj) - mean_B(ii)) / std_B(ii);
+      statistics.z_mean.resize(B->extent(0));
+      statistics.z_std.resize(B->extent(0));
+      bob::core::parallelChunks(B->extent(0), n_threads,
+        ZStatisticsChunk(*B, statistics.z_mean, statistics.z_std));
+    }
+    else {
+      statistics.z_mean.resize(0);
+      statistics.z_std.resize(0);
     }
-    else
-      zA = A;
 
-    blitz::Array<double,2> zC(size_tnorm, size_enrol);
+    // Compute mean_Dimp and std_Dimp = D only with impostors
+    blitz::Array<double,1> mean_Dimp, std_Dimp;
     if (D && size_tnorm > 0 && size_znorm > 0) {
-      blitz::Array<double,1> mean_Dimp(size_tnorm);
-      blitz::Array<double,1> std_Dimp(size_tnorm);
+      mean_Dimp.resize(size_tnorm);
+      std_Dimp.resize(size_tnorm);
+      bob::core::parallelChunks(size_tnorm, n_threads,
+        DStatisticsChunk(*D, mask_zprobes_vs_tmodels_istruetrial, mean_Dimp,
+          std_Dimp));
+    }
 
-      // Compute mean_Dimp and std_Dimp = D only with impostors
-      for (int i = 0; i < size_tnorm; ++i) {
-        double sum = 0;
-        double sumsq = 0;
-        double count = 0;
-        for (int j = 0; j < size_znorm; ++j) {
-          bool keep;
-          // The second part is never executed if mask_zprobes_vs_tmodels_istruetrial==NULL
-          keep = (mask_zprobes_vs_tmodels_istruetrial == NULL) || !(*mask_zprobes_vs_tmodels_istruetrial)(i, j); //tnorm_models_spk_ids(i) != znorm_tests_spk_ids(j);
-          
-          double value = keep * (*D)(i, j);
-          sum += value;
-          sumsq += value*value;
-          count += keep;
-        }
+    // zC  = (C - mean(D)) / std(D)     [znorm the tnorm scores]
+    // and the mean and std of zC for each probe
+    if (C && size_tnorm > 0) {
+      statistics.t_mean.resize(C->extent(1));
+      statistics.t_std.resize(C->extent(1));
+      bob::core::parallelChunks(C->extent(1), n_threads,
+        TStatisticsChunk(*C, mean_Dimp, std_Dimp, statistics.t_mean,
+          statistics.t_std));
+    }
+    else {
+      statistics.t_mean.resize(0);
+      statistics.t_std.resize(0);
+    }
+  }
 
-        double mean = sum / count;
-        mean_Dimp(i) = mean;
-        if (count > 1)
-          std_Dimp(i) = sqrt((sumsq - count * mean * mean) / (count -1));
-        else // 1 single value -> std = 0
-          std_Dimp(i) = 0;
-      }
+  void ztNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
+              const blitz::Array<double,2>* rawscores_zprobes_vs_models,
+              const blitz::Array<double,2>* rawscores_probes_vs_tmodels,
+              const blitz::Array<double,2>* rawscores_zprobes_vs_tmodels,
+              const blitz::Array<bool,2>* mask_zprobes_vs_tmodels_istruetrial,
+              blitz::Array<double,2>& scores, const size_t n_threads)
+  {
+    // Rename variables
+    const blitz::Array<double,2>& A = rawscores_probes_vs_models;
+    const blitz::Array<double,2>* B = rawscores_zprobes_vs_models;
+    const blitz::Array<double,2>* C = rawscores_probes_vs_tmodels;
 
-      // zC  = (C - mean(D)) / std(D)     [znorm the tnorm scores]
-      std_Dimp = blitz::where( std_Dimp <= eps, 1., std_Dimp);
-      zC = ((*C)(ii, jj) - mean_Dimp(ii)) / std_Dimp(ii);
-    }
-    else if (C && size_tnorm > 0)
-      zC = *C;
+    // Compute the sizes
+    int size_eval  = A.extent(0);
+    int size_enrol = A.extent(1);
+    int size_tnorm = (C ? C->extent(0) : 0);
+    int size_znorm = (B ? B->extent(1) : 0);
 
+    // Check the inputs (the others are checked by ztNormStatistics())
+    if (B && size_znorm > 0)
+      bob::core::array::assertSameDimensionLength(B->extent(0), size_eval);
     if (C && size_tnorm > 0)
-    {
-      blitz::Array<double,1> mean_zC(size_enrol);
-      blitz::Array<double,1> std_zC(size_enrol);
-      
-      // ztA = (zA - mean(zC)) / std(zC)  [ztnorm on eval scores]
-      mean_zC = blitz::mean(zC(jj, ii), jj);
-      if (size_tnorm > 1)
-        std_zC = sqrt(blitz::sum(pow(zC(jj, ii) - mean_zC(ii), 2) , jj) / (size_tnorm - 1));
-      else // 1 single value -> std = 0
-        std_zC = 0;
-      std_zC = blitz::where( std_zC <= eps, 1., std_zC);
-
-      // Normalised scores
-      scores = (zA(ii, jj) - mean_zC(jj)) /  std_zC(jj);
-    }
-    else
-      scores = zA;
+      bob::core::array::assertSameDimensionLength(C->extent(1), size_enrol);
+
+    ZTNormStatistics statistics;
+    ztNormStatistics(B, C, rawscores_zprobes_vs_tmodels,
+      mask_zprobes_vs_tmodels_istruetrial, statistics, n_threads);
+    bob::machine::ztNormApply(A, statistics, 0, 0, scores, n_threads);
+  }
+}
+
+void ztNormStatistics(const blitz::Array<double,2>& rawscores_zprobes_vs_models,
+                      const blitz::Array<double,2>& rawscores_probes_vs_tmodels,
+                      const blitz::Array<double,2>& rawscores_zprobes_vs_tmodels,
+                      const blitz::Array<bool,2>& mask_zprobes_vs_tmodels_istruetrial,
+                      ZTNormStatistics& statistics, const size_t n_threads)
+{
+  detail::ztNormStatistics(&rawscores_zprobes_vs_models, &rawscores_probes_vs_tmodels,
+                           &rawscores_zprobes_vs_tmodels, &mask_zprobes_vs_tmodels_istruetrial,
+                           statistics, n_threads);
+}
+
+void ztNormStatistics(const blitz::Array<double,2>& rawscores_zprobes_vs_models,
+                      const blitz::Array<double,2>& rawscores_probes_vs_tmodels,
+                      const blitz::Array<double,2>& rawscores_zprobes_vs_tmodels,
+                      ZTNormStatistics& statistics, const size_t n_threads)
+{
+  detail::ztNormStatistics(&rawscores_zprobes_vs_models, &rawscores_probes_vs_tmodels,
+                           &rawscores_zprobes_vs_tmodels, NULL, statistics, n_threads);
+}
+
+void ztNormApply(const blitz::Array<double,2>& rawscores_probes_vs_models,
+                 const ZTNormStatistics& statistics, const int first_model,
+                 const int first_probe, blitz::Array<double,2>& scores,
+                 const size_t n_threads)
+{
+  const blitz::Array<double,2>& A = rawscores_probes_vs_models;
+  bob::core::array::assertSameShape(scores, A);
+  if (statistics.z_mean.extent(0) > 0 && (first_model < 0 ||
+        first_model + A.extent(0) > statistics.z_mean.extent(0))) {
+    boost::format m("the models [%d, %d[ of the scores are out of the range of the Z-Norm statistics (%d models)");
+    m % first_model % (first_model + A.extent(0)) % statistics.z_mean.extent(0);
+    throw std::runtime_error(m.str());
+  }
+  if (statistics.t_mean.extent(0) > 0 && (first_probe < 0 ||
+        first_probe + A.extent(1) > statistics.t_mean.extent(0))) {
+    boost::format m("the probes [%d, %d[ of the scores are out of the range of the T-Norm statistics (%d probes)");
+    m % first_probe % (first_probe + A.extent(1)) % statistics.t_mean.extent(0);
+    throw std::runtime_error(m.str());
+  }
+
+  bob::core::parallelChunks(A.extent(0), n_threads,
+    ApplyChunk(A, statistics, first_model, first_probe, scores));
+}
+
+void ztNormApply(const blitz::Array<double,2>& rawscores_probes_vs_models,
+                 const ZTNormStatistics& statistics, bob::io::HDF5File& file,
+                 const std::string& path, const size_t n_threads,
+                 const size_t block_size)
+{
+  const blitz::Array<double,2>& A = rawscores_probes_vs_models;
+  const int n_models = A.extent(0);
+  const int block = std::max(1, std::min(n_models, static_cast<int>(block_size)));
+  blitz::Array<double,2> scores(block, A.extent(1));
+  blitz::Range a = blitz::Range::all();
+  for (int start=0; start<n_models; start+=block) {
+    const int n = std::min(block, n_models-start);
+    blitz::Array<double,2> scores_ = scores(blitz::Range(0, n-1), a);
+    ztNormApply(A(blitz::Range(start, start+n-1), a), statistics, start, 0,
+      scores_, n_threads);
+    file.appendArrayRange(path, scores_);
   }
 }
 
@@ -165,36 +354,37 @@ void ztNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
             const blitz::Array<double,2>& rawscores_probes_vs_tmodels,
             const blitz::Array<double,2>& rawscores_zprobes_vs_tmodels,
             const blitz::Array<bool,2>& mask_zprobes_vs_tmodels_istruetrial,
-            blitz::Array<double,2>& scores)
+            blitz::Array<double,2>& scores, const size_t n_threads)
 {
   detail::ztNorm(rawscores_probes_vs_models, &rawscores_zprobes_vs_models, &rawscores_probes_vs_tmodels,
-                 &rawscores_zprobes_vs_tmodels, &mask_zprobes_vs_tmodels_istruetrial, scores);
+                 &rawscores_zprobes_vs_tmodels, &mask_zprobes_vs_tmodels_istruetrial, scores,
+                 n_threads);
 }
 
 void ztNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
             const blitz::Array<double,2>& rawscores_zprobes_vs_models,
             const blitz::Array<double,2>& rawscores_probes_vs_tmodels,
             const blitz::Array<double,2>& rawscores_zprobes_vs_tmodels,
-            blitz::Array<double,2>& scores)
+            blitz::Array<double,2>& scores, const size_t n_threads)
 {
   detail::ztNorm(rawscores_probes_vs_models, &rawscores_zprobes_vs_models, &rawscores_probes_vs_tmodels,
-                 &rawscores_zprobes_vs_tmodels, NULL, scores);
+                 &rawscores_zprobes_vs_tmodels, NULL, scores, n_threads);
 }
 
 void tNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
            const blitz::Array<double,2>& rawscores_probes_vs_tmodels,
-           blitz::Array<double,2>& scores)
+           blitz::Array<double,2>& scores, const size_t n_threads)
 {
   detail::ztNorm(rawscores_probes_vs_models, NULL, &rawscores_probes_vs_tmodels,
-                 NULL, NULL, scores);
+                 NULL, NULL, scores, n_threads);
 }
 
 void zNorm(const blitz::Array<double,2>& rawscores_probes_vs_models,
            const blitz::Array<double,2>& rawscores_zprobes_vs_models,
-           blitz::Array<double,2>& scores)
+           blitz::Array<double,2>& scores, const size_t n_threads)
 {
   detail::ztNorm(rawscores_probes_vs_models, &rawscores_zprobes_vs_models, NULL,
-                 NULL, NULL, scores);
+                 NULL, NULL, scores, n_threads);
 }
 
 }}
@@ -0,0 +1,148 @@
+/**
+ * @file machine/cxx/test/ztnorm.cc
+ * @date Fri Oct 16 11:42:07 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Tests the blocked application of ZT-Norm against the full one
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ZTNorm Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <blitz/array.h>
+#include <cmath>
+
+#include "bob/machine/ZTNorm.h"
+#include "bob/core/logging.h" // for bob::core::tmpfile()
+#include "bob/io/HDF5File.h"
+
+struct T {
+  blitz::Array<double,2> A; // probes vs models (5 x 7)
+  blitz::Array<double,2> B; // zprobes vs models (5 x 4)
+  blitz::Array<double,2> C; // probes vs tmodels (3 x 7)
+  blitz::Array<double,2> D; // zprobes vs tmodels (3 x 4)
+  blitz::Array<bool,2> mask; // zprobes vs tmodels true trials (3 x 4)
+  blitz::Array<double,2> reference; // full ZT-Norm of A
+  double eps;
+
+  T(): A(5,7), B(5,4), C(3,7), D(3,4), mask(3,4), reference(5,7),
+    eps(1e-10)
+  {
+    fill(A, 0.3);
+    fill(B, 1.1);
+    fill(C, 2.7);
+    fill(D, 4.2);
+    mask = false;
+    mask(0,1) = true;
+    mask(2,3) = true;
+    bob::machine::ztNorm(A, B, C, D, mask, reference);
+  }
+
+  ~T() {}
+
+  static void fill(blitz::Array<double,2>& x, const double seed) {
+    for (int i=0; i<x.extent(0); ++i)
+      for (int j=0; j<x.extent(1); ++j)
+        x(i,j) = std::sin(seed + 1.7*i + 0.9*j*j) * (1. + 0.25*i);
+  }
+};
+
+void check_close(const blitz::Array<double,2>& a,
+    const blitz::Array<double,2>& b, const int first_row, const int first_col,
+    const double eps)
+{
+  for (int i=0; i<a.extent(0); ++i)
+    for (int j=0; j<a.extent(1); ++j)
+      BOOST_CHECK_SMALL(a(i,j) - b(first_row+i, first_col+j), eps);
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_ztnorm_blocks )
+{
+  bob::machine::ZTNormStatistics statistics;
+  bob::machine::ztNormStatistics(B, C, D, mask, statistics, 2);
+
+  // Uneven blocks, which start at non-zero models and probes
+  const int models[] = {0, 2, 5};
+  const int probes[] = {0, 3, 4, 7};
+  blitz::Range all = blitz::Range::all();
+  for (int m=0; m<2; ++m) {
+    for (int p=0; p<3; ++p) {
+      blitz::Range rm(models[m], models[m+1]-1);
+      blitz::Range rp(probes[p], probes[p+1]-1);
+      blitz::Array<double,2> block = A(rm, rp).copy();
+      blitz::Array<double,2> scores(block.shape());
+      bob::machine::ztNormApply(block, statistics, models[m], probes[p],
+        scores, 3);
+      check_close(scores, reference, models[m], probes[p], eps);
+    }
+  }
+
+  // Blocks out of the range of the statistics are rejected
+  blitz::Array<double,2> block = A(blitz::Range(0,1), all).copy();
+  blitz::Array<double,2> scores(block.shape());
+  BOOST_CHECK_THROW(bob::machine::ztNormApply(block, statistics, 4, 0,
+    scores), std::runtime_error);
+  BOOST_CHECK_THROW(bob::machine::ztNormApply(block, statistics, 0, 1,
+    scores), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( test_ztnorm_inplace )
+{
+  // The normalized scores may be the raw scores themselves
+  blitz::Array<double,2> scores = A.copy();
+  bob::machine::ztNorm(scores, B, C, D, mask, scores, 2);
+  check_close(scores, reference, 0, 0, eps);
+
+  bob::machine::ZTNormStatistics statistics;
+  bob::machine::ztNormStatistics(B, C, D, mask, statistics);
+  blitz::Array<double,2> block = A(blitz::Range(1,3), blitz::Range(2,6)).copy();
+  bob::machine::ztNormApply(block, statistics, 1, 2, block, 2);
+  check_close(block, reference, 1, 2, eps);
+}
+
+BOOST_AUTO_TEST_CASE( test_ztnorm_hdf5 )
+{
+  bob::machine::ZTNormStatistics statistics;
+  bob::machine::ztNormStatistics(B, C, D, mask, statistics);
+
+  const std::string filename = bob::core::tmpfile();
+  {
+    bob::io::HDF5File file(filename, bob::io::HDF5File::trunc);
+    bob::machine::ztNormApply(A, statistics, file, "scores", 2, 2);
+  }
+
+  // The normalized scores of all the models are stored as a single array,
+  // which can also be read back model by model
+  bob::io::HDF5File file(filename, bob::io::HDF5File::in);
+  blitz::Array<double,2> scores = file.readArray<double,2>("scores");
+  BOOST_REQUIRE_EQUAL(scores.extent(0), A.extent(0));
+  BOOST_REQUIRE_EQUAL(scores.extent(1), A.extent(1));
+  check_close(scores, reference, 0, 0, eps);
+  for (int i=0; i<A.extent(0); ++i) {
+    blitz::Array<double,2> row = file.readArrayRange<double,2>("scores", i, 1);
+    check_close(row, reference, i, 0, eps);
+  }
+
+  // Clean-up
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
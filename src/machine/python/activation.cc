@@ -77,7 +77,24 @@ static void apply(boost::function<double (double)> function, bob::python::const_
   }
 }
 
+/**
+ * Tells if arr and retval are matrices, which can be mapped through a
+ * single call to the layer variants of the activation functions
+ */
+static bool is_layer(bob::python::const_ndarray arr, bob::python::ndarray retval) {
+  const bob::core::array::typeinfo& info = arr.type();
+  return info.nd == 2 && info.is_compatible(retval.type());
+}
+
 static object activation_f_ndarray_1(boost::shared_ptr<bob::machine::Activation> a, bob::python::const_ndarray arr, bob::python::ndarray retval) {
+  if (is_layer(arr, retval)) {
+    blitz::Array<double,2> retval_ = retval.bz<double,2>();
+    retval_ = arr.bz<double,2>();
+    blitz::Array<double,1> bias(retval_.extent(1));
+    bias = 0.;
+    a->f_layer(retval_, bias);
+    return retval.self();
+  }
   apply(boost::bind(&bob::machine::Activation::f, a, _1), arr, retval);
   return retval.self();
 }
@@ -97,7 +114,33 @@ static object activation_f_prime_ndarray_2(boost::shared_ptr<bob::machine::Activ
   return activation_f_prime_ndarray_1(a, arr, retval);
 }
 
+/**
+ * Tells if the memory spanned by two matrices overlaps
+ */
+static bool overlap(const blitz::Array<double,2>& a, const blitz::Array<double,2>& b) {
+  const double* a_lo = a.data(); const double* a_hi = a.data();
+  const double* b_lo = b.data(); const double* b_hi = b.data();
+  for (int d=0; d<2; ++d) {
+    const ptrdiff_t a_end = (a.extent(d) - 1) * a.stride(d);
+    const ptrdiff_t b_end = (b.extent(d) - 1) * b.stride(d);
+    if (a_end < 0) a_lo += a_end; else a_hi += a_end;
+    if (b_end < 0) b_lo += b_end; else b_hi += b_end;
+  }
+  return a_lo <= b_hi && b_lo <= a_hi;
+}
+
 static object activation_f_prime_from_f_ndarray_1(boost::shared_ptr<bob::machine::Activation> a, bob::python::const_ndarray arr, bob::python::ndarray retval) {
+  if (is_layer(arr, retval)) {
+    blitz::Array<double,2> arr_ = arr.bz<double,2>();
+    blitz::Array<double,2> retval_ = retval.bz<double,2>();
+    //the layer variant overwrites retval before reading arr: if they share
+    //memory, the values are computed one by one instead
+    if (!overlap(arr_, retval_)) {
+      retval_ = 1.;
+      a->f_prime_from_f_layer(arr_, retval_);
+      return retval.self();
+    }
+  }
   apply(boost::bind(&bob::machine::Activation::f_prime_from_f, a, _1), arr, retval);
   return retval.self();
 }
@@ -19,6 +19,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <boost/python.hpp>
 #include <bob/machine/BICMachine.h>
 #include <bob/io/HDF5File.h>
@@ -27,13 +28,21 @@
 
 static double bic_call_(const bob::machine::BICMachine& machine, bob::python::const_ndarray input){
   double o;
-  machine.forward_(input.bz<double,1>(), o);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    machine.forward_(input_, o);
+  }
   return o;
 }
 
 static double bic_call(const bob::machine::BICMachine& machine, bob::python::const_ndarray input){
   double o;
-  machine.forward(input.bz<double,1>(), o);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    machine.forward(input_, o);
+  }
   return o;
 }
 
@@ -23,6 +23,7 @@
 
 #include <boost/python.hpp>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 
 #include <bob/ip/GaborWaveletTransform.h>
 #include <bob/machine/GaborGraphMachine.h>
@@ -31,10 +32,18 @@
 static void bob_extract(bob::machine::GaborGraphMachine& self, bob::python::const_ndarray input_jet_image, bob::python::ndarray output_graph){
   if (output_graph.type().nd == 2){
     blitz::Array<double,2> graph = output_graph.bz<double,2>();
-    self.extract(input_jet_image.bz<double,3>(), graph);
+    blitz::Array<double,3> input_jet_image_ = input_jet_image.bz<double,3>();
+    {
+      bob::python::no_gil unlock;
+      self.extract(input_jet_image_, graph);
+    }
   } else if (output_graph.type().nd == 3){
     blitz::Array<double,3> graph = output_graph.bz<double,3>();
-    self.extract(input_jet_image.bz<double,4>(), graph);
+    blitz::Array<double,4> input_jet_image_ = input_jet_image.bz<double,4>();
+    {
+      bob::python::no_gil unlock;
+      self.extract(input_jet_image_, graph);
+    }
   } else {
     PYTHON_ERROR(RuntimeError, "parameter `output_graph' should be 2 or 3 dimensional, but you passed a " SIZE_T_FMT " dimensional array.", output_graph.type().nd);
   }
@@ -20,6 +20,7 @@
 
 #include <boost/python.hpp>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/machine/Gaussian.h>
 
 
@@ -58,7 +59,11 @@ static double py_logLikelihood(const bob::machine::Gaussian& machine,
   bob::python::const_ndarray input)
 {
   double output;
-  machine.forward(input.bz<double,1>(), output);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    machine.forward(input_, output);
+  }
   return output;
 }
 
@@ -66,7 +71,11 @@ static double py_logLikelihood_(const bob::machine::Gaussian& machine,
   bob::python::const_ndarray input)
 {
   double output;
-  machine.forward_(input.bz<double,1>(), output);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    machine.forward_(input_, output);
+  }
   return output;
 }
 
@@ -19,6 +19,7 @@
  */
 #include <boost/python.hpp>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <boost/concept_check.hpp>
 #include <bob/machine/GMMStats.h>
 #include <bob/machine/GMMMachine.h>
@@ -171,26 +172,82 @@ static double py_gmmmachine_loglikelihoodA(const bob::machine::GMMMachine& machi
   bob::python::const_ndarray x, bob::python::ndarray ll)
 {
   blitz::Array<double,1> ll_ = ll.bz<double,1>();
-  return machine.logLikelihood(x.bz<double,1>(), ll_);
+  blitz::Array<double,1> x_ = x.bz<double,1>();
+  bob::python::no_gil unlock;
+  return machine.logLikelihood(x_, ll_);
 }
 
 static double py_gmmmachine_loglikelihoodA_(const bob::machine::GMMMachine& machine, 
   bob::python::const_ndarray x, bob::python::ndarray ll)
 {
   blitz::Array<double,1> ll_ = ll.bz<double,1>();
-  return machine.logLikelihood_(x.bz<double,1>(), ll_);
+  blitz::Array<double,1> x_ = x.bz<double,1>();
+  bob::python::no_gil unlock;
+  return machine.logLikelihood_(x_, ll_);
 }
 
-static double py_gmmmachine_loglikelihoodB(const bob::machine::GMMMachine& machine,
+static object py_gmmmachine_loglikelihoodB(const bob::machine::GMMMachine& machine,
   bob::python::const_ndarray x)
 {
-  return machine.logLikelihood(x.bz<double,1>());
+  const bob::core::array::typeinfo& info = x.type();
+  switch(info.nd) {
+    case 1:
+      {
+        blitz::Array<double,1> x_ = x.bz<double,1>();
+        double ll;
+        {
+          bob::python::no_gil unlock;
+          ll = machine.logLikelihood(x_);
+        }
+        return object(ll);
+      }
+    case 2:
+      {
+        blitz::Array<double,2> x_ = x.bz<double,2>();
+        bob::python::ndarray ll(bob::core::array::t_float64, x_.extent(0));
+        blitz::Array<double,1> ll_ = ll.bz<double,1>();
+        {
+          bob::python::no_gil unlock;
+          machine.logLikelihood(x_, ll_);
+        }
+        return ll.self();
+      }
+    default:
+      PYTHON_ERROR(TypeError, "cannot compute the log likelihood of arrays with "  SIZE_T_FMT " dimensions (only with 1 or 2 dimensions).", info.nd);
+  }
+  return object();
 }
 
-static double py_gmmmachine_loglikelihoodB_(const bob::machine::GMMMachine& machine,
+static object py_gmmmachine_loglikelihoodB_(const bob::machine::GMMMachine& machine,
   bob::python::const_ndarray x)
 {
-  return machine.logLikelihood_(x.bz<double,1>());
+  const bob::core::array::typeinfo& info = x.type();
+  switch(info.nd) {
+    case 1:
+      {
+        blitz::Array<double,1> x_ = x.bz<double,1>();
+        double ll;
+        {
+          bob::python::no_gil unlock;
+          ll = machine.logLikelihood_(x_);
+        }
+        return object(ll);
+      }
+    case 2:
+      {
+        blitz::Array<double,2> x_ = x.bz<double,2>();
+        bob::python::ndarray ll(bob::core::array::t_float64, x_.extent(0));
+        blitz::Array<double,1> ll_ = ll.bz<double,1>();
+        {
+          bob::python::no_gil unlock;
+          machine.logLikelihood_(x_, ll_);
+        }
+        return ll.self();
+      }
+    default:
+      PYTHON_ERROR(TypeError, "cannot compute the log likelihood of arrays with "  SIZE_T_FMT " dimensions (only with 1 or 2 dimensions).", info.nd);
+  }
+  return object();
 }
 
 static void py_gmmmachine_accStatistics(const bob::machine::GMMMachine& machine,
@@ -199,10 +256,18 @@ static void py_gmmmachine_accStatistics(const bob::machine::GMMMachine& machine,
   const bob::core::array::typeinfo& info = x.type();
   switch(info.nd) {
     case 1:
-      machine.accStatistics(x.bz<double,1>(), gs);
+      {
+        blitz::Array<double,1> x_ = x.bz<double,1>();
+        bob::python::no_gil unlock;
+        machine.accStatistics(x_, gs);
+      }
       break;
     case 2:
-      machine.accStatistics(x.bz<double,2>(), gs);
+      {
+        blitz::Array<double,2> x_ = x.bz<double,2>();
+        bob::python::no_gil unlock;
+        machine.accStatistics(x_, gs);
+      }
       break;
     default:
       PYTHON_ERROR(TypeError, "cannot accStatistics of arrays with "  SIZE_T_FMT " dimensions (only with 1 or 2 dimensions).", info.nd);
@@ -215,10 +280,18 @@ static void py_gmmmachine_accStatistics_(const bob::machine::GMMMachine& machine
   const bob::core::array::typeinfo& info = x.type();
   switch(info.nd) {
     case 1:
-      machine.accStatistics_(x.bz<double,1>(), gs);
+      {
+        blitz::Array<double,1> x_ = x.bz<double,1>();
+        bob::python::no_gil unlock;
+        machine.accStatistics_(x_, gs);
+      }
       break;
     case 2:
-      machine.accStatistics_(x.bz<double,2>(), gs);
+      {
+        blitz::Array<double,2> x_ = x.bz<double,2>();
+        bob::python::no_gil unlock;
+        machine.accStatistics_(x_, gs);
+      }
       break;
     default:
       PYTHON_ERROR(TypeError, "cannot accStatistics of arrays with "  SIZE_T_FMT " dimensions (only with 1 or 2 dimensions).", info.nd);
@@ -292,9 +365,9 @@ void bind_machine_gmm()
     .def("log_likelihood_", &py_gmmmachine_loglikelihoodA_, args("self", "x", "log_weighted_gaussian_likelihoods"),
          "Output the log likelihood of the sample, x, i.e. log(p(x|bob::machine::GMMMachine)). Inputs are NOT checked.")
     .def("log_likelihood", &py_gmmmachine_loglikelihoodB, args("self", "x"),
-         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). Inputs are checked.")
+         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). If x is a 2D array, the log likelihoods of all its rows are computed at once and returned as a 1D array. Inputs are checked.")
     .def("log_likelihood_", &py_gmmmachine_loglikelihoodB_, args("self", "x"),
-         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). Inputs are checked.")
+         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). If x is a 2D array, the log likelihoods of all its rows are computed at once and returned as a 1D array. Inputs are NOT checked.")
     .def("acc_statistics", &py_gmmmachine_accStatistics, args("self", "x", "stats"),
          "Accumulate the GMM statistics for this sample(s). Inputs are checked.")
     .def("acc_statistics_", &py_gmmmachine_accStatistics_, args("self", "x", "stats"),
@@ -22,6 +22,7 @@
 
 #include <boost/python.hpp>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <boost/shared_ptr.hpp>
 #include <bob/machine/JFAMachine.h>
 #include <bob/machine/GMMMachine.h>
@@ -74,7 +75,11 @@ static double py_jfa_forwardUx(bob::machine::JFAMachine& machine,
   const bob::machine::GMMStats& gmm_stats, bob::python::const_ndarray ux)
 {
   double score;
-  machine.forward(gmm_stats, ux.bz<double,1>(), score);
+  blitz::Array<double,1> ux_ = ux.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    machine.forward(gmm_stats, ux_, score);
+  }
   return score;
 }
 
@@ -113,7 +118,11 @@ static double py_isv_forwardUx(bob::machine::ISVMachine& machine,
   const bob::machine::GMMStats& gmm_stats, bob::python::const_ndarray ux)
 {
   double score;
-  machine.forward(gmm_stats, ux.bz<double,1>(), score);
+  blitz::Array<double,1> ux_ = ux.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    machine.forward(gmm_stats, ux_, score);
+  }
   return score;
 }
 
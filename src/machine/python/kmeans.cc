@@ -22,6 +22,7 @@
 #include <bob/machine/KMeansMachine.h>
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 
 using namespace boost::python;
 
@@ -32,7 +33,11 @@ static tuple py_getVariancesAndWeightsForEachCluster(const bob::machine::KMeansM
   bob::python::ndarray weights(bob::core::array::t_float64, n_means);
   blitz::Array<double,2> variances_ = variances.bz<double,2>();
   blitz::Array<double,1> weights_ = weights.bz<double,1>();
-  machine.getVariancesAndWeightsForEachCluster(ar.bz<double,2>(), variances_, weights_);
+  blitz::Array<double,2> ar_ = ar.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    machine.getVariancesAndWeightsForEachCluster(ar_, variances_, weights_);
+  }
   return boost::python::make_tuple(variances.self(), weights.self());
 }
 
@@ -78,7 +83,11 @@ static tuple py_getClosestMean(const bob::machine::KMeansMachine& machine, bob::
 {
   size_t closest_mean;
   double min_distance;
-  machine.getClosestMean(x.bz<double,1>(), closest_mean, min_distance);
+  blitz::Array<double,1> x_ = x.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    machine.getClosestMean(x_, closest_mean, min_distance);
+  }
   return boost::python::make_tuple(closest_mean, min_distance);
 }
 
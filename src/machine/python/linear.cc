@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/machine/LinearMachine.h>
 
 using namespace boost::python;
@@ -35,7 +36,11 @@ static object forward(const bob::machine::LinearMachine& m,
       {
         bob::python::ndarray output(bob::core::array::t_float64, m.outputSize());
         blitz::Array<double,1> output_ = output.bz<double,1>();
-        m.forward(input.bz<double,1>(), output_);
+        blitz::Array<double,1> input_ = input.bz<double,1>();
+        {
+          bob::python::no_gil unlock;
+          m.forward(input_, output_);
+        }
         return output.self();
       }
     case 2:
@@ -65,7 +70,9 @@ static void forward2(const bob::machine::LinearMachine& m,
     case 1:
       {
         blitz::Array<double,1> output_ = output.bz<double,1>();
-        m.forward(input.bz<double,1>(), output_);
+        blitz::Array<double,1> input_ = input.bz<double,1>();
+        bob::python::no_gil unlock;
+        m.forward(input_, output_);
       }
       break;
     case 2:
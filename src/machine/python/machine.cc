@@ -23,20 +23,29 @@
 #include <bob/machine/Machine.h>
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 
 using namespace boost::python;
 
 static double forward(const bob::machine::Machine<blitz::Array<double,1>, double>& m,
     bob::python::const_ndarray input) {
   double output;
-  m.forward(input.bz<double,1>(), output);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    m.forward(input_, output);
+  }
   return output;
 }
 
 static double forward_(const bob::machine::Machine<blitz::Array<double,1>, double>& m,
     bob::python::const_ndarray input) {
   double output;
-  m.forward_(input.bz<double,1>(), output);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    m.forward_(input_, output);
+  }
   return output;
 }
 
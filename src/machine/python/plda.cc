@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <boost/shared_ptr.hpp>
 #include <bob/python/exception.h>
 #include <bob/machine/PLDAMachine.h>
@@ -89,14 +90,22 @@ static double plda_forward_sample(bob::machine::PLDAMachine& m,
       {
         double score;
         // Calls the forward function
-        m.forward(samples.bz<double,1>(), score);
+        blitz::Array<double,1> samples_ = samples.bz<double,1>();
+        {
+          bob::python::no_gil unlock;
+          m.forward(samples_, score);
+        }
         return score;
       }
     case 2:
       {
         double score;
         // Calls the forward function
-        m.forward(samples.bz<double,2>(), score);
+        blitz::Array<double,2> samples_ = samples.bz<double,2>();
+        {
+          bob::python::no_gil unlock;
+          m.forward(samples_, score);
+        }
         return score;
       }
     default:
@@ -19,6 +19,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <vector>
 #include <bob/machine/roll.h>
 #include <boost/python/stl_iterator.hpp>
@@ -85,7 +86,9 @@ static object unroll3(object w, object b)
 
 static void roll1(bob::machine::MLP& m, bob::python::const_ndarray vec)
 {
-  bob::machine::roll(m, vec.bz<double,1>());
+  blitz::Array<double,1> vec_ = vec.bz<double,1>();
+  bob::python::no_gil unlock;
+  bob::machine::roll(m, vec_);
 }
 
 static void roll2(object w, object b, bob::python::const_ndarray vec)
@@ -104,7 +107,9 @@ static void roll2(object w, object b, bob::python::const_ndarray vec)
       it!=bv.end(); ++it)
     b_.push_back(it->bz<double,1>());
 
-  bob::machine::roll(w_, b_, vec.bz<double,1>());
+  blitz::Array<double,1> vec_ = vec.bz<double,1>();
+  bob::python::no_gil unlock;
+  bob::machine::roll(w_, b_, vec_);
 }
 
 void bind_machine_roll() {
@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/machine/SVM.h>
 
 using namespace boost::python;
@@ -31,12 +32,24 @@ static tuple get_shape(const bob::machine::SupportVector& m) {
 
 static object predict_class(const bob::machine::SupportVector& m,
     bob::python::const_ndarray input) {
-  return object(m.predictClass(input.bz<double,1>()));
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  int c;
+  {
+    bob::python::no_gil unlock;
+    c = m.predictClass(input_);
+  }
+  return object(c);
 }
 
 static object predict_class_(const bob::machine::SupportVector& m,
     bob::python::const_ndarray input) {
-  return object(m.predictClass_(input.bz<double,1>()));
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  int c;
+  {
+    bob::python::no_gil unlock;
+    c = m.predictClass_(input_);
+  }
+  return object(c);
 }
 
 static object predict_class_n(const bob::machine::SupportVector& m,
@@ -46,11 +59,16 @@ static object predict_class_n(const bob::machine::SupportVector& m,
     PYTHON_ERROR(RuntimeError, "Input array should have " SIZE_T_FMT " columns, but you have given me one with %d instead", m.inputSize(), i_.extent(1));
   }
   blitz::Range all = blitz::Range::all();
-  list retval;
-  for (int k=0; k<i_.extent(0); ++k) {
-    blitz::Array<double,1> tmp = i_(k,all);
-    retval.append(m.predictClass_(tmp));
+  std::vector<int> classes(i_.extent(0));
+  {
+    bob::python::no_gil unlock;
+    for (int k=0; k<i_.extent(0); ++k) {
+      blitz::Array<double,1> tmp = i_(k,all);
+      classes[k] = m.predictClass_(tmp);
+    }
   }
+  list retval;
+  for (size_t k=0; k<classes.size(); ++k) retval.append(classes[k]);
   return tuple(retval);
 }
 
@@ -69,20 +87,29 @@ static object svm_call(const bob::machine::SupportVector& m,
 static int predict_class_and_scores(const bob::machine::SupportVector& m, 
     bob::python::const_ndarray input, bob::python::ndarray scores) {
   blitz::Array<double,1> scores_ = scores.bz<double,1>();
-  return m.predictClassAndScores(input.bz<double,1>(), scores_);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  bob::python::no_gil unlock;
+  return m.predictClassAndScores(input_, scores_);
 }
 
 static int predict_class_and_scores_(const bob::machine::SupportVector& m, 
     bob::python::const_ndarray input, bob::python::ndarray scores) {
   blitz::Array<double,1> scores_ = scores.bz<double,1>();
-  return m.predictClassAndScores_(input.bz<double,1>(), scores_);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  bob::python::no_gil unlock;
+  return m.predictClassAndScores_(input_, scores_);
 }
 
 static tuple predict_class_and_scores2(const bob::machine::SupportVector& m, 
     bob::python::const_ndarray input) {
   bob::python::ndarray scores(bob::core::array::t_float64, m.outputSize());
   blitz::Array<double,1> scores_ = scores.bz<double,1>();
-  int c = m.predictClassAndScores(input.bz<double,1>(), scores_);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  int c;
+  {
+    bob::python::no_gil unlock;
+    c = m.predictClassAndScores(input_, scores_);
+  }
   return make_tuple(c, scores.self());
 }
 
@@ -93,13 +120,24 @@ static object predict_class_and_scores_n(const bob::machine::SupportVector& m,
     PYTHON_ERROR(RuntimeError, "Input array should have " SIZE_T_FMT " columns, but you have given me one with %d instead", m.inputSize(), i_.extent(1));
   }
   blitz::Range all = blitz::Range::all();
+  std::vector<bob::python::ndarray> s;
+  std::vector<blitz::Array<double,1> > s_;
+  for (int k=0; k<i_.extent(0); ++k) {
+    s.push_back(bob::python::ndarray(bob::core::array::t_float64, m.outputSize()));
+    s_.push_back(s.back().bz<double,1>());
+  }
+  std::vector<int> c(i_.extent(0));
+  {
+    bob::python::no_gil unlock;
+    for (int k=0; k<i_.extent(0); ++k) {
+      blitz::Array<double,1> tmp = i_(k,all);
+      c[k] = m.predictClassAndScores_(tmp, s_[k]);
+    }
+  }
   list classes, scores;
   for (int k=0; k<i_.extent(0); ++k) {
-    blitz::Array<double,1> tmp = i_(k,all);
-    bob::python::ndarray s(bob::core::array::t_float64, m.outputSize());
-    blitz::Array<double,1> s_ = s.bz<double,1>();
-    classes.append(m.predictClassAndScores_(tmp, s_));
-    scores.append(s.self());
+    classes.append(c[k]);
+    scores.append(s[k].self());
   }
   return make_tuple(tuple(classes), tuple(scores));
 }
@@ -107,20 +145,29 @@ static object predict_class_and_scores_n(const bob::machine::SupportVector& m,
 static int predict_class_and_probs(const bob::machine::SupportVector& m, 
     bob::python::const_ndarray input, bob::python::ndarray probs) {
   blitz::Array<double,1> probs_ = probs.bz<double,1>();
-  return m.predictClassAndProbabilities(input.bz<double,1>(), probs_);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  bob::python::no_gil unlock;
+  return m.predictClassAndProbabilities(input_, probs_);
 }
 
 static int predict_class_and_probs_(const bob::machine::SupportVector& m, 
     bob::python::const_ndarray input, bob::python::ndarray probs) {
   blitz::Array<double,1> probs_ = probs.bz<double,1>();
-  return m.predictClassAndProbabilities_(input.bz<double,1>(), probs_);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  bob::python::no_gil unlock;
+  return m.predictClassAndProbabilities_(input_, probs_);
 }
 
 static tuple predict_class_and_probs2(const bob::machine::SupportVector& m, 
     bob::python::const_ndarray input) {
   bob::python::ndarray probs(bob::core::array::t_float64, m.outputSize());
   blitz::Array<double,1> probs_ = probs.bz<double,1>();
-  int c = m.predictClassAndProbabilities(input.bz<double,1>(), probs_);
+  blitz::Array<double,1> input_ = input.bz<double,1>();
+  int c;
+  {
+    bob::python::no_gil unlock;
+    c = m.predictClassAndProbabilities(input_, probs_);
+  }
   return make_tuple(c, probs.self());
 }
 
@@ -134,17 +181,58 @@ static object predict_class_and_probs_n(const bob::machine::SupportVector& m,
     PYTHON_ERROR(RuntimeError, "this SVM does not support probabilities");
   }
   blitz::Range all = blitz::Range::all();
+  std::vector<bob::python::ndarray> s;
+  std::vector<blitz::Array<double,1> > s_;
+  for (int k=0; k<i_.extent(0); ++k) {
+    s.push_back(bob::python::ndarray(bob::core::array::t_float64, m.numberOfClasses()));
+    s_.push_back(s.back().bz<double,1>());
+  }
+  std::vector<int> c(i_.extent(0));
+  {
+    bob::python::no_gil unlock;
+    for (int k=0; k<i_.extent(0); ++k) {
+      blitz::Array<double,1> tmp = i_(k,all);
+      c[k] = m.predictClassAndProbabilities_(tmp, s_[k]);
+    }
+  }
   list classes, probs;
   for (int k=0; k<i_.extent(0); ++k) {
-    blitz::Array<double,1> tmp = i_(k,all);
-    bob::python::ndarray s(bob::core::array::t_float64, m.numberOfClasses());
-    blitz::Array<double,1> s_ = s.bz<double,1>();
-    classes.append(m.predictClassAndProbabilities_(tmp, s_));
-    probs.append(s.self());
+    classes.append(c[k]);
+    probs.append(s[k].self());
   }
   return make_tuple(tuple(classes), tuple(probs));
 }
 
+static object predict_classes_dense(const bob::machine::SupportVector& m,
+    bob::python::const_ndarray input, const size_t n_threads,
+    const bool single_precision) {
+  blitz::Array<double,2> i_ = input.bz<double,2>();
+  bob::python::ndarray classes(bob::core::array::t_int32, i_.extent(0));
+  blitz::Array<int32_t,1> classes_ = classes.bz<int32_t,1>();
+  {
+    bob::python::no_gil unlock;
+    m.predictClasses(i_, classes_, n_threads, single_precision);
+  }
+  return classes.self();
+}
+
+static tuple predict_classes_and_scores_dense
+(const bob::machine::SupportVector& m, bob::python::const_ndarray input,
+ const size_t n_threads, const bool single_precision) {
+  blitz::Array<double,2> i_ = input.bz<double,2>();
+  bob::python::ndarray classes(bob::core::array::t_int32, i_.extent(0));
+  blitz::Array<int32_t,1> classes_ = classes.bz<int32_t,1>();
+  bob::python::ndarray scores(bob::core::array::t_float64,
+      (size_t)i_.extent(0), m.numberOfDecisionValues());
+  blitz::Array<double,2> scores_ = scores.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    m.predictClassesAndScores(i_, classes_, scores_, n_threads,
+        single_precision);
+  }
+  return make_tuple(classes.self(), scores.self());
+}
+
 static tuple labels(const bob::machine::SupportVector& m) {
   list retval;
   for (size_t k=0; k<m.numberOfClasses(); ++k) retval.append(m.classLabel(k));
@@ -284,6 +372,9 @@ void bind_machine_svm() {
     .def("predict_class_and_scores", &predict_class_and_scores, (arg("self"), arg("input"), arg("scores")), "Returns the predicted class given a certain input. Returns the scores for each class in the second argument. Checks the input and output arrays for size conformity. If the size is wrong, an exception is raised.")
     .def("predict_class_and_scores_", &predict_class_and_scores_, (arg("self"), arg("input"), arg("scores")), "Returns the predicted class given a certain input. Returns the scores for each class in the second argument. Checks the input and output arrays for size conformity. Does not check the input data and is, therefore, a little bit faster.")
     .def("predict_classes_and_scores", &predict_class_and_scores_n, (arg("self"), arg("input")), "Returns the predicted class and output scores as a tuple, in this order. Checks the input array for size conformity. If the size is wrong, an exception is raised. This variant takes a single 2D double array as input. The samples should be organized row-wise.")
+    .def("predict_classes_dense", &predict_classes_dense, (arg("self"), arg("input"), arg("n_threads")=1, arg("single_precision")=false), "Returns the predicted classes of a 2D double array of samples, organized row-wise, as a 1D int32 array. Checks the input array for size conformity. For linear, polynomial, RBF and sigmoid kernels, the kernel values of blocks of samples against all the (densely stored) support vectors are computed with matrix products, and combined into the decision values as libsvm does: results may differ from predict_classes() by rounding errors on samples lying on the decision boundaries. The samples are split across n_threads threads, and the kernel values may be computed in single precision.")
+    .def("predict_classes_and_scores_dense", &predict_classes_and_scores_dense, (arg("self"), arg("input"), arg("n_threads")=1, arg("single_precision")=false), "Returns the predicted classes and the decision values of a 2D double array of samples, organized row-wise, as a tuple with a 1D int32 array and a 2D float64 array (one row per sample, one column per pair of classes), in this order. See predict_classes_dense().")
+    .add_property("number_of_decision_values", &bob::machine::SupportVector::numberOfDecisionValues, "The number of decision values computed for each sample: one per pair of classes for classification, 1 otherwise")
     .def("predict_class_and_probabilities", &predict_class_and_probs2, (arg("self"), arg("input")), "Returns the predicted class and probabilities in a tuple (on that order) given a certain input. The current machine has to support probabilities, otherwise an exception is raised. Checks the input array for size conformity. If the size is wrong, an exception is raised.")
     .def("predict_class_and_probabilities", &predict_class_and_probs, (arg("self"), arg("input"), arg("probabilities")), "Returns the predicted class given a certain input. If the model supports it, returns the probabilities for each class in the second argument, otherwise raises an exception. Checks the input and output arrays for size conformity. If the size is wrong, an exception is raised.")
     .def("predict_class_and_probabilities_", &predict_class_and_probs_, (arg("self"), arg("input"), arg("probabilities")), "Returns the predicted class given a certain input. This version will not run any checks, so you must be sure to pass the correct input to the classifier.")
@@ -0,0 +1,302 @@
+/**
+ * @file math/cxx/linear.cc
+ * @date Fri Oct 16 10:12:43 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief BLAS-backed implementation of the double precision matrix
+ * products.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/math/linear.h>
+#include <algorithm>
+
+// Declaration of the external BLAS functions (Matrix products)
+extern "C" void dgemm_( const char *transa, const char *transb, const int *M,
+  const int *N, const int *K, const double *alpha, const double *A,
+  const int *lda, const double *B, const int *ldb, const double *beta,
+  double *C, const int *ldc);
+extern "C" void sgemm_( const char *transa, const char *transb, const int *M,
+  const int *N, const int *K, const float *alpha, const float *A,
+  const int *lda, const float *B, const int *ldb, const float *beta,
+  float *C, const int *ldc);
+extern "C" void dgemv_( const char *trans, const int *M, const int *N,
+  const double *alpha, const double *A, const int *lda, const double *x,
+  const int *incx, const double *beta, double *y, const int *incy);
+extern "C" void dsyrk_( const char *uplo, const char *trans, const int *N,
+  const int *K, const double *alpha, const double *A, const int *lda,
+  const double *beta, double *C, const int *ldc);
+extern "C" void ssyrk_( const char *uplo, const char *trans, const int *N,
+  const int *K, const float *alpha, const float *A, const int *lda,
+  const float *beta, float *C, const int *ldc);
+
+namespace {
+
+  /**
+   * Describes how a 2D blitz array is seen by the (column-major) BLAS.
+   * A row-major array is seen as its transpose, a Fortran-style array
+   * (e.g. a transposed view of a row-major array) as itself.
+   */
+  struct BlasLayout {
+    bool row_major;
+    int ld;
+  };
+
+  /**
+   * Checks if the array can be handed to BLAS as is, and fills in the
+   * corresponding layout. Extents of size 1 do not constrain the strides.
+   */
+  template <typename T>
+  bool blasLayout(const blitz::Array<T,2>& A, BlasLayout& l) {
+    const int m = A.extent(0);
+    const int n = A.extent(1);
+    if (m == 0 || n == 0) return false;
+    // Row-major: A(i,j) is at data + i*ld + j
+    if (n == 1 || A.stride(1) == 1) {
+      const int ld = (m == 1) ? n : A.stride(0);
+      if (ld >= n) {
+        l.row_major = true;
+        l.ld = ld;
+        return true;
+      }
+    }
+    // Column-major: A(i,j) is at data + i + j*ld
+    if (m == 1 || A.stride(0) == 1) {
+      const int ld = (n == 1) ? m : A.stride(1);
+      if (ld >= m) {
+        l.row_major = false;
+        l.ld = ld;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Returns the BLAS increment of a 1D blitz array, or 0 if the array
+   * cannot be handed to BLAS (negative or zero stride)
+   */
+  int blasIncrement(const blitz::Array<double,1>& a) {
+    if (a.extent(0) == 1) return 1;
+    return a.stride(0) > 0 ? a.stride(0) : 0;
+  }
+
+  /**
+   * Checks if B is a transposed view of A, in which case A*B is symmetric
+   */
+  template <typename T>
+  bool isTransposeOf(const blitz::Array<T,2>& A,
+      const blitz::Array<T,2>& B) {
+    return A.data() == B.data() &&
+      A.extent(0) == B.extent(1) && A.extent(1) == B.extent(0) &&
+      A.stride(0) == B.stride(1) && A.stride(1) == B.stride(0);
+  }
+
+  /**
+   * Overloads of the BLAS matrix products on the precision
+   */
+  void gemm(const char *transa, const char *transb, const int *M,
+      const int *N, const int *K, const double *alpha, const double *A,
+      const int *lda, const double *B, const int *ldb, const double *beta,
+      double *C, const int *ldc) {
+    dgemm_(transa, transb, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+  }
+
+  void gemm(const char *transa, const char *transb, const int *M,
+      const int *N, const int *K, const float *alpha, const float *A,
+      const int *lda, const float *B, const int *ldb, const float *beta,
+      float *C, const int *ldc) {
+    sgemm_(transa, transb, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+  }
+
+  void syrk(const char *uplo, const char *trans, const int *N,
+      const int *K, const double *alpha, const double *A, const int *lda,
+      const double *beta, double *C, const int *ldc) {
+    dsyrk_(uplo, trans, N, K, alpha, A, lda, beta, C, ldc);
+  }
+
+  void syrk(const char *uplo, const char *trans, const int *N,
+      const int *K, const float *alpha, const float *A, const int *lda,
+      const float *beta, float *C, const int *ldc) {
+    ssyrk_(uplo, trans, N, K, alpha, A, lda, beta, C, ldc);
+  }
+
+  /**
+   * Computes C=A*B with BLAS, C being a BLAS compatible array
+   */
+  template <typename T>
+  void blasProd(const blitz::Array<T,2>& A, const BlasLayout& la,
+      const blitz::Array<T,2>& B, const BlasLayout& lb,
+      blitz::Array<T,2>& C, const BlasLayout& lc) {
+    const int M = A.extent(0);
+    const int N = A.extent(1);
+    const int P = B.extent(1);
+    const T alpha = 1.;
+    const T beta = 0.;
+
+    if (isTransposeOf(A, B)) {
+      // C = A*A^T is symmetric: computes one triangle with ?syrk and
+      // mirrors it. In column-major terms, A is either A (trans='N') or
+      // A^T (trans='T') for a row-major A.
+      const char uplo = 'U';
+      const char trans = la.row_major ? 'T' : 'N';
+      T* c = C.data();
+      syrk(&uplo, &trans, &M, &N, &alpha, A.data(), &la.ld, &beta,
+        c, &lc.ld);
+      for (int j=0; j<M; ++j)
+        for (int i=0; i<j; ++i)
+          c[j + i*lc.ld] = c[i + j*lc.ld];
+      return;
+    }
+
+    if (lc.row_major) {
+      // C^T = B^T * A^T in column-major terms
+      const char transb = lb.row_major ? 'N' : 'T';
+      const char transa = la.row_major ? 'N' : 'T';
+      gemm(&transb, &transa, &P, &M, &N, &alpha, B.data(), &lb.ld,
+        A.data(), &la.ld, &beta, C.data(), &lc.ld);
+    }
+    else {
+      const char transa = la.row_major ? 'T' : 'N';
+      const char transb = lb.row_major ? 'T' : 'N';
+      gemm(&transa, &transb, &M, &P, &N, &alpha, A.data(), &la.ld,
+        B.data(), &lb.ld, &beta, C.data(), &lc.ld);
+    }
+  }
+
+  /**
+   * Computes C=A*B with BLAS if the arrays can be handed to BLAS, and with
+   * the generic blitz expression otherwise
+   */
+  template <typename T>
+  void blasProd(const blitz::Array<T,2>& A, const blitz::Array<T,2>& B,
+      blitz::Array<T,2>& C)
+  {
+    if (C.extent(0) == 0 || C.extent(1) == 0) return;
+    if (A.extent(1) == 0) {
+      C = 0.;
+      return;
+    }
+
+    BlasLayout la, lb, lc;
+    if (!blasLayout(A, la) || !blasLayout(B, lb)) {
+      // Strided views: falls back to the generic blitz expression
+      blitz::firstIndex i;
+      blitz::secondIndex j;
+      blitz::thirdIndex k;
+      C = blitz::sum(A(i,k) * B(k,j), k);
+      return;
+    }
+
+    if (blasLayout(C, lc)) blasProd(A, la, B, lb, C, lc);
+    else {
+      blitz::Array<T,2> C_(C.extent(0), C.extent(1));
+      blasLayout(C_, lc);
+      blasProd(A, la, B, lb, C_, lc);
+      C = C_;
+    }
+  }
+
+}
+
+void bob::math::prod_(const blitz::Array<double,2>& A,
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C)
+{
+  blasProd(A, B, C);
+}
+
+void bob::math::prod_(const blitz::Array<float,2>& A,
+  const blitz::Array<float,2>& B, blitz::Array<float,2>& C)
+{
+  blasProd(A, B, C);
+}
+
+void bob::math::prod_(const blitz::Array<double,2>& A,
+  const blitz::Array<double,1>& b, blitz::Array<double,1>& c)
+{
+  if (c.extent(0) == 0) return;
+  if (A.extent(1) == 0) {
+    c = 0.;
+    return;
+  }
+
+  BlasLayout la;
+  const int incx = blasIncrement(b);
+  const int incy = blasIncrement(c);
+  if (!blasLayout(A, la) || incx == 0 || incy == 0) {
+    blitz::firstIndex i;
+    blitz::secondIndex j;
+    c = blitz::sum(A(i,j) * b(j), j);
+    return;
+  }
+
+  const double alpha = 1.;
+  const double beta = 0.;
+  if (la.row_major) {
+    // A is seen as A^T (NxM) by BLAS
+    const char trans = 'T';
+    const int M = A.extent(1);
+    const int N = A.extent(0);
+    dgemv_(&trans, &M, &N, &alpha, A.data(), &la.ld, b.data(), &incx,
+      &beta, c.data(), &incy);
+  }
+  else {
+    const char trans = 'N';
+    const int M = A.extent(0);
+    const int N = A.extent(1);
+    dgemv_(&trans, &M, &N, &alpha, A.data(), &la.ld, b.data(), &incx,
+      &beta, c.data(), &incy);
+  }
+}
+
+void bob::math::prod_(const blitz::Array<double,1>& a,
+  const blitz::Array<double,2>& B, blitz::Array<double,1>& c)
+{
+  if (c.extent(0) == 0) return;
+  if (B.extent(0) == 0) {
+    c = 0.;
+    return;
+  }
+
+  BlasLayout lb;
+  const int incx = blasIncrement(a);
+  const int incy = blasIncrement(c);
+  if (!blasLayout(B, lb) || incx == 0 || incy == 0) {
+    blitz::firstIndex i;
+    blitz::secondIndex j;
+    c = blitz::sum(a(j) * B(j,i), j);
+    return;
+  }
+
+  // c = B^T * a
+  const double alpha = 1.;
+  const double beta = 0.;
+  if (lb.row_major) {
+    // B is seen as B^T (NxM) by BLAS
+    const char trans = 'N';
+    const int M = B.extent(1);
+    const int N = B.extent(0);
+    dgemv_(&trans, &M, &N, &alpha, B.data(), &lb.ld, a.data(), &incx,
+      &beta, c.data(), &incy);
+  }
+  else {
+    const char trans = 'T';
+    const int M = B.extent(0);
+    const int N = B.extent(1);
+    dgemv_(&trans, &M, &N, &alpha, B.data(), &lb.ld, a.data(), &incx,
+      &beta, c.data(), &incy);
+  }
+}
@@ -135,6 +135,93 @@ BOOST_AUTO_TEST_CASE( test_vector_vector_prod )
   checkBlitzClose( Asol_44, sol, eps);
 }
 
+BOOST_AUTO_TEST_CASE( test_matrix_matrix_prod_transposed )
+{
+  // A_24 * A_43 computed from transposed (Fortran-style) views
+  blitz::Array<double,2> A_42(4,2), A_34(3,4);
+  A_42 = A_24.transpose(1,0);
+  A_34 = A_43.transpose(1,0);
+  blitz::Array<double,2> sol(2,3);
+  bob::math::prod( A_42.transpose(1,0), A_34.transpose(1,0), sol);
+  checkBlitzClose( A_23, sol, eps);
+
+  // Transposed output
+  blitz::Array<double,2> sol_t(3,2);
+  blitz::Array<double,2> sol_tt = sol_t.transpose(1,0);
+  bob::math::prod( A_24, A_43, sol_tt);
+  checkBlitzClose( A_23, sol_tt, eps);
+}
+
+BOOST_AUTO_TEST_CASE( test_matrix_matrix_prod_strided )
+{
+  // Views with non-unit strides along both dimensions use the fallback
+  blitz::Array<double,2> A_48(4,8), A_86(8,6);
+  A_48 = 0.;
+  A_86 = 0.;
+  blitz::Array<double,2> A_24s = A_48(blitz::Range(0,3,2), blitz::Range(0,7,2));
+  blitz::Array<double,2> A_43s = A_86(blitz::Range(0,7,2), blitz::Range(0,5,2));
+  A_24s = A_24;
+  A_43s = A_43;
+  blitz::Array<double,2> sol(2,3);
+  bob::math::prod( A_24s, A_43s, sol);
+  checkBlitzClose( A_23, sol, eps);
+
+  // Sub-matrices with unit stride along the last dimension use BLAS
+  blitz::Array<double,2> A_sub = A_48(blitz::Range(1,2), blitz::Range(2,5));
+  A_sub = A_24;
+  bob::math::prod( A_sub, A_43, sol);
+  checkBlitzClose( A_23, sol, eps);
+}
+
+BOOST_AUTO_TEST_CASE( test_matrix_matrix_prod_symmetric )
+{
+  // A*A^T goes through dsyrk
+  blitz::Array<double,2> sol(2,2), ref(2,2);
+  bob::math::prod( A_24, A_24.transpose(1,0), sol);
+  ref = 30., 70., 70., 174.;
+  checkBlitzClose( ref, sol, eps);
+}
+
+BOOST_AUTO_TEST_CASE( test_matrix_matrix_prod_float )
+{
+  // Single precision products go through sgemm (resp. ssyrk)
+  blitz::Array<float,2> A_24f(2,4), A_43f(4,3), A_23f(2,3), sol(2,3);
+  A_24f = blitz::cast<float>(A_24);
+  A_43f = blitz::cast<float>(A_43);
+  A_23f = blitz::cast<float>(A_23);
+  bob::math::prod( A_24f, A_43f, sol);
+  checkBlitzClose( A_23f, sol, eps);
+
+  blitz::Array<float,2> A_34f(3,4);
+  A_34f = A_43f.transpose(1,0);
+  bob::math::prod( A_24f, A_34f.transpose(1,0), sol);
+  checkBlitzClose( A_23f, sol, eps);
+
+  blitz::Array<float,2> sol_s(2,2), ref(2,2);
+  bob::math::prod( A_24f, A_24f.transpose(1,0), sol_s);
+  ref = 30., 70., 70., 174.;
+  checkBlitzClose( ref, sol_s, eps);
+}
+
+BOOST_AUTO_TEST_CASE( test_matrix_vector_prod_strided )
+{
+  blitz::Array<double,1> b_8(8), sol_4(4);
+  b_8 = 0.;
+  blitz::Array<double,1> b_4s = b_8(blitz::Range(0,7,2));
+  b_4s = b_4;
+  blitz::Array<double,1> sol = sol_4(blitz::Range(0,3,2));
+  bob::math::prod( A_24, b_4s, sol);
+  checkBlitzClose( b_2, sol, eps);
+
+  blitz::Array<double,2> A_42(4,2);
+  A_42 = A_24.transpose(1,0);
+  bob::math::prod( A_42.transpose(1,0), b_4s, sol);
+  checkBlitzClose( b_2, sol, eps);
+
+  bob::math::prod( b_4s, A_42, sol);
+  checkBlitzClose( b_2, sol, eps);
+}
+
 BOOST_AUTO_TEST_CASE( test_vector_vector_dot )
 {
   double sol = bob::math::dot( b_5a, b_5b);
@@ -42,6 +42,50 @@ std::pair<double, double> bob::measure::farfrr(const blitz::Array<double,1>& neg
       false_rejects/(double)total_positives);
 }
 
+void bob::measure::sortScores(const blitz::Array<double,1>& scores,
+    std::vector<double>& sorted) {
+  sorted.resize(scores.extent(0));
+  std::copy(scores.begin(), scores.end(), sorted.begin());
+  std::sort(sorted.begin(), sorted.end());
+}
+
+/**
+ * Number of sorted scores strictly below the threshold
+ */
+static size_t countBelow(const std::vector<double>& sorted, double threshold) {
+  return std::lower_bound(sorted.begin(), sorted.end(), threshold) -
+    sorted.begin();
+}
+
+std::pair<double, double> bob::measure::sortedFarfrr(
+    const std::vector<double>& sorted_negatives,
+    const std::vector<double>& sorted_positives, double threshold) {
+  size_t total_negatives = sorted_negatives.size();
+  size_t total_positives = sorted_positives.size();
+  size_t false_accepts = total_negatives - countBelow(sorted_negatives, threshold);
+  size_t false_rejects = countBelow(sorted_positives, threshold);
+  if (!total_negatives) total_negatives = 1; //avoids division by zero
+  if (!total_positives) total_positives = 1; //avoids division by zero
+  return std::make_pair(false_accepts/(double)total_negatives,
+      false_rejects/(double)total_positives);
+}
+
+/**
+ * Same as bob::measure::precision_recall(), from sorted scores
+ */
+static std::pair<double, double> sorted_precision_recall(
+    const std::vector<double>& sorted_negatives,
+    const std::vector<double>& sorted_positives, double threshold) {
+  size_t total_positives = sorted_positives.size();
+  size_t false_positives = sorted_negatives.size() - countBelow(sorted_negatives, threshold);
+  size_t true_positives = total_positives - countBelow(sorted_positives, threshold);
+  size_t total_classified_positives = true_positives + false_positives;
+  if (!total_classified_positives) total_classified_positives = 1; //avoids division by zero
+  if (!total_positives) total_positives = 1; //avoids division by zero
+  return std::make_pair(true_positives/(double)(total_classified_positives),
+      true_positives/(double)(total_positives));
+}
+
 std::pair<double, double> bob::measure::precision_recall(const blitz::Array<double,1>& negatives,
     const blitz::Array<double,1>& positives, double threshold) {
   blitz::sizeType total_positives = positives.extent(blitz::firstDim);
@@ -94,9 +138,8 @@ double bob::measure::farThreshold(const blitz::Array<double,1>& negatives,
   }
 
   // sort negative scores ascendingly
-  std::vector<double> negatives_(negatives.shape()[0]);
-  std::copy(negatives.begin(), negatives.end(), negatives_.begin());
-  std::sort(negatives_.begin(), negatives_.end(), std::less<double>());
+  std::vector<double> negatives_;
+  bob::measure::sortScores(negatives, negatives_);
 
   // compute position of the threshold
   double crr = 1.-far_value; // (Correct Rejection Rate; = 1 - FAR)
@@ -134,9 +177,9 @@ double bob::measure::frrThreshold(const blitz::Array<double,1>&,
   }
 
   // sort positive scores descendingly
-  std::vector<double> positives_(positives.shape()[0]);
-  std::copy(positives.begin(), positives.end(), positives_.begin());
-  std::sort(positives_.begin(), positives_.end(), std::greater<double>());
+  std::vector<double> positives_;
+  bob::measure::sortScores(positives, positives_);
+  std::reverse(positives_.begin(), positives_.end());
 
   // compute position of the threshold
   double car = 1.-frr_value; // (Correct Acceptance Rate; = 1 - FRR)
@@ -193,10 +236,14 @@ blitz::Array<double,2> bob::measure::roc(const blitz::Array<double,1>& negatives
   double min = std::min(blitz::min(negatives), blitz::min(positives));
   double max = std::max(blitz::max(negatives), blitz::max(positives));
   double step = (max-min)/((double)points-1.0);
+  // sort the scores once: each point is then computed by bisection
+  std::vector<double> negatives_, positives_;
+  bob::measure::sortScores(negatives, negatives_);
+  bob::measure::sortScores(positives, positives_);
   blitz::Array<double,2> retval(2, points);
   for (int i=0; i<(int)points; ++i) {
     std::pair<double, double> ratios =
-      bob::measure::farfrr(negatives, positives, min + i*step);
+      bob::measure::sortedFarfrr(negatives_, positives_, min + i*step);
     //note: inversion to preserve X x Y ordering (FRR x FAR)
     retval(0,i) = ratios.second;
     retval(1,i) = ratios.first;
@@ -209,10 +256,14 @@ blitz::Array<double,2> bob::measure::precision_recall_curve(const blitz::Array<d
   double min = std::min(blitz::min(negatives), blitz::min(positives));
   double max = std::max(blitz::max(negatives), blitz::max(positives));
   double step = (max-min)/((double)points-1.0);
+  // sort the scores once: each point is then computed by bisection
+  std::vector<double> negatives_, positives_;
+  bob::measure::sortScores(negatives, negatives_);
+  bob::measure::sortScores(positives, positives_);
   blitz::Array<double,2> retval(2, points);
   for (int i=0; i<(int)points; ++i) {
     std::pair<double, double> ratios =
-      bob::measure::precision_recall(negatives, positives, min + i*step);
+      sorted_precision_recall(negatives_, positives_, min + i*step);
     retval(0,i) = ratios.first;
     retval(1,i) = ratios.second;
   }
@@ -289,6 +340,8 @@ blitz::Array<double,2> bob::measure::rocch(const blitz::Array<double,1>& negativ
   blitz::Array<double,2> retval(2,nbins+1); // FAR, FRR
 
   // Fill in output
+  // (miss counts the positives among the 'left' lowest scores, and fa the
+  // negatives among the others: both are updated bin by bin)
   size_t left = 0;
   size_t fa = Nn;
   size_t miss = 0;
@@ -296,15 +349,10 @@ blitz::Array<double,2> bob::measure::rocch(const blitz::Array<double,1>& negativ
   {
     retval(0,i) = miss / (double)Nt; // pmiss
     retval(1,i) = fa / (double)Nn; // pfa
+    for(size_t k=left; k<left+width(i); ++k)
+      miss += Pideal(k);
     left += width(i);
-    if(left >= 1)
-      miss = blitz::sum(Pideal(blitz::Range(0,left-1)));
-    else
-      miss = 0;
-    if(Pideal.extent(0)-1 >= (int)left)
-      fa = N - left - blitz::sum(Pideal(blitz::Range(left,Pideal.extent(0)-1)));
-    else
-      fa = 0;
+    fa = Nn - (left - miss);
   }
   retval(0,nbins) = miss / (double)Nt; // pmiss
   retval(1,nbins) = fa / (double)Nn; // pfa
@@ -372,13 +420,11 @@ blitz::Array<double,2> bob::measure::roc_for_far(const blitz::Array<double,1>& n
   int n_points = far_list.extent(0);
 
   // sort negative scores ascendingly
-  std::vector<double> negatives_(negatives.extent(0));;
-  std::copy(negatives.begin(), negatives.end(), negatives_.begin());
-  std::sort(negatives_.begin(), negatives_.end());
+  std::vector<double> negatives_;
+  bob::measure::sortScores(negatives, negatives_);
   // sort positive scores ascendingly
-  std::vector<double> positives_(positives.extent(0));;
-  std::copy(positives.begin(), positives.end(), positives_.begin());
-  std::sort(positives_.begin(), positives_.end());
+  std::vector<double> positives_;
+  bob::measure::sortScores(positives, positives_);
 
   // do some magic to compute the FRR list
   blitz::Array<double,2> retval(2, n_points);
@@ -519,15 +565,24 @@ blitz::Array<double,2> bob::measure::epc
  const blitz::Array<double,1>& dev_positives,
  const blitz::Array<double,1>& test_negatives,
  const blitz::Array<double,1>& test_positives, size_t points) {
+  // sort the scores once, for all the points
+  std::vector<double> dev_negatives_, dev_positives_;
+  std::vector<double> test_negatives_, test_positives_;
+  bob::measure::sortScores(dev_negatives, dev_negatives_);
+  bob::measure::sortScores(dev_positives, dev_positives_);
+  bob::measure::sortScores(test_negatives, test_negatives_);
+  bob::measure::sortScores(test_positives, test_positives_);
+
   double step = 1.0/((double)points-1.0);
   blitz::Array<double,2> retval(2, points);
   for (int i=0; i<(int)points; ++i) {
     double alpha = (double)i*step;
     retval(0,i) = alpha;
-    double threshold = bob::measure::minWeightedErrorRateThreshold(dev_negatives,
-        dev_positives, alpha);
+    weighted_error predicate(alpha);
+    double threshold = bob::measure::sortedMinimizingThreshold(dev_negatives_,
+        dev_positives_, predicate);
     std::pair<double, double> ratios =
-      bob::measure::farfrr(test_negatives, test_positives, threshold);
+      bob::measure::sortedFarfrr(test_negatives_, test_positives_, threshold);
     retval(1,i) = (ratios.first + ratios.second) / 2;
   }
   return retval;
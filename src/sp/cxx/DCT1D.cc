@@ -23,6 +23,7 @@
 
 #include <bob/sp/DCT1D.h>
 #include <bob/core/assert.h>
+#include <bob/sp/fftw.h>
 #include <fftw3.h>
 
 bob::sp::DCT1DAbstract::DCT1DAbstract(const size_t length):
@@ -121,16 +122,11 @@ void bob::sp::DCT1D::operator()(const blitz::Array<double,1>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  double* src_ = const_cast<double*>(src.data());
-  double* dst_ = dst.data();
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_1d(src.extent(0), src_, dst_, FFTW_REDFT10, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Executes the transform with a cached plan
+  const int n = src.extent(0);
+  const int kind = FFTW_REDFT10;
+  bob::sp::detail::fftwR2R(1, &n, 1, const_cast<double*>(src.data()),
+    dst.data(), &kind);
 
   // Normalize
   dst(0) *= m_sqrt_1byl/2.;
@@ -180,14 +176,9 @@ void bob::sp::IDCT1D::operator()(const blitz::Array<double,1>& src,
     dst(r_dst) /= m_sqrt_2l;
   }
 
-  // Reinterpret cast to fftw format
-  double* dst_ = dst.data();
- 
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_1d(src.extent(0), dst_, dst_, FFTW_REDFT01, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Executes the in-place transform with a cached plan
+  const int n = src.extent(0);
+  const int kind = FFTW_REDFT01;
+  bob::sp::detail::fftwR2R(1, &n, 1, dst.data(), dst.data(), &kind);
 }
 
@@ -23,6 +23,7 @@
 
 #include <bob/sp/DCT2D.h>
 #include <bob/core/assert.h>
+#include <bob/sp/fftw.h>
 #include <fftw3.h>
 
 
@@ -130,16 +131,11 @@ void bob::sp::DCT2D::operator()(const blitz::Array<double,2>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  double* src_ = const_cast<double*>(src.data());
-  double* dst_ = dst.data();
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_REDFT10, FFTW_REDFT10, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Executes the transform with a cached plan
+  const int n[2] = {src.extent(0), src.extent(1)};
+  const int kinds[2] = {FFTW_REDFT10, FFTW_REDFT10};
+  bob::sp::detail::fftwR2R(2, n, 1, const_cast<double*>(src.data()),
+    dst.data(), kinds);
 
   // Rescale the result
   for (int i=0; i<(int)m_height; ++i)
@@ -185,15 +181,10 @@ void bob::sp::IDCT2D::operator()(const blitz::Array<double,2>& src,
       dst(i,j) = src(i,j)*4/(i==0?m_sqrt_1h:m_sqrt_2h)/(j==0?m_sqrt_1w:m_sqrt_2w);
   }
 
-  // Reinterpret cast to fftw format
-  double* dst_ = dst.data();
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_2d(src.extent(0), src.extent(1), dst_, dst_, FFTW_REDFT01, FFTW_REDFT01, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Executes the in-place transform with a cached plan
+  const int n[2] = {src.extent(0), src.extent(1)};
+  const int kinds[2] = {FFTW_REDFT01, FFTW_REDFT01};
+  bob::sp::detail::fftwR2R(2, n, 1, dst.data(), dst.data(), kinds);
   
   // Rescale the result by the size of the input 
   // (as this is not performed by FFW)
@@ -23,6 +23,7 @@
 
 #include <bob/sp/FFT1D.h>
 #include <bob/core/assert.h>
+#include <bob/sp/fftw.h>
 #include <fftw3.h>
 
 
@@ -100,16 +101,10 @@ void bob::sp::FFT1D::operator()(const blitz::Array<std::complex<double>,1>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape(dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_1d(src.extent(0), src_, dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Executes the transform with a cached plan
+  const int n = src.extent(0);
+  bob::sp::detail::fftwDFT(1, &n, 1,
+    const_cast<std::complex<double>*>(src.data()), dst.data(), FFTW_FORWARD);
 }
 
 
@@ -142,16 +137,10 @@ void bob::sp::IFFT1D::operator()(const blitz::Array<std::complex<double>,1>& src
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape(dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_1d(src.extent(0), src_, dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p); /* repeat as needed */
-  fftw_destroy_plan(p);
+  // Executes the transform with a cached plan
+  const int n = src.extent(0);
+  bob::sp::detail::fftwDFT(1, &n, 1,
+    const_cast<std::complex<double>*>(src.data()), dst.data(), FFTW_BACKWARD);
 
   // Rescale as FFTW is not doing it
   dst /= static_cast<double>(m_length);
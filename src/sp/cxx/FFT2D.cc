@@ -23,6 +23,7 @@
 
 #include <bob/sp/FFT2D.h>
 #include <bob/core/assert.h>
+#include <bob/sp/fftw.h>
 #include <fftw3.h>
 
 bob::sp::FFT2DAbstract::FFT2DAbstract(const size_t height, const size_t width):
@@ -94,16 +95,10 @@ void bob::sp::FFT2D::operator()(const blitz::Array<std::complex<double>,2>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Executes the transform with a cached plan
+  const int n[2] = {src.extent(0), src.extent(1)};
+  bob::sp::detail::fftwDFT(2, n, 1,
+    const_cast<std::complex<double>*>(src.data()), dst.data(), FFTW_FORWARD);
 }
 
 
@@ -112,15 +107,9 @@ void bob::sp::FFT2D::operator()(blitz::Array<std::complex<double>,2>& src_dst) c
   // check data
   bob::core::array::assertCZeroBaseContiguous(src_dst);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_dst_ = reinterpret_cast<fftw_complex*>(src_dst.data());
-
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized
-  // for large arrays
-  p = fftw_plan_dft_2d(src_dst.extent(0), src_dst.extent(1), src_dst_, src_dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Executes the in-place transform with a cached plan
+  const int n[2] = {src_dst.extent(0), src_dst.extent(1)};
+  bob::sp::detail::fftwDFT(2, n, 1, src_dst.data(), src_dst.data(), FFTW_FORWARD);
 }
 
 
@@ -153,16 +142,10 @@ void bob::sp::IFFT2D::operator()(const blitz::Array<std::complex<double>,2>& src
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Executes the transform with a cached plan
+  const int n[2] = {src.extent(0), src.extent(1)};
+  bob::sp::detail::fftwDFT(2, n, 1,
+    const_cast<std::complex<double>*>(src.data()), dst.data(), FFTW_BACKWARD);
 
   // Rescale the result by the size of the input 
   // (as this is not performed by FFTW)
@@ -174,15 +157,9 @@ void bob::sp::IFFT2D::operator()(blitz::Array<std::complex<double>,2>& src_dst)
   // check data
   bob::core::array::assertCZeroBaseContiguous(src_dst);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_dst_ = reinterpret_cast<fftw_complex*>(src_dst.data());
-
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized
-  // for large arrays
-  p = fftw_plan_dft_2d(src_dst.extent(0), src_dst.extent(1), src_dst_, src_dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Executes the in-place transform with a cached plan
+  const int n[2] = {src_dst.extent(0), src_dst.extent(1)};
+  bob::sp::detail::fftwDFT(2, n, 1, src_dst.data(), src_dst.data(), FFTW_BACKWARD);
 
   // Rescale the result by the size of the input
   // (as this is not performed by FFTW)
@@ -0,0 +1,209 @@
+/**
+ * @file sp/cxx/batch.cc
+ * @date Fri Oct 16 14:21:05 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Batched FFT/DCT transforms based on the FFTW advanced interface
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/sp/batch.h>
+#include <bob/sp/fftw.h>
+#include <bob/core/assert.h>
+#include <bob/core/array_copy.h>
+#include <bob/core/parallel.h>
+#include <fftw3.h>
+
+namespace {
+
+  /**
+   * The functors below are called by bob::core::parallelChunks() for each
+   * chunk of contiguous transforms. FFTW plans are thread-safe to execute,
+   * and the cache serializes their creation.
+   */
+  struct DFTChunk {
+    DFTChunk(const int n, const int sign, std::complex<double>* src,
+        std::complex<double>* dst):
+      m_n(n), m_sign(sign), m_src(src), m_dst(dst) {}
+    void operator()(const int, const int start, const int count) const {
+      bob::sp::detail::fftwDFT(1, &m_n, count, m_src + start*m_n,
+          m_dst + start*m_n, m_sign);
+    }
+    int m_n;
+    int m_sign;
+    std::complex<double>* m_src;
+    std::complex<double>* m_dst;
+  };
+
+  struct R2CChunk {
+    R2CChunk(const int n, double* src, std::complex<double>* dst):
+      m_n(n), m_src(src), m_dst(dst) {}
+    void operator()(const int, const int start, const int count) const {
+      bob::sp::detail::fftwR2C(1, &m_n, count, m_src + start*m_n,
+          m_dst + start*(m_n/2+1));
+    }
+    int m_n;
+    double* m_src;
+    std::complex<double>* m_dst;
+  };
+
+  struct C2RChunk {
+    C2RChunk(const int n, std::complex<double>* src, double* dst):
+      m_n(n), m_src(src), m_dst(dst) {}
+    void operator()(const int, const int start, const int count) const {
+      bob::sp::detail::fftwC2R(1, &m_n, count, m_src + start*(m_n/2+1),
+          m_dst + start*m_n);
+      // Rescale as FFTW is not doing it
+      double* dst = m_dst + start*m_n;
+      const double factor = 1. / m_n;
+      for (int i=0; i<count*m_n; ++i) dst[i] *= factor;
+    }
+    int m_n;
+    std::complex<double>* m_src;
+    double* m_dst;
+  };
+
+  /**
+   * DCT-II (resp. DCT-III) of 2D blocks, with the normalization of DCT2D
+   * (resp. IDCT2D) applied as an elementwise scaling of each block
+   */
+  struct DCTChunk {
+    DCTChunk(const int h, const int w, const bool inverse,
+        const blitz::Array<double,2>& scale, double* src, double* dst):
+      m_inverse(inverse), m_scale(scale.data()), m_src(src), m_dst(dst) {
+      m_n[0] = h;
+      m_n[1] = w;
+    }
+    void operator()(const int, const int start, const int count) const {
+      const int size = m_n[0]*m_n[1];
+      double* src = m_src + start*size;
+      double* dst = m_dst + start*size;
+      if (!m_inverse) {
+        const int kinds[2] = {FFTW_REDFT10, FFTW_REDFT10};
+        bob::sp::detail::fftwR2R(2, m_n, count, src, dst, kinds);
+        for (int b=0; b<count; ++b)
+          for (int k=0; k<size; ++k) dst[b*size+k] *= m_scale[k];
+      }
+      else {
+        for (int b=0; b<count; ++b)
+          for (int k=0; k<size; ++k) dst[b*size+k] = src[b*size+k] * m_scale[k];
+        const int kinds[2] = {FFTW_REDFT01, FFTW_REDFT01};
+        bob::sp::detail::fftwR2R(2, m_n, count, dst, dst, kinds);
+      }
+    }
+    int m_n[2];
+    bool m_inverse;
+    const double* m_scale;
+    double* m_src;
+    double* m_dst;
+  };
+
+  /**
+   * Elementwise scaling factors of the 2D DCT normalization (see DCT2D and
+   * IDCT2D)
+   */
+  blitz::Array<double,2> dct_scale(const int h, const int w,
+      const bool inverse) {
+    blitz::Array<double,2> scale(h, w);
+    const double sqrt_1h = sqrt(1./h), sqrt_2h = sqrt(2./h);
+    const double sqrt_1w = sqrt(1./w), sqrt_2w = sqrt(2./w);
+    for (int i=0; i<h; ++i)
+      for (int j=0; j<w; ++j) {
+        const double f = (i==0?sqrt_1h:sqrt_2h) * (j==0?sqrt_1w:sqrt_2w);
+        // The output of the unnormalized DCT-III is rescaled by 4*h*w
+        scale(i,j) = inverse ? 1./(f*h*w) : f/4.;
+      }
+    return scale;
+  }
+
+}
+
+void bob::sp::fft1DBatch(const blitz::Array<std::complex<double>,2>& src,
+  blitz::Array<std::complex<double>,2>& dst, const size_t n_threads)
+{
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape(dst, src);
+
+  bob::core::parallelChunks(src.extent(0), n_threads, DFTChunk(src.extent(1), FFTW_FORWARD,
+    const_cast<std::complex<double>*>(src.data()), dst.data()));
+}
+
+void bob::sp::ifft1DBatch(const blitz::Array<std::complex<double>,2>& src,
+  blitz::Array<std::complex<double>,2>& dst, const size_t n_threads)
+{
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape(dst, src);
+
+  bob::core::parallelChunks(src.extent(0), n_threads, DFTChunk(src.extent(1), FFTW_BACKWARD,
+    const_cast<std::complex<double>*>(src.data()), dst.data()));
+
+  // Rescale as FFTW is not doing it
+  dst /= static_cast<double>(src.extent(1));
+}
+
+void bob::sp::rfft1DBatch(const blitz::Array<double,2>& src,
+  blitz::Array<std::complex<double>,2>& dst, const size_t n_threads)
+{
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameDimensionLength(dst.extent(0), src.extent(0));
+  bob::core::array::assertSameDimensionLength(dst.extent(1), src.extent(1)/2+1);
+
+  bob::core::parallelChunks(src.extent(0), n_threads, R2CChunk(src.extent(1),
+    const_cast<double*>(src.data()), dst.data()));
+}
+
+void bob::sp::irfft1DBatch(const blitz::Array<std::complex<double>,2>& src,
+  blitz::Array<double,2>& dst, const size_t n_threads)
+{
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameDimensionLength(dst.extent(0), src.extent(0));
+  bob::core::array::assertSameDimensionLength(src.extent(1), dst.extent(1)/2+1);
+
+  // Complex-to-real transforms overwrite their input
+  blitz::Array<std::complex<double>,2> src_ = bob::core::array::ccopy(src);
+  bob::core::parallelChunks(dst.extent(0), n_threads, C2RChunk(dst.extent(1), src_.data(),
+    dst.data()));
+}
+
+void bob::sp::dct2DBatch(const blitz::Array<double,3>& src,
+  blitz::Array<double,3>& dst, const size_t n_threads)
+{
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape(dst, src);
+
+  const blitz::Array<double,2> scale = dct_scale(src.extent(1),
+    src.extent(2), false);
+  bob::core::parallelChunks(src.extent(0), n_threads, DCTChunk(src.extent(1), src.extent(2),
+    false, scale, const_cast<double*>(src.data()), dst.data()));
+}
+
+void bob::sp::idct2DBatch(const blitz::Array<double,3>& src,
+  blitz::Array<double,3>& dst, const size_t n_threads)
+{
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape(dst, src);
+
+  const blitz::Array<double,2> scale = dct_scale(src.extent(1),
+    src.extent(2), true);
+  bob::core::parallelChunks(src.extent(0), n_threads, DCTChunk(src.extent(1), src.extent(2),
+    true, scale, const_cast<double*>(src.data()), dst.data()));
+}
@@ -0,0 +1,389 @@
+/**
+ * @file sp/cxx/fftw.cc
+ * @date Fri Oct 16 11:02:17 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Process-wide cache of FFTW plans
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/sp/fftw.h>
+#include <map>
+#include <vector>
+#include <cstdio>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <fftw3.h>
+
+namespace {
+
+  /**
+   * The FFTW planner (and wisdom) is not thread-safe, whereas executing a
+   * plan on new arrays (fftw_execute_dft(), fftw_execute_r2r()) is. All
+   * calls to the planner are therefore serialized by this mutex.
+   */
+  boost::mutex& planner_mutex() {
+    static boost::mutex s_mutex;
+    return s_mutex;
+  }
+
+  /**
+   * A cached plan. Destruction goes through the planner, hence the lock.
+   */
+  class Plan {
+    public:
+      Plan(fftw_plan plan, boost::mutex& mutex): m_plan(plan), m_mutex(mutex) {}
+      ~Plan() {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        fftw_destroy_plan(m_plan);
+      }
+      fftw_plan get() const { return m_plan; }
+
+    private:
+      Plan(const Plan&);
+      Plan& operator=(const Plan&);
+      fftw_plan m_plan;
+      boost::mutex& m_mutex;
+  };
+
+  typedef std::vector<int> PlanKey;
+  typedef std::map<PlanKey, boost::shared_ptr<Plan> > PlanMap;
+
+  struct PlanCache {
+    PlanCache(): mode(bob::sp::FFTW_PLAN_ESTIMATE) {}
+    bob::sp::FFTWPlanningMode mode;
+    PlanMap plans;
+  };
+
+  PlanCache& cache() {
+    // Makes sure the mutex outlives the cache (and its plans)
+    planner_mutex();
+    static PlanCache s_cache;
+    return s_cache;
+  }
+
+  enum { DFT = 0, R2R, R2C, C2R };
+
+  unsigned planner_flags(const bob::sp::FFTWPlanningMode mode) {
+    switch (mode) {
+      case bob::sp::FFTW_PLAN_MEASURE: return FFTW_MEASURE;
+      case bob::sp::FFTW_PLAN_PATIENT: return FFTW_PATIENT;
+      case bob::sp::FFTW_PLAN_EXHAUSTIVE: return FFTW_EXHAUSTIVE;
+      default: return FFTW_ESTIMATE;
+    }
+  }
+
+  /**
+   * A plan may only be executed on arrays with the same SIMD alignment (as
+   * given by fftw_alignment_of()) as the arrays it was planned on. Plans
+   * are made on fftw_malloc() scratch buffers: those for arrays aligned
+   * differently are created with FFTW_UNALIGNED. The alignments of the
+   * input and output are part of the key of the plans.
+   */
+  int alignment_of(const void* p) {
+    return fftw_alignment_of(static_cast<double*>(const_cast<void*>(p)));
+  }
+
+  int total_size(const int rank, const int* n) {
+    int size = 1;
+    for (int i=0; i<rank; ++i) size *= n[i];
+    return size;
+  }
+
+  /**
+   * Builds the key of a plan: type, planner flags, in-place, alignments of
+   * the input and output, number of transforms, rank, shape and sign/kinds
+   */
+  PlanKey make_key(const int type, const unsigned flags, const bool inplace,
+      const int in_align, const int out_align, const int howmany,
+      const int rank, const int* n, const int nparams, const int* params) {
+    PlanKey key;
+    key.reserve(7 + rank + nparams);
+    key.push_back(type);
+    key.push_back(static_cast<int>(flags));
+    key.push_back(inplace);
+    key.push_back(in_align);
+    key.push_back(out_align);
+    key.push_back(howmany);
+    key.push_back(rank);
+    key.insert(key.end(), n, n+rank);
+    key.insert(key.end(), params, params+nparams);
+    return key;
+  }
+
+  /**
+   * Looks up a plan in the cache, or creates it using the given functor.
+   * The planner runs on scratch buffers so that FFTW_MEASURE and above do
+   * not overwrite the caller's data.
+   */
+  template <typename TIn, typename TOut, typename Planner>
+  boost::shared_ptr<Plan> get_plan(const int type, const void* in_array,
+      const void* out_array, const int howmany, const int rank, const int* n,
+      const int nparams, const int* params, const size_t in_size,
+      const size_t out_size, Planner planner) {
+    const bool inplace = (in_array == out_array);
+    const int in_align = alignment_of(in_array);
+    const int out_align = alignment_of(out_array);
+    boost::lock_guard<boost::mutex> lock(planner_mutex());
+    PlanCache& c = cache();
+    unsigned flags = planner_flags(c.mode);
+    PlanKey key = make_key(type, flags, inplace, in_align, out_align,
+        howmany, rank, n, nparams, params);
+    PlanMap::iterator it = c.plans.find(key);
+    if (it != c.plans.end()) return it->second;
+
+    void* in = fftw_malloc(sizeof(TIn)*(in_size > 0 ? in_size : 1));
+    void* out = inplace ? in :
+      fftw_malloc(sizeof(TOut)*(out_size > 0 ? out_size : 1));
+    if (in_align != alignment_of(in) || out_align != alignment_of(out))
+      flags |= FFTW_UNALIGNED;
+    fftw_plan p = planner(static_cast<TIn*>(in), static_cast<TOut*>(out),
+        flags);
+    if (!inplace) fftw_free(out);
+    fftw_free(in);
+    if (!p) {
+      boost::format m("FFTW could not create a plan for a transform of rank %d");
+      m % rank;
+      throw std::runtime_error(m.str());
+    }
+    boost::shared_ptr<Plan> plan(new Plan(p, planner_mutex()));
+    c.plans[key] = plan;
+    return plan;
+  }
+
+  /**
+   * Largest number of transforms executed by a single plan. Batches are
+   * split into power-of-two sub-batches (of at most MAX_BATCH transforms),
+   * so that at most log2(MAX_BATCH)+1 plans are created per transform
+   * shape and alignment, whatever the numbers of transforms requested.
+   */
+  const int MAX_BATCH = 64;
+
+  /**
+   * Number of transforms of the next sub-batch, when remaining transforms
+   * are still to be executed
+   */
+  int batch_size(const int remaining) {
+    if (remaining >= MAX_BATCH) return MAX_BATCH;
+    int b = 1;
+    while (2*b <= remaining) b *= 2;
+    return b;
+  }
+
+  /**
+   * Number of complex elements of the half-spectrum of a real transform
+   */
+  int half_size(const int rank, const int* n) {
+    return total_size(rank-1, n) * (n[rank-1]/2 + 1);
+  }
+
+  /**
+   * The planners below create plans for howmany contiguous transforms
+   */
+  struct DFTPlanner {
+    DFTPlanner(const int howmany, const int rank, const int* n,
+        const int sign):
+      m_howmany(howmany), m_rank(rank), m_n(n), m_sign(sign),
+      m_dist(total_size(rank, n)) {}
+    fftw_plan operator()(fftw_complex* in, fftw_complex* out,
+        unsigned flags) const {
+      return fftw_plan_many_dft(m_rank, m_n, m_howmany, in, 0, 1, m_dist,
+          out, 0, 1, m_dist, m_sign, flags);
+    }
+    int m_howmany;
+    int m_rank;
+    const int* m_n;
+    int m_sign;
+    int m_dist;
+  };
+
+  struct R2RPlanner {
+    R2RPlanner(const int howmany, const int rank, const int* n,
+        const int* kinds):
+      m_howmany(howmany), m_rank(rank), m_n(n), m_kinds(rank),
+      m_dist(total_size(rank, n)) {
+      for (int i=0; i<rank; ++i)
+        m_kinds[i] = static_cast<fftw_r2r_kind>(kinds[i]);
+    }
+    fftw_plan operator()(double* in, double* out, unsigned flags) const {
+      return fftw_plan_many_r2r(m_rank, m_n, m_howmany, in, 0, 1, m_dist,
+          out, 0, 1, m_dist, &m_kinds[0], flags);
+    }
+    int m_howmany;
+    int m_rank;
+    const int* m_n;
+    std::vector<fftw_r2r_kind> m_kinds;
+    int m_dist;
+  };
+
+  struct R2CPlanner {
+    R2CPlanner(const int howmany, const int rank, const int* n):
+      m_howmany(howmany), m_rank(rank), m_n(n) {}
+    fftw_plan operator()(double* in, fftw_complex* out,
+        unsigned flags) const {
+      return fftw_plan_many_dft_r2c(m_rank, m_n, m_howmany,
+          in, 0, 1, total_size(m_rank, m_n),
+          out, 0, 1, half_size(m_rank, m_n), flags);
+    }
+    int m_howmany;
+    int m_rank;
+    const int* m_n;
+  };
+
+  struct C2RPlanner {
+    C2RPlanner(const int howmany, const int rank, const int* n):
+      m_howmany(howmany), m_rank(rank), m_n(n) {}
+    fftw_plan operator()(fftw_complex* in, double* out,
+        unsigned flags) const {
+      return fftw_plan_many_dft_c2r(m_rank, m_n, m_howmany,
+          in, 0, 1, half_size(m_rank, m_n),
+          out, 0, 1, total_size(m_rank, m_n), flags);
+    }
+    int m_howmany;
+    int m_rank;
+    const int* m_n;
+  };
+
+}
+
+void bob::sp::setFFTWPlanningMode(const bob::sp::FFTWPlanningMode mode)
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  cache().mode = mode;
+}
+
+bob::sp::FFTWPlanningMode bob::sp::getFFTWPlanningMode()
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  return cache().mode;
+}
+
+bool bob::sp::loadFFTWWisdom(const std::string& filename)
+{
+  FILE* f = std::fopen(filename.c_str(), "r");
+  if (!f) return false;
+  int ok;
+  {
+    boost::lock_guard<boost::mutex> lock(planner_mutex());
+    ok = fftw_import_wisdom_from_file(f);
+  }
+  std::fclose(f);
+  return ok != 0;
+}
+
+void bob::sp::saveFFTWWisdom(const std::string& filename)
+{
+  FILE* f = std::fopen(filename.c_str(), "w");
+  if (!f) {
+    boost::format m("cannot open file '%s' to save the FFTW wisdom");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+  {
+    boost::lock_guard<boost::mutex> lock(planner_mutex());
+    fftw_export_wisdom_to_file(f);
+  }
+  std::fclose(f);
+}
+
+void bob::sp::clearFFTWPlanCache()
+{
+  PlanMap plans;
+  {
+    boost::lock_guard<boost::mutex> lock(planner_mutex());
+    plans.swap(cache().plans);
+  }
+  // plans are destroyed here, outside of the lock
+}
+
+size_t bob::sp::getFFTWPlanCacheSize()
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  return cache().plans.size();
+}
+
+void bob::sp::detail::fftwDFT(const int rank, const int* n,
+  const int howmany, std::complex<double>* in, std::complex<double>* out,
+  const int sign)
+{
+  const int dist = total_size(rank, n);
+  for (int done=0; done<howmany; ) {
+    const int b = batch_size(howmany - done);
+    std::complex<double>* in_b = in + done*dist;
+    std::complex<double>* out_b = out + done*dist;
+    boost::shared_ptr<Plan> plan = get_plan<fftw_complex,fftw_complex>(DFT,
+        in_b, out_b, b, rank, n, 1, &sign, b*dist, b*dist,
+        DFTPlanner(b, rank, n, sign));
+    fftw_execute_dft(plan->get(), reinterpret_cast<fftw_complex*>(in_b),
+        reinterpret_cast<fftw_complex*>(out_b));
+    done += b;
+  }
+}
+
+void bob::sp::detail::fftwR2R(const int rank, const int* n,
+  const int howmany, double* in, double* out, const int* kinds)
+{
+  const int dist = total_size(rank, n);
+  for (int done=0; done<howmany; ) {
+    const int b = batch_size(howmany - done);
+    double* in_b = in + done*dist;
+    double* out_b = out + done*dist;
+    boost::shared_ptr<Plan> plan = get_plan<double,double>(R2R, in_b, out_b,
+        b, rank, n, rank, kinds, b*dist, b*dist,
+        R2RPlanner(b, rank, n, kinds));
+    fftw_execute_r2r(plan->get(), in_b, out_b);
+    done += b;
+  }
+}
+
+void bob::sp::detail::fftwR2C(const int rank, const int* n,
+  const int howmany, double* in, std::complex<double>* out)
+{
+  const int in_dist = total_size(rank, n);
+  const int out_dist = half_size(rank, n);
+  for (int done=0; done<howmany; ) {
+    const int b = batch_size(howmany - done);
+    double* in_b = in + done*in_dist;
+    std::complex<double>* out_b = out + done*out_dist;
+    boost::shared_ptr<Plan> plan = get_plan<double,fftw_complex>(R2C, in_b,
+        out_b, b, rank, n, 0, 0, b*in_dist, b*out_dist,
+        R2CPlanner(b, rank, n));
+    fftw_execute_dft_r2c(plan->get(), in_b,
+        reinterpret_cast<fftw_complex*>(out_b));
+    done += b;
+  }
+}
+
+void bob::sp::detail::fftwC2R(const int rank, const int* n,
+  const int howmany, std::complex<double>* in, double* out)
+{
+  const int in_dist = half_size(rank, n);
+  const int out_dist = total_size(rank, n);
+  for (int done=0; done<howmany; ) {
+    const int b = batch_size(howmany - done);
+    std::complex<double>* in_b = in + done*in_dist;
+    double* out_b = out + done*out_dist;
+    boost::shared_ptr<Plan> plan = get_plan<fftw_complex,double>(C2R, in_b,
+        out_b, b, rank, n, 0, 0, b*in_dist, b*out_dist,
+        C2RPlanner(b, rank, n));
+    fftw_execute_dft_c2r(plan->get(), reinterpret_cast<fftw_complex*>(in_b),
+        out_b);
+    done += b;
+  }
+}
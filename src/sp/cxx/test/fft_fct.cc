@@ -36,6 +36,8 @@
 #include <bob/sp/DCT1DNaive.h>
 #include <bob/sp/DCT2D.h>
 #include <bob/sp/DCT2DNaive.h>
+#include <bob/sp/fftw.h>
+#include <bob/sp/batch.h>
 // Random number
 #include <cstdlib>
 
@@ -392,6 +394,120 @@ BOOST_AUTO_TEST_CASE( test_fft2D_range1x1to64x64_random )
   }
 }
 
+BOOST_AUTO_TEST_CASE( test_fftw_plan_cache )
+{
+  bob::sp::clearFFTWPlanCache();
+  BOOST_CHECK_EQUAL( bob::sp::getFFTWPlanCacheSize(), (size_t)0 );
+
+  // Repeated transforms of the same size reuse the same plan
+  blitz::Array<std::complex<double>,1> t(64);
+  for (int i=0; i<64; ++i)
+    t(i) = std::complex<double>((rand()/(double)RAND_MAX)*10.,0);
+  test_fft1D( t, eps);
+  const size_t n_plans = bob::sp::getFFTWPlanCacheSize();
+  BOOST_CHECK( n_plans > 0 );
+  test_fft1D( t, eps);
+  BOOST_CHECK_EQUAL( bob::sp::getFFTWPlanCacheSize(), n_plans );
+
+  // Measured plans do not alter the input and give the same results
+  bob::sp::setFFTWPlanningMode(bob::sp::FFTW_PLAN_MEASURE);
+  BOOST_CHECK_EQUAL( bob::sp::getFFTWPlanningMode(), bob::sp::FFTW_PLAN_MEASURE );
+  blitz::Array<std::complex<double>,1> t_copy(t.copy());
+  test_fft1D( t, eps);
+  for (int i=0; i<64; ++i)
+    BOOST_CHECK_EQUAL( t(i), t_copy(i) );
+  BOOST_CHECK( bob::sp::getFFTWPlanCacheSize() > n_plans );
+  bob::sp::setFFTWPlanningMode(bob::sp::FFTW_PLAN_ESTIMATE);
+
+  bob::sp::clearFFTWPlanCache();
+  BOOST_CHECK_EQUAL( bob::sp::getFFTWPlanCacheSize(), (size_t)0 );
+}
+
+BOOST_AUTO_TEST_CASE( test_fft1D_batch )
+{
+  // Batched transforms of random frames, compared to the per-frame ones
+  const int n_frames = 37;
+  const int N = 64;
+  blitz::Array<double,2> t(n_frames, N);
+  blitz::Array<std::complex<double>,2> tc(n_frames, N);
+  for (int i=0; i<n_frames; ++i)
+    for (int j=0; j<N; ++j) {
+      t(i,j) = (rand()/(double)RAND_MAX)*10.;
+      tc(i,j) = std::complex<double>(t(i,j), (rand()/(double)RAND_MAX)*10.);
+    }
+
+  bob::sp::FFT1D fft(N);
+  blitz::Array<std::complex<double>,1> ref(N);
+  for (size_t n_threads=1; n_threads<=4; n_threads+=3) {
+    blitz::Array<std::complex<double>,2> tc_fft(n_frames, N), tc_ifft(n_frames, N);
+    bob::sp::fft1DBatch(tc, tc_fft, n_threads);
+    bob::sp::ifft1DBatch(tc_fft, tc_ifft, n_threads);
+    blitz::Array<std::complex<double>,2> t_rfft(n_frames, N/2+1);
+    blitz::Array<double,2> t_irfft(n_frames, N);
+    bob::sp::rfft1DBatch(t, t_rfft, n_threads);
+    bob::sp::irfft1DBatch(t_rfft, t_irfft, n_threads);
+
+    for (int i=0; i<n_frames; ++i) {
+      fft(tc(i,blitz::Range::all()).copy(), ref);
+      for (int j=0; j<N; ++j) {
+        BOOST_CHECK_SMALL( abs(tc_fft(i,j)-ref(j)), eps);
+        BOOST_CHECK_SMALL( abs(tc_ifft(i,j)-tc(i,j)), eps);
+        BOOST_CHECK_SMALL( fabs(t_irfft(i,j)-t(i,j)), eps);
+      }
+      blitz::Array<std::complex<double>,1> tr(N);
+      for (int j=0; j<N; ++j) tr(j) = t(i,j);
+      fft(tr, ref);
+      for (int j=0; j<N/2+1; ++j)
+        BOOST_CHECK_SMALL( abs(t_rfft(i,j)-ref(j)), eps);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_fft1D_batch_plans )
+{
+  // The number of cached plans does not grow with the number of frames
+  bob::sp::clearFFTWPlanCache();
+  const int N = 64;
+  for (int n_frames=1; n_frames<=150; ++n_frames) {
+    blitz::Array<double,2> t(n_frames, N);
+    t = 1.;
+    blitz::Array<std::complex<double>,2> t_rfft(n_frames, N/2+1);
+    bob::sp::rfft1DBatch(t, t_rfft);
+    BOOST_CHECK_SMALL( abs(t_rfft(n_frames-1,0)-std::complex<double>(N,0)), eps);
+  }
+  // at most 7 batch sizes (1 to 64), times the possible alignments of
+  // the input and output of each sub-batch
+  BOOST_CHECK( bob::sp::getFFTWPlanCacheSize() <= (size_t)28 );
+  bob::sp::clearFFTWPlanCache();
+}
+
+BOOST_AUTO_TEST_CASE( test_dct2D_batch )
+{
+  // Batched DCT of random blocks, compared to the per-block DCT2D
+  const int n_blocks = 21;
+  const int M = 8;
+  const int N = 6;
+  blitz::Array<double,3> t(n_blocks, M, N), t_dct(n_blocks, M, N),
+    t_idct(n_blocks, M, N);
+  for (int b=0; b<n_blocks; ++b)
+    for (int i=0; i<M; ++i)
+      for (int j=0; j<N; ++j)
+        t(b,i,j) = (rand()/(double)RAND_MAX)*10.;
+
+  bob::sp::dct2DBatch(t, t_dct, 3);
+  bob::sp::idct2DBatch(t_dct, t_idct, 3);
+
+  bob::sp::DCT2D dct(M, N);
+  blitz::Array<double,2> ref(M, N);
+  for (int b=0; b<n_blocks; ++b) {
+    dct(t(b,blitz::Range::all(),blitz::Range::all()).copy(), ref);
+    for (int i=0; i<M; ++i)
+      for (int j=0; j<N; ++j) {
+        BOOST_CHECK_SMALL( fabs(t_dct(b,i,j)-ref(i,j)), eps);
+        BOOST_CHECK_SMALL( fabs(t_idct(b,i,j)-t(b,i,j)), eps);
+      }
+  }
+}
 
 BOOST_AUTO_TEST_CASE( test_fftshift1D_simple )
 {
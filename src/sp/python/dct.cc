@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 
 #include <bob/sp/DCT1D.h>
 #include <bob/sp/DCT2D.h>
@@ -45,14 +46,20 @@ static void py_dct1d_c(bob::sp::DCT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<double,1> dst_ = dst.bz<double,1>();
-  op(src.bz<double,1>(), dst_);
+  blitz::Array<double,1> src_ = src.bz<double,1>();
+  bob::python::no_gil unlock;
+  op(src_, dst_);
 }
 
 static object py_dct1d_p(bob::sp::DCT1D& op, bob::python::const_ndarray src)
 {
   bob::python::ndarray dst(bob::core::array::t_float64, op.getLength());
   blitz::Array<double,1> dst_ = dst.bz<double,1>();
-  op(src.bz<double,1>(), dst_);
+  blitz::Array<double,1> src_ = src.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst_);
+  }
   return dst.self();
 }
 
@@ -60,14 +67,20 @@ static void py_idct1d_c(bob::sp::IDCT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<double,1> dst_ = dst.bz<double,1>();
-  op(src.bz<double,1>(), dst_);
+  blitz::Array<double,1> src_ = src.bz<double,1>();
+  bob::python::no_gil unlock;
+  op(src_, dst_);
 }
 
 static object py_idct1d_p(bob::sp::IDCT1D& op, bob::python::const_ndarray src)
 {
   bob::python::ndarray dst(bob::core::array::t_float64, op.getLength());
   blitz::Array<double,1> dst_ = dst.bz<double,1>();
-  op(src.bz<double,1>(), dst_);
+  blitz::Array<double,1> src_ = src.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst_);
+  }
   return dst.self();
 }
 
@@ -76,7 +89,9 @@ static void py_dct2d_c(bob::sp::DCT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
-  op(src.bz<double,2>(), dst_);
+  blitz::Array<double,2> src_ = src.bz<double,2>();
+  bob::python::no_gil unlock;
+  op(src_, dst_);
 }
 
 static object py_dct2d_p(bob::sp::DCT2D& op, bob::python::const_ndarray src)
@@ -84,7 +99,11 @@ static object py_dct2d_p(bob::sp::DCT2D& op, bob::python::const_ndarray src)
   bob::python::ndarray dst(bob::core::array::t_float64, op.getHeight(), 
     op.getWidth());
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
-  op(src.bz<double,2>(), dst_);
+  blitz::Array<double,2> src_ = src.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst_);
+  }
   return dst.self();
 }
 
@@ -92,7 +111,9 @@ static void py_idct2d_c(bob::sp::IDCT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
-  op(src.bz<double,2>(), dst_);
+  blitz::Array<double,2> src_ = src.bz<double,2>();
+  bob::python::no_gil unlock;
+  op(src_, dst_);
 }
 
 static object py_idct2d_p(bob::sp::IDCT2D& op, bob::python::const_ndarray src)
@@ -100,7 +121,11 @@ static object py_idct2d_p(bob::sp::IDCT2D& op, bob::python::const_ndarray src)
   bob::python::ndarray dst(bob::core::array::t_float64, op.getHeight(), 
     op.getWidth());
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
-  op(src.bz<double,2>(), dst_);
+  blitz::Array<double,2> src_ = src.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst_);
+  }
   return dst.self();
 }
 
@@ -114,14 +139,18 @@ static object script_dct(bob::python::const_ndarray ar)
       {
         bob::sp::DCT1D op(info.shape[0]);
         blitz::Array<double,1> res_ = res.bz<double,1>();
-        op(ar.bz<double,1>(), res_);
+        blitz::Array<double,1> ar_ = ar.bz<double,1>();
+        bob::python::no_gil unlock;
+        op(ar_, res_);
       }
       break;
     case 2:
       {
         bob::sp::DCT2D op(info.shape[0], info.shape[1]);
         blitz::Array<double,2> res_ = res.bz<double,2>();
-        op(ar.bz<double,2>(), res_);
+        blitz::Array<double,2> ar_ = ar.bz<double,2>();
+        bob::python::no_gil unlock;
+        op(ar_, res_);
       }
       break;
     default:
@@ -138,14 +167,18 @@ static object script_idct(bob::python::const_ndarray ar) {
       {
         bob::sp::IDCT1D op(info.shape[0]);
         blitz::Array<double,1> res_ = res.bz<double,1>();
-        op(ar.bz<double,1>(), res_);
+        blitz::Array<double,1> ar_ = ar.bz<double,1>();
+        bob::python::no_gil unlock;
+        op(ar_, res_);
       }
       break;
     case 2:
       {
         bob::sp::IDCT2D op(info.shape[0], info.shape[1]);
         blitz::Array<double,2> res_ = res.bz<double,2>();
-        op(ar.bz<double,2>(), res_);
+        blitz::Array<double,2> ar_ = ar.bz<double,2>();
+        bob::python::no_gil unlock;
+        op(ar_, res_);
       }
       break;
     default:
@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/sp/extrapolate.h>
 
 using namespace boost::python;
@@ -30,7 +31,10 @@ static void inner_extrapolateConstant_dim_size(bob::python::const_ndarray a,
   bob::python::ndarray b, object c) 
 {
   blitz::Array<T,N> b_ = b.bz<T,N>();
-  bob::sp::extrapolateConstant<T>(a.bz<T,N>(), b_, extract<T>(c));
+  blitz::Array<T,N> a_ = a.bz<T,N>();
+  const T c_ = extract<T>(c);
+  bob::python::no_gil unlock;
+  bob::sp::extrapolateConstant<T>(a_, b_, c_);
 }
 
 template <typename T>
@@ -84,7 +88,9 @@ static void inner_extrapolateZero_dim_size(bob::python::const_ndarray a,
   bob::python::ndarray b) 
 {
   blitz::Array<T,N> b_ = b.bz<T,N>();
-  bob::sp::extrapolateZero<T>(a.bz<T,N>(), b_);
+  blitz::Array<T,N> a_ = a.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::sp::extrapolateZero<T>(a_, b_);
 }
 
 template <typename T>
@@ -137,7 +143,9 @@ static void inner_extrapolateNearest_dim_size(bob::python::const_ndarray a,
   bob::python::ndarray b) 
 {
   blitz::Array<T,N> b_ = b.bz<T,N>();
-  bob::sp::extrapolateNearest<T>(a.bz<T,N>(), b_);
+  blitz::Array<T,N> a_ = a.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::sp::extrapolateNearest<T>(a_, b_);
 }
 
 template <typename T>
@@ -190,7 +198,9 @@ static void inner_extrapolateCircular_dim_size(bob::python::const_ndarray a,
   bob::python::ndarray b) 
 {
   blitz::Array<T,N> b_ = b.bz<T,N>();
-  bob::sp::extrapolateCircular<T>(a.bz<T,N>(), b_);
+  blitz::Array<T,N> a_ = a.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::sp::extrapolateCircular<T>(a_, b_);
 }
 
 template <typename T>
@@ -242,7 +252,9 @@ template <typename T, int N>
 static void inner_extrapolateMirror_dim_size(bob::python::const_ndarray a,
     bob::python::ndarray b) {
   blitz::Array<T,N> b_ = b.bz<T,N>();
-  bob::sp::extrapolateMirror<T>(a.bz<T,N>(), b_);
+  blitz::Array<T,N> a_ = a.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::sp::extrapolateMirror<T>(a_, b_);
 }
 
 template <typename T>
@@ -296,7 +308,9 @@ static void inner_extrapolate_dim_size(bob::python::const_ndarray a,
   const T val) 
 {
   blitz::Array<T,N> b_ = b.bz<T,N>();
-  bob::sp::extrapolate<T>(a.bz<T,N>(), b_, border_type, val);
+  blitz::Array<T,N> a_ = a.bz<T,N>();
+  bob::python::no_gil unlock;
+  bob::sp::extrapolate<T>(a_, b_, border_type, val);
 }
 
 template <typename T>
@@ -22,12 +22,14 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 
 #include <bob/sp/FFT1D.h>
 #include <bob/sp/FFT2D.h>
 #include <bob/sp/FFT1DNaive.h>
 #include <bob/sp/FFT2DNaive.h>
 #include <bob/sp/fftshift.h>
+#include <bob/sp/fftw.h>
 
 
 using namespace boost::python;
@@ -50,14 +52,20 @@ static void py_fft1d_c(bob::sp::FFT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
-  op(src.bz<std::complex<double>,1>(), dst_);
+  blitz::Array<std::complex<double>,1> src_ = src.bz<std::complex<double>,1>();
+  bob::python::no_gil unlock;
+  op(src_, dst_);
 }
 
 static object py_fft1d_p(bob::sp::FFT1D& op, bob::python::const_ndarray src)
 {
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getLength());
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
-  op(src.bz<std::complex<double>,1>(), dst_);
+  blitz::Array<std::complex<double>,1> src_ = src.bz<std::complex<double>,1>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst_);
+  }
   return dst.self();
 }
 
@@ -65,14 +73,20 @@ static void py_ifft1d_c(bob::sp::IFFT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
-  op(src.bz<std::complex<double>,1>(), dst_);
+  blitz::Array<std::complex<double>,1> src_ = src.bz<std::complex<double>,1>();
+  bob::python::no_gil unlock;
+  op(src_, dst_);
 }
 
 static object py_ifft1d_p(bob::sp::IFFT1D& op, bob::python::const_ndarray src)
 {
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getLength());
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
-  op(src.bz<std::complex<double>,1>(), dst_);
+  blitz::Array<std::complex<double>,1> src_ = src.bz<std::complex<double>,1>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst_);
+  }
   return dst.self();
 }
 
@@ -81,7 +95,9 @@ static void py_fft2d_c(bob::sp::FFT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
-  op(src.bz<std::complex<double>,2>(), dst_);
+  blitz::Array<std::complex<double>,2> src_ = src.bz<std::complex<double>,2>();
+  bob::python::no_gil unlock;
+  op(src_, dst_);
 }
 
 static object py_fft2d_p(bob::sp::FFT2D& op, bob::python::const_ndarray src)
@@ -89,7 +105,11 @@ static object py_fft2d_p(bob::sp::FFT2D& op, bob::python::const_ndarray src)
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getHeight(), 
     op.getWidth());
   blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
-  op(src.bz<std::complex<double>,2>(), dst_);
+  blitz::Array<std::complex<double>,2> src_ = src.bz<std::complex<double>,2>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst_);
+  }
   return dst.self();
 }
 
@@ -97,7 +117,9 @@ static void py_ifft2d_c(bob::sp::IFFT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
-  op(src.bz<std::complex<double>,2>(), dst_);
+  blitz::Array<std::complex<double>,2> src_ = src.bz<std::complex<double>,2>();
+  bob::python::no_gil unlock;
+  op(src_, dst_);
 }
 
 static object py_ifft2d_p(bob::sp::IFFT2D& op, bob::python::const_ndarray src)
@@ -105,7 +127,11 @@ static object py_ifft2d_p(bob::sp::IFFT2D& op, bob::python::const_ndarray src)
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getHeight(), 
     op.getWidth());
   blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
-  op(src.bz<std::complex<double>,2>(), dst_);
+  blitz::Array<std::complex<double>,2> src_ = src.bz<std::complex<double>,2>();
+  {
+    bob::python::no_gil unlock;
+    op(src_, dst_);
+  }
   return dst.self();
 }
 
@@ -120,14 +146,18 @@ static object script_fft(bob::python::const_ndarray ar)
       {
         bob::sp::FFT1D op(info.shape[0]);
         blitz::Array<dcplx,1> res_ = res.bz<dcplx,1>();
-        op(ar.bz<dcplx,1>(), res_);
+        blitz::Array<dcplx,1> ar_ = ar.bz<dcplx,1>();
+        bob::python::no_gil unlock;
+        op(ar_, res_);
       }
       break;
     case 2:
       {
         bob::sp::FFT2D op(info.shape[0], info.shape[1]);
         blitz::Array<dcplx,2> res_ = res.bz<dcplx,2>();
-        op(ar.bz<dcplx,2>(), res_);
+        blitz::Array<dcplx,2> ar_ = ar.bz<dcplx,2>();
+        bob::python::no_gil unlock;
+        op(ar_, res_);
       }
       break;
     default:
@@ -146,14 +176,18 @@ static object script_ifft(bob::python::const_ndarray ar)
       {
         bob::sp::IFFT1D op(info.shape[0]);
         blitz::Array<dcplx,1> res_ = res.bz<dcplx,1>();
-        op(ar.bz<dcplx,1>(), res_);
+        blitz::Array<dcplx,1> ar_ = ar.bz<dcplx,1>();
+        bob::python::no_gil unlock;
+        op(ar_, res_);
       }
       break;
     case 2:
       {
         bob::sp::IFFT2D op(info.shape[0], info.shape[1]);
         blitz::Array<dcplx,2> res_ = res.bz<dcplx,2>();
-        op(ar.bz<dcplx,2>(), res_);
+        blitz::Array<dcplx,2> ar_ = ar.bz<dcplx,2>();
+        bob::python::no_gil unlock;
+        op(ar_, res_);
       }
       break;
     default:
@@ -171,13 +205,17 @@ static object script_fftshift(bob::python::const_ndarray ar)
     case 1:
       {
         blitz::Array<dcplx,1> res_ = res.bz<dcplx,1>();
-        bob::sp::fftshift(ar.bz<dcplx,1>(), res_);
+        blitz::Array<dcplx,1> ar_ = ar.bz<dcplx,1>();
+        bob::python::no_gil unlock;
+        bob::sp::fftshift(ar_, res_);
       }
       break;
     case 2:
       {
         blitz::Array<dcplx,2> res_ = res.bz<dcplx,2>();
-        bob::sp::fftshift(ar.bz<dcplx,2>(), res_);
+        blitz::Array<dcplx,2> ar_ = ar.bz<dcplx,2>();
+        bob::python::no_gil unlock;
+        bob::sp::fftshift(ar_, res_);
       }
       break;
     default:
@@ -195,13 +233,17 @@ static object script_ifftshift(bob::python::const_ndarray ar)
     case 1:
       {
         blitz::Array<dcplx,1> res_ = res.bz<dcplx,1>();
-        bob::sp::ifftshift(ar.bz<dcplx,1>(), res_);
+        blitz::Array<dcplx,1> ar_ = ar.bz<dcplx,1>();
+        bob::python::no_gil unlock;
+        bob::sp::ifftshift(ar_, res_);
       }
       break;
     case 2:
       {
         blitz::Array<dcplx,2> res_ = res.bz<dcplx,2>();
-        bob::sp::ifftshift(ar.bz<dcplx,2>(), res_);
+        blitz::Array<dcplx,2> ar_ = ar.bz<dcplx,2>();
+        bob::python::no_gil unlock;
+        bob::sp::ifftshift(ar_, res_);
       }
       break;
     default:
@@ -218,14 +260,18 @@ static void py_fftshift(bob::python::const_ndarray ar, bob::python::ndarray t)
       {
         blitz::Array<std::complex<double>,1> t_ =
           t.bz<std::complex<double>,1>();
-        bob::sp::fftshift(ar.bz<std::complex<double>,1>(), t_);
+        blitz::Array<std::complex<double>,1> ar_ = ar.bz<std::complex<double>,1>();
+        bob::python::no_gil unlock;
+        bob::sp::fftshift(ar_, t_);
       }
       break;
     case 2:
       {
         blitz::Array<std::complex<double>,2> t_ =
           t.bz<std::complex<double>,2>();
-        bob::sp::fftshift(ar.bz<std::complex<double>,2>(), t_);
+        blitz::Array<std::complex<double>,2> ar_ = ar.bz<std::complex<double>,2>();
+        bob::python::no_gil unlock;
+        bob::sp::fftshift(ar_, t_);
       }
       break;
     default:
@@ -241,14 +287,18 @@ static void py_ifftshift(bob::python::const_ndarray ar, bob::python::ndarray t)
       {
         blitz::Array<std::complex<double>,1> t_ =
           t.bz<std::complex<double>,1>();
-        bob::sp::ifftshift(ar.bz<std::complex<double>,1>(), t_);
+        blitz::Array<std::complex<double>,1> ar_ = ar.bz<std::complex<double>,1>();
+        bob::python::no_gil unlock;
+        bob::sp::ifftshift(ar_, t_);
       }
       break;
     case 2:
       {
         blitz::Array<std::complex<double>,2> t_ =
           t.bz<std::complex<double>,2>();
-        bob::sp::ifftshift(ar.bz<std::complex<double>,2>(), t_);
+        blitz::Array<std::complex<double>,2> ar_ = ar.bz<std::complex<double>,2>();
+        bob::python::no_gil unlock;
+        bob::sp::ifftshift(ar_, t_);
       }
       break;
     default:
@@ -313,4 +363,19 @@ void bind_sp_fft()
 
   def("fftshift", &py_fftshift, (arg("input"),arg("output")), FFTSHIFT_DOC);
   def("ifftshift", &py_ifftshift, (arg("input"),arg("output")), IFFTSHIFT_DOC);
+
+  // FFTW plan cache and wisdom
+  enum_<bob::sp::FFTWPlanningMode>("FFTWPlanningMode", "Rigor of the FFTW planner used when a transform of a given shape is planned for the first time")
+    .value("ESTIMATE", bob::sp::FFTW_PLAN_ESTIMATE)
+    .value("MEASURE", bob::sp::FFTW_PLAN_MEASURE)
+    .value("PATIENT", bob::sp::FFTW_PLAN_PATIENT)
+    .value("EXHAUSTIVE", bob::sp::FFTW_PLAN_EXHAUSTIVE)
+    ;
+
+  def("set_fftw_planning_mode", &bob::sp::setFFTWPlanningMode, (arg("mode")), "Sets the rigor of the FFTW planner for the plans created from now on. Plans are cached per shape and mode for the whole process.");
+  def("get_fftw_planning_mode", &bob::sp::getFFTWPlanningMode, "Gets the rigor of the FFTW planner used for the plans created from now on.");
+  def("load_fftw_wisdom", &bob::sp::loadFFTWWisdom, (arg("filename")), "Imports FFTW wisdom from the given file. Returns False if the file cannot be read or does not contain valid wisdom.");
+  def("save_fftw_wisdom", &bob::sp::saveFFTWWisdom, (arg("filename")), "Exports the FFTW wisdom accumulated so far to the given file.");
+  def("clear_fftw_plan_cache", &bob::sp::clearFFTWPlanCache, "Destroys all the cached FFTW plans.");
+  def("fftw_plan_cache_size", &bob::sp::getFFTWPlanCacheSize, "Returns the number of FFTW plans currently in the cache.");
 }
@@ -21,6 +21,30 @@
 #include <bob/trainer/GMMTrainer.h>
 #include <bob/core/assert.h>
 #include <bob/core/check.h>
+#include <bob/core/parallel.h>
+#include <vector>
+
+namespace {
+
+  /**
+   * Accumulates the statistics of each chunk of the data into its own
+   * GMMStats (called by bob::core::parallelChunks()). The chunks are sliced
+   * beforehand, on the calling thread.
+   */
+  struct AccStatisticsChunk {
+    AccStatisticsChunk(const bob::machine::GMMMachine& gmm,
+        const std::vector<blitz::Array<double,2> >& chunks,
+        std::vector<bob::machine::GMMStats>& stats):
+      m_gmm(gmm), m_chunks(chunks), m_stats(stats) {}
+    void operator()(const int k, const int, const int) const {
+      m_gmm.accStatistics_(m_chunks[k], m_stats[k]);
+    }
+    const bob::machine::GMMMachine& m_gmm;
+    const std::vector<blitz::Array<double,2> >& m_chunks;
+    std::vector<bob::machine::GMMStats>& m_stats;
+  };
+
+}
 
 bob::trainer::GMMTrainer::GMMTrainer(const bool update_means, 
     const bool update_variances, const bool update_weights,
@@ -28,14 +52,16 @@ bob::trainer::GMMTrainer::GMMTrainer(const bool update_means,
   bob::trainer::EMTrainer<bob::machine::GMMMachine, blitz::Array<double,2> >(), 
   m_update_means(update_means), m_update_variances(update_variances),
   m_update_weights(update_weights), 
-  m_mean_var_update_responsibilities_threshold(mean_var_update_responsibilities_threshold) 
+  m_mean_var_update_responsibilities_threshold(mean_var_update_responsibilities_threshold),
+  m_n_threads(1)
 {
 }
 
 bob::trainer::GMMTrainer::GMMTrainer(const bob::trainer::GMMTrainer& b):
   bob::trainer::EMTrainer<bob::machine::GMMMachine, blitz::Array<double,2> >(b),
   m_update_means(b.m_update_means), m_update_variances(b.m_update_variances),
-  m_mean_var_update_responsibilities_threshold(b.m_mean_var_update_responsibilities_threshold)
+  m_mean_var_update_responsibilities_threshold(b.m_mean_var_update_responsibilities_threshold),
+  m_n_threads(b.m_n_threads)
 {
 }
 
@@ -54,8 +80,31 @@ void bob::trainer::GMMTrainer::eStep(bob::machine::GMMMachine& gmm,
   const blitz::Array<double,2>& data) 
 {
   m_ss.init();
-  // Calculate the sufficient statistics and save in m_ss
-  gmm.accStatistics(data, m_ss);
+  const int n_chunks = bob::core::getNChunks(data.extent(0), m_n_threads);
+  if (n_chunks == 1) {
+    // Calculate the sufficient statistics and save in m_ss
+    gmm.accStatistics(data, m_ss);
+    return;
+  }
+
+  // Checks the dimensions once, as the chunks are accumulated without checks
+  bob::core::array::assertSameDimensionLength(data.extent(1), gmm.getNInputs());
+  bob::core::array::assertSameDimensionLength(m_ss.sumPx.extent(0), gmm.getNGaussians());
+  bob::core::array::assertSameDimensionLength(m_ss.sumPx.extent(1), gmm.getNInputs());
+
+  // Calculate the sufficient statistics of each chunk, and sum them in order
+  std::vector<blitz::Array<double,2> > chunks(n_chunks);
+  for (int k=0; k<n_chunks; ++k) {
+    int start, count;
+    bob::core::getChunk(data.extent(0), n_chunks, k, start, count);
+    chunks[k].reference(data(blitz::Range(start, start+count-1),
+      blitz::Range::all()));
+  }
+  std::vector<bob::machine::GMMStats> stats(n_chunks,
+    bob::machine::GMMStats(gmm.getNGaussians(), gmm.getNInputs()));
+  bob::core::parallelChunks(data.extent(0), m_n_threads,
+    AccStatisticsChunk(gmm, chunks, stats));
+  for (int k=0; k<n_chunks; ++k) m_ss += stats[k];
 }
 
 double bob::trainer::GMMTrainer::computeLikelihood(bob::machine::GMMMachine& gmm)
@@ -80,6 +129,7 @@ bob::trainer::GMMTrainer& bob::trainer::GMMTrainer::operator=
     m_update_variances = other.m_update_variances;
     m_update_weights = other.m_update_weights;
     m_mean_var_update_responsibilities_threshold = other.m_mean_var_update_responsibilities_threshold;
+    m_n_threads = other.m_n_threads;
   }
   return *this;
 }
@@ -21,19 +21,66 @@
 
 #include <bob/trainer/KMeansTrainer.h>
 #include <bob/core/array_copy.h>
+#include <bob/core/parallel.h>
+#include <boost/bind.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
 #include <boost/random.hpp>
+#include <limits>
 
 #if BOOST_VERSION >= 104700
 #include <boost/random/discrete_distribution.hpp>
 #endif
 
+namespace {
+
+  /**
+   * Square Euclidean distance between the i'th sample and the j'th mean.
+   * The arrays are only accessed through their elements, as this is called
+   * from several threads at once (see bob::core::parallelChunks()).
+   */
+  inline double squareDistance(const blitz::Array<double,2>& data,
+      const int i, const blitz::Array<double,2>& means, const int j)
+  {
+    double distance = 0.;
+    for (int d=0; d<data.extent(1); ++d) {
+      const double diff = means(j,d) - data(i,d);
+      distance += diff * diff;
+    }
+    return distance;
+  }
+
+#if BOOST_VERSION >= 104700
+  /**
+   * Updates the distance of each sample to its closest mean with the
+   * distance to the m'th mean (called by bob::core::parallelChunks())
+   */
+  struct MinDistanceChunk {
+    MinDistanceChunk(const blitz::Array<double,2>& data,
+        const blitz::Array<double,2>& means, const int m,
+        blitz::Array<double,1>& min_distances):
+      m_data(data), m_means(means), m_m(m), m_min_distances(min_distances) {}
+    void operator()(const int, const int start, const int count) const {
+      for (int s=start; s<start+count; ++s)
+        m_min_distances(s) = std::min(m_min_distances(s),
+          squareDistance(m_data, s, m_means, m_m));
+    }
+    const blitz::Array<double,2>& m_data;
+    const blitz::Array<double,2>& m_means;
+    int m_m;
+    blitz::Array<double,1>& m_min_distances;
+  };
+#endif
+
+}
+
 bob::trainer::KMeansTrainer::KMeansTrainer(double convergence_threshold,
     size_t max_iterations, bool compute_likelihood, InitializationMethod i_m):
   bob::trainer::EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >(
     convergence_threshold, max_iterations, compute_likelihood), 
   m_initialization_method(i_m),
   m_rng(new boost::mt19937()), m_average_min_distance(0),
-  m_zeroethOrderStats(0), m_firstOrderStats(0,0)
+  m_zeroethOrderStats(0), m_firstOrderStats(0,0), m_n_threads(1),
+  m_bounds_enabled(false), m_bounds_valid(false)
 {
 }
 
@@ -43,7 +90,9 @@ bob::trainer::KMeansTrainer::KMeansTrainer(const bob::trainer::KMeansTrainer& ot
   m_initialization_method(other.m_initialization_method),
   m_rng(other.m_rng), m_average_min_distance(other.m_average_min_distance),
   m_zeroethOrderStats(bob::core::array::ccopy(other.m_zeroethOrderStats)), 
-  m_firstOrderStats(bob::core::array::ccopy(other.m_firstOrderStats))
+  m_firstOrderStats(bob::core::array::ccopy(other.m_firstOrderStats)),
+  m_n_threads(other.m_n_threads), m_bounds_enabled(false),
+  m_bounds_valid(false)
 {
 }
  
@@ -58,6 +107,7 @@ bob::trainer::KMeansTrainer& bob::trainer::KMeansTrainer::operator=
     m_average_min_distance = other.m_average_min_distance;
     m_zeroethOrderStats.reference(bob::core::array::ccopy(other.m_zeroethOrderStats));
     m_firstOrderStats.reference(bob::core::array::ccopy(other.m_firstOrderStats));
+    m_n_threads = other.m_n_threads;
   }
   return *this;
 }
@@ -151,23 +201,20 @@ void bob::trainer::KMeansTrainer::initialize(bob::machine::KMeansMachine& kmeans
     kmeans.setMean(0, mean);
 
     // 1.b. Loops, computes probability distribution and select samples accordingly
+    //   The distance of each sample to its closest mean is updated with the
+    //   last selected mean only
+    const blitz::Array<double,2>& means = kmeans.getMeans();
+    blitz::Array<double,1> min_distances(n_data);
+    min_distances = std::numeric_limits<double>::max();
     blitz::Array<double,1> weights(n_data);
     for(size_t m=1; m<kmeans.getNMeans(); ++m) 
     {
       // For each sample, puts the distance to the closest mean in the weight vector
-      for(size_t s=0; s<n_data; ++s)
-      {
-        blitz::Array<double,1> s_cur = ar(s,a);
-        double& w_cur = weights(s);
-        // Initializes with the distance to first mean
-        w_cur = kmeans.getDistanceFromMean(s_cur, 0);
-        // Loops over the remaining mean and update the mean distance if required
-        for(size_t i=1; i<m; ++i)
-          w_cur = std::min(w_cur, kmeans.getDistanceFromMean(s_cur, i));
-      }
+      bob::core::parallelChunks(n_data, m_n_threads,
+        MinDistanceChunk(ar, means, m-1, min_distances));
       // Square and normalize the weights vectors such that
       // \f$weights[x] = D(x)^{2} \sum_{y} D(y)^{2}\f$
-      weights = blitz::pow2(weights);
+      weights = blitz::pow2(min_distances);
       weights /= blitz::sum(weights);
 
       // Takes a sample according to the weights distribution
@@ -184,29 +231,179 @@ void bob::trainer::KMeansTrainer::initialize(bob::machine::KMeansMachine& kmeans
   m_firstOrderStats.resize(kmeans.getNMeans(), kmeans.getNInputs());
 }
 
+void bob::trainer::KMeansTrainer::train(bob::machine::KMeansMachine& kmeans,
+  const blitz::Array<double,2>& ar)
+{
+  // The bounds are only valid for the data and machine of this training
+  m_bounds_enabled = true;
+  m_bounds_valid = false;
+  try {
+    EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >::train(kmeans, ar);
+  }
+  catch (...) {
+    m_bounds_enabled = false;
+    m_bounds_valid = false;
+    throw;
+  }
+  m_bounds_enabled = false;
+  m_bounds_valid = false;
+}
+
 void bob::trainer::KMeansTrainer::eStep(bob::machine::KMeansMachine& kmeans, 
   const blitz::Array<double,2>& ar)
 {
   // initialise the accumulators
   resetAccumulators(kmeans);
+  bob::core::array::assertSameDimensionLength(ar.extent(1), kmeans.getNInputs());
 
-  // iterate over data samples
-  blitz::Range a = blitz::Range::all();
-  for(int i=0; i<ar.extent(0); ++i) {
-    // get example
-    blitz::Array<double, 1> x(ar(i,a));
+  // update the distance bounds (if enabled) with the new means
+  const bool use_bounds = m_bounds_enabled && updateBounds(kmeans, ar);
 
-    // find closest mean, and distance from that mean
-    size_t closest_mean = 0;
+  // accumulate the statistics of each chunk of the data, and sum them in order
+  const int n_chunks = bob::core::getNChunks(ar.extent(0), m_n_threads);
+  std::vector<ChunkStats> stats(n_chunks);
+  for(int k=0; k<n_chunks; ++k) {
+    stats[k].zeroeth.resize(m_zeroethOrderStats.shape());
+    stats[k].zeroeth = 0;
+    stats[k].first.resize(m_firstOrderStats.shape());
+    stats[k].first = 0;
+    stats[k].sum_min_distance = 0;
+  }
+  bob::core::parallelChunks(ar.extent(0), m_n_threads,
+    boost::bind(&bob::trainer::KMeansTrainer::eStepChunk, this,
+      boost::cref(kmeans), boost::cref(ar), use_bounds, boost::ref(stats),
+      _1, _2, _3));
+  for(int k=0; k<n_chunks; ++k) {
+    m_average_min_distance += stats[k].sum_min_distance;
+    m_zeroethOrderStats += stats[k].zeroeth;
+    m_firstOrderStats += stats[k].first;
+  }
+  m_average_min_distance /= static_cast<double>(ar.extent(0));
+  if(m_bounds_enabled) m_bounds_valid = true;
+}
+
+void bob::trainer::KMeansTrainer::eStepChunk(
+  const bob::machine::KMeansMachine& kmeans, const blitz::Array<double,2>& ar,
+  const bool use_bounds, std::vector<ChunkStats>& stats, const int k,
+  const int start, const int count)
+{
+  ChunkStats& s = stats[k];
+
+  // Shared arrays are only accessed through their elements
+  // (see bob::core::parallelChunks())
+  const blitz::Array<double,2>& means = kmeans.getMeans();
+  const int n_means = kmeans.getNMeans();
+  const int n_inputs = kmeans.getNInputs();
+  for(int i=start; i<start+count; ++i) {
+    int closest_mean = 0;
     double min_distance = 0;
-    kmeans.getClosestMean(x,closest_mean,min_distance);
+    bool found = false;
+
+    if(use_bounds) {
+      // The distance to the previous closest mean tightens the upper bound.
+      // If it is below the lower bound of the distances to the other means,
+      // or below half the distance from this mean to any other one, the
+      // closest mean cannot have changed.
+      closest_mean = m_closest_mean(i);
+      min_distance = squareDistance(ar, i, means, closest_mean);
+      m_upper_bound(i) = sqrt(min_distance);
+      found = m_upper_bound(i) < std::max(m_half_min_separation(closest_mean),
+        m_lower_bound(i));
+    }
+
+    if(!found) {
+      // find closest mean, and distance from that mean (as well as the
+      // distance from the second closest mean, for the bounds)
+      min_distance = std::numeric_limits<double>::max();
+      double second_distance = std::numeric_limits<double>::max();
+      for(int j=0; j<n_means; ++j) {
+        const double distance = squareDistance(ar, i, means, j);
+        if(distance < min_distance) {
+          second_distance = min_distance;
+          min_distance = distance;
+          closest_mean = j;
+        }
+        else if(distance < second_distance)
+          second_distance = distance;
+      }
+      if(m_bounds_enabled) {
+        m_closest_mean(i) = closest_mean;
+        m_upper_bound(i) = sqrt(min_distance);
+        m_lower_bound(i) = sqrt(second_distance);
+      }
+    }
 
     // accumulate the stats
-    m_average_min_distance += min_distance;
-    ++m_zeroethOrderStats(closest_mean);
-    m_firstOrderStats(closest_mean,blitz::Range::all()) += x;
+    s.sum_min_distance += min_distance;
+    ++s.zeroeth(closest_mean);
+    for(int d=0; d<n_inputs; ++d)
+      s.first(closest_mean,d) += ar(i,d);
   }
-  m_average_min_distance /= static_cast<double>(ar.extent(0));
+}
+
+bool bob::trainer::KMeansTrainer::updateBounds(
+  const bob::machine::KMeansMachine& kmeans, const blitz::Array<double,2>& ar)
+{
+  const blitz::Array<double,2>& means = kmeans.getMeans();
+  const int n_means = kmeans.getNMeans();
+  const int n_data = ar.extent(0);
+  blitz::Range a = blitz::Range::all();
+
+  bool valid = m_bounds_valid && m_closest_mean.extent(0) == n_data &&
+    bob::core::array::hasSameShape(m_bound_means, means);
+  if(valid) {
+    // Distance moved by each mean since the previous E-step. A mean which
+    // is not finite (e.g. of an empty cluster) is never the closest one,
+    // and can be ignored, unless it was not finite before.
+    blitz::Array<double,1> drift(n_means);
+    double max_drift = 0, second_max_drift = 0;
+    int max_drift_mean = 0;
+    for(int j=0; j<n_means && valid; ++j) {
+      double distance = squareDistance(m_bound_means, j, means, j);
+      if(!boost::math::isfinite(distance)) {
+        if(boost::math::isfinite(blitz::sum(means(j,a)))) valid = false;
+        distance = 0;
+      }
+      drift(j) = sqrt(distance);
+      if(drift(j) > max_drift) {
+        second_max_drift = max_drift;
+        max_drift = drift(j);
+        max_drift_mean = j;
+      }
+      else if(drift(j) > second_max_drift)
+        second_max_drift = drift(j);
+    }
+
+    // The closest mean of each sample is at most drift(closest) farther,
+    // and the other means are at least max_drift (over these other means)
+    // closer
+    if(valid) {
+      for(int i=0; i<n_data; ++i) {
+        const int j = m_closest_mean(i);
+        m_upper_bound(i) += drift(j);
+        m_lower_bound(i) -= (j == max_drift_mean ? second_max_drift : max_drift);
+      }
+    }
+  }
+  if(!valid) {
+    m_closest_mean.resize(n_data);
+    m_upper_bound.resize(n_data);
+    m_lower_bound.resize(n_data);
+  }
+
+  // Half the distance from each mean to the closest other one
+  m_half_min_separation.resize(n_means);
+  for(int j=0; j<n_means; ++j) {
+    double min_distance = std::numeric_limits<double>::max();
+    for(int l=0; l<n_means; ++l)
+      if(l != j) min_distance = std::min(min_distance,
+        squareDistance(means, j, means, l));
+    m_half_min_separation(j) = 0.5 * sqrt(min_distance);
+  }
+  m_bound_means.resize(means.shape());
+  m_bound_means = means;
+
+  return valid;
 }
 
 void bob::trainer::KMeansTrainer::mStep(bob::machine::KMeansMachine& kmeans, 
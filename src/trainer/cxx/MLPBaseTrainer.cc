@@ -22,15 +22,107 @@
 #include <algorithm>
 #include <bob/core/assert.h>
 #include <bob/core/check.h>
+#include <bob/core/parallel.h>
+#include <bob/core/thread_local.h>
 #include <bob/math/linear.h>
 #include <bob/trainer/MLPBaseTrainer.h>
 
+namespace {
+
+  /**
+   * The examples of a chunk of the batch: slices of the input, target,
+   * outputs and errors, as well as the buffers receiving the (unscaled)
+   * derivatives of the chunk. They are all set up on the calling thread, so
+   * the worker threads do not create nor release any reference to shared
+   * arrays (see bob::core::parallelChunks()).
+   */
+  struct BatchChunk {
+    blitz::Array<double,2> input;
+    blitz::Array<double,2> input_t; ///< transposed input
+    blitz::Array<double,2> target;
+    std::vector<blitz::Array<double,2> > output;
+    std::vector<blitz::Array<double,2> > output_t; ///< transposed outputs
+    std::vector<blitz::Array<double,2> > error;
+    std::vector<blitz::Array<double,2> > deriv;
+    std::vector<blitz::Array<double,1> > deriv_bias;
+  };
+
+  /**
+   * Forwards and/or back-propagates each chunk of the batch (called by
+   * bob::core::parallelChunks()). The back-propagation computes the sums,
+   * over the examples of the chunk, of the derivatives of the cost.
+   */
+  struct StepChunk {
+    StepChunk(const bob::machine::MLP& machine,
+        const std::vector<blitz::Array<double,2> >& weight_t,
+        const bob::trainer::Cost& cost, std::vector<BatchChunk>& chunks,
+        bool forward, bool backward):
+      m_weight(machine.getWeights()), m_bias(machine.getBiases()),
+      m_weight_t(weight_t),
+      m_hidden(machine.getHiddenActivation().get()),
+      m_output(machine.getOutputActivation().get()),
+      m_cost(cost), m_chunks(chunks),
+      m_forward(forward), m_backward(backward) {}
+
+    void operator()(const int k, const int, const int) const {
+      BatchChunk& c = m_chunks[k];
+      const size_t H = m_weight.size() - 1;
+
+      if (m_forward) {
+        for (size_t l=0; l<=H; ++l) { //for all layers
+          bob::math::prod_(l == 0 ? c.input : c.output[l-1], m_weight[l],
+              c.output[l]);
+          (l == H ? m_output : m_hidden)->f_layer(c.output[l], m_bias[l]);
+        }
+      }
+
+      if (!m_backward) return;
+
+      //last layer
+      for (int i=0; i<c.error[H].extent(0); ++i) { //for every example
+        for (int j=0; j<c.error[H].extent(1); ++j) { //for all variables
+          c.error[H](i,j) = m_cost.error(c.output[H](i,j), c.target(i,j));
+        }
+      }
+
+      //all other layers
+      for (size_t l=H; l>0; --l) {
+        bob::math::prod_(c.error[l], m_weight_t[l], c.error[l-1]);
+        m_hidden->f_prime_from_f_layer(c.output[l-1], c.error[l-1]);
+      }
+
+      //sums of the derivatives of the cost w.r.t. the weights and biases
+      for (size_t l=0; l<=H; ++l) { //for all layers
+        bob::math::prod_(l == 0 ? c.input_t : c.output_t[l-1], c.error[l],
+            c.deriv[l]);
+        for (int j=0; j<c.error[l].extent(1); ++j) {
+          double sum = 0.;
+          for (int i=0; i<c.error[l].extent(0); ++i) sum += c.error[l](i,j);
+          c.deriv_bias[l](j) = sum;
+        }
+      }
+    }
+
+    const std::vector<blitz::Array<double,2> >& m_weight;
+    const std::vector<blitz::Array<double,1> >& m_bias;
+    const std::vector<blitz::Array<double,2> >& m_weight_t;
+    const bob::machine::Activation* m_hidden;
+    const bob::machine::Activation* m_output;
+    const bob::trainer::Cost& m_cost;
+    std::vector<BatchChunk>& m_chunks;
+    bool m_forward;
+    bool m_backward;
+  };
+
+}
+
 bob::trainer::MLPBaseTrainer::MLPBaseTrainer(size_t batch_size,
     boost::shared_ptr<bob::trainer::Cost> cost):
   m_batch_size(batch_size),
   m_cost(cost),
   m_train_bias(true),
   m_H(0), ///< handy!
+  m_n_threads(1),
   m_deriv(1),
   m_deriv_bias(1),
   m_error(1),
@@ -50,6 +142,7 @@ bob::trainer::MLPBaseTrainer::MLPBaseTrainer(size_t batch_size,
   m_cost(cost),
   m_train_bias(true),
   m_H(machine.numOfHiddenLayers()), ///< handy!
+  m_n_threads(1),
   m_deriv(m_H + 1),
   m_deriv_bias(m_H + 1),
   m_error(m_H + 1),
@@ -66,6 +159,7 @@ bob::trainer::MLPBaseTrainer::MLPBaseTrainer(size_t batch_size,
   m_cost(cost),
   m_train_bias(train_biases),
   m_H(machine.numOfHiddenLayers()), ///< handy!
+  m_n_threads(1),
   m_deriv(m_H + 1),
   m_deriv_bias(m_H + 1),
   m_error(m_H + 1),
@@ -80,7 +174,8 @@ bob::trainer::MLPBaseTrainer::MLPBaseTrainer(const MLPBaseTrainer& other):
   m_batch_size(other.m_batch_size),
   m_cost(other.m_cost),
   m_train_bias(other.m_train_bias),
-  m_H(other.m_H)
+  m_H(other.m_H),
+  m_n_threads(other.m_n_threads)
 {
   bob::core::array::ccopy(other.m_deriv, m_deriv);
   bob::core::array::ccopy(other.m_deriv_bias, m_deriv_bias);
@@ -96,6 +191,7 @@ bob::trainer::MLPBaseTrainer& bob::trainer::MLPBaseTrainer::operator=
     m_cost = other.m_cost;
     m_train_bias = other.m_train_bias;
     m_H = other.m_H;
+    m_n_threads = other.m_n_threads;
 
     bob::core::array::ccopy(other.m_deriv, m_deriv);
     bob::core::array::ccopy(other.m_deriv_bias, m_deriv_bias);
@@ -140,59 +236,95 @@ bool bob::trainer::MLPBaseTrainer::isCompatible(const bob::machine::MLP& machine
 void bob::trainer::MLPBaseTrainer::forward_step(const bob::machine::MLP& machine,
   const blitz::Array<double,2>& input)
 {
-  const std::vector<blitz::Array<double,2> >& machine_weight = machine.getWeights();
-  const std::vector<blitz::Array<double,1> >& machine_bias = machine.getBiases();
-
-  boost::shared_ptr<bob::machine::Activation> hidden_actfun = machine.getHiddenActivation();
-  boost::shared_ptr<bob::machine::Activation> output_actfun = machine.getOutputActivation();
-
-  for (size_t k=0; k<machine_weight.size(); ++k) { //for all layers
-    if (k == 0) bob::math::prod_(input, machine_weight[k], m_output[k]);
-    else bob::math::prod_(m_output[k-1], machine_weight[k], m_output[k]);
-    boost::shared_ptr<bob::machine::Activation> cur_actfun =
-      (k == (machine_weight.size()-1) ? output_actfun : hidden_actfun );
-    for (int i=0; i<(int)m_batch_size; ++i) { //for every example
-      for (int j=0; j<m_output[k].extent(1); ++j) { //for all variables
-        m_output[k](i,j) = cur_actfun->f(m_output[k](i,j) + machine_bias[k](j));
-      }
-    }
-  }
+  step(machine, input, 0, true);
 }
 
 void bob::trainer::MLPBaseTrainer::backward_step
 (const bob::machine::MLP& machine,
  const blitz::Array<double,2>& input, const blitz::Array<double,2>& target)
 {
-  const std::vector<blitz::Array<double,2> >& machine_weight = machine.getWeights();
+  step(machine, input, &target, false);
+}
 
-  //last layer
-  boost::shared_ptr<bob::machine::Activation> output_actfun = machine.getOutputActivation();
-  for (int i=0; i<(int)m_batch_size; ++i) { //for every example
-    for (int j=0; j<m_error[m_H].extent(1); ++j) { //for all variables
-      m_error[m_H](i,j) = m_cost->error(m_output[m_H](i,j), target(i,j));
-    }
-  }
+void bob::trainer::MLPBaseTrainer::forward_backward_step
+(const bob::machine::MLP& machine,
+ const blitz::Array<double,2>& input, const blitz::Array<double,2>& target)
+{
+  step(machine, input, &target, true);
+}
 
-  //all other layers
-  boost::shared_ptr<bob::machine::Activation> hidden_actfun = machine.getHiddenActivation();
-  for (size_t k=m_H; k>0; --k) {
-    bob::math::prod_(m_error[k], machine_weight[k].transpose(1,0), m_error[k-1]);
-    for (int i=0; i<(int)m_batch_size; ++i) { //for every example
-      for (int j=0; j<m_error[k-1].extent(1); ++j) { //for all variables
-        m_error[k-1](i,j) *= hidden_actfun->f_prime_from_f(m_output[k-1](i,j));
+void bob::trainer::MLPBaseTrainer::step(const bob::machine::MLP& machine,
+  const blitz::Array<double,2>& input, const blitz::Array<double,2>* target,
+  bool forward)
+{
+  const std::vector<blitz::Array<double,2> >& machine_weight = machine.getWeights();
+  const int n_chunks = bob::core::getNChunks(m_batch_size, m_n_threads);
+
+  //slices the batch, and transposes the arrays the chunks need transposed
+  blitz::Range all = blitz::Range::all();
+  std::vector<BatchChunk> chunks(n_chunks);
+  for (int k=0; k<n_chunks; ++k) {
+    BatchChunk& c = chunks[k];
+    blitz::Range rows = all;
+    if (n_chunks > 1) {
+      int start, count;
+      bob::core::getChunk(m_batch_size, n_chunks, k, start, count);
+      rows = blitz::Range(start, start+count-1);
+    }
+    c.input.reference(input(rows, all));
+    if (target) {
+      c.input_t.reference(c.input.transpose(1,0));
+      c.target.reference((*target)(rows, all));
+    }
+    c.output.resize(m_H + 1);
+    c.output_t.resize(m_H + 1);
+    c.error.resize(m_H + 1);
+    c.deriv.resize(m_H + 1);
+    c.deriv_bias.resize(m_H + 1);
+    if (n_chunks > 1 && target) {
+      m_chunk_deriv.resize(n_chunks);
+      m_chunk_deriv_bias.resize(n_chunks);
+      m_chunk_deriv[k].resize(m_H + 1);
+      m_chunk_deriv_bias[k].resize(m_H + 1);
+    }
+    for (size_t l=0; l<(m_H + 1); ++l) {
+      c.output[l].reference(m_output[l](rows, all));
+      c.output_t[l].reference(c.output[l].transpose(1,0));
+      c.error[l].reference(m_error[l](rows, all));
+      if (n_chunks == 1) {
+        c.deriv[l].reference(m_deriv[l]);
+        c.deriv_bias[l].reference(m_deriv_bias[l]);
+      }
+      else if (target) {
+        bob::core::ensureExtent(m_chunk_deriv[k][l], m_deriv[l].extent(0),
+            m_deriv[l].extent(1));
+        bob::core::ensureExtent(m_chunk_deriv_bias[k][l],
+            m_deriv_bias[l].extent(0));
+        c.deriv[l].reference(m_chunk_deriv[k][l]);
+        c.deriv_bias[l].reference(m_chunk_deriv_bias[k][l]);
       }
     }
   }
-
-  //calculate the derivatives of the cost w.r.t. the weights and biases
-  for (size_t k=0; k<machine_weight.size(); ++k) { //for all layers
-    // For the weights
-    if (k == 0) bob::math::prod_(input.transpose(1,0), m_error[k], m_deriv[k]);
-    else bob::math::prod_(m_output[k-1].transpose(1,0), m_error[k], m_deriv[k]);
-    m_deriv[k] /= m_batch_size;
-    // For the biases
-    blitz::secondIndex bj;
-    m_deriv_bias[k] = blitz::mean(m_error[k].transpose(1,0), bj);
+  std::vector<blitz::Array<double,2> > weight_t(m_H + 1);
+  for (size_t l=1; l<(m_H + 1); ++l)
+    weight_t[l].reference(machine_weight[l].transpose(1,0));
+
+  bob::core::parallelChunks(m_batch_size, m_n_threads,
+      StepChunk(machine, weight_t, *m_cost, chunks, forward, target != 0));
+  if (!target) return;
+
+  //sums the derivatives of the chunks, in order, and averages them
+  for (size_t l=0; l<(m_H + 1); ++l) {
+    for (int k=1; k<n_chunks; ++k) {
+      chunks[0].deriv[l] += chunks[k].deriv[l];
+      chunks[0].deriv_bias[l] += chunks[k].deriv_bias[l];
+    }
+    if (n_chunks > 1) {
+      m_deriv[l] = chunks[0].deriv[l];
+      m_deriv_bias[l] = chunks[0].deriv_bias[l];
+    }
+    m_deriv[l] /= m_batch_size;
+    m_deriv_bias[l] /= m_batch_size;
   }
 }
 
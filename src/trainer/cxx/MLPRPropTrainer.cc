@@ -236,8 +236,7 @@ void bob::trainer::MLPRPropTrainer::train_(bob::machine::MLP& machine,
     const blitz::Array<double,2>& target) {
 
   // To be called in this sequence for a general backprop algorithm
-  forward_step(machine, input);
-  backward_step(machine, input, target);
+  forward_backward_step(machine, input, target);
   rprop_weight_update(machine, input);
 }
 
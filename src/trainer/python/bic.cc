@@ -20,14 +20,17 @@
 
 #include <boost/python.hpp>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/trainer/BICTrainer.h>
 
 void py_train(const bob::trainer::BICTrainer& t, 
   bob::machine::BICMachine& m, bob::python::const_ndarray intra_differences,
   bob::python::const_ndarray extra_differences)
 {
-  t.train(m, intra_differences.bz<double,2>(), 
-    extra_differences.bz<double,2>());
+  blitz::Array<double,2> intra_differences_ = intra_differences.bz<double,2>();
+  blitz::Array<double,2> extra_differences_ = extra_differences.bz<double,2>();
+  bob::python::no_gil unlock;
+  t.train(m, intra_differences_, extra_differences_);
 }
 
 
@@ -19,6 +19,7 @@
  */
 #include <boost/python.hpp>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/trainer/GMMTrainer.h>
 #include <bob/trainer/MAP_GMMTrainer.h>
 #include <bob/trainer/ML_GMMTrainer.h>
@@ -29,27 +30,37 @@ typedef bob::trainer::EMTrainer<bob::machine::GMMMachine, blitz::Array<double,2>
 
 static void py_train(EMTrainerGMMBase& trainer, bob::machine::GMMMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.train(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.train(machine, sample_);
 }
 
 static void py_initialize(EMTrainerGMMBase& trainer, bob::machine::GMMMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.initialize(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.initialize(machine, sample_);
 }
 
 static void py_finalize(EMTrainerGMMBase& trainer, bob::machine::GMMMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.finalize(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.finalize(machine, sample_);
 }
 
 static void py_eStep(EMTrainerGMMBase& trainer, bob::machine::GMMMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.eStep(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.eStep(machine, sample_);
 }
 
 static void py_mStep(EMTrainerGMMBase& trainer, bob::machine::GMMMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.mStep(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.mStep(machine, sample_);
 }
 
 void bind_trainer_gmm() {
@@ -74,6 +85,7 @@ void bind_trainer_gmm() {
       "This class implements the E-step of the expectation-maximisation algorithm for a GMM Machine.\n"
       "See Section 9.2.2 of Bishop, \"Pattern recognition and machine learning\", 2006", no_init)
     .add_property("gmm_statistics", make_function(&bob::trainer::GMMTrainer::getGMMStats, return_value_policy<copy_const_reference>()), &bob::trainer::GMMTrainer::setGMMStats, "The internal GMM statistics. Useful to parallelize the E-step.")
+    .add_property("n_threads", &bob::trainer::GMMTrainer::getNThreads, &bob::trainer::GMMTrainer::setNThreads, "The number of threads used by the E-step. The data is split into contiguous chunks, whose statistics are summed in order: results are reproducible for a given number of threads.")
   ;
 
   class_<bob::trainer::MAP_GMMTrainer, boost::noncopyable, bases<bob::trainer::GMMTrainer> >("MAP_GMMTrainer",
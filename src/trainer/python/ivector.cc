@@ -20,6 +20,7 @@
 
 #include <boost/python.hpp>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <boost/shared_ptr.hpp>
 #include <bob/trainer/IVectorTrainer.h>
 #include <bob/machine/IVectorMachine.h>
@@ -35,6 +36,7 @@ static void py_train(EMTrainerIVectorBase& trainer,
 {
   stl_input_iterator<bob::machine::GMMStats> dbegin(data), dend;
   std::vector<bob::machine::GMMStats> vdata(dbegin, dend);
+  bob::python::no_gil unlock;
   trainer.train(machine, vdata);
 }
 
@@ -43,6 +45,7 @@ static void py_initialize(EMTrainerIVectorBase& trainer,
 {
   stl_input_iterator<bob::machine::GMMStats> dbegin(data), dend;
   std::vector<bob::machine::GMMStats> vdata(dbegin, dend);
+  bob::python::no_gil unlock;
   trainer.initialize(machine, vdata);
 }
 
@@ -51,6 +54,7 @@ static void py_eStep(EMTrainerIVectorBase& trainer,
 {
   stl_input_iterator<bob::machine::GMMStats> dbegin(data), dend;
   std::vector<bob::machine::GMMStats> vdata(dbegin, dend);
+  bob::python::no_gil unlock;
   trainer.eStep(machine, vdata);
 }
 
@@ -59,6 +63,7 @@ static void py_mStep(EMTrainerIVectorBase& trainer,
 {
   stl_input_iterator<bob::machine::GMMStats> dbegin(data), dend;
   std::vector<bob::machine::GMMStats> vdata(dbegin, dend);
+  bob::python::no_gil unlock;
   trainer.mStep(machine, vdata);
 }
 
@@ -67,6 +72,7 @@ static void py_finalize(EMTrainerIVectorBase& trainer,
 {
   stl_input_iterator<bob::machine::GMMStats> dbegin(data), dend;
   std::vector<bob::machine::GMMStats> vdata(dbegin, dend);
+  bob::python::no_gil unlock;
   trainer.finalize(machine, vdata);
 }
 
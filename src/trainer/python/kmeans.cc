@@ -19,6 +19,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <bob/trainer/KMeansTrainer.h>
 
 using namespace boost::python;
@@ -42,31 +43,41 @@ static void py_setFirstOrderStats(bob::trainer::KMeansTrainer& op, bob::python::
 static void py_train(EMTrainerKMeansBase& trainer, 
   bob::machine::KMeansMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.train(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.train(machine, sample_);
 }
 
 static void py_initialize(EMTrainerKMeansBase& trainer, 
   bob::machine::KMeansMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.initialize(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.initialize(machine, sample_);
 }
 
 static void py_finalize(EMTrainerKMeansBase& trainer, 
   bob::machine::KMeansMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.finalize(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.finalize(machine, sample_);
 }
 
 static void py_eStep(EMTrainerKMeansBase& trainer, 
   bob::machine::KMeansMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.eStep(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.eStep(machine, sample_);
 }
 
 static void py_mStep(EMTrainerKMeansBase& trainer, 
   bob::machine::KMeansMachine& machine, bob::python::const_ndarray sample)
 {
-  trainer.mStep(machine, sample.bz<double,2>());
+  blitz::Array<double,2> sample_ = sample.bz<double,2>();
+  bob::python::no_gil unlock;
+  trainer.mStep(machine, sample_);
 }
 
 void bind_trainer_kmeans() 
@@ -104,6 +115,7 @@ void bind_trainer_kmeans()
      .def(self != self)
      .add_property("initialization_method", &bob::trainer::KMeansTrainer::getInitializationMethod, &bob::trainer::KMeansTrainer::setInitializationMethod, "The initialization method to generate the initial means.")
      .add_property("rng", &bob::trainer::KMeansTrainer::getRng, &bob::trainer::KMeansTrainer::setRng, "The Mersenne Twister mt19937 random generator used for the initialization of the means.")
+     .add_property("n_threads", &bob::trainer::KMeansTrainer::getNThreads, &bob::trainer::KMeansTrainer::setNThreads, "The number of threads used by the E-step and by the K-Means++ initialization. The data is split into contiguous chunks, whose statistics are summed in order: the result is reproducible for a given number of threads, but may differ by rounding errors from one number of threads to another.")
      .add_property("average_min_distance", &bob::trainer::KMeansTrainer::getAverageMinDistance, &bob::trainer::KMeansTrainer::setAverageMinDistance, "Average min (square Euclidean) distance. Useful to parallelize the E-step.")
      .add_property("zeroeth_order_statistics", make_function(&bob::trainer::KMeansTrainer::getZeroethOrderStats, return_value_policy<copy_const_reference>()), &py_setZeroethOrderStats, "The zeroeth order statistics. Useful to parallelize the E-step.")
      .add_property("first_order_statistics", make_function(&bob::trainer::KMeansTrainer::getFirstOrderStats, return_value_policy<copy_const_reference>()), &py_setFirstOrderStats, "The first order statistics. Useful to parallelize the E-step.")
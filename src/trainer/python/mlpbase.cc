@@ -22,6 +22,7 @@
 
 #include <boost/python.hpp>
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <boost/python/stl_iterator.hpp>
 #include <bob/trainer/MLPBaseTrainer.h>
 
@@ -143,14 +144,19 @@ static void mlpbase_set_deriv_bias2(bob::trainer::MLPBaseTrainer& t,
 static void mlpbase_forward_step(bob::trainer::MLPBaseTrainer& t, 
   const bob::machine::MLP& m, bob::python::const_ndarray input)
 {
-  t.forward_step(m, input.bz<double,2>());
+  blitz::Array<double,2> input_ = input.bz<double,2>();
+  bob::python::no_gil unlock;
+  t.forward_step(m, input_);
 }
 
 static void mlpbase_backward_step(bob::trainer::MLPBaseTrainer& t, 
   const bob::machine::MLP& m, bob::python::const_ndarray input, 
   bob::python::const_ndarray target)
 {
-  t.backward_step(m, input.bz<double,2>(), target.bz<double,2>());
+  blitz::Array<double,2> input_ = input.bz<double,2>();
+  blitz::Array<double,2> target_ = target.bz<double,2>();
+  bob::python::no_gil unlock;
+  t.backward_step(m, input_, target_);
 }
 
 void bind_trainer_mlpbase() {
@@ -232,6 +238,8 @@ void bind_trainer_mlpbase() {
 
     .add_property("train_biases", &bob::trainer::MLPBaseTrainer::getTrainBiases, &bob::trainer::MLPBaseTrainer::setTrainBiases, "A flag, indicating if this trainer will adjust the biases of the network (``True``) or not (``False``).")
 
+    .add_property("n_threads", &bob::trainer::MLPBaseTrainer::getNThreads, &bob::trainer::MLPBaseTrainer::setNThreads, "The number of threads each batch is split across. Every thread forwards and back-propagates a contiguous chunk of the examples, and the derivatives of the chunks are summed in order: results are reproducible for a given number of threads.")
+
     .def("is_compatible", &bob::trainer::MLPBaseTrainer::isCompatible, (arg("self"), arg("machine")), "Checks if a given machine is compatible with my inner settings")
 
     .def("initialize", &bob::trainer::MLPBaseTrainer::initialize, (arg("self"), arg("mlp")), "Initialize the training process.")
@@ -21,6 +21,7 @@
  */
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 #include <boost/python/stl_iterator.hpp>
 #include <bob/trainer/SVMTrainer.h>
 
@@ -34,6 +35,7 @@ static boost::shared_ptr<bob::machine::SupportVector> train1
   for(std::vector<bob::python::const_ndarray>::iterator it=vdata_ref.begin(); 
       it!=vdata_ref.end(); ++it)
     vdata.push_back(it->bz<double,2>());
+  bob::python::no_gil unlock;
   return trainer.train(vdata);
 }
 
@@ -31,6 +31,7 @@
 #include "bob/visioner/cv/cv_detector.h"
 #include "bob/visioner/model/mdecoder.h"
 #include "bob/visioner/util/timer.h"
+#include "bob/visioner/util/threads.h"
 
 namespace bob { namespace visioner {
 
@@ -40,7 +41,8 @@ namespace bob { namespace visioner {
     m_cluster(0.05),
     m_threshold(0.0),
     m_type(GroundTruth),
-    m_levels(0)
+    m_levels(0),
+    m_threads(0)
   {
   }
 
@@ -84,7 +86,11 @@ namespace bob { namespace visioner {
       
       ("detect_method",
        boost::program_options::value<std::string>()->default_value("groundtruth"),
-       "detection: method (scanning, groundtruth)");
+       "detection: method (scanning, groundtruth)")
+
+      ("detect_threads",
+       boost::program_options::value<uint64_t>()->default_value(m_threads),
+       "detection: number of scanning threads (0: no thread)");
 
   }
 
@@ -98,6 +104,7 @@ namespace bob { namespace visioner {
         << "Failed to load the model <" << cmd_model << ">!" << std::endl;
       return false;
     }
+    m_tmodels.clear();
     if (valid_model() == false)
     {
       bob::core::error << "Invalid model!" << std::endl;
@@ -113,6 +120,7 @@ namespace bob { namespace visioner {
     decode_var(po_desc, po_vm, "detect_levels", m_levels);
     decode_var(po_desc, po_vm, "detect_ds", m_ds);
     decode_var(po_desc, po_vm, "detect_cluster", m_cluster);     
+    decode_var(po_desc, po_vm, "detect_threads", m_threads);
 
     std::string cmd_method;
     decode_var(po_desc, po_vm, "detect_method", cmd_method);
@@ -143,7 +151,8 @@ namespace bob { namespace visioner {
     m_ds(scale_variation),
     m_cluster(clustering),
     m_threshold(threshold),
-    m_type(detection_method) {
+    m_type(detection_method),
+    m_threads(0) {
 
       // Load the model
       if (Model::load(model, m_model) == false) {
@@ -225,6 +234,12 @@ namespace bob { namespace visioner {
     return	output < m_model->n_outputs();
   }
 
+  // Number of scanning positions in [min, max) with the given step
+  static uint64_t scan_steps(int min, int max, int step)
+  {
+    return max > min ? (max - min + step - 1) / step : 0;
+  }
+
   // Detect objects
   // NB: The detections are thresholded and clustered!
   bool CVDetector::scan(std::vector<detection_t>& detections) const
@@ -256,44 +271,55 @@ namespace bob { namespace visioner {
       return false;
     }
 
-    // Scan the image ... 
-    Timer timer;
+    // Index the sub-windows to scan in the <scale, output, x, y> order
+    std::vector<uint64_t> sbegins(m_ipyramid.size() + 1, 0);
     for (uint64_t is = 0; is < m_ipyramid.size(); is ++)
     {
       const ipscale_t& ip = m_ipyramid[is];
-      m_model->preprocess(ip);
+      const uint64_t nx = scan_steps(ip.m_scan_min_x, ip.m_scan_max_x, ip.m_scan_dx);
+      const uint64_t ny = scan_steps(ip.m_scan_min_y, ip.m_scan_max_y, ip.m_scan_dy);
+      sbegins[is + 1] = sbegins[is] + n_outputs() * nx * ny;
+    }
+    const uint64_t n_sws = sbegins[m_ipyramid.size()];
 
-      // ... with every model type
-      for (uint64_t o = 0; o < n_outputs(); o ++)
+    // Scan the image ... 
+    Timer timer;
+    std::vector<scan_t> results;
+    if (!m_threads)
+    {
+      results.resize(1);
+      scan_mt(0, std::pair<uint64_t,uint64_t>(0, n_sws), sbegins, results[0]);
+    }
+    else
+    {
+      // ... with a copy of the model for each additional thread
+      if (m_tmodels.size() + 1 < m_threads)
       {
-        for (int x = ip.m_scan_min_x; x < ip.m_scan_max_x; x += ip.m_scan_dx)
-          for (int y = ip.m_scan_min_y; y < ip.m_scan_max_y; y += ip.m_scan_dy)
+        m_tmodels.resize(m_threads - 1);
+        for (uint64_t ith = 0; ith + 1 < m_threads; ith ++)
+        {
+          if (!m_tmodels[ith])
           {
-            // Concentrate computation on the most promising detections
-            double score = 0.0;
-            for (uint64_t l = 0; l <= m_levels && score >= 0.0; l ++)
-            {
-              const uint64_t lbegin = m_lmodel_begins[o][l];
-              const uint64_t lend = m_lmodel_ends[o][l];
-              score += m_model->score(o, lbegin, lend, x, y);
+            m_tmodels[ith] = m_model->clone();
+          }
+        }
+      }
 
-              // Update statistics
-              m_stats.m_evals += lend - lbegin;
-            }
+      thread_iloop(boost::bind(&CVDetector::scan_mt, this, 
+            boost::lambda::_1, boost::lambda::_2, boost::cref(sbegins), 
+            boost::lambda::_3), n_sws, results, m_threads);
+    }
 
-            // Threshold detection and map it to the original image size
-            if (score >= m_threshold)
-            {
-              detections.push_back(make_detection(
-                    score, 
-                    m_ipyramid.map(subwindow_t(x, y, is)), 
-                    o));
-            }
+    // Merge the detections (in the scanning order)
+    for (uint64_t ith = 0; ith < results.size(); ith ++)
+    {
+      const scan_t& result = results[ith];
+      detections.insert(detections.end(), 
+          result.m_detections.begin(), result.m_detections.end());
 
-            // Update statistics
-            m_stats.m_sws ++;
-          }
-      }
+      // Update statistics
+      m_stats.m_sws += result.m_sws;
+      m_stats.m_evals += result.m_evals;
     }
 
     // Update statistics
@@ -305,6 +331,62 @@ namespace bob { namespace visioner {
     return true;
   }
 
+  // Scan a range of sub-windows
+  void CVDetector::scan_mt(uint64_t ith, 
+      const std::pair<uint64_t, uint64_t>& range, 
+      const std::vector<uint64_t>& sbegins, scan_t& result) const
+  {
+    Model& model = (ith == 0) ? *m_model : *m_tmodels[ith - 1];
+
+    for (uint64_t is = 0; is < m_ipyramid.size(); is ++)
+    {
+      const uint64_t begin = std::max(range.first, sbegins[is]);
+      const uint64_t end = std::min(range.second, sbegins[is + 1]);
+      if (begin >= end)
+      {
+        continue;
+      }
+
+      const ipscale_t& ip = m_ipyramid[is];
+      model.preprocess(ip);
+
+      const uint64_t ny = scan_steps(ip.m_scan_min_y, ip.m_scan_max_y, ip.m_scan_dy);
+      const uint64_t nxy = (sbegins[is + 1] - sbegins[is]) / n_outputs();
+
+      // ... with every model type
+      for (uint64_t k = begin - sbegins[is]; k < end - sbegins[is]; k ++)
+      {
+        const uint64_t o = k / nxy;
+        const int x = ip.m_scan_min_x + (int)((k % nxy) / ny) * ip.m_scan_dx;
+        const int y = ip.m_scan_min_y + (int)(k % ny) * ip.m_scan_dy;
+
+        // Concentrate computation on the most promising detections
+        double score = 0.0;
+        for (uint64_t l = 0; l <= m_levels && score >= 0.0; l ++)
+        {
+          const uint64_t lbegin = m_lmodel_begins[o][l];
+          const uint64_t lend = m_lmodel_ends[o][l];
+          score += model.score(o, lbegin, lend, x, y);
+
+          // Update statistics
+          result.m_evals += lend - lbegin;
+        }
+
+        // Threshold detection and map it to the original image size
+        if (score >= m_threshold)
+        {
+          result.m_detections.push_back(make_detection(
+                score, 
+                m_ipyramid.map(subwindow_t(x, y, is)), 
+                o));
+        }
+
+        // Update statistics
+        result.m_sws ++;
+      }
+    }
+  }
+
   // Match detections with ground truth locations
   bool CVDetector::match(const detection_t& detection, Object& object) const
   {
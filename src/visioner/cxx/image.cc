@@ -27,6 +27,36 @@
 
 namespace bob { namespace visioner {	
 
+  // Compute the contributions of the <src_size> source pixels to each of the <dst_size>
+  //	destination pixels when downscaling with a box filter:
+  //	the destination pixel <d> averages the source pixels [begins[d], begins[d + 1])
+  //	(with the same offsets in <indices> and <weights>).
+  static void box_weights(uint64_t src_size, uint64_t dst_size,
+      std::vector<uint64_t>& begins, std::vector<uint64_t>& indices, std::vector<float>& weights)
+  {
+    const double ratio = (double)src_size / (double)dst_size;
+    const double inv_ratio = inverse(ratio);
+
+    begins.assign(1, 0);
+    indices.clear();
+    weights.clear();
+    for (uint64_t d = 0; d < dst_size; d ++)
+    {
+      const double start = d * ratio, stop = std::min((double)src_size, (d + 1) * ratio);
+      for (uint64_t s = (uint64_t)start; (double)s < stop; s ++)
+      {
+        const double overlap = std::min(stop, s + 1.0) - std::max(start, (double)s);
+        if (overlap > 0.0)
+        {
+          indices.push_back(s);
+          weights.push_back(overlap * inv_ratio);
+        }
+      }
+      begins.push_back(indices.size());
+    }
+  }
+
+
   // Loads an image
   bool load(const QImage& qimage, Matrix<uint8_t>& grays)
   {
@@ -51,6 +81,64 @@ namespace bob { namespace visioner {
     return load(qimage.scaled(new_w, new_h, Qt::KeepAspectRatio, Qt::SmoothTransformation), dst);
   }
 
+  // Downscale the <src> source image to <rows> x <cols> using a box filter
+  bool downscale(const Matrix<uint8_t>& src, uint64_t rows, uint64_t cols, Matrix<uint8_t>& dst)
+  {
+    rows = std::min(rows, (uint64_t)src.rows());
+    cols = std::min(cols, (uint64_t)src.cols());
+    if (rows < 1 || cols < 1)
+    {
+      return false;
+    }
+
+    std::vector<uint64_t> xbegins, xindices, ybegins, yindices;
+    std::vector<float> xweights, yweights;
+    box_weights(src.cols(), cols, xbegins, xindices, xweights);
+    box_weights(src.rows(), rows, ybegins, yindices, yweights);
+
+    // Horizontal pass: each source row is downscaled to <cols> columns ...
+    Matrix<float> tmp(src.rows(), cols);
+    for (uint64_t y = 0; y < src.rows(); y ++)
+    {
+      const uint8_t* src_row = src[y];
+      float* tmp_row = tmp[y];
+      for (uint64_t x = 0; x < cols; x ++)
+      {
+        float sum = 0.0f;
+        for (uint64_t k = xbegins[x]; k < xbegins[x + 1]; k ++)
+        {
+          sum += xweights[k] * src_row[xindices[k]];
+        }
+        tmp_row[x] = sum;
+      }
+    }
+
+    // ... then the vertical pass combines whole rows
+    dst.resize(rows, cols);
+    std::vector<float> sums(cols);
+    for (uint64_t y = 0; y < rows; y ++)
+    {
+      std::fill(sums.begin(), sums.end(), 0.0f);
+      for (uint64_t k = ybegins[y]; k < ybegins[y + 1]; k ++)
+      {
+        const float weight = yweights[k];
+        const float* tmp_row = tmp[yindices[k]];
+        for (uint64_t x = 0; x < cols; x ++)
+        {
+          sums[x] += weight * tmp_row[x];
+        }
+      }
+
+      uint8_t* dst_row = dst[y];
+      for (uint64_t x = 0; x < cols; x ++)
+      {
+        dst_row[x] = (uint8_t)range((int)(0.5f + sums[x]), 0, 255);
+      }
+    }
+
+    return true;
+  }
+
   // Convert from <Matrix<uint8_t>> to <QImage>
   QImage convert(const Matrix<uint8_t>& grays)
   {
@@ -150,20 +150,7 @@ namespace bob { namespace visioner {
     update_ipscale(m_ipscales[0], m_param);
 
     // Build the scaled versions of the original image
-    const ipscale_t& src = m_ipscales[0];
-    for (uint64_t i = 1; i < scales.size(); i ++)
-    {
-      ipscale_t& dst = m_ipscales[i];
-      src.scale(scales[i], dst);
-      update_ipscale(dst, m_param);
-
-      if (	dst.m_scan_min_x >= dst.m_scan_max_x ||
-          dst.m_scan_min_y >= dst.m_scan_max_y)
-      {
-        m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
-        break;
-      }
-    }
+    build(scales);
 
     // OK
     return true;
@@ -188,18 +175,7 @@ namespace bob { namespace visioner {
     update_ipscale(m_ipscales[0], m_param);
 
     // Build the scaled versions of the original image
-    const ipscale_t& src = m_ipscales[0];
-    for (uint64_t i = 1; i < scales.size(); i ++) {
-      ipscale_t& dst = m_ipscales[i];
-      src.scale(scales[i], dst);
-      update_ipscale(dst, m_param);
-
-      if (dst.m_scan_min_x >= dst.m_scan_max_x ||
-          dst.m_scan_min_y >= dst.m_scan_max_y) {
-        m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
-        break;
-      }
-    }
+    build(scales);
 
     // OK
     return true;
@@ -224,11 +200,45 @@ namespace bob { namespace visioner {
     update_ipscale(m_ipscales[0], m_param);
 
     // Build the scaled versions of the original image
-    const ipscale_t& src = m_ipscales[0];
+    build(scales);
+
+    // OK
+    return true;
+  }
+
+  // Build the scaled versions of the top of the pyramid:
+  //	each level is downscaled from the smallest level already built that is at least
+  //	twice as large (or from the original image). This way each downscaling reads a small
+  //	image, while the resampling errors do not accumulate over more than a few levels.
+  void ipyramid_t::build(const std::vector<double>& scales)
+  {
+    const ipscale_t& top = m_ipscales[0];
+    integral(top.m_image, m_ipscales[0].m_iimage);
+
+    uint64_t isrc = 0;
     for (uint64_t i = 1; i < scales.size(); i ++)
     {
       ipscale_t& dst = m_ipscales[i];
-      src.scale(scales[i], dst);
+      dst.m_scale = range(scales[i], 0.0, 1.0);
+      dst.m_inv_scale = inverse(dst.m_scale);
+
+      // The scales are decreasing, so the source level can only move down the pyramid
+      while (isrc + 1 < i && m_ipscales[isrc + 1].m_scale >= 2.0 * dst.m_scale)
+      {
+        isrc ++;
+      }
+
+      // The ground truth is always scaled from the original one
+      dst.m_objects = top.m_objects;
+      for (std::vector<Object>::iterator it = dst.m_objects.begin(); it != dst.m_objects.end(); ++ it)
+      {
+        it->scale(dst.m_scale);
+      }
+
+      downscale(m_ipscales[isrc].m_image, 
+          (uint64_t)(0.5 + dst.m_scale * top.rows()), 
+          (uint64_t)(0.5 + dst.m_scale * top.cols()), 
+          dst.m_image);
       update_ipscale(dst, m_param);
 
       if (	dst.m_scan_min_x >= dst.m_scan_max_x ||
@@ -237,10 +247,9 @@ namespace bob { namespace visioner {
         m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
         break;
       }
-    }
 
-    // OK
-    return true;
+      integral(dst.m_image, dst.m_iimage);
+    }
   }
 
   // Map regions (at the original scale) to sub-windows
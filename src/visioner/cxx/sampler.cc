@@ -124,6 +124,7 @@ namespace bob { namespace visioner {
         // Make sure to store only images with at least one sample
         if (new_n_samples > 0) {
           m_ipscales.push_back(ip);
+          m_ipscales.back().m_iimage.clear(); // Too large to keep for all the training images
           m_ipsbegins.push_back(old_n_samples);
           m_ipsends.push_back(old_n_samples + new_n_samples);
           m_n_samples += new_n_samples;
@@ -494,13 +495,13 @@ namespace bob { namespace visioner {
       std::pair<uint64_t, uint64_t> srange, const Model& bmodel,
       std::vector<double>& terrors) const
   {
+    terrors.resize(n_types(), 0.0);
+
     if (srange.first >= srange.second)
     {
       return;
     }
 
-    terrors.resize(n_types(), 0.0);
-
     const boost::shared_ptr<Model> model = bmodel.clone();
     std::vector<double> targets(n_outputs()), scores(n_outputs());
     uint64_t type;
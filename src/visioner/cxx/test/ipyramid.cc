@@ -0,0 +1,168 @@
+/**
+ * @file visioner/cxx/test/ipyramid.cc
+ * @date Fri Oct 16 22:58:03 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Test the box-filter downscaling and the levels of the visioner
+ * image pyramid (scaled images and their integral images)
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Visioner-IPyramid Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include "bob/visioner/vision/image.h"
+#include "bob/visioner/vision/integral.h"
+#include "bob/visioner/model/ipyramid.h"
+
+/**
+ * Random grayscale image
+ */
+static bob::visioner::Matrix<uint8_t> random_image(uint64_t rows,
+    uint64_t cols)
+{
+  bob::visioner::Matrix<uint8_t> image(rows, cols);
+  for (uint64_t y=0; y<rows; ++y)
+    for (uint64_t x=0; x<cols; ++x)
+      image(y,x) = (uint8_t)(std::rand() % 256);
+  return image;
+}
+
+/**
+ * Overlap of the source interval [s, s+1) with the destination pixel d,
+ * in source pixel units
+ */
+static double overlap(uint64_t s, uint64_t d, double ratio)
+{
+  const double start = d * ratio, stop = (d + 1) * ratio;
+  return std::max(0., std::min(stop, s + 1.) - std::max(start, (double)s));
+}
+
+/**
+ * Box-filter downscaling computed directly: each destination pixel is the
+ * average of the source pixels it covers, weighted by their 2D overlaps
+ */
+static double reference(const bob::visioner::Matrix<uint8_t>& src,
+    uint64_t rows, uint64_t cols, uint64_t y, uint64_t x)
+{
+  const double ry = (double)src.rows() / rows, rx = (double)src.cols() / cols;
+  double sum = 0.;
+  for (uint64_t sy=0; sy<src.rows(); ++sy)
+  {
+    const double oy = overlap(sy, y, ry);
+    if (oy == 0.) continue;
+    for (uint64_t sx=0; sx<src.cols(); ++sx)
+      sum += oy * overlap(sx, x, rx) * src(sy,sx);
+  }
+  return sum / (ry * rx);
+}
+
+/**
+ * Integral image computed directly, by summing the whole top-left region
+ * of each pixel
+ */
+static void check_integral(const bob::visioner::Matrix<uint8_t>& image,
+    const bob::visioner::Matrix<uint32_t>& iimage)
+{
+  BOOST_REQUIRE_EQUAL(iimage.rows(), image.rows());
+  BOOST_REQUIRE_EQUAL(iimage.cols(), image.cols());
+  std::vector<uint32_t> column_sums(image.cols(), 0);
+  for (uint64_t y=0; y<image.rows(); ++y)
+  {
+    uint32_t sum = 0;
+    for (uint64_t x=0; x<image.cols(); ++x)
+    {
+      column_sums[x] += image(y,x);
+      sum += column_sums[x];
+      BOOST_CHECK_EQUAL(iimage(y,x), sum);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_downscale_box )
+{
+  std::srand(0);
+  const bob::visioner::Matrix<uint8_t> src = random_image(37, 53);
+
+  // Non-integer ratios: compared to the direct weighted average
+  bob::visioner::Matrix<uint8_t> dst;
+  BOOST_REQUIRE( bob::visioner::downscale(src, 13, 20, dst) );
+  BOOST_REQUIRE_EQUAL(dst.rows(), (uint64_t)13);
+  BOOST_REQUIRE_EQUAL(dst.cols(), (uint64_t)20);
+  for (uint64_t y=0; y<13; ++y)
+    for (uint64_t x=0; x<20; ++x)
+      BOOST_CHECK_SMALL( dst(y,x) - reference(src, 13, 20, y, x), 0.5 + 1e-3 );
+
+  // Halving: each pixel is the rounded average of a 2x2 block
+  const bob::visioner::Matrix<uint8_t> src2 = random_image(40, 60);
+  BOOST_REQUIRE( bob::visioner::downscale(src2, 20, 30, dst) );
+  for (uint64_t y=0; y<20; ++y)
+    for (uint64_t x=0; x<30; ++x)
+    {
+      const int sum = src2(2*y,2*x) + src2(2*y,2*x+1) + src2(2*y+1,2*x) +
+        src2(2*y+1,2*x+1);
+      BOOST_CHECK_EQUAL( (int)dst(y,x), (sum + 2) / 4 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_pyramid_levels )
+{
+  std::srand(1);
+  const bob::visioner::Matrix<uint8_t> image = random_image(90, 110);
+
+  bob::visioner::ipyramid_t pyramid;
+  BOOST_REQUIRE( pyramid.load(&image(0,0), image.rows(), image.cols()) );
+  BOOST_REQUIRE( pyramid.size() > 2 );
+
+  // The top of the pyramid is the original image
+  BOOST_CHECK( pyramid[0].m_image == image );
+  check_integral(pyramid[0].m_image, pyramid[0].m_iimage);
+
+  uint64_t isrc = 0;
+  for (uint64_t i=1; i<pyramid.size(); ++i)
+  {
+    const bob::visioner::ipscale_t& level = pyramid[i];
+    const uint64_t rows = (uint64_t)(0.5 + level.m_scale * image.rows());
+    const uint64_t cols = (uint64_t)(0.5 + level.m_scale * image.cols());
+    BOOST_REQUIRE_EQUAL(level.rows(), rows);
+    BOOST_REQUIRE_EQUAL(level.cols(), cols);
+
+    // Levels down to half the original size are downscaled from the
+    // original image: compared to the direct weighted average
+    if (level.m_scale >= 0.5)
+    {
+      for (uint64_t y=0; y<rows; ++y)
+        for (uint64_t x=0; x<cols; ++x)
+          BOOST_CHECK_SMALL( level.m_image(y,x) -
+              reference(image, rows, cols, y, x), 0.5 + 1e-3 );
+    }
+
+    // Smaller levels are downscaled from the smallest level at least twice
+    // as large
+    while (isrc + 1 < i && pyramid[isrc + 1].m_scale >= 2.0 * level.m_scale)
+      ++isrc;
+    bob::visioner::Matrix<uint8_t> expected;
+    bob::visioner::downscale(pyramid[isrc].m_image, rows, cols, expected);
+    BOOST_CHECK( level.m_image == expected );
+
+    // Each level comes with the integral image of its scaled image
+    check_integral(level.m_image, level.m_iimage);
+  }
+}
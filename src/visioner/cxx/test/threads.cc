@@ -0,0 +1,188 @@
+/**
+ * @file visioner/cxx/test/threads.cc
+ * @date Fri Oct 16 23:41:15 2026 +0200
+ * @author Laurent El Shafey <Laurent.El-Shafey@idiap.ch>
+ *
+ * @brief Test the splitting of the visioner loops and their scheduling on
+ * the work-stealing thread pool
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Visioner-Threads Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "bob/visioner/util/threads.h"
+
+typedef std::pair<uint64_t, uint64_t> Range;
+
+/**
+ * Sums the indices of a range into its result
+ */
+struct Sum {
+  typedef void result_type;
+  void operator()(const Range& range, uint64_t& result) const {
+    result = 0;
+    for (uint64_t i=range.first; i<range.second; ++i) result += i;
+  }
+};
+
+/**
+ * Throws on the range holding a given index
+ */
+struct Throw {
+  typedef void result_type;
+  explicit Throw(uint64_t index): m_index(index) {}
+  void operator()(const Range& range) const {
+    if (range.first <= m_index && m_index < range.second)
+      throw std::runtime_error("chunk failure");
+  }
+  uint64_t m_index;
+};
+
+/**
+ * Rendezvous of a given number of threads, which fails (rather than
+ * hangs) if they do not all arrive within a few seconds
+ */
+struct Rendezvous {
+  explicit Rendezvous(size_t n): m_n(n), m_count(0) {}
+  bool arrive() {
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    if (++m_count == m_n) m_cond.notify_all();
+    return wait(lock, m_n);
+  }
+  bool wait(boost::unique_lock<boost::mutex>& lock, size_t count) {
+    const boost::system_time timeout = boost::get_system_time() +
+      boost::posix_time::seconds(10);
+    while (m_count < count)
+      if (!m_cond.timed_wait(lock, timeout)) return false;
+    return true;
+  }
+  size_t m_n;
+  size_t m_count;
+  boost::mutex m_mutex;
+  boost::condition_variable m_cond;
+};
+
+/**
+ * Task of a batch which occupies all the threads of the pool: the first
+ * task runs a nested loop, which helper jobs are queued to busy workers,
+ * while the other tasks wait for it to be over.
+ */
+struct Occupy {
+  typedef void result_type;
+  Occupy(Rendezvous& all, Rendezvous& nested, size_t n_threads,
+      std::vector<int>& ok):
+    m_all(all), m_nested(nested), m_n_threads(n_threads), m_ok(ok) {}
+  void operator()(const uint64_t task) const {
+    if (!m_all.arrive()) return;
+    if (task == 0) {
+      std::vector<uint64_t> results;
+      bob::visioner::thread_loop(Sum(), 1000, results, m_n_threads);
+      uint64_t sum = 0;
+      for (size_t k=0; k<results.size(); ++k) sum += results[k];
+      m_ok[task] = (sum == 999 * 1000 / 2);
+      m_nested.arrive();
+    }
+    else {
+      boost::unique_lock<boost::mutex> lock(m_nested.m_mutex);
+      m_ok[task] = m_nested.wait(lock, 1);
+    }
+  }
+  Rendezvous& m_all;
+  Rendezvous& m_nested;
+  size_t m_n_threads;
+  std::vector<int>& m_ok;
+};
+
+BOOST_AUTO_TEST_CASE( test_thread_split )
+{
+  for (uint64_t n=0; n<50; ++n) {
+    for (size_t n_threads=1; n_threads<10; ++n_threads) {
+      std::vector<uint64_t> begins, ends;
+      bob::visioner::thread_split(n, begins, ends, n_threads);
+      BOOST_REQUIRE_EQUAL(begins.size(), n_threads);
+      BOOST_REQUIRE_EQUAL(ends.size(), n_threads);
+      BOOST_CHECK_EQUAL(begins.front(), (uint64_t)0);
+      BOOST_CHECK_EQUAL(ends.back(), n);
+      for (size_t k=0; k<n_threads; ++k) {
+        if (k > 0) BOOST_CHECK_EQUAL(begins[k], ends[k-1]);
+        const uint64_t size = ends[k] - begins[k];
+        // nearly equal sizes, and no empty chunk if possible
+        BOOST_CHECK(size == n / n_threads || size == n / n_threads + 1);
+        if (n >= n_threads) BOOST_CHECK(size > 0);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_thread_loop_results )
+{
+  for (uint64_t n=0; n<100; n+=7) {
+    for (size_t n_threads=1; n_threads<6; ++n_threads) {
+      std::vector<uint64_t> results;
+      bob::visioner::thread_loop(Sum(), n, results, n_threads);
+      // one result per chunk, several chunks per thread but never more
+      // chunks than objects
+      BOOST_CHECK_EQUAL(results.size(),
+          bob::visioner::thread_chunks(n, n_threads));
+      BOOST_CHECK(results.size() <= std::max(n, (uint64_t)1));
+      uint64_t sum = 0;
+      for (size_t k=0; k<results.size(); ++k) sum += results[k];
+      BOOST_CHECK_EQUAL(sum, n * (n > 0 ? n-1 : 0) / 2);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_thread_loop_exception )
+{
+  // The exception of a chunk is rethrown to the caller, once the loop is over
+  BOOST_CHECK_THROW(bob::visioner::thread_loop(Throw(0), 100, 4),
+      std::runtime_error);
+  BOOST_CHECK_THROW(bob::visioner::thread_loop(Throw(99), 100, 4),
+      std::runtime_error);
+  BOOST_CHECK_NO_THROW(bob::visioner::thread_loop(Throw(100), 100, 4));
+
+  // The pool is still usable afterwards
+  std::vector<uint64_t> results;
+  bob::visioner::thread_loop(Sum(), 100, results, 4);
+  uint64_t sum = 0;
+  for (size_t k=0; k<results.size(); ++k) sum += results[k];
+  BOOST_CHECK_EQUAL(sum, (uint64_t)(99 * 100 / 2));
+}
+
+BOOST_AUTO_TEST_CASE( test_nested_run_with_busy_workers )
+{
+  bob::visioner::ThreadPool& pool = bob::visioner::ThreadPool::instance();
+  const size_t n_threads = pool.n_workers() + 1;
+
+  // All the threads of the pool (and the caller) are held by the batch: the
+  // helper jobs of the nested loop are queued to busy workers, and can only
+  // be run if the thread of the nested loop takes them from their queues.
+  Rendezvous all(n_threads), nested(1);
+  std::vector<int> ok(n_threads, 0);
+  std::vector<boost::function<void()> > tasks(n_threads);
+  for (size_t k=0; k<n_threads; ++k)
+    tasks[k] = boost::bind(Occupy(all, nested, n_threads, ok), (uint64_t)k);
+  pool.run(tasks, n_threads);
+
+  BOOST_CHECK_EQUAL(all.m_count, n_threads);
+  for (size_t k=0; k<n_threads; ++k) BOOST_CHECK(ok[k]);
+}
@@ -23,18 +23,221 @@
  */
 
 #include "bob/visioner/util/threads.h"
+#include "bob/core/parallel.h"
 
-// Split some objects to process using multiple threads
-void bob::visioner::thread_split(uint64_t n_objects, 
-    std::vector<uint64_t>& sbegins, std::vector<uint64_t>& sends, 
-    size_t num_of_threads=boost::thread::hardware_concurrency()) {
+namespace bob { namespace visioner {
 
-  uint64_t n_objects_per_thread = n_objects / num_of_threads + 1;
+  // Batch of tasks submitted to the pool
+  struct ThreadPool::Batch {
+    explicit Batch(const std::vector<boost::function<void()> >& t)
+      : tasks(t), next(0), n_jobs(0) {}
 
-  for (uint64_t ith = 0, sbegin = 0; ith < num_of_threads; ith ++) {
-    sbegins.push_back(sbegin);
-    sbegin = std::min(sbegin + n_objects_per_thread, n_objects);
-    sends.push_back(sbegin);
+    const std::vector<boost::function<void()> >& tasks;
+    boost::mutex          mutex;  // protects <next> and <error>
+    uint64_t              next;   // next task to claim
+    boost::exception_ptr  error;  // first exception raised by a task
+    size_t                n_jobs; // unfinished helper jobs (pool mutex)
+  };
+
+  namespace {
+    boost::once_flag  pool_once = BOOST_ONCE_INIT;
+    ThreadPool*       pool = 0;
+  }
+
+  void ThreadPool::create() {
+    const size_t n_workers = boost::thread::hardware_concurrency();
+    static ThreadPool instance(n_workers > 0 ? n_workers : 1);
+    pool = &instance;
+  }
+
+  ThreadPool& ThreadPool::instance() {
+    boost::call_once(&ThreadPool::create, pool_once);
+    return *pool;
+  }
+
+  ThreadPool::ThreadPool(size_t n_workers)
+    : m_n_jobs(0), m_next_queue(0), m_stop(false) {
+
+    for (size_t w = 0; w < n_workers; w ++) {
+      m_queues.push_back(new Queue);
+    }
+    for (size_t w = 0; w < n_workers; w ++) {
+      m_threads.create_thread(boost::bind(&ThreadPool::work, this, w));
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cond.notify_all();
+    m_threads.join_all();
+
+    for (size_t w = 0; w < m_queues.size(); w ++) {
+      delete m_queues[w];
+    }
+  }
+
+  // Worker loop: run jobs until the pool is destroyed
+  void ThreadPool::work(size_t worker) {
+    while (true) {
+      Job job;
+      if (pop(worker, job)) {
+        execute(job);
+        continue;
+      }
+
+      boost::unique_lock<boost::mutex> lock(m_mutex);
+      while (!m_stop && m_n_jobs == 0) {
+        m_cond.wait(lock);
+      }
+      if (m_stop && m_n_jobs == 0) {
+        return;
+      }
+    }
+  }
+
+  // Pop a job: the newest of the given queue, or the oldest of the others
+  bool ThreadPool::pop(size_t first, Job& job) {
+    const size_t n_queues = m_queues.size();
+    bool found = false;
+    for (size_t i = 0; i < n_queues && !found; i ++) {
+      Queue& queue = *m_queues[(first + i) % n_queues];
+      boost::lock_guard<boost::mutex> lock(queue.mutex);
+      if (!queue.jobs.empty()) {
+        if (i == 0) {
+          job = queue.jobs.back();
+          queue.jobs.pop_back();
+        }
+        else {
+          job = queue.jobs.front();
+          queue.jobs.pop_front();
+        }
+        found = true;
+      }
+    }
+
+    if (found) {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_n_jobs --;
+    }
+    return found;
+  }
+
+  // Claim and run the tasks of a batch until there is none left
+  void ThreadPool::drain(Batch& batch) {
+    const uint64_t n_tasks = batch.tasks.size();
+    while (true) {
+      uint64_t task;
+      {
+        boost::lock_guard<boost::mutex> lock(batch.mutex);
+        if (batch.next >= n_tasks) {
+          return;
+        }
+        task = batch.next ++;
+      }
+
+      try {
+        batch.tasks[task]();
+      }
+      catch (...) {
+        boost::lock_guard<boost::mutex> lock(batch.mutex);
+        if (!batch.error) {
+          batch.error = boost::current_exception();
+        }
+      }
+    }
+  }
+
+  void ThreadPool::execute(const Job& job) {
+    drain(*job.batch);
+
+    bool over;
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      over = (-- job.batch->n_jobs == 0);
+    }
+    if (over) {
+      m_cond.notify_all();
+    }
+  }
+
+  void ThreadPool::run(const std::vector<boost::function<void()> >& tasks,
+      size_t num_of_threads) {
+
+    if (tasks.empty()) {
+      return;
+    }
+
+    // Helper jobs for the other threads (the calling thread is one of them)
+    Batch batch(tasks);
+    const size_t n_jobs = std::min(std::min(num_of_threads, tasks.size()),
+        m_queues.size() + 1) - 1;
+
+    size_t first = 0;
+    if (n_jobs > 0) {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      batch.n_jobs = n_jobs;
+      m_n_jobs += n_jobs;
+      first = m_next_queue;
+      m_next_queue = (m_next_queue + n_jobs) % m_queues.size();
+    }
+    for (size_t j = 0; j < n_jobs; j ++) {
+      Queue& queue = *m_queues[(first + j) % m_queues.size()];
+      boost::lock_guard<boost::mutex> lock(queue.mutex);
+      queue.jobs.push_back(Job(&batch));
+    }
+    if (n_jobs > 0) {
+      m_cond.notify_all();
+    }
+
+    drain(batch);
+
+    // Wait for the helper jobs, running queued jobs in the meantime: the
+    // batch lives on this stack, and its jobs may not even have started
+    while (true) {
+      {
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        if (batch.n_jobs == 0) {
+          break;
+        }
+        if (m_n_jobs == 0) {
+          m_cond.wait(lock);
+          continue;
+        }
+      }
+
+      Job job;
+      if (pop(first, job)) {
+        execute(job);
+      }
+    }
+
+    if (batch.error) {
+      boost::rethrow_exception(batch.error);
+    }
+  }
+
+  // Split some objects to process using multiple threads
+  void thread_split(uint64_t n_objects, 
+      std::vector<uint64_t>& sbegins, std::vector<uint64_t>& sends, 
+      size_t num_of_threads) {
+
+    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
+      int sbegin, scount;
+      bob::core::getChunk((int)n_objects, (int)num_of_threads, (int)ith,
+          sbegin, scount);
+      sbegins.push_back(sbegin);
+      sends.push_back(sbegin + scount);
+    }
+
+  }
+
+  uint64_t thread_chunks(uint64_t size, size_t num_of_threads) {
+    static const uint64_t chunks_per_thread = 4;
+    const uint64_t n_chunks = chunks_per_thread * std::max(num_of_threads, (size_t)1);
+    return std::max(std::min(n_chunks, size), (uint64_t)1);
   }
 
-}
+}}
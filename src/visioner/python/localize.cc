@@ -121,6 +121,7 @@ void bind_visioner_localize() {
   boost::python::class_<bob::visioner::CVDetector>("CVDetector", "Object detector that processes a pyramid of images", boost::python::init<const std::string&, double, uint64_t, uint64_t, double, bob::visioner::CVDetector::Type>((boost::python::arg("model"), boost::python::arg("threshold")=0.0, boost::python::arg("scanning_levels")=0, boost::python::arg("scale_variation")=2, boost::python::arg("clustering")=0.05, boost::python::arg("method")=bob::visioner::CVDetector::GroundTruth), "Basic constructor with the following parameters:\n\nmodel\n  file containing the model to be loaded; **note**: Serialization will use a native text format by default. Files that have their names suffixed with '.gz' will be automatically decompressed. If the filename ends in '.vbin' or '.vbgz' the format used will be the native binary format.\n\nthreshold\n  object classification threshold\n\nscanning_levels\n  scanning levels (the more, the faster)\n\nscale_variation\n  scale variation in pixels\n\nclustering\n  overlapping threshold for clustering detections\n\nmethod\n  Scanning or GroundTruth"))
     .def_readwrite("threshold", &bob::visioner::CVDetector::m_threshold, "Object classification threshold")
     .add_property("scanning_levels", &bob::visioner::CVDetector::get_scan_levels, &bob::visioner::CVDetector::set_scan_levels, "Levels (the more, the faster)")
+    .add_property("scanning_threads", &bob::visioner::CVDetector::get_scan_threads, &bob::visioner::CVDetector::set_scan_threads, "Number of threads the sub-windows are scanned with (0: no thread)")
     .def_readwrite("scale_variation", &bob::visioner::CVDetector::m_ds, "Scale variation in pixels")
     .def_readwrite("clustering", &bob::visioner::CVDetector::m_cluster, "Overlapping threshold for clustering detections")
     .def_readwrite("method", &bob::visioner::CVDetector::m_type, "Scanning or GroundTruth (default)")